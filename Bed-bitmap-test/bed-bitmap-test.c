@@ -0,0 +1,183 @@
+/***************************************************************************
+ *  Description:
+ *      Test bl_bed_bitmap_save() and bl_bed_bitmap_load().  Features
+ *      from a BED file are added to a bitmap, which is saved, loaded,
+ *      and compared with the original around every feature boundary and
+ *      across the start of each contig.  Truncated and corrupt files
+ *      must be rejected.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "bed-bitmap.h"
+
+// Offset of the first contig's chunk count in a saved bitmap
+#define CHUNK_COUNT_OFFSET  32
+#define SCAN_BASES          200000
+
+int     compare_range(bl_bed_bitmap_t *b1, bl_bed_bitmap_t *b2,
+		      const char *chrom, uint64_t first, uint64_t last);
+int     load_bytes(const char *bytes, size_t len);
+
+int     main(int argc,char *argv[])
+
+{
+    bl_bed_bitmap_t bitmap, loaded;
+    bl_bed_t        bed_feature = BL_BED_INIT;
+    FILE            *bed_stream, *temp;
+    char            *bytes;
+    long            len;
+    uint64_t        start, end, chunk_count;
+    size_t          c;
+    int             errors = 0;
+    
+    if ( argc != 2 )
+    {
+	fprintf(stderr, "Usage: %s file.bed\n", argv[0]);
+	return EX_USAGE;
+    }
+    if ( (bed_stream = fopen(argv[1], "r")) == NULL )
+    {
+	fprintf(stderr, "bed-bitmap-test: Could not open %s.\n", argv[1]);
+	return EX_NOINPUT;
+    }
+    bl_bed_bitmap_init(&bitmap);
+    bl_bed_bitmap_add_bed(&bitmap, bed_stream);
+    
+    if ( (temp = tmpfile()) == NULL )
+    {
+	fprintf(stderr, "bed-bitmap-test: Could not create temp file.\n");
+	return EX_CANTCREAT;
+    }
+    if ( bl_bed_bitmap_save(&bitmap, temp) != BL_WRITE_OK )
+    {
+	fprintf(stderr, "bed-bitmap-test: Save failed.\n");
+	return EX_IOERR;
+    }
+    rewind(temp);
+    if ( bl_bed_bitmap_load(&loaded, temp) != BL_READ_OK )
+    {
+	fprintf(stderr, "bed-bitmap-test: Load failed.\n");
+	return EX_SOFTWARE;
+    }
+    
+    if ( (BL_BED_BITMAP_CONTIG_COUNT(&loaded) !=
+	  BL_BED_BITMAP_CONTIG_COUNT(&bitmap)) ||
+	 (bl_bed_bitmap_count(&loaded) != bl_bed_bitmap_count(&bitmap)) )
+    {
+	fprintf(stderr, "bed-bitmap-test: Loaded contig or base count differs.\n");
+	++errors;
+    }
+    for (c = 0; c < BL_BED_BITMAP_CONTIG_COUNT(&bitmap); ++c)
+	errors += compare_range(&bitmap, &loaded,
+				BL_BED_BITMAP_CONTIG_NAME(&bitmap, c),
+				0, SCAN_BASES - 1);
+    
+    rewind(bed_stream);
+    while ( bl_bed_read(bed_stream, &bed_feature, BL_BED_FIELD_ALL)
+	    == BL_READ_OK )
+    {
+	start = BL_BED_CHROM_START(&bed_feature);
+	end = BL_BED_CHROM_END(&bed_feature);
+	errors += compare_range(&bitmap, &loaded, BL_BED_CHROM(&bed_feature),
+				start > 0 ? start - 1 : 0, start + 1);
+	errors += compare_range(&bitmap, &loaded, BL_BED_CHROM(&bed_feature),
+				end - 1, end + 1);
+    }
+    bl_bed_free(&bed_feature);
+    fclose(bed_stream);
+    bl_bed_bitmap_free(&loaded);
+    
+    // Truncated and corrupt copies of the saved bitmap
+    len = ftell(temp);
+    rewind(temp);
+    bytes = xt_malloc(len, 1);
+    if ( fread(bytes, len, 1, temp) != 1 )
+    {
+	fprintf(stderr, "bed-bitmap-test: Could not reread saved bitmap.\n");
+	return EX_IOERR;
+    }
+    fclose(temp);
+    
+    if ( load_bytes(bytes, len / 2) == BL_READ_OK )
+    {
+	fprintf(stderr, "bed-bitmap-test: Loaded a truncated bitmap.\n");
+	++errors;
+    }
+    
+    // A chunk count far beyond the file size must not be allocated
+    chunk_count = (uint64_t)1 << 30;
+    memcpy(bytes + CHUNK_COUNT_OFFSET, &chunk_count, sizeof(chunk_count));
+    if ( load_bytes(bytes, len) != BL_READ_MISMATCH )
+    {
+	fprintf(stderr, "bed-bitmap-test: Loaded an oversized chunk count.\n");
+	++errors;
+    }
+    free(bytes);
+    
+    bl_bed_bitmap_free(&bitmap);
+    return errors == 0 ? EX_OK : EX_SOFTWARE;
+}
+
+
+/*
+ *  Return 1 if any position from first through last is in one bitmap
+ *  but not the other
+ */
+
+int     compare_range(bl_bed_bitmap_t *b1, bl_bed_bitmap_t *b2,
+		      const char *chrom, uint64_t first, uint64_t last)
+
+{
+    ssize_t     id1 = bl_bed_bitmap_contig_id(b1, chrom),
+		id2 = bl_bed_bitmap_contig_id(b2, chrom);
+    uint64_t    pos;
+    bool        in1, in2;
+    
+    for (pos = first; pos <= last; ++pos)
+    {
+	in1 = (id1 >= 0) && bl_bed_bitmap_contains(b1, id1, pos);
+	in2 = (id2 >= 0) && bl_bed_bitmap_contains(b2, id2, pos);
+	if ( in1 != in2 )
+	{
+	    fprintf(stderr, "bed-bitmap-test: %s:%" PRIu64 " %s after load.\n",
+		    chrom, pos, in1 ? "lost" : "gained");
+	    return 1;
+	}
+    }
+    return 0;
+}
+
+
+/*
+ *  Load a bitmap from a copy of saved data in a temp file, which like
+ *  any regular file has a known size
+ */
+
+int     load_bytes(const char *bytes, size_t len)
+
+{
+    bl_bed_bitmap_t bitmap;
+    FILE            *temp;
+    int             status;
+    
+    if ( (temp = tmpfile()) == NULL )
+    {
+	fprintf(stderr, "bed-bitmap-test: Could not create temp file.\n");
+	exit(EX_CANTCREAT);
+    }
+    fwrite(bytes, len, 1, temp);
+    rewind(temp);
+    status = bl_bed_bitmap_load(&bitmap, temp);
+    bl_bed_bitmap_free(&bitmap);
+    fclose(temp);
+    return status;
+}
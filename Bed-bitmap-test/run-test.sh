@@ -0,0 +1,9 @@
+#!/bin/sh -e
+
+# Load errors are expected on stderr for the corrupt copies
+if ./bed-bitmap-test input.bed; then
+    printf "BED bitmap test: Save and load OK.\n"
+else
+    printf "BED bitmap test: Failure.\n"
+    exit 1
+fi
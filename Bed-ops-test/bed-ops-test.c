@@ -0,0 +1,93 @@
+/***************************************************************************
+ *  Description:
+ *      Test bed-ops.c functions.  Runs one operation on the named files
+ *      and writes the resulting features to stdout.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "bed-ops.h"
+
+void    usage(char *argv[]);
+FILE    *open_input(const char *filename);
+
+int     main(int argc,char *argv[])
+
+{
+    bl_bed_t            bed_feature = BL_BED_INIT;
+    bl_bed_merge_t      merge;
+    bl_bed_complement_t complement;
+    bl_bed_subtract_t   subtract;
+    FILE                *stream1, *stream2 = NULL;
+    int                 status = BL_READ_EOF;
+    
+    if ( argc != 4 )
+	usage(argv);
+    stream1 = open_input(argv[2]);
+    
+    if ( strcmp(argv[1], "merge") == 0 )
+    {
+	bl_bed_merge_init(&merge, stream1, strtoull(argv[3], NULL, 10));
+	while ( (status = bl_bed_merge_next(&merge, &bed_feature))
+		== BL_READ_OK )
+	    bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+	bl_bed_merge_free(&merge);
+    }
+    else if ( strcmp(argv[1], "complement") == 0 )
+    {
+	stream2 = open_input(argv[3]);
+	bl_bed_complement_init(&complement, stream1, stream2);
+	while ( (status = bl_bed_complement_next(&complement, &bed_feature))
+		== BL_READ_OK )
+	    bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+	bl_bed_complement_free(&complement);
+    }
+    else if ( strcmp(argv[1], "subtract") == 0 )
+    {
+	stream2 = open_input(argv[3]);
+	bl_bed_subtract_init(&subtract, stream1, stream2);
+	while ( (status = bl_bed_subtract_next(&subtract, &bed_feature))
+		== BL_READ_OK )
+	    bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+	bl_bed_subtract_free(&subtract);
+    }
+    else
+	usage(argv);
+    
+    bl_bed_free(&bed_feature);
+    fclose(stream1);
+    if ( stream2 != NULL )
+	fclose(stream2);
+    return status == BL_READ_EOF ? EX_OK : EX_DATAERR;
+}
+
+
+FILE    *open_input(const char *filename)
+
+{
+    FILE    *stream;
+    
+    if ( (stream = fopen(filename, "r")) == NULL )
+    {
+	fprintf(stderr, "bed-ops-test: Could not open %s.\n", filename);
+	exit(EX_NOINPUT);
+    }
+    return stream;
+}
+
+
+void    usage(char *argv[])
+
+{
+    fprintf(stderr, "Usage: %s merge file.bed max-gap\n", argv[0]);
+    fprintf(stderr, "       %s complement file.bed genome-file\n", argv[0]);
+    fprintf(stderr, "       %s subtract file1.bed file2.bed\n", argv[0]);
+    exit(EX_USAGE);
+}
@@ -0,0 +1,22 @@
+#!/bin/sh -e
+
+status=0
+
+check()
+{
+    name=$1
+    shift
+    if ./bed-ops-test "$@" > out.bed && diff $name.expected out.bed; then
+	printf "BED ops test: $name OK.\n"
+    else
+	printf "BED ops test: Failure on $name.\n"
+	status=1
+    fi
+}
+
+check merge merge a.bed 0
+check merge-gap merge a.bed 100
+check complement complement a.bed genome.txt
+check subtract subtract a.bed b.bed
+rm -f out.bed
+exit $status
@@ -1,24 +1,26 @@
 /***************************************************************************
  *  Description:
- *      Test bedio.c functions
+ *      Test bed.c functions
  *
  *  History: 
  *  Date        Name        Modification
  *  2021-05-19  Jason Bacon Begin
+ *  2026-10-18  Jason Bacon Port from bedio.h to the bl_bed API
  ***************************************************************************/
 
 #include <stdio.h>
 #include <sysexits.h>
-#include "bedio.h"
+#include <xtend.h>
+#include "bed.h"
 
 int     main(int argc,char *argv[])
 
 {
-    bed_feature_t   bed_feature;
+    bl_bed_t    bed_feature = BL_BED_INIT;
     
-    bed_skip_header(stdin);
-    while ( bed_read_feature(stdin, &bed_feature) != EOF )
-	bed_write_feature(stdout, &bed_feature, BED_FIELD_ALL);
+    bl_bed_skip_header(stdin);
+    while ( bl_bed_read(stdin, &bed_feature, BL_BED_FIELD_ALL) == BL_READ_OK )
+	bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+    bl_bed_free(&bed_feature);
     return EX_OK;
 }
-
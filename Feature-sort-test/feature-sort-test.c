@@ -0,0 +1,54 @@
+/***************************************************************************
+ *  Description:
+ *      Test feature-sort.c.  Sorts BED or GFF features from stdin to
+ *      stdout with a given memory limit and thread count, so that small
+ *      limits exercise the external merge of spilled runs.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "feature-sort.h"
+
+void    usage(char *argv[]);
+
+int     main(int argc,char *argv[])
+
+{
+    bl_feature_sort_t   sort;
+    int                 format = BL_FEATURE_SORT_BED, status;
+    size_t              mem_limit;
+    unsigned            threads;
+    
+    if ( argc != 4 )
+	usage(argv);
+    if ( strcmp(argv[1], "gff") == 0 )
+	format = BL_FEATURE_SORT_GFF;
+    else if ( strcmp(argv[1], "bed") != 0 )
+	usage(argv);
+    mem_limit = strtoul(argv[2], NULL, 10);
+    threads = strtoul(argv[3], NULL, 10);
+    
+    bl_feature_sort_init(&sort, format, mem_limit, threads);
+    if ( (status = bl_feature_sort_add_stream(&sort, stdin)) == BL_READ_OK )
+	status = bl_feature_sort_write(&sort, stdout);
+    fprintf(stderr, "feature-sort-test: %s %zu bytes: %zu runs.\n",
+	    argv[1], mem_limit, BL_FEATURE_SORT_RUN_COUNT(&sort));
+    bl_feature_sort_free(&sort);
+    return status == 0 ? EX_OK : EX_DATAERR;
+}
+
+
+void    usage(char *argv[])
+
+{
+    fprintf(stderr, "Usage: %s bed|gff mem-limit threads < input > output\n",
+	    argv[0]);
+    exit(EX_USAGE);
+}
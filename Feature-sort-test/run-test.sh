@@ -0,0 +1,20 @@
+#!/bin/sh -e
+
+status=0
+for format in bed gff; do
+    # 16 kB forces many spilled runs, 64 MB sorts in memory
+    for mem_limit in 16384 67108864; do
+	for threads in 1 4; do
+	    ./feature-sort-test $format $mem_limit $threads \
+		< input.$format > out.$format
+	    if diff sorted.$format out.$format; then
+		printf "Feature sort test: $format $mem_limit $threads OK.\n"
+	    else
+		printf "Feature sort test: Failure on $format $mem_limit $threads.\n"
+		status=1
+	    fi
+	done
+    done
+done
+rm -f out.bed out.gff
+exit $status
@@ -0,0 +1,127 @@
+/***************************************************************************
+ *  Description:
+ *      Test bl_qual_stats_merge().  QUAL strings from stdin are added to
+ *      one accumulator, and alternately to two others that are then
+ *      merged, with empty accumulators on either side of the merges.
+ *      Every merged result must match the single accumulator.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "qual-stats.h"
+
+#define THRESHOLD   30
+
+int     stats_cmp(bl_qual_stats_t *s1, bl_qual_stats_t *s2);
+int     check(const char *test, bl_qual_stats_t *whole, bl_qual_stats_t *merged);
+
+int     main(int argc,char *argv[])
+
+{
+    bl_qual_stats_t whole, odd, even, empty, from_empty, mismatch;
+    char            qual[BL_SAM_SEQ_MAX_CHARS + 2];
+    size_t          len, line;
+    int             errors = 0;
+    
+    bl_qual_stats_init(&whole, BL_QUAL_PHRED33, THRESHOLD);
+    bl_qual_stats_init(&odd, BL_QUAL_PHRED33, THRESHOLD);
+    bl_qual_stats_init(&even, BL_QUAL_PHRED33, THRESHOLD);
+    bl_qual_stats_init(&empty, BL_QUAL_PHRED33, THRESHOLD);
+    bl_qual_stats_init(&from_empty, BL_QUAL_PHRED33, THRESHOLD);
+    
+    for (line = 0; fgets(qual, sizeof(qual), stdin) != NULL; ++line)
+    {
+	len = strcspn(qual, "\n");
+	bl_qual_stats_add(&whole, qual, len);
+	bl_qual_stats_add(line % 2 ? &odd : &even, qual, len);
+    }
+    
+    // Empty source: dest must be unchanged
+    bl_qual_stats_merge(&odd, &empty);
+    bl_qual_stats_merge(&odd, &even);
+    errors += check("split merge", &whole, &odd);
+    
+    // Empty dest: must become a copy of src, per-cycle arrays included
+    bl_qual_stats_merge(&from_empty, &whole);
+    errors += check("merge into empty", &whole, &from_empty);
+    
+    // Empty into empty stays empty
+    bl_qual_stats_init(&mismatch, BL_QUAL_PHRED33, THRESHOLD);
+    bl_qual_stats_merge(&mismatch, &empty);
+    if ( (BL_QUAL_STATS_READS(&mismatch) != 0) ||
+	 (BL_QUAL_STATS_CYCLE_MAX(&mismatch) != 0) )
+    {
+	fprintf(stderr, "qual-stats-test: empty + empty is not empty.\n");
+	++errors;
+    }
+    bl_qual_stats_free(&mismatch);
+    
+    bl_qual_stats_init(&mismatch, BL_QUAL_PHRED64, THRESHOLD);
+    if ( bl_qual_stats_merge(&mismatch, &whole) != BL_DATA_INVALID )
+    {
+	fprintf(stderr, "qual-stats-test: Merged different offsets.\n");
+	++errors;
+    }
+    
+    printf("Reads: %" PRIu64 "  Bases: %" PRIu64 "  Mean: %.2f  >= Q%u: %.4f\n",
+	   BL_QUAL_STATS_READS(&whole), BL_QUAL_STATS_BASES(&whole),
+	   BL_QUAL_STATS_MEAN(&whole), THRESHOLD,
+	   BL_QUAL_STATS_FRACTION_AT_LEAST(&whole));
+    
+    bl_qual_stats_free(&whole);
+    bl_qual_stats_free(&odd);
+    bl_qual_stats_free(&even);
+    bl_qual_stats_free(&empty);
+    bl_qual_stats_free(&from_empty);
+    bl_qual_stats_free(&mismatch);
+    return errors == 0 ? EX_OK : EX_SOFTWARE;
+}
+
+
+int     check(const char *test, bl_qual_stats_t *whole, bl_qual_stats_t *merged)
+
+{
+    if ( stats_cmp(whole, merged) != 0 )
+    {
+	fprintf(stderr, "qual-stats-test: %s does not match.\n", test);
+	return 1;
+    }
+    return 0;
+}
+
+
+/*
+ *  Compare everything a caller can see: totals, histograms, and
+ *  per-cycle means
+ */
+
+int     stats_cmp(bl_qual_stats_t *s1, bl_qual_stats_t *s2)
+
+{
+    size_t  c;
+    
+    if ( (BL_QUAL_STATS_READS(s1) != BL_QUAL_STATS_READS(s2)) ||
+	 (BL_QUAL_STATS_BASES(s1) != BL_QUAL_STATS_BASES(s2)) ||
+	 (BL_QUAL_STATS_SUM(s1) != BL_QUAL_STATS_SUM(s2)) ||
+	 (BL_QUAL_STATS_AT_LEAST(s1) != BL_QUAL_STATS_AT_LEAST(s2)) ||
+	 (BL_QUAL_STATS_CYCLE_MAX(s1) != BL_QUAL_STATS_CYCLE_MAX(s2)) )
+	return 1;
+    for (c = 0; c < BL_QUAL_HIST_SIZE; ++c)
+	if ( (BL_QUAL_STATS_HIST_AE(s1, c) != BL_QUAL_STATS_HIST_AE(s2, c)) ||
+	     (BL_QUAL_STATS_MEAN_HIST_AE(s1, c) !=
+	      BL_QUAL_STATS_MEAN_HIST_AE(s2, c)) ||
+	     (BL_QUAL_STATS_MIN_HIST_AE(s1, c) !=
+	      BL_QUAL_STATS_MIN_HIST_AE(s2, c)) )
+	    return 1;
+    for (c = 0; c <= BL_QUAL_STATS_CYCLE_MAX(s1); ++c)
+	if ( bl_qual_stats_cycle_mean(s1, c) != bl_qual_stats_cycle_mean(s2, c) )
+	    return 1;
+    return 0;
+}
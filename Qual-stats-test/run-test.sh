@@ -0,0 +1,8 @@
+#!/bin/sh -e
+
+if ./qual-stats-test < input.txt; then
+    printf "Qual stats test: Merges with empty accumulators OK.\n"
+else
+    printf "Qual stats test: Failure.\n"
+    exit 1
+fi
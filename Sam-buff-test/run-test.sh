@@ -0,0 +1,8 @@
+#!/bin/sh -e
+
+if ./sam-buff-test; then
+    printf "SAM buff test: Spilled alignments reloaded in order OK.\n"
+else
+    printf "SAM buff test: Failure.\n"
+    exit 1
+fi
@@ -0,0 +1,202 @@
+/***************************************************************************
+ *  Description:
+ *      Test spilling in sam-buff.c.  Sorted alignments are added to a
+ *      buffer with a small memory budget, so the oldest are spilled to
+ *      disk, while alignments are shifted off the head as a caller
+ *      sliding a window would.  Every buffered alignment must remain
+ *      reachable in input order, with its sequence intact.  A sliding
+ *      window is then run over more alignments to check that the spill
+ *      file does not grow without bound as spilled alignments are
+ *      shifted out.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-buff.h"
+
+#define ALIGNMENTS  20000
+#define MEM_BUDGET  1000000
+#define WINDOW      2000
+#define SLIDES      100000
+#define SEQ         "ACGTNACGTTGCA"
+
+int     check_buff(bl_sam_buff_t *sam_buff, uint64_t first_pos);
+int     check_slide(void);
+
+int     main(int argc,char *argv[])
+
+{
+    bl_sam_buff_t   sam_buff;
+    bl_sam_t        sam_alignment;
+    FILE            *sam_stream;
+    uint64_t        c, first_pos = 1;
+    int             errors = 0;
+    
+    if ( (sam_stream = tmpfile()) == NULL )
+    {
+	fprintf(stderr, "sam-buff-test: Could not create temp file.\n");
+	return EX_CANTCREAT;
+    }
+    for (c = 1; c <= ALIGNMENTS; ++c)
+	fprintf(sam_stream, "read%" PRIu64 "\t0\tchr1\t%" PRIu64
+		"\t60\t13M\t*\t0\t0\t" SEQ "\tIIIIIIIIIIIII\n", c, c);
+    rewind(sam_stream);
+    
+    bl_sam_buff_init(&sam_buff, 0);
+    bl_sam_buff_set_mem_budget(&sam_buff, MEM_BUDGET);
+    bl_sam_buff_set_seq_encoding(&sam_buff, BL_SEQ_NT4);
+    
+    bl_sam_init(&sam_alignment, 0, BL_SAM_FIELD_ALL);
+    for (c = 1; bl_sam_read(sam_stream, &sam_alignment, BL_SAM_FIELD_ALL)
+		== BL_READ_OK; ++c)
+    {
+	bl_sam_buff_add_alignment(&sam_buff, &sam_alignment);
+	bl_sam_free(&sam_alignment);
+	bl_sam_init(&sam_alignment, 0, BL_SAM_FIELD_ALL);
+	
+	// The newest alignment is the one a caller works on next
+	if ( BL_SAM_BUFF_ALIGNMENTS(&sam_buff)
+		[BL_SAM_BUFF_BUFFERED_COUNT(&sam_buff) - 1] == NULL )
+	{
+	    fprintf(stderr, "sam-buff-test: Newest alignment %" PRIu64
+		    " was spilled.\n", c);
+	    ++errors;
+	}
+	
+	// Drop 3 of every 7 so the buffer keeps growing and spilling
+	if ( c % 7 == 0 )
+	{
+	    bl_sam_buff_shift(&sam_buff, 3);
+	    first_pos += 3;
+	}
+	if ( c % 1000 == 0 )
+	    errors += check_buff(&sam_buff, first_pos);
+    }
+    bl_sam_free(&sam_alignment);
+    fclose(sam_stream);
+    
+    errors += check_buff(&sam_buff, first_pos);
+    if ( BL_SAM_BUFF_SPILLED_ALIGNMENTS(&sam_buff) == 0 )
+    {
+	fprintf(stderr, "sam-buff-test: Nothing was spilled.\n");
+	++errors;
+    }
+    
+    bl_sam_buff_shift(&sam_buff, BL_SAM_BUFF_BUFFERED_COUNT(&sam_buff));
+    if ( (BL_SAM_BUFF_SPILL_COUNT(&sam_buff) != 0) ||
+	 (BL_SAM_BUFF_MEM_USED(&sam_buff) != 0) )
+    {
+	fprintf(stderr, "sam-buff-test: Empty buffer still holds %zu spilled, %zu bytes.\n",
+		BL_SAM_BUFF_SPILL_COUNT(&sam_buff),
+		BL_SAM_BUFF_MEM_USED(&sam_buff));
+	++errors;
+    }
+    bl_sam_buff_free(&sam_buff);
+    
+    errors += check_slide();
+    return errors == 0 ? EX_OK : EX_SOFTWARE;
+}
+
+
+/*
+ *  Keep WINDOW alignments buffered, far more than fit the budget, while
+ *  SLIDES more pass through.  Dead space from alignments shifted out
+ *  must be reclaimed, so the spill file stays within twice the live
+ *  spilled data plus the 1 MiB batch size.
+ */
+
+int     check_slide(void)
+
+{
+    bl_sam_buff_t   sam_buff;
+    bl_sam_t        sam_alignment;
+    FILE            *sam_stream;
+    uint64_t        c;
+    size_t          s, live_bytes;
+    int             errors = 0;
+    
+    if ( (sam_stream = tmpfile()) == NULL )
+    {
+	fprintf(stderr, "sam-buff-test: Could not create temp file.\n");
+	return 1;
+    }
+    for (c = 1; c <= SLIDES; ++c)
+	fprintf(sam_stream, "read%" PRIu64 "\t0\tchr1\t%" PRIu64
+		"\t60\t13M\t*\t0\t0\t" SEQ "\tIIIIIIIIIIIII\n", c, c);
+    rewind(sam_stream);
+    
+    bl_sam_buff_init(&sam_buff, 0);
+    bl_sam_buff_set_mem_budget(&sam_buff, MEM_BUDGET);
+    bl_sam_init(&sam_alignment, 0, BL_SAM_FIELD_ALL);
+    while ( (errors == 0) &&
+	    (bl_sam_read(sam_stream, &sam_alignment, BL_SAM_FIELD_ALL)
+		== BL_READ_OK) )
+    {
+	bl_sam_buff_add_alignment(&sam_buff, &sam_alignment);
+	if ( BL_SAM_BUFF_BUFFERED_COUNT(&sam_buff) > WINDOW )
+	    bl_sam_buff_shift(&sam_buff, 1);
+	
+	for (s = 0, live_bytes = 0;
+	     s < BL_SAM_BUFF_BUFFERED_COUNT(&sam_buff); ++s)
+	    if ( BL_SAM_BUFF_SPILL_SIZES(&sam_buff) != NULL )
+		live_bytes += BL_SAM_BUFF_SPILL_SIZES_AE(&sam_buff, s);
+	if ( (size_t)BL_SAM_BUFF_SPILL_WRITE_POS(&sam_buff) >
+		2 * live_bytes + 1024 * 1024 )
+	{
+	    fprintf(stderr, "sam-buff-test: Spill file at %jd bytes "
+		    "for %zu live.\n",
+		    (intmax_t)BL_SAM_BUFF_SPILL_WRITE_POS(&sam_buff),
+		    live_bytes);
+	    ++errors;
+	}
+    }
+    bl_sam_free(&sam_alignment);
+    fclose(sam_stream);
+    
+    if ( errors == 0 )
+	errors += check_buff(&sam_buff, SLIDES - WINDOW + 1);
+    bl_sam_buff_free(&sam_buff);
+    return errors;
+}
+
+
+/*
+ *  Every buffered alignment, spilled or not, must be returned in order
+ */
+
+int     check_buff(bl_sam_buff_t *sam_buff, uint64_t first_pos)
+
+{
+    bl_sam_t    *sam_alignment;
+    size_t      c;
+    char        qname[BL_SAM_QNAME_MAX_CHARS + 1];
+    
+    for (c = 0; c < BL_SAM_BUFF_BUFFERED_COUNT(sam_buff); ++c)
+    {
+	sam_alignment = bl_sam_buff_alignment(sam_buff, c);
+	snprintf(qname, sizeof(qname), "read%" PRIu64, first_pos + c);
+	if ( (sam_alignment == NULL) ||
+	     (BL_SAM_POS(sam_alignment) != first_pos + c) ||
+	     (strcmp(BL_SAM_QNAME(sam_alignment), qname) != 0) )
+	{
+	    fprintf(stderr, "sam-buff-test: Alignment %zu is not %s.\n",
+		    c, qname);
+	    return 1;
+	}
+	bl_sam_unpack_seq(sam_alignment);
+	if ( strcmp(BL_SAM_SEQ(sam_alignment), SEQ) != 0 )
+	{
+	    fprintf(stderr, "sam-buff-test: Bad sequence in %s.\n", qname);
+	    return 1;
+	}
+    }
+    return 0;
+}
@@ -0,0 +1,14 @@
+#!/bin/sh -e
+
+status=0
+for api in stream reader; do
+    ./sam-dup-test $api < input.sam > out.sam
+    if diff expected.sam out.sam; then
+	printf "SAM dup test: $api drop OK.\n"
+    else
+	printf "SAM dup test: Failure on $api drop.\n"
+	status=1
+    fi
+done
+rm -f out.sam
+exit $status
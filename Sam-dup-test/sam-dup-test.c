@@ -0,0 +1,70 @@
+/***************************************************************************
+ *  Description:
+ *      Test BL_SAM_DUP_DROP in sam-dup.c.  Duplicates are skipped by
+ *      reading the next record into the caller's bl_sam_t, which must
+ *      hold records of any length, e.g. a 30 base read following a
+ *      dropped 5 base duplicate.  Survivors are written to stdout.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-dup.h"
+
+void    usage(char *argv[]);
+
+int     main(int argc,char *argv[])
+
+{
+    bl_sam_buff_t   sam_buff;
+    bl_sam_dup_t    dup;
+    bl_sam_reader_t reader;
+    bl_sam_t        sam_alignment;
+    bool            use_reader = false;
+    
+    if ( argc != 2 )
+	usage(argv);
+    if ( strcmp(argv[1], "reader") == 0 )
+	use_reader = true;
+    else if ( strcmp(argv[1], "stream") != 0 )
+	usage(argv);
+    
+    bl_sam_buff_init(&sam_buff, 0);
+    bl_sam_dup_init(&dup, &sam_buff, BL_SAM_DUP_DEFAULT_WINDOW,
+		    BL_SAM_DUP_DROP);
+    
+    // Sized for the first record only
+    bl_sam_init(&sam_alignment, 5, BL_SAM_FIELD_ALL);
+    if ( use_reader )
+    {
+	bl_sam_reader_init(&reader, stdin, BL_SAM_FIELD_ALL);
+	while ( bl_sam_dup_reader_read(&dup, &reader, &sam_alignment)
+		== BL_READ_OK )
+	    bl_sam_write(stdout, &sam_alignment, BL_SAM_FIELD_ALL);
+	bl_sam_reader_close(&reader);
+    }
+    else
+    {
+	while ( bl_sam_dup_read(&dup, stdin, &sam_alignment,
+				BL_SAM_FIELD_ALL) == BL_READ_OK )
+	    bl_sam_write(stdout, &sam_alignment, BL_SAM_FIELD_ALL);
+    }
+    bl_sam_free(&sam_alignment);
+    bl_sam_dup_free(&dup);
+    bl_sam_buff_free(&sam_buff);
+    return EX_OK;
+}
+
+
+void    usage(char *argv[])
+
+{
+    fprintf(stderr, "Usage: %s stream|reader < file.sam\n", argv[0]);
+    exit(EX_USAGE);
+}
@@ -0,0 +1,13 @@
+#!/bin/sh -e
+
+status=0
+for region in "chr1 1000 3000" "chr1 15700 16000" "chr1 1 100000" \
+	      "chr2 7000 7400" "chr3 1 10"; do
+    if count=$(./sam-index-test input.sam $region); then
+	printf "SAM index test: $region, $count alignments OK.\n"
+    else
+	printf "SAM index test: Failure on $region.\n"
+	status=1
+    fi
+done
+exit $status
@@ -0,0 +1,142 @@
+/***************************************************************************
+ *  Description:
+ *      Test region queries in sam-index.c.  The SAM file named by argv[1]
+ *      is indexed, and alignments overlapping the region given by
+ *      argv[2..4] are read with bl_sam_iter_next(3) into one bl_sam_t,
+ *      with a field mask including SEQ, so that records of different
+ *      lengths reuse the same buffers.  The results must match a linear
+ *      scan of the whole file, including sequences.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-index.h"
+
+#define FIELD_MASK  (BL_SAM_FIELD_QNAME | BL_SAM_FIELD_RNAME | \
+		     BL_SAM_FIELD_POS | BL_SAM_FIELD_CIGAR | BL_SAM_FIELD_SEQ)
+
+void    usage(char *argv[]);
+
+int     main(int argc,char *argv[])
+
+{
+    bl_sam_index_t  index = BL_SAM_INDEX_INIT;
+    bl_sam_iter_t   iter;
+    bl_sam_reader_t iter_reader, scan_reader;
+    bl_sam_t        found = BL_SAM_ALIGNMENT_INIT,
+		    expected = BL_SAM_ALIGNMENT_INIT;
+    FILE            *sam_stream, *scan_stream;
+    char            *rname, *end;
+    uint64_t        beg, last;
+    unsigned long   count = 0;
+    int             ch, status = EX_OK, scan_status = BL_READ_OK;
+    
+    if ( argc != 5 )
+	usage(argv);
+    rname = argv[2];
+    beg = strtoull(argv[3], &end, 10);
+    if ( *end != '\0' )
+	usage(argv);
+    last = strtoull(argv[4], &end, 10);
+    if ( *end != '\0' )
+	usage(argv);
+    
+    if ( ((sam_stream = fopen(argv[1], "r")) == NULL) ||
+	 ((scan_stream = fopen(argv[1], "r")) == NULL) )
+    {
+	fprintf(stderr, "sam-index-test: Could not open %s.\n", argv[1]);
+	return EX_NOINPUT;
+    }
+    if ( bl_sam_index_build(&index, sam_stream) != BL_READ_OK )
+    {
+	fprintf(stderr, "sam-index-test: bl_sam_index_build() failed.\n");
+	return EX_DATAERR;
+    }
+    
+    bl_sam_reader_init(&iter_reader, sam_stream, FIELD_MASK);
+    if ( bl_sam_iter_init(&iter, &index, &iter_reader, rname, beg, last)
+	    != BL_DATA_OK )
+    {
+	fprintf(stderr, "sam-index-test: bl_sam_iter_init() failed.\n");
+	return EX_DATAERR;
+    }
+    
+    while ( (ch = getc(scan_stream)) == '@' )
+	while ( ((ch = getc(scan_stream)) != '\n') && (ch != EOF) )
+	    ;
+    ungetc(ch, scan_stream);
+    bl_sam_reader_init(&scan_reader, scan_stream, FIELD_MASK);
+    while ( bl_sam_iter_next(&iter, &found) == BL_READ_OK )
+    {
+	// Next overlapping alignment in the whole file
+	while ( (scan_status = bl_sam_reader_read(&scan_reader, &expected))
+		== BL_READ_OK )
+	{
+	    if ( (strcmp(BL_SAM_RNAME(&expected), rname) == 0) &&
+		 (BL_SAM_POS(&expected) <= last) &&
+		 (BL_SAM_REF_END(&expected) >= beg) )
+		break;
+	}
+	if ( scan_status != BL_READ_OK )
+	{
+	    fprintf(stderr, "sam-index-test: Extra alignment %s.\n",
+		    BL_SAM_QNAME(&found));
+	    status = EX_SOFTWARE;
+	    break;
+	}
+	if ( (strcmp(BL_SAM_QNAME(&found), BL_SAM_QNAME(&expected)) != 0) ||
+	     (BL_SAM_SEQ_LEN(&found) != BL_SAM_SEQ_LEN(&expected)) ||
+	     (strcmp(BL_SAM_SEQ(&found), BL_SAM_SEQ(&expected)) != 0) )
+	{
+	    fprintf(stderr, "sam-index-test: Got %s, expected %s.\n",
+		    BL_SAM_QNAME(&found), BL_SAM_QNAME(&expected));
+	    status = EX_SOFTWARE;
+	    break;
+	}
+	++count;
+    }
+    
+    // Anything the iterator missed?
+    if ( status == EX_OK )
+    {
+	while ( bl_sam_reader_read(&scan_reader, &expected) == BL_READ_OK )
+	{
+	    if ( (strcmp(BL_SAM_RNAME(&expected), rname) == 0) &&
+		 (BL_SAM_POS(&expected) <= last) &&
+		 (BL_SAM_REF_END(&expected) >= beg) )
+	    {
+		fprintf(stderr, "sam-index-test: Missed alignment %s.\n",
+			BL_SAM_QNAME(&expected));
+		status = EX_SOFTWARE;
+		break;
+	    }
+	}
+    }
+    printf("%lu\n", count);
+    
+    bl_sam_iter_free(&iter);
+    bl_sam_index_free(&index);
+    bl_sam_free(&found);
+    bl_sam_free(&expected);
+    bl_sam_reader_close(&iter_reader);
+    bl_sam_reader_close(&scan_reader);
+    fclose(sam_stream);
+    fclose(scan_stream);
+    return status;
+}
+
+
+void    usage(char *argv[])
+
+{
+    fprintf(stderr, "Usage: %s file.sam rname beg end\n", argv[0]);
+    exit(EX_USAGE);
+}
@@ -0,0 +1,26 @@
+#!/bin/sh -e
+
+status=0
+for encoding in ascii nt16 nt4; do
+    for unpack in --packed --unpack; do
+	./sam-test $encoding $unpack < input.sam > out.sam
+	if diff input.sam out.sam; then
+	    printf "SAM test: $encoding $unpack round trip OK.\n"
+	else
+	    printf "SAM test: Failure on $encoding $unpack round trip.\n"
+	    status=1
+	fi
+    done
+done
+# Read into the same bl_sam_t, packed by the previous iteration
+for encoding in ascii nt16 nt4; do
+    ./sam-test $encoding --reuse < input.sam > out.sam
+    if diff input.sam out.sam; then
+	printf "SAM test: $encoding --reuse round trip OK.\n"
+    else
+	printf "SAM test: Failure on $encoding --reuse round trip.\n"
+	status=1
+    fi
+done
+rm -f out.sam
+exit $status
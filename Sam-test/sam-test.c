@@ -0,0 +1,95 @@
+/***************************************************************************
+ *  Description:
+ *      Test sequence packing in sam.c.  Alignments from stdin are packed
+ *      with the encoding named by argv[1], serialized to a temp file,
+ *      deserialized, optionally unpacked, and written to stdout, which
+ *      should match the input exactly.  With --reuse, one bl_sam_t is
+ *      read into repeatedly without bl_sam_free()/bl_sam_init(), as
+ *      tools reading a stream normally do.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam.h"
+#include "seq-pack.h"
+
+void    usage(char *argv[]);
+
+int     main(int argc,char *argv[])
+
+{
+    bl_sam_t            sam_alignment, copy;
+    sam_field_mask_t    field_mask = BL_SAM_FIELD_ALL | BL_SAM_FIELD_TAGS;
+    FILE                *temp;
+    int                 encoding = BL_SEQ_ASCII;
+    bool                unpack = false,
+			reuse = false;
+    int                 arg;
+    
+    if ( (argc < 2) || (argc > 4) )
+	usage(argv);
+    if ( strcmp(argv[1], "nt16") == 0 )
+	encoding = BL_SEQ_NT16;
+    else if ( strcmp(argv[1], "nt4") == 0 )
+	encoding = BL_SEQ_NT4;
+    else if ( strcmp(argv[1], "ascii") != 0 )
+	usage(argv);
+    for (arg = 2; arg < argc; ++arg)
+    {
+	if ( strcmp(argv[arg], "--unpack") == 0 )
+	    unpack = true;
+	else if ( strcmp(argv[arg], "--reuse") == 0 )
+	    reuse = true;
+	else if ( strcmp(argv[arg], "--packed") != 0 )
+	    usage(argv);
+    }
+    
+    if ( (temp = tmpfile()) == NULL )
+    {
+	fprintf(stderr, "sam-test: Could not create temp file.\n");
+	return EX_CANTCREAT;
+    }
+    
+    bl_sam_init(&sam_alignment, 0, field_mask);
+    while ( bl_sam_read(stdin, &sam_alignment, field_mask) == BL_READ_OK )
+    {
+	if ( bl_sam_pack_seq(&sam_alignment, encoding) != BL_DATA_OK )
+	{
+	    fprintf(stderr, "sam-test: bl_sam_pack_seq() failed.\n");
+	    return EX_SOFTWARE;
+	}
+	bl_sam_serialize(temp, &sam_alignment);
+	if ( ! reuse )
+	{
+	    bl_sam_free(&sam_alignment);
+	    bl_sam_init(&sam_alignment, 0, field_mask);
+	}
+    }
+    bl_sam_free(&sam_alignment);
+    
+    rewind(temp);
+    while ( bl_sam_deserialize(temp, &copy) == BL_READ_OK )
+    {
+	if ( unpack )
+	    bl_sam_unpack_seq(&copy);
+	bl_sam_write(stdout, &copy, field_mask);
+	bl_sam_free(&copy);
+    }
+    fclose(temp);
+    return EX_OK;
+}
+
+
+void    usage(char *argv[])
+
+{
+    fprintf(stderr, "Usage: %s ascii|nt16|nt4 [--packed|--unpack] [--reuse] < file.sam\n", argv[0]);
+    exit(EX_USAGE);
+}
@@ -0,0 +1,1105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <sys/param.h>  // MIN(), MAX()
+#include <sys/stat.h>
+#include <xtend.h>
+#include "bed-bitmap.h"
+#include "biolibc.h"
+
+#define CHUNK_MASK  (BL_BED_BITMAP_CHUNK_SIZE - 1)
+
+// Refuse to load contigs longer than 2^48 bases
+#define MAX_CHUNKS  ((uint64_t)1 << 32)
+
+/*
+ *  Chunk arrays are allocated from counts in the file, so bound the
+ *  total by the file size, allowing 2^36 bases for small or unseekable
+ *  inputs.  Even a sparse bitmap has at most a few chunks per byte
+ *  saved, so a larger total means the counts are corrupt.
+ */
+#define MIN_CHUNK_LIMIT ((uint64_t)1 << 20)
+
+typedef struct
+{
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    byte_order;
+    uint64_t    contig_count;
+}   bitmap_file_header_t;
+
+typedef struct
+{
+    uint64_t    name_len;
+    uint64_t    chunk_count;
+    uint64_t    container_count;
+}   bitmap_file_contig_t;
+
+typedef struct
+{
+    uint64_t    chunk;
+    uint32_t    type;
+    uint32_t    count;
+}   bitmap_file_container_t;
+
+/* Set bits lo through hi, inclusive. */
+
+static void bitmap_set_bits(uint64_t *words, unsigned lo, unsigned hi)
+
+{
+    unsigned    w, w1 = lo >> 6, w2 = hi >> 6;
+    uint64_t    m1 = ~0ULL << (lo & 63),
+		m2 = ~0ULL >> (63 - (hi & 63));
+
+    if ( w1 == w2 )
+	words[w1] |= m1 & m2;
+    else
+    {
+	words[w1] |= m1;
+	for (w = w1 + 1; w < w2; ++w)
+	    words[w] = ~0ULL;
+	words[w2] |= m2;
+    }
+}
+
+
+/*
+ *  Find the first bit at or after pos that is set, or clear if invert
+ *  is all ones.  Return BL_BED_BITMAP_CHUNK_SIZE if there is none.
+ */
+
+static unsigned bitmap_next_bit(const uint64_t *words, unsigned pos,
+				uint64_t invert)
+
+{
+    unsigned    w = pos >> 6;
+    uint64_t    bits;
+
+    if ( pos >= BL_BED_BITMAP_CHUNK_SIZE )
+	return BL_BED_BITMAP_CHUNK_SIZE;
+    bits = (words[w] ^ invert) & (~0ULL << (pos & 63));
+    while ( bits == 0 )
+    {
+	if ( ++w == BL_BED_BITMAP_WORDS )
+	    return BL_BED_BITMAP_CHUNK_SIZE;
+	bits = words[w] ^ invert;
+    }
+    return w * 64 + __builtin_ctzll(bits);
+}
+
+
+static void bitmap_container_clear(bl_bed_bitmap_container_t *container)
+
+{
+    if ( container->type == BL_BED_BITMAP_BITSET )
+	free(container->words);
+    else
+	free(container->runs);
+    container->runs = NULL;
+    container->count = 0;
+    container->max = 0;
+    container->type = BL_BED_BITMAP_EMPTY;
+}
+
+
+static void bitmap_container_to_bits(const bl_bed_bitmap_container_t *container,
+				     uint64_t *words)
+
+{
+    uint32_t    c;
+
+    if ( container->type == BL_BED_BITMAP_BITSET )
+	memcpy(words, container->words, BL_BED_BITMAP_WORDS * sizeof(*words));
+    else
+    {
+	memset(words, 0, BL_BED_BITMAP_WORDS * sizeof(*words));
+	for (c = 0; c < container->count; ++c)
+	    bitmap_set_bits(words, container->runs[c].start,
+			    container->runs[c].last);
+    }
+}
+
+
+/*
+ *  Replace the contents of a container with words, choosing runs or a
+ *  bitset, whichever is smaller.
+ */
+
+static void bitmap_container_from_bits(bl_bed_bitmap_container_t *container,
+				       const uint64_t *words)
+
+{
+    unsigned    w, runs = 0, start, end;
+    uint64_t    carry = 0;
+
+    // A run starts at each set bit whose predecessor is clear
+    for (w = 0; w < BL_BED_BITMAP_WORDS; ++w)
+    {
+	runs += __builtin_popcountll(words[w] & ~((words[w] << 1) | carry));
+	carry = words[w] >> 63;
+    }
+
+    bitmap_container_clear(container);
+    if ( runs == 0 )
+	return;
+    if ( runs <= BL_BED_BITMAP_MAX_RUNS )
+    {
+	if ( (container->runs = xt_malloc(runs, sizeof(*container->runs)))
+		== NULL )
+	{
+	    fputs("bl_bed_bitmap: Could not allocate runs.\n", stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+	container->type = BL_BED_BITMAP_RUNS;
+	container->max = runs;
+	start = bitmap_next_bit(words, 0, 0);
+	while ( start < BL_BED_BITMAP_CHUNK_SIZE )
+	{
+	    end = bitmap_next_bit(words, start, ~0ULL);
+	    container->runs[container->count].start = start;
+	    container->runs[container->count].last = end - 1;
+	    ++container->count;
+	    start = bitmap_next_bit(words, end, 0);
+	}
+    }
+    else
+    {
+	if ( (container->words = xt_malloc(BL_BED_BITMAP_WORDS,
+		sizeof(*container->words))) == NULL )
+	{
+	    fputs("bl_bed_bitmap: Could not allocate bitset.\n", stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+	container->type = BL_BED_BITMAP_BITSET;
+	memcpy(container->words, words, BL_BED_BITMAP_WORDS * sizeof(*words));
+    }
+}
+
+
+/* Convert a run container that has grown too large to a bitset. */
+
+static void bitmap_container_to_bitset(bl_bed_bitmap_container_t *container)
+
+{
+    uint64_t    *words;
+
+    if ( (words = xt_malloc(BL_BED_BITMAP_WORDS, sizeof(*words))) == NULL )
+    {
+	fputs("bl_bed_bitmap: Could not allocate bitset.\n", stderr);
+	exit(EX_UNAVAILABLE);
+    }
+    bitmap_container_to_bits(container, words);
+    bitmap_container_clear(container);
+    container->type = BL_BED_BITMAP_BITSET;
+    container->words = words;
+}
+
+
+/* Add positions lo through hi, inclusive, to a container. */
+
+static void bitmap_container_add(bl_bed_bitmap_container_t *container,
+				 unsigned lo, unsigned hi)
+
+{
+    bl_bed_bitmap_run_t *runs;
+    uint32_t            low, high, mid, i, j;
+
+    if ( container->type == BL_BED_BITMAP_BITSET )
+    {
+	bitmap_set_bits(container->words, lo, hi);
+	return;
+    }
+
+    if ( container->count == container->max )
+    {
+	container->max = container->max == 0 ? 4 :
+			 MIN(container->max * 2, BL_BED_BITMAP_MAX_RUNS + 1);
+	if ( (container->runs = xt_realloc(container->runs, container->max,
+		sizeof(*container->runs))) == NULL )
+	{
+	    fputs("bl_bed_bitmap: Could not allocate runs.\n", stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+	container->type = BL_BED_BITMAP_RUNS;
+    }
+    runs = container->runs;
+
+    // First run that ends no more than 1 before lo and can be joined
+    low = 0, high = container->count;
+    while ( low < high )
+    {
+	mid = (low + high) / 2;
+	if ( (unsigned)runs[mid].last + 1 < lo )
+	    low = mid + 1;
+	else
+	    high = mid;
+    }
+    i = low;
+    for (j = i; (j < container->count) && (runs[j].start <= hi + 1); ++j)
+	;
+
+    if ( i == j )
+    {
+	memmove(runs + i + 1, runs + i,
+		(container->count - i) * sizeof(*runs));
+	runs[i].start = lo;
+	runs[i].last = hi;
+	++container->count;
+    }
+    else
+    {
+	// Replace runs i through j - 1 with their union with lo..hi
+	runs[i].start = MIN(lo, runs[i].start);
+	runs[i].last = MAX(hi, runs[j - 1].last);
+	memmove(runs + i + 1, runs + j, (container->count - j) * sizeof(*runs));
+	container->count -= j - i - 1;
+    }
+
+    if ( container->count > BL_BED_BITMAP_MAX_RUNS )
+	bitmap_container_to_bitset(container);
+}
+
+
+static uint64_t bitmap_container_count(const bl_bed_bitmap_container_t *container)
+
+{
+    uint64_t    total = 0;
+    uint32_t    c;
+
+    if ( container->type == BL_BED_BITMAP_BITSET )
+	for (c = 0; c < BL_BED_BITMAP_WORDS; ++c)
+	    total += __builtin_popcountll(container->words[c]);
+    else
+	for (c = 0; c < container->count; ++c)
+	    total += container->runs[c].last - container->runs[c].start + 1;
+    return total;
+}
+
+
+/* Make room for chunks 0 through chunk_count - 1 in a contig. */
+
+static void bitmap_contig_grow(bl_bed_bitmap_contig_t *contig,
+			       size_t chunk_count)
+
+{
+    if ( chunk_count <= contig->chunk_count )
+	return;
+    if ( (contig->chunks = xt_realloc(contig->chunks, chunk_count,
+		sizeof(*contig->chunks))) == NULL )
+    {
+	fputs("bl_bed_bitmap: Could not allocate chunk table.\n", stderr);
+	exit(EX_UNAVAILABLE);
+    }
+    memset(contig->chunks + contig->chunk_count, 0,
+	   (chunk_count - contig->chunk_count) * sizeof(*contig->chunks));
+    contig->chunk_count = chunk_count;
+}
+
+
+/*
+ *  Binary search the name lookup table.  Return the contig ID, or -1
+ *  with *pos set to where it would be inserted.
+ */
+
+static ssize_t bitmap_find_contig(bl_bed_bitmap_t *bitmap, const char *chrom,
+				  size_t *pos)
+
+{
+    size_t  low = 0, high = bitmap->contig_count, mid;
+    int     cmp;
+
+    while ( low < high )
+    {
+	mid = (low + high) / 2;
+	cmp = strcmp(bitmap->contigs[bitmap->lookup[mid]].name, chrom);
+	if ( cmp == 0 )
+	    return bitmap->lookup[mid];
+	else if ( cmp < 0 )
+	    low = mid + 1;
+	else
+	    high = mid;
+    }
+    *pos = low;
+    return -1;
+}
+
+
+/* Return the ID of a contig, adding it if new. */
+
+static size_t bitmap_get_contig(bl_bed_bitmap_t *bitmap, const char *chrom)
+
+{
+    bl_bed_bitmap_contig_t  *contig;
+    ssize_t                 id;
+    size_t                  pos;
+
+    if ( (id = bitmap_find_contig(bitmap, chrom, &pos)) != -1 )
+	return id;
+
+    if ( bitmap->contig_count == bitmap->contig_max )
+    {
+	bitmap->contig_max = bitmap->contig_max == 0 ? 32 :
+			     bitmap->contig_max * 2;
+	if ( ((bitmap->contigs = xt_realloc(bitmap->contigs,
+		bitmap->contig_max, sizeof(*bitmap->contigs))) == NULL) ||
+	     ((bitmap->lookup = xt_realloc(bitmap->lookup,
+		bitmap->contig_max, sizeof(*bitmap->lookup))) == NULL) )
+	{
+	    fputs("bl_bed_bitmap: Could not allocate contigs.\n", stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    contig = &bitmap->contigs[bitmap->contig_count];
+    if ( (contig->name = strdup(chrom)) == NULL )
+    {
+	fputs("bl_bed_bitmap: Could not allocate contig name.\n", stderr);
+	exit(EX_UNAVAILABLE);
+    }
+    contig->chunks = NULL;
+    contig->chunk_count = 0;
+    memmove(bitmap->lookup + pos + 1, bitmap->lookup + pos,
+	    (bitmap->contig_count - pos) * sizeof(*bitmap->lookup));
+    bitmap->lookup[pos] = bitmap->contig_count;
+    return bitmap->contig_count++;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize an empty region bitmap.  A bitmap records a set of
+ *      positions on each contig, such as the targets of an exome
+ *      capture kit, in a compressed form that supports constant-time
+ *      membership tests.  Positions are stored in 64 KiB chunks, each
+ *      held as a short list of runs or, if the positions are scattered,
+ *      a plain bitset, as in roaring bitmaps.  A chunk is found by
+ *      direct indexing, so testing a position never searches more than
+ *      one small container.
+ *
+ *      A bitmap can also be initialized with BL_BED_BITMAP_INIT.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to the bl_bed_bitmap_t structure to initialize
+ *
+ *  Examples:
+ *      bl_bed_bitmap_t targets;
+ *
+ *      bl_bed_bitmap_init(&targets);
+ *      bl_bed_bitmap_add_bed(&targets, bed_stream);
+ *
+ *  See also:
+ *      bl_bed_bitmap_add(3), bl_bed_bitmap_contains(3),
+ *      bl_bed_bitmap_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_bitmap_init(bl_bed_bitmap_t *bitmap)
+
+{
+    bitmap->contigs = NULL;
+    bitmap->contig_count = 0;
+    bitmap->contig_max = 0;
+    bitmap->lookup = NULL;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Look up the ID of a contig for use with bl_bed_bitmap_contains(3).
+ *      Looking up the ID only when the contig changes keeps string
+ *      comparisons out of the inner loop when testing sorted positions.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to a bl_bed_bitmap_t structure
+ *      chrom:  Contig name
+ *
+ *  Returns:
+ *      Contig ID, or -1 if the bitmap has no positions on chrom
+ *
+ *  Examples:
+ *      ssize_t id;
+ *
+ *      id = bl_bed_bitmap_contig_id(&targets, BL_VCF_CHROM(&vcf_call));
+ *
+ *  See also:
+ *      bl_bed_bitmap_contains(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t bl_bed_bitmap_contig_id(bl_bed_bitmap_t *bitmap, const char *chrom)
+
+{
+    size_t  pos;
+
+    return bitmap_find_contig(bitmap, chrom, &pos);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add the positions start through end - 1 on chrom to a bitmap.
+ *      Positions are 0-based, as in BED.  Ranges may be added in any
+ *      order and may overlap.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to a bl_bed_bitmap_t structure
+ *      chrom:  Contig name
+ *      start:  First position, 0-based
+ *      end:    One past the last position
+ *
+ *  Examples:
+ *      bl_bed_bitmap_add_range(&targets, "chr1", 11873, 14409);
+ *
+ *  See also:
+ *      bl_bed_bitmap_add(3), bl_bed_bitmap_add_bed(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_bitmap_add_range(bl_bed_bitmap_t *bitmap, const char *chrom,
+				uint64_t start, uint64_t end)
+
+{
+    bl_bed_bitmap_contig_t  *contig;
+    uint64_t                first, last, chunk;
+    size_t                  id;
+
+    if ( end <= start )
+	return;
+    // Get the ID first, since adding a contig may move the array
+    id = bitmap_get_contig(bitmap, chrom);
+    contig = &bitmap->contigs[id];
+    first = start >> BL_BED_BITMAP_CHUNK_BITS;
+    last = (end - 1) >> BL_BED_BITMAP_CHUNK_BITS;
+    bitmap_contig_grow(contig, last + 1);
+    for (chunk = first; chunk <= last; ++chunk)
+	bitmap_container_add(&contig->chunks[chunk],
+			     chunk == first ? start & CHUNK_MASK : 0,
+			     chunk == last ? (end - 1) & CHUNK_MASK : CHUNK_MASK);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add the positions covered by a BED feature to a bitmap.  Only
+ *      chrom, chromStart and chromEnd are used.
+ *
+ *  Arguments:
+ *      bitmap:         Pointer to a bl_bed_bitmap_t structure
+ *      bed_feature:    Pointer to a bl_bed_t structure
+ *
+ *  Examples:
+ *      while ( bl_bed_read(bed_stream, &bed_feature, BL_BED_FIELD_ALL)
+ *                  == BL_READ_OK )
+ *          bl_bed_bitmap_add(&targets, &bed_feature);
+ *
+ *  See also:
+ *      bl_bed_bitmap_add_range(3), bl_bed_bitmap_add_bed(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_bitmap_add(bl_bed_bitmap_t *bitmap, bl_bed_t *bed_feature)
+
+{
+    bl_bed_bitmap_add_range(bitmap, BL_BED_CHROM(bed_feature),
+			    BL_BED_CHROM_START(bed_feature),
+			    BL_BED_CHROM_END(bed_feature));
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add all features in a BED stream to a bitmap.  The stream need
+ *      not be sorted.  Any header must be skipped first, e.g. with
+ *      bl_bed_skip_header(3).
+ *
+ *  Arguments:
+ *      bitmap:     Pointer to a bl_bed_bitmap_t structure
+ *      bed_stream: FILE stream from which BED features are read
+ *
+ *  Returns:
+ *      BL_READ_OK if the whole stream was read, or the error code from
+ *      bl_bed_read(3)
+ *
+ *  Examples:
+ *      if ( bl_bed_bitmap_add_bed(&targets, bed_stream) != BL_READ_OK )
+ *          exit(EX_DATAERR);
+ *
+ *  See also:
+ *      bl_bed_bitmap_add(3), bl_bed_reader_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_bitmap_add_bed(bl_bed_bitmap_t *bitmap, FILE *bed_stream)
+
+{
+    bl_bed_reader_t reader;
+    bl_bed_t        bed_feature = BL_BED_INIT;
+    int             status;
+
+    bl_bed_reader_init(&reader, bed_stream, BL_BED_FIELD_ALL, 0);
+    while ( (status = bl_bed_reader_read(&reader, &bed_feature))
+	    == BL_READ_OK )
+	bl_bed_bitmap_add(bitmap, &bed_feature);
+    bl_bed_reader_close(&reader);
+    return status == BL_READ_EOF ? BL_READ_OK : status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Test whether a position is in a bitmap.  The chunk containing
+ *      the position is found by direct indexing and tested with a bit
+ *      lookup or a binary search of at most BL_BED_BITMAP_MAX_RUNS
+ *      runs, usually only a few, so the cost does not depend on the
+ *      size of the bitmap.
+ *
+ *      Positions are 0-based, as in BED.  Subtract 1 from 1-based VCF
+ *      and SAM positions.
+ *
+ *  Arguments:
+ *      bitmap:     Pointer to a bl_bed_bitmap_t structure
+ *      contig_id:  Contig ID from bl_bed_bitmap_contig_id(3)
+ *      pos:        0-based position
+ *
+ *  Returns:
+ *      true if pos is in the bitmap, false otherwise or if contig_id
+ *      is invalid
+ *
+ *  Examples:
+ *      if ( bl_bed_bitmap_contains(&targets, id, BL_VCF_POS(&vcf_call) - 1) )
+ *          ++on_target;
+ *
+ *  See also:
+ *      bl_bed_bitmap_contig_id(3), bl_bed_bitmap_add(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    bl_bed_bitmap_contains(bl_bed_bitmap_t *bitmap, size_t contig_id,
+			       uint64_t pos)
+
+{
+    bl_bed_bitmap_contig_t      *contig;
+    bl_bed_bitmap_container_t   *container;
+    uint64_t                    chunk = pos >> BL_BED_BITMAP_CHUNK_BITS;
+    unsigned                    offset = pos & CHUNK_MASK;
+    uint32_t                    low, high, mid;
+
+    if ( contig_id >= bitmap->contig_count )
+	return false;
+    contig = &bitmap->contigs[contig_id];
+    if ( chunk >= contig->chunk_count )
+	return false;
+    container = &contig->chunks[chunk];
+
+    switch(container->type)
+    {
+	case BL_BED_BITMAP_BITSET:
+	    return (container->words[offset >> 6] >> (offset & 63)) & 1;
+	case BL_BED_BITMAP_RUNS:
+	    // Find the last run starting at or before offset
+	    low = 0, high = container->count;
+	    while ( low < high )
+	    {
+		mid = (low + high) / 2;
+		if ( container->runs[mid].start <= offset )
+		    low = mid + 1;
+		else
+		    high = mid;
+	    }
+	    return (low > 0) && (container->runs[low - 1].last >= offset);
+	default:
+	    return false;
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Count the positions in a bitmap, e.g. the total target size.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to a bl_bed_bitmap_t structure
+ *
+ *  Returns:
+ *      Number of positions in the bitmap on all contigs
+ *
+ *  Examples:
+ *      printf("%" PRIu64 " bases targeted\n", bl_bed_bitmap_count(&targets));
+ *
+ *  See also:
+ *      bl_bed_bitmap_add(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+uint64_t    bl_bed_bitmap_count(bl_bed_bitmap_t *bitmap)
+
+{
+    uint64_t    total = 0;
+    size_t      c, chunk;
+
+    for (c = 0; c < bitmap->contig_count; ++c)
+	for (chunk = 0; chunk < bitmap->contigs[c].chunk_count; ++chunk)
+	    total += bitmap_container_count(&bitmap->contigs[c].chunks[chunk]);
+    return total;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add all positions in other to bitmap, leaving other unchanged.
+ *      Contigs are matched by name.  Chunks are combined container by
+ *      container, with bitsets merged a word at a time.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to the bl_bed_bitmap_t structure to add to
+ *      other:  Pointer to the bl_bed_bitmap_t structure to add
+ *
+ *  Examples:
+ *      bl_bed_bitmap_union(&targets, &extra_targets);
+ *
+ *  See also:
+ *      bl_bed_bitmap_intersect(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_bitmap_union(bl_bed_bitmap_t *bitmap, bl_bed_bitmap_t *other)
+
+{
+    bl_bed_bitmap_contig_t      *contig, *other_contig;
+    bl_bed_bitmap_container_t   *container, *other_container;
+    uint64_t                    words[BL_BED_BITMAP_WORDS];
+    size_t                      c, chunk, id;
+    uint32_t                    r;
+    unsigned                    w;
+
+    for (c = 0; c < other->contig_count; ++c)
+    {
+	other_contig = &other->contigs[c];
+	id = bitmap_get_contig(bitmap, other_contig->name);
+	contig = &bitmap->contigs[id];
+	bitmap_contig_grow(contig, other_contig->chunk_count);
+	for (chunk = 0; chunk < other_contig->chunk_count; ++chunk)
+	{
+	    container = &contig->chunks[chunk];
+	    other_container = &other_contig->chunks[chunk];
+	    if ( other_container->type == BL_BED_BITMAP_RUNS )
+	    {
+		for (r = 0; r < other_container->count; ++r)
+		    bitmap_container_add(container,
+					 other_container->runs[r].start,
+					 other_container->runs[r].last);
+	    }
+	    else if ( other_container->type == BL_BED_BITMAP_BITSET )
+	    {
+		bitmap_container_to_bits(container, words);
+		for (w = 0; w < BL_BED_BITMAP_WORDS; ++w)
+		    words[w] |= other_container->words[w];
+		bitmap_container_from_bits(container, words);
+	    }
+	}
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Remove positions that are not in other from bitmap, leaving
+ *      other unchanged.  Contigs are matched by name.  Each pair of
+ *      non-empty chunks is combined a word at a time and stored in
+ *      whichever container type is smaller.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to the bl_bed_bitmap_t structure to modify
+ *      other:  Pointer to the bl_bed_bitmap_t structure to intersect with
+ *
+ *  Examples:
+ *      // Targets with adequate mappability
+ *      bl_bed_bitmap_intersect(&targets, &mappable);
+ *
+ *  See also:
+ *      bl_bed_bitmap_union(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_bitmap_intersect(bl_bed_bitmap_t *bitmap, bl_bed_bitmap_t *other)
+
+{
+    bl_bed_bitmap_contig_t      *contig, *other_contig;
+    bl_bed_bitmap_container_t   *container;
+    uint64_t                    words[BL_BED_BITMAP_WORDS],
+				other_words[BL_BED_BITMAP_WORDS];
+    ssize_t                     other_id;
+    size_t                      c, chunk, pos;
+    unsigned                    w;
+
+    for (c = 0; c < bitmap->contig_count; ++c)
+    {
+	contig = &bitmap->contigs[c];
+	other_id = bitmap_find_contig(other, contig->name, &pos);
+	other_contig = other_id == -1 ? NULL : &other->contigs[other_id];
+	for (chunk = 0; chunk < contig->chunk_count; ++chunk)
+	{
+	    container = &contig->chunks[chunk];
+	    if ( container->type == BL_BED_BITMAP_EMPTY )
+		continue;
+	    if ( (other_contig == NULL) ||
+		 (chunk >= other_contig->chunk_count) ||
+		 (other_contig->chunks[chunk].type == BL_BED_BITMAP_EMPTY) )
+		bitmap_container_clear(container);
+	    else
+	    {
+		bitmap_container_to_bits(container, words);
+		bitmap_container_to_bits(&other_contig->chunks[chunk],
+					 other_words);
+		for (w = 0; w < BL_BED_BITMAP_WORDS; ++w)
+		    words[w] &= other_words[w];
+		bitmap_container_from_bits(container, words);
+	    }
+	}
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Write a bitmap to a binary stream for fast reloading with
+ *      bl_bed_bitmap_load(3), so that a target set can be built once
+ *      and shared by many jobs.  Containers are written as they are
+ *      stored, in native byte order, so saved bitmaps are not portable
+ *      between architectures.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to a bl_bed_bitmap_t structure
+ *      stream: FILE stream open for writing
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE on error
+ *
+ *  Examples:
+ *      bl_bed_bitmap_save(&targets, bitmap_stream);
+ *
+ *  See also:
+ *      bl_bed_bitmap_load(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_bitmap_save(bl_bed_bitmap_t *bitmap, FILE *stream)
+
+{
+    bitmap_file_header_t        header;
+    bitmap_file_contig_t        file_contig;
+    bitmap_file_container_t     file_container;
+    bl_bed_bitmap_contig_t      *contig;
+    bl_bed_bitmap_container_t   *container;
+    size_t                      c, chunk;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BL_BED_BITMAP_MAGIC, sizeof(header.magic));
+    header.version = BL_BED_BITMAP_VERSION;
+    header.byte_order = BL_BED_BITMAP_BYTE_ORDER;
+    header.contig_count = bitmap->contig_count;
+    fwrite(&header, sizeof(header), 1, stream);
+
+    for (c = 0; c < bitmap->contig_count; ++c)
+    {
+	contig = &bitmap->contigs[c];
+	file_contig.name_len = strlen(contig->name);
+	file_contig.chunk_count = contig->chunk_count;
+	file_contig.container_count = 0;
+	for (chunk = 0; chunk < contig->chunk_count; ++chunk)
+	    if ( contig->chunks[chunk].type != BL_BED_BITMAP_EMPTY )
+		++file_contig.container_count;
+	fwrite(&file_contig, sizeof(file_contig), 1, stream);
+	fwrite(contig->name, 1, file_contig.name_len, stream);
+
+	for (chunk = 0; chunk < contig->chunk_count; ++chunk)
+	{
+	    container = &contig->chunks[chunk];
+	    if ( container->type == BL_BED_BITMAP_EMPTY )
+		continue;
+	    memset(&file_container, 0, sizeof(file_container));
+	    file_container.chunk = chunk;
+	    file_container.type = container->type;
+	    file_container.count = container->count;
+	    fwrite(&file_container, sizeof(file_container), 1, stream);
+	    if ( container->type == BL_BED_BITMAP_RUNS )
+		fwrite(container->runs, sizeof(*container->runs),
+		       container->count, stream);
+	    else
+		fwrite(container->words, sizeof(*container->words),
+		       BL_BED_BITMAP_WORDS, stream);
+	}
+    }
+    return ferror(stream) ? BL_WRITE_FAILURE : BL_WRITE_OK;
+}
+
+
+/* Read and check one container saved by bl_bed_bitmap_save(). */
+
+static int  bitmap_load_container(bl_bed_bitmap_contig_t *contig, FILE *stream)
+
+{
+    bitmap_file_container_t     file_container;
+    bl_bed_bitmap_container_t   *container;
+    uint32_t                    r;
+
+    if ( fread(&file_container, sizeof(file_container), 1, stream) != 1 )
+	return BL_READ_TRUNCATED;
+    if ( (file_container.chunk >= contig->chunk_count) ||
+	 (contig->chunks[file_container.chunk].type != BL_BED_BITMAP_EMPTY) )
+	return BL_READ_MISMATCH;
+    container = &contig->chunks[file_container.chunk];
+
+    if ( file_container.type == BL_BED_BITMAP_RUNS )
+    {
+	if ( (file_container.count == 0) ||
+	     (file_container.count > BL_BED_BITMAP_MAX_RUNS) )
+	    return BL_READ_MISMATCH;
+	if ( (container->runs = xt_malloc(file_container.count,
+		sizeof(*container->runs))) == NULL )
+	{
+	    fputs("bl_bed_bitmap_load(): Could not allocate runs.\n", stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+	container->type = BL_BED_BITMAP_RUNS;
+	container->count = container->max = file_container.count;
+	if ( fread(container->runs, sizeof(*container->runs),
+		   container->count, stream) != container->count )
+	    return BL_READ_TRUNCATED;
+	// Runs must be sorted and separated for contains() and add()
+	for (r = 0; r < container->count; ++r)
+	    if ( (container->runs[r].start > container->runs[r].last) ||
+		 ((r > 0) && ((unsigned)container->runs[r - 1].last + 1 >=
+			      container->runs[r].start)) )
+		return BL_READ_MISMATCH;
+    }
+    else if ( file_container.type == BL_BED_BITMAP_BITSET )
+    {
+	if ( (container->words = xt_malloc(BL_BED_BITMAP_WORDS,
+		sizeof(*container->words))) == NULL )
+	{
+	    fputs("bl_bed_bitmap_load(): Could not allocate bitset.\n", stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+	container->type = BL_BED_BITMAP_BITSET;
+	if ( fread(container->words, sizeof(*container->words),
+		   BL_BED_BITMAP_WORDS, stream) != BL_BED_BITMAP_WORDS )
+	    return BL_READ_TRUNCATED;
+    }
+    else
+	return BL_READ_MISMATCH;
+    return BL_READ_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Load a bitmap saved by bl_bed_bitmap_save(3).  The bitmap
+ *      structure is initialized first, so it must not hold a bitmap
+ *      that has not been freed.  Chunk counts in the stream are checked
+ *      against the size of the file before any memory is allocated for
+ *      them.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to the bl_bed_bitmap_t structure to fill in
+ *      stream: FILE stream open for reading
+ *
+ *  Returns:
+ *      BL_READ_OK on success,
+ *      BL_READ_TRUNCATED if the stream ends early,
+ *      BL_READ_MISMATCH if the stream does not contain a valid bitmap
+ *      saved on this architecture
+ *      On error, the bitmap is left empty.
+ *
+ *  Examples:
+ *      bl_bed_bitmap_t targets;
+ *
+ *      if ( bl_bed_bitmap_load(&targets, bitmap_stream) != BL_READ_OK )
+ *          exit(EX_DATAERR);
+ *
+ *  See also:
+ *      bl_bed_bitmap_save(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_bitmap_load(bl_bed_bitmap_t *bitmap, FILE *stream)
+
+{
+    bitmap_file_header_t    header;
+    bitmap_file_contig_t    file_contig;
+    bl_bed_bitmap_contig_t  *contig;
+    char                    name[BL_CHROM_MAX_CHARS + 1];
+    struct stat             st;
+    uint64_t                c, k, chunk_limit = MIN_CHUNK_LIMIT;
+    size_t                  id;
+    int                     status = BL_READ_OK;
+
+    bl_bed_bitmap_init(bitmap);
+    if ( (fstat(fileno(stream), &st) == 0) && S_ISREG(st.st_mode) )
+	chunk_limit = MAX(chunk_limit, (uint64_t)st.st_size);
+
+    if ( fread(&header, sizeof(header), 1, stream) != 1 )
+	status = BL_READ_TRUNCATED;
+    else if ( (memcmp(header.magic, BL_BED_BITMAP_MAGIC,
+		      sizeof(header.magic)) != 0) ||
+	      (header.version != BL_BED_BITMAP_VERSION) ||
+	      (header.byte_order != BL_BED_BITMAP_BYTE_ORDER) )
+	status = BL_READ_MISMATCH;
+
+    for (c = 0; (status == BL_READ_OK) && (c < header.contig_count); ++c)
+    {
+	if ( fread(&file_contig, sizeof(file_contig), 1, stream) != 1 )
+	    status = BL_READ_TRUNCATED;
+	else if ( (file_contig.name_len == 0) ||
+		  (file_contig.name_len > BL_CHROM_MAX_CHARS) ||
+		  (file_contig.chunk_count > MAX_CHUNKS) ||
+		  (file_contig.chunk_count > chunk_limit) ||
+		  (file_contig.container_count > file_contig.chunk_count) )
+	    status = BL_READ_MISMATCH;
+	else if ( fread(name, 1, file_contig.name_len, stream)
+		    != file_contig.name_len )
+	    status = BL_READ_TRUNCATED;
+	else
+	{
+	    name[file_contig.name_len] = '\0';
+	    if ( bl_bed_bitmap_contig_id(bitmap, name) != -1 )
+		status = BL_READ_MISMATCH;
+	    else
+	    {
+		id = bitmap_get_contig(bitmap, name);
+		contig = &bitmap->contigs[id];
+		bitmap_contig_grow(contig, file_contig.chunk_count);
+		chunk_limit -= file_contig.chunk_count;
+		for (k = 0; (status == BL_READ_OK) &&
+			    (k < file_contig.container_count); ++k)
+		    status = bitmap_load_container(contig, stream);
+	    }
+	}
+    }
+
+    if ( status != BL_READ_OK )
+    {
+	fprintf(stderr, "bl_bed_bitmap_load(): %s bitmap.\n",
+		status == BL_READ_TRUNCATED ? "Truncated" : "Invalid");
+	bl_bed_bitmap_free(bitmap);
+    }
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-bitmap.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory used by a bitmap, leaving it empty and ready
+ *      for reuse.
+ *
+ *  Arguments:
+ *      bitmap: Pointer to a bl_bed_bitmap_t structure
+ *
+ *  Examples:
+ *      bl_bed_bitmap_free(&targets);
+ *
+ *  See also:
+ *      bl_bed_bitmap_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_bitmap_free(bl_bed_bitmap_t *bitmap)
+
+{
+    size_t  c, chunk;
+
+    for (c = 0; c < bitmap->contig_count; ++c)
+    {
+	for (chunk = 0; chunk < bitmap->contigs[c].chunk_count; ++chunk)
+	    bitmap_container_clear(&bitmap->contigs[c].chunks[chunk]);
+	free(bitmap->contigs[c].chunks);
+	free(bitmap->contigs[c].name);
+    }
+    free(bitmap->contigs);
+    free(bitmap->lookup);
+    bl_bed_bitmap_init(bitmap);
+}
@@ -0,0 +1,91 @@
+#ifndef _bed_bitmap_h_
+#define _bed_bitmap_h_
+
+#ifndef _STDBOOL_H_
+#include <stdbool.h>
+#endif
+
+#include <sys/types.h>      // ssize_t
+
+#ifndef _bed_h_
+#include "bed.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+/*
+ *  Positions are split into 64 KiB chunks, each stored in a container
+ *  chosen for its contents as in roaring bitmaps: a sorted list of runs
+ *  for region sets such as BED targets, which are mostly long runs, or
+ *  a plain bitset once the runs would take more space than the bits.
+ */
+#define BL_BED_BITMAP_CHUNK_BITS    16
+#define BL_BED_BITMAP_CHUNK_SIZE    (1 << BL_BED_BITMAP_CHUNK_BITS)
+#define BL_BED_BITMAP_WORDS         (BL_BED_BITMAP_CHUNK_SIZE / 64)
+#define BL_BED_BITMAP_MAX_RUNS      2048    // Same size as a bitset
+
+#define BL_BED_BITMAP_EMPTY         0
+#define BL_BED_BITMAP_RUNS          1
+#define BL_BED_BITMAP_BITSET        2
+
+#define BL_BED_BITMAP_MAGIC         "BLBMAP\r\n"
+#define BL_BED_BITMAP_VERSION       1
+#define BL_BED_BITMAP_BYTE_ORDER    0x01020304
+
+typedef struct
+{
+    uint16_t    start;      // Offsets within chunk
+    uint16_t    last;       // Inclusive, so a run can cover a whole chunk
+}   bl_bed_bitmap_run_t;
+
+typedef struct
+{
+    uint32_t    count;      // Runs, unused for a bitset
+    uint16_t    type;
+    uint16_t    max;        // Runs allocated
+    union
+    {
+	bl_bed_bitmap_run_t *runs;
+	uint64_t            *words;
+    };
+}   bl_bed_bitmap_container_t;
+
+typedef struct
+{
+    char                        *name;
+    // Indexed directly by position >> BL_BED_BITMAP_CHUNK_BITS
+    bl_bed_bitmap_container_t   *chunks;
+    size_t                      chunk_count;
+}   bl_bed_bitmap_contig_t;
+
+typedef struct
+{
+    bl_bed_bitmap_contig_t  *contigs;
+    size_t                  contig_count;
+    size_t                  contig_max;
+    size_t                  *lookup;    // Contig IDs sorted by name
+}   bl_bed_bitmap_t;
+
+#define BL_BED_BITMAP_INIT  { NULL, 0, 0, NULL }
+
+/* Not generated by gen-get-set */
+#define BL_BED_BITMAP_CONTIG_COUNT(ptr)     ((ptr)->contig_count)
+#define BL_BED_BITMAP_CONTIG_NAME(ptr,c)    ((ptr)->contigs[c].name)
+
+/* bed-bitmap.c */
+void bl_bed_bitmap_init(bl_bed_bitmap_t *bitmap);
+ssize_t bl_bed_bitmap_contig_id(bl_bed_bitmap_t *bitmap, const char *chrom);
+void bl_bed_bitmap_add_range(bl_bed_bitmap_t *bitmap, const char *chrom, uint64_t start, uint64_t end);
+void bl_bed_bitmap_add(bl_bed_bitmap_t *bitmap, bl_bed_t *bed_feature);
+int bl_bed_bitmap_add_bed(bl_bed_bitmap_t *bitmap, FILE *bed_stream);
+bool bl_bed_bitmap_contains(bl_bed_bitmap_t *bitmap, size_t contig_id, uint64_t pos);
+uint64_t bl_bed_bitmap_count(bl_bed_bitmap_t *bitmap);
+void bl_bed_bitmap_union(bl_bed_bitmap_t *bitmap, bl_bed_bitmap_t *other);
+void bl_bed_bitmap_intersect(bl_bed_bitmap_t *bitmap, bl_bed_bitmap_t *other);
+int bl_bed_bitmap_save(bl_bed_bitmap_t *bitmap, FILE *stream);
+int bl_bed_bitmap_load(bl_bed_bitmap_t *bitmap, FILE *stream);
+void bl_bed_bitmap_free(bl_bed_bitmap_t *bitmap);
+
+#endif  // _bed_bitmap_h_
@@ -0,0 +1,960 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sysexits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <xtend.h>
+#include "bed-cache.h"
+#include "biolibc.h"
+
+// Column sections are aligned so the mapped arrays can be used in place
+#define BED_CACHE_ALIGN(offset) (((offset) + 7) & ~(uint64_t)7)
+
+// Rows gathered per fwrite() when writing columns in sorted order
+#define BED_CACHE_WRITE_ROWS    4096
+
+/*
+ *  Columns accumulated in input order by bl_bed_cache_create() before
+ *  sorting.
+ */
+typedef struct
+{
+    size_t      count;
+    size_t      max;
+    uint32_t    *chrom_ids;
+    uint64_t    *starts;
+    uint64_t    *ends;
+    uint64_t    *thick_starts;
+    uint64_t    *thick_ends;
+    uint64_t    *name_offsets;
+    uint64_t    *rgb_offsets;
+    uint64_t    *block_offsets;
+    uint16_t    *scores;
+    uint16_t    *block_counts;
+    char        *strands;
+    uint8_t     *fields;
+
+    char        *strings;
+    size_t      string_bytes;
+    size_t      string_max;
+    uint64_t    *blocks;
+    size_t      block_values;
+    size_t      block_max;
+
+    bl_bed_cache_chrom_t    *chroms;
+    size_t      chrom_count;
+    size_t      chrom_max;
+    uint64_t    *chrom_lookup;  // Chrom IDs sorted by name
+}   bed_cache_build_t;
+
+typedef struct
+{
+    uint32_t    chrom_id;
+    uint64_t    start;
+    uint64_t    end;
+    size_t      row;
+}   bed_cache_sort_t;
+
+/* Grow an array of count elements to at least min elements. */
+static void *bed_cache_grow(void *array, size_t *max, size_t min,
+			    size_t size)
+
+{
+    if ( min <= *max )
+	return array;
+    *max = *max == 0 ? 1024 : *max;
+    while ( *max < min )
+	*max *= 2;
+    if ( (array = xt_realloc(array, *max, size)) == NULL )
+    {
+	fputs("bl_bed_cache_create(): Could not allocate build arrays.\n",
+	      stderr);
+	exit(EX_UNAVAILABLE);
+    }
+    return array;
+}
+
+
+/* Append a string to the arena and return its offset. */
+static uint64_t bed_cache_add_string(bed_cache_build_t *build,
+				     const char *string)
+
+{
+    size_t      len = strlen(string) + 1;
+    uint64_t    offset = build->string_bytes;
+
+    build->strings = bed_cache_grow(build->strings, &build->string_max,
+				    build->string_bytes + len, 1);
+    memcpy(build->strings + build->string_bytes, string, len);
+    build->string_bytes += len;
+    return offset;
+}
+
+
+/*
+ *  Return the ID of chrom, adding it if new.  The lookup table is kept
+ *  in strcmp() order so it can be written as is.
+ */
+static uint32_t bed_cache_chrom_id(bed_cache_build_t *build,
+				   const char *chrom, uint32_t last_id)
+
+{
+    size_t  low = 0, high = build->chrom_count, mid;
+    int     cmp;
+
+    // Sorted input stays on the same chrom for many features
+    if ( (build->chrom_count > 0) &&
+	 (strcmp(build->strings + build->chroms[last_id].name_offset,
+		 chrom) == 0) )
+	return last_id;
+
+    while ( low < high )
+    {
+	mid = (low + high) / 2;
+	cmp = strcmp(build->strings +
+		     build->chroms[build->chrom_lookup[mid]].name_offset, chrom);
+	if ( cmp == 0 )
+	    return build->chrom_lookup[mid];
+	else if ( cmp < 0 )
+	    low = mid + 1;
+	else
+	    high = mid;
+    }
+
+    build->chroms = bed_cache_grow(build->chroms, &build->chrom_max,
+				   build->chrom_count + 1,
+				   sizeof(*build->chroms));
+    // chrom_lookup has the same capacity as chroms
+    if ( (build->chrom_lookup = xt_realloc(build->chrom_lookup,
+		build->chrom_max, sizeof(*build->chrom_lookup))) == NULL )
+    {
+	fputs("bl_bed_cache_create(): Could not allocate chrom lookup.\n",
+	      stderr);
+	exit(EX_UNAVAILABLE);
+    }
+    memmove(build->chrom_lookup + low + 1, build->chrom_lookup + low,
+	    (build->chrom_count - low) * sizeof(*build->chrom_lookup));
+    build->chrom_lookup[low] = build->chrom_count;
+    build->chroms[build->chrom_count].name_offset =
+	bed_cache_add_string(build, chrom);
+    build->chroms[build->chrom_count].first = 0;
+    build->chroms[build->chrom_count].count = 0;
+    build->chroms[build->chrom_count].max_end = 0;
+    return build->chrom_count++;
+}
+
+
+/*
+ *  Append one feature to the build columns.  Returns BL_READ_OVERFLOW
+ *  if the feature cannot be represented in the cache.
+ */
+static int  bed_cache_add_feature(bed_cache_build_t *build,
+				  bl_bed_t *bed_feature, uint32_t chrom_id,
+				  uint64_t empty_offset)
+
+{
+    size_t  row = build->count, max, blocks;
+
+    // block_counts is uint16_t
+    blocks = BL_BED_FIELDS(bed_feature) > 9 ? BL_BED_BLOCK_COUNT(bed_feature) : 0;
+    if ( blocks > UINT16_MAX )
+    {
+	fprintf(stderr, "bl_bed_cache_create(): %s,%" PRIu64 ": Block count %zu exceeds %u.\n",
+		BL_BED_CHROM(bed_feature), BL_BED_CHROM_START(bed_feature),
+		blocks, UINT16_MAX);
+	return BL_READ_OVERFLOW;
+    }
+    
+    if ( row == build->max )
+    {
+	max = build->max;
+	build->chrom_ids = bed_cache_grow(build->chrom_ids, &max, row + 1,
+				sizeof(*build->chrom_ids));
+#define GROW_COLUMN(col) \
+	max = build->max; \
+	build->col = bed_cache_grow(build->col, &max, row + 1, \
+				    sizeof(*build->col));
+	GROW_COLUMN(starts)
+	GROW_COLUMN(ends)
+	GROW_COLUMN(thick_starts)
+	GROW_COLUMN(thick_ends)
+	GROW_COLUMN(name_offsets)
+	GROW_COLUMN(rgb_offsets)
+	GROW_COLUMN(block_offsets)
+	GROW_COLUMN(scores)
+	GROW_COLUMN(block_counts)
+	GROW_COLUMN(strands)
+	GROW_COLUMN(fields)
+#undef GROW_COLUMN
+	build->max = max;
+    }
+
+    build->chrom_ids[row] = chrom_id;
+    build->starts[row] = BL_BED_CHROM_START(bed_feature);
+    build->ends[row] = BL_BED_CHROM_END(bed_feature);
+    build->fields[row] = BL_BED_FIELDS(bed_feature);
+    build->name_offsets[row] = BL_BED_FIELDS(bed_feature) > 3 ?
+	bed_cache_add_string(build, BL_BED_NAME(bed_feature)) : empty_offset;
+    build->scores[row] = BL_BED_FIELDS(bed_feature) > 4 ?
+	BL_BED_SCORE(bed_feature) : 0;
+    build->strands[row] = BL_BED_FIELDS(bed_feature) > 5 ?
+	BL_BED_STRAND(bed_feature) : '.';
+    if ( BL_BED_FIELDS(bed_feature) > 6 )
+    {
+	build->thick_starts[row] = BL_BED_THICK_START(bed_feature);
+	build->thick_ends[row] = BL_BED_THICK_END(bed_feature);
+    }
+    else
+	build->thick_starts[row] = build->thick_ends[row] = 0;
+
+    // RGB is usually the same for many features, so share the previous one
+    if ( BL_BED_FIELDS(bed_feature) > 8 )
+    {
+	if ( (row > 0) && (build->rgb_offsets[row - 1] != empty_offset) &&
+	     (strcmp(build->strings + build->rgb_offsets[row - 1],
+		     BL_BED_ITEM_RGB(bed_feature)) == 0) )
+	    build->rgb_offsets[row] = build->rgb_offsets[row - 1];
+	else
+	    build->rgb_offsets[row] =
+		bed_cache_add_string(build, BL_BED_ITEM_RGB(bed_feature));
+    }
+    else
+	build->rgb_offsets[row] = empty_offset;
+
+    // Sizes followed by starts
+    if ( BL_BED_FIELDS(bed_feature) > 9 )
+    {
+	build->blocks = bed_cache_grow(build->blocks, &build->block_max,
+				       build->block_values + 2 * blocks,
+				       sizeof(*build->blocks));
+	build->block_counts[row] = blocks;
+	build->block_offsets[row] = build->block_values;
+	memcpy(build->blocks + build->block_values,
+	       BL_BED_BLOCK_SIZES(bed_feature), blocks * sizeof(uint64_t));
+	memcpy(build->blocks + build->block_values + blocks,
+	       BL_BED_BLOCK_STARTS(bed_feature), blocks * sizeof(uint64_t));
+	build->block_values += 2 * blocks;
+    }
+    else
+    {
+	build->block_counts[row] = 0;
+	build->block_offsets[row] = 0;
+    }
+    ++build->count;
+    return BL_READ_OK;
+}
+
+
+static int  bed_cache_sort_cmp(const void *p1, const void *p2)
+
+{
+    const bed_cache_sort_t  *s1 = p1, *s2 = p2;
+
+    if ( s1->chrom_id != s2->chrom_id )
+	return s1->chrom_id < s2->chrom_id ? -1 : 1;
+    if ( s1->start != s2->start )
+	return s1->start < s2->start ? -1 : 1;
+    if ( s1->end != s2->end )
+	return s1->end < s2->end ? -1 : 1;
+    // Keep input order for identical positions
+    return s1->row < s2->row ? -1 : s1->row > s2->row;
+}
+
+
+/* Pad the stream to the next 8-byte boundary and return the offset. */
+static uint64_t bed_cache_align(FILE *stream, uint64_t offset)
+
+{
+    static const char   zeros[8] = { 0 };
+    uint64_t            aligned = BED_CACHE_ALIGN(offset);
+
+    fwrite(zeros, 1, aligned - offset, stream);
+    return aligned;
+}
+
+
+/*
+ *  Write column elements in sorted row order, gathering through a
+ *  buffer.  Return the offset following the column.
+ */
+static uint64_t bed_cache_write_column(FILE *stream, uint64_t offset,
+				       uint64_t *column_offset,
+				       const void *column, size_t size,
+				       const bed_cache_sort_t *sorted,
+				       size_t count)
+
+{
+    char    buff[BED_CACHE_WRITE_ROWS * sizeof(uint64_t)];
+    size_t  c, b;
+
+    *column_offset = offset = bed_cache_align(stream, offset);
+    for (c = 0; c < count; c += b)
+    {
+	for (b = 0; (b < BED_CACHE_WRITE_ROWS) && (c + b < count); ++b)
+	    memcpy(buff + b * size,
+		   (const char *)column + sorted[c + b].row * size, size);
+	fwrite(buff, size, b, stream);
+    }
+    return offset + count * size;
+}
+
+
+/* Write a section as is.  Return the offset following it. */
+static uint64_t bed_cache_write_section(FILE *stream, uint64_t offset,
+					uint64_t *section_offset,
+					const void *section, size_t size,
+					size_t count)
+
+{
+    *section_offset = offset = bed_cache_align(stream, offset);
+    if ( count > 0 )
+	fwrite(section, size, count, stream);
+    return offset + count * size;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-cache.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Read BED features from bed_stream and save them in a binary
+ *      columnar cache file that can later be loaded almost instantly
+ *      with bl_bed_cache_open(3), avoiding the cost of parsing the
+ *      text and allocating block arrays for every feature on each run.
+ *
+ *      Features are grouped by chromosome, in the order each chromosome
+ *      first appears in the input, and sorted by start position within
+ *      each chromosome.  Input therefore need not be sorted, but if it
+ *      is, the order is preserved.  All BED fields are stored regardless
+ *      of how many columns each line has, so the cache can be written
+ *      back to a BED file identical to a sorted copy of the input.
+ *
+ *      Any header lines must be skipped before calling
+ *      bl_bed_cache_create(), e.g. with bl_bed_skip_header(3).
+ *
+ *  Arguments:
+ *      filename:   Name of the cache file to create
+ *      bed_stream: FILE stream from which BED features are read
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE if the cache file could
+ *      not be written, or the error code from bl_bed_read(3) if the
+ *      BED input is invalid
+ *
+ *  Examples:
+ *      FILE    *bed_stream;
+ *
+ *      if ( (bed_stream = fopen("genes.bed", "r")) != NULL )
+ *      {
+ *          bl_bed_skip_header(bed_stream);
+ *          if ( bl_bed_cache_create("genes.blbed", bed_stream) != BL_WRITE_OK )
+ *              fputs("Could not create cache.\n", stderr);
+ *          fclose(bed_stream);
+ *      }
+ *
+ *  See also:
+ *      bl_bed_cache_open(3), bl_bed_cache_write_bed(3), bl_bed_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_cache_create(const char *filename, FILE *bed_stream)
+
+{
+    bed_cache_build_t       build;
+    bed_cache_sort_t        *sorted;
+    bl_bed_cache_header_t   header;
+    bl_bed_cache_chrom_t    *chrom;
+    bl_bed_t                bed_feature = BL_BED_INIT;
+    FILE                    *cache_stream;
+    uint64_t                empty_offset, offset;
+    uint32_t                chrom_id = 0;
+    size_t                  c;
+    int                     status;
+
+    memset(&build, 0, sizeof(build));
+    // Offset 0 is "", shared by all features without a name or RGB
+    empty_offset = bed_cache_add_string(&build, "");
+
+    while ( (status = bl_bed_read(bed_stream, &bed_feature,
+				  BL_BED_FIELD_ALL)) == BL_READ_OK )
+    {
+	chrom_id = bed_cache_chrom_id(&build, BL_BED_CHROM(&bed_feature),
+				      chrom_id);
+	status = bed_cache_add_feature(&build, &bed_feature, chrom_id,
+				       empty_offset);
+	free(BL_BED_BLOCK_SIZES(&bed_feature));
+	free(BL_BED_BLOCK_STARTS(&bed_feature));
+	BL_BED_SET_BLOCK_SIZES(&bed_feature, NULL);
+	BL_BED_SET_BLOCK_STARTS(&bed_feature, NULL);
+	if ( status != BL_READ_OK )
+	    break;
+    }
+    free(BL_BED_BLOCK_SIZES(&bed_feature));
+    free(BL_BED_BLOCK_STARTS(&bed_feature));
+
+    if ( status == BL_READ_EOF )
+    {
+	if ( (sorted = xt_malloc(build.count + 1, sizeof(*sorted))) == NULL )
+	{
+	    fputs("bl_bed_cache_create(): Could not allocate sort array.\n",
+		  stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+	for (c = 0; c < build.count; ++c)
+	{
+	    sorted[c].chrom_id = build.chrom_ids[c];
+	    sorted[c].start = build.starts[c];
+	    sorted[c].end = build.ends[c];
+	    sorted[c].row = c;
+	}
+	qsort(sorted, build.count, sizeof(*sorted), bed_cache_sort_cmp);
+
+	// Chromosome runs in the sorted rows
+	for (c = 0; c < build.count; ++c)
+	{
+	    chrom = &build.chroms[sorted[c].chrom_id];
+	    if ( chrom->count++ == 0 )
+		chrom->first = c;
+	    if ( sorted[c].end > chrom->max_end )
+		chrom->max_end = sorted[c].end;
+	}
+
+	if ( (cache_stream = fopen(filename, "w")) == NULL )
+	{
+	    fprintf(stderr, "bl_bed_cache_create(): Could not open %s: %s\n",
+		    filename, strerror(errno));
+	    status = BL_WRITE_FAILURE;
+	}
+	else
+	{
+	    memset(&header, 0, sizeof(header));
+	    memcpy(header.magic, BL_BED_CACHE_MAGIC, sizeof(header.magic));
+	    header.version = BL_BED_CACHE_VERSION;
+	    header.byte_order = BL_BED_CACHE_BYTE_ORDER;
+	    header.feature_count = build.count;
+	    header.chrom_count = build.chrom_count;
+	    header.string_bytes = build.string_bytes;
+	    header.block_values = build.block_values;
+
+	    // Placeholder, rewritten with offsets filled in below
+	    fwrite(&header, sizeof(header), 1, cache_stream);
+	    offset = sizeof(header);
+	    offset = bed_cache_write_section(cache_stream, offset,
+		&header.chroms_offset, build.chroms,
+		sizeof(*build.chroms), build.chrom_count);
+	    offset = bed_cache_write_section(cache_stream, offset,
+		&header.chrom_lookup_offset, build.chrom_lookup,
+		sizeof(*build.chrom_lookup), build.chrom_count);
+#define WRITE_COLUMN(col) \
+	    offset = bed_cache_write_column(cache_stream, offset, \
+		&header.col##_offset, build.col, sizeof(*build.col), \
+		sorted, build.count);
+	    WRITE_COLUMN(starts)
+	    WRITE_COLUMN(ends)
+	    WRITE_COLUMN(thick_starts)
+	    WRITE_COLUMN(thick_ends)
+	    WRITE_COLUMN(name_offsets)
+	    WRITE_COLUMN(rgb_offsets)
+	    WRITE_COLUMN(block_offsets)
+	    WRITE_COLUMN(scores)
+	    WRITE_COLUMN(block_counts)
+	    WRITE_COLUMN(strands)
+	    WRITE_COLUMN(fields)
+#undef WRITE_COLUMN
+	    offset = bed_cache_write_section(cache_stream, offset,
+		&header.strings_offset, build.strings, 1, build.string_bytes);
+	    offset = bed_cache_write_section(cache_stream, offset,
+		&header.blocks_offset, build.blocks,
+		sizeof(*build.blocks), build.block_values);
+	    header.file_size = bed_cache_align(cache_stream, offset);
+
+	    rewind(cache_stream);
+	    fwrite(&header, sizeof(header), 1, cache_stream);
+	    status = BL_WRITE_OK;
+	    if ( ferror(cache_stream) )
+	    {
+		fprintf(stderr, "bl_bed_cache_create(): Error writing %s: %s\n",
+			filename, strerror(errno));
+		status = BL_WRITE_FAILURE;
+	    }
+	    if ( fclose(cache_stream) != 0 )
+	    {
+		fprintf(stderr, "bl_bed_cache_create(): Error closing %s: %s\n",
+			filename, strerror(errno));
+		status = BL_WRITE_FAILURE;
+	    }
+	    if ( status != BL_WRITE_OK )
+		unlink(filename);
+	}
+	free(sorted);
+    }
+
+    free(build.chrom_ids);
+    free(build.starts);
+    free(build.ends);
+    free(build.thick_starts);
+    free(build.thick_ends);
+    free(build.name_offsets);
+    free(build.rgb_offsets);
+    free(build.block_offsets);
+    free(build.scores);
+    free(build.block_counts);
+    free(build.strands);
+    free(build.fields);
+    free(build.strings);
+    free(build.blocks);
+    free(build.chroms);
+    free(build.chrom_lookup);
+    return status;
+}
+
+
+/*
+ *  Check that a section of count elements lies within the file and
+ *  return a pointer to it in the mapping.
+ */
+static const void *bed_cache_section(bl_bed_cache_t *cache, uint64_t offset,
+				     uint64_t count, size_t size,
+				     const char *filename)
+
+{
+    if ( (offset % 8 != 0) || (offset > cache->map_size) ||
+	 (count > (cache->map_size - offset) / size) )
+    {
+	fprintf(stderr, "bl_bed_cache_open(): %s: Section at %" PRIu64
+		" extends past end of file.\n", filename, offset);
+	return NULL;
+    }
+    return (const char *)cache->map + offset;
+}
+
+
+/*
+ *  Check that the chromosome table refers to names within the string
+ *  arena and rows within the feature range.  The string arena is known
+ *  to end with '\0', so any offset within it yields a terminated string.
+ *  Per-row offsets are checked by bl_bed_cache_get() instead, so that
+ *  opening a cache does not read every row.
+ */
+static bool bed_cache_check_chroms(bl_bed_cache_t *cache,
+				   const char *filename)
+
+{
+    const bl_bed_cache_header_t *header = cache->header;
+    uint64_t                    r;
+
+    for (r = 0; r < header->chrom_count; ++r)
+    {
+	if ( (cache->chroms[r].name_offset >= header->string_bytes) ||
+	     (cache->chroms[r].first > header->feature_count) ||
+	     (cache->chroms[r].count >
+		header->feature_count - cache->chroms[r].first) ||
+	     (cache->chrom_lookup[r] >= header->chrom_count) )
+	{
+	    fprintf(stderr, "bl_bed_cache_open(): %s: Invalid chromosome %"
+		    PRIu64 ".\n", filename, r);
+	    return false;
+	}
+    }
+    return true;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-cache.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Map a BED cache created by bl_bed_cache_create(3) into memory.
+ *      The columns are then available through the pointers in the
+ *      bl_bed_cache_t structure and the BL_BED_CACHE_* macros.  Since the
+ *      mapping is shared, many processes loading the same annotation use
+ *      a single copy in the page cache.
+ *
+ *      Every section is checked to lie within the file, and every
+ *      chromosome entry to lie within its section.  The name, RGB, and
+ *      block offsets of a row are checked by bl_bed_cache_get(3) when
+ *      the row is accessed, so opening takes the same time regardless
+ *      of the number of features, and columns are read from disk only
+ *      as they are touched.
+ *
+ *  Arguments:
+ *      cache:      Pointer to the bl_bed_cache_t structure to fill in
+ *      filename:   Name of the cache file
+ *
+ *  Returns:
+ *      BL_READ_OK on success,
+ *      BL_READ_EOF if the file could not be opened or mapped,
+ *      BL_READ_TRUNCATED if the file is shorter than its header says
+ *      or a section or chromosome entry is out of range,
+ *      BL_READ_MISMATCH if the file is not a BED cache, or was written
+ *      by an incompatible version or architecture
+ *
+ *  Examples:
+ *      bl_bed_cache_t  cache;
+ *      size_t          row;
+ *
+ *      if ( bl_bed_cache_open(&cache, "genes.blbed") == BL_READ_OK )
+ *      {
+ *          for (row = 0; row < BL_BED_CACHE_FEATURE_COUNT(&cache); ++row)
+ *              total += BL_BED_CACHE_END(&cache, row) -
+ *                       BL_BED_CACHE_START(&cache, row);
+ *          bl_bed_cache_close(&cache);
+ *      }
+ *
+ *  See also:
+ *      bl_bed_cache_create(3), bl_bed_cache_close(3),
+ *      bl_bed_cache_find_chrom(3), bl_bed_cache_get(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_cache_open(bl_bed_cache_t *cache, const char *filename)
+
+{
+    const bl_bed_cache_header_t *header;
+    struct stat                 st;
+    int                         fd;
+    bool                        valid;
+
+    memset(cache, 0, sizeof(*cache));
+    if ( (fd = open(filename, O_RDONLY)) == -1 )
+    {
+	fprintf(stderr, "bl_bed_cache_open(): Could not open %s: %s\n",
+		filename, strerror(errno));
+	return BL_READ_EOF;
+    }
+    if ( fstat(fd, &st) != 0 )
+    {
+	fprintf(stderr, "bl_bed_cache_open(): Could not stat %s: %s\n",
+		filename, strerror(errno));
+	close(fd);
+	return BL_READ_EOF;
+    }
+    if ( (size_t)st.st_size < sizeof(*header) )
+    {
+	fprintf(stderr, "bl_bed_cache_open(): %s is too small to be a "
+		"BED cache.\n", filename);
+	close(fd);
+	return BL_READ_TRUNCATED;
+    }
+    cache->map_size = st.st_size;
+    cache->map = mmap(NULL, cache->map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if ( cache->map == MAP_FAILED )
+    {
+	fprintf(stderr, "bl_bed_cache_open(): Could not map %s: %s\n",
+		filename, strerror(errno));
+	cache->map = NULL;
+	return BL_READ_EOF;
+    }
+
+    header = cache->header = cache->map;
+    if ( (memcmp(header->magic, BL_BED_CACHE_MAGIC,
+		 sizeof(header->magic)) != 0) ||
+	 (header->version != BL_BED_CACHE_VERSION) ||
+	 (header->byte_order != BL_BED_CACHE_BYTE_ORDER) )
+    {
+	fprintf(stderr, "bl_bed_cache_open(): %s is not a version %d BED "
+		"cache for this architecture.\n", filename,
+		BL_BED_CACHE_VERSION);
+	bl_bed_cache_close(cache);
+	return BL_READ_MISMATCH;
+    }
+    if ( header->file_size != cache->map_size )
+    {
+	fprintf(stderr, "bl_bed_cache_open(): %s: Size is %zu, expected %"
+		PRIu64 ".\n", filename, cache->map_size, header->file_size);
+	bl_bed_cache_close(cache);
+	return BL_READ_TRUNCATED;
+    }
+
+    cache->feature_count = header->feature_count;
+    cache->chrom_count = header->chrom_count;
+#define MAP_SECTION(sec, count) \
+    ((cache->sec = bed_cache_section(cache, header->sec##_offset, \
+	(count), sizeof(*cache->sec), filename)) != NULL)
+    valid = MAP_SECTION(chroms, header->chrom_count) &&
+	    MAP_SECTION(chrom_lookup, header->chrom_count) &&
+	    MAP_SECTION(starts, header->feature_count) &&
+	    MAP_SECTION(ends, header->feature_count) &&
+	    MAP_SECTION(thick_starts, header->feature_count) &&
+	    MAP_SECTION(thick_ends, header->feature_count) &&
+	    MAP_SECTION(name_offsets, header->feature_count) &&
+	    MAP_SECTION(rgb_offsets, header->feature_count) &&
+	    MAP_SECTION(block_offsets, header->feature_count) &&
+	    MAP_SECTION(scores, header->feature_count) &&
+	    MAP_SECTION(block_counts, header->feature_count) &&
+	    MAP_SECTION(strands, header->feature_count) &&
+	    MAP_SECTION(fields, header->feature_count) &&
+	    MAP_SECTION(strings, header->string_bytes) &&
+	    MAP_SECTION(blocks, header->block_values);
+#undef MAP_SECTION
+
+    // Every string, including the last, must be terminated
+    if ( valid && ((header->string_bytes == 0) ||
+		   (cache->strings[header->string_bytes - 1] != '\0')) )
+    {
+	fprintf(stderr, "bl_bed_cache_open(): %s: Invalid string arena.\n",
+		filename);
+	valid = false;
+    }
+    if ( valid )
+	valid = bed_cache_check_chroms(cache, filename);
+    if ( !valid )
+    {
+	bl_bed_cache_close(cache);
+	return BL_READ_TRUNCATED;
+    }
+    return BL_READ_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-cache.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Unmap a BED cache opened by bl_bed_cache_open(3).  Pointers to
+ *      cache contents, including block arrays set by bl_bed_cache_get(3),
+ *      are invalid afterward.
+ *
+ *  Arguments:
+ *      cache:  Pointer to the bl_bed_cache_t structure to close
+ *
+ *  See also:
+ *      bl_bed_cache_open(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_cache_close(bl_bed_cache_t *cache)
+
+{
+    if ( cache->map != NULL )
+	munmap(cache->map, cache->map_size);
+    memset(cache, 0, sizeof(*cache));
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-cache.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Look up a chromosome in a BED cache by name.  The features on
+ *      the chromosome are rows BL_BED_CACHE_CHROM_FIRST(cache, c) through
+ *      BL_BED_CACHE_CHROM_FIRST(cache, c) +
+ *      BL_BED_CACHE_CHROM_COUNT_AE(cache, c) - 1, sorted by start
+ *      position.
+ *
+ *  Arguments:
+ *      cache:  Pointer to an open bl_bed_cache_t structure
+ *      chrom:  Chromosome name
+ *
+ *  Returns:
+ *      Index of the chromosome, or -1 if it has no features in the cache
+ *
+ *  Examples:
+ *      ssize_t c;
+ *      size_t  row, end;
+ *
+ *      if ( (c = bl_bed_cache_find_chrom(&cache, "chr2")) != -1 )
+ *      {
+ *          end = BL_BED_CACHE_CHROM_FIRST(&cache, c) +
+ *                BL_BED_CACHE_CHROM_COUNT_AE(&cache, c);
+ *          for (row = BL_BED_CACHE_CHROM_FIRST(&cache, c); row < end; ++row)
+ *              puts(BL_BED_CACHE_NAME(&cache, row));
+ *      }
+ *
+ *  See also:
+ *      bl_bed_cache_open(3), bl_bed_cache_get(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t bl_bed_cache_find_chrom(bl_bed_cache_t *cache, const char *chrom)
+
+{
+    size_t      low = 0, high = cache->chrom_count, mid;
+    uint64_t    c;
+    int         cmp;
+
+    while ( low < high )
+    {
+	mid = (low + high) / 2;
+	c = cache->chrom_lookup[mid];
+	cmp = strcmp(BL_BED_CACHE_CHROM_NAME(cache, c), chrom);
+	if ( cmp == 0 )
+	    return c;
+	else if ( cmp < 0 )
+	    low = mid + 1;
+	else
+	    high = mid;
+    }
+    return -1;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-cache.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Copy one row of a BED cache into a bl_bed_t structure for use
+ *      with bl_bed_write(3) or other bl_bed_*() functions.
+ *
+ *      To avoid an allocation per feature, block_sizes and block_starts
+ *      are set to point into the read-only cache mapping rather than to
+ *      allocated arrays, so they must not be modified or freed, and are
+ *      valid only until bl_bed_cache_close(3).  They are NULL for
+ *      features with no blocks.
+ *
+ *      The row's name, RGB, and block offsets are checked against the
+ *      string and block arenas, so a corrupt cache cannot cause reads
+ *      outside the mapping.
+ *
+ *  Arguments:
+ *      cache:          Pointer to an open bl_bed_cache_t structure
+ *      row:            Row to copy, 0 to BL_BED_CACHE_FEATURE_COUNT(cache) - 1
+ *      bed_feature:    Pointer to the bl_bed_t structure to fill in
+ *
+ *  Returns:
+ *      BL_DATA_OK on success, BL_DATA_OUT_OF_RANGE if row is invalid,
+ *      BL_DATA_INVALID if the row holds an offset outside its arena
+ *
+ *  Examples:
+ *      bl_bed_t    bed_feature;
+ *
+ *      bl_bed_cache_get(&cache, row, &bed_feature);
+ *      bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+ *
+ *  See also:
+ *      bl_bed_cache_open(3), bl_bed_cache_write_bed(3), bl_bed_write(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_cache_get(bl_bed_cache_t *cache, size_t row,
+			 bl_bed_t *bed_feature)
+
+{
+    size_t      low = 0, high = cache->chrom_count, mid;
+    uint64_t    *blocks;
+
+    if ( row >= cache->feature_count )
+	return BL_DATA_OUT_OF_RANGE;
+    if ( (cache->name_offsets[row] >= cache->header->string_bytes) ||
+	 (cache->rgb_offsets[row] >= cache->header->string_bytes) ||
+	 (cache->block_offsets[row] > cache->header->block_values) ||
+	 (2 * (uint64_t)cache->block_counts[row] >
+	    cache->header->block_values - cache->block_offsets[row]) )
+    {
+	fprintf(stderr, "bl_bed_cache_get(): Invalid offset in row %zu.\n",
+		row);
+	return BL_DATA_INVALID;
+    }
+
+    // Chromosome runs are in row order
+    while ( high - low > 1 )
+    {
+	mid = (low + high) / 2;
+	if ( cache->chroms[mid].first <= row )
+	    low = mid;
+	else
+	    high = mid;
+    }
+    strlcpy(bed_feature->chrom, BL_BED_CACHE_CHROM_NAME(cache, low),
+	    BL_CHROM_MAX_CHARS + 1);
+    bed_feature->chrom_start = cache->starts[row];
+    bed_feature->chrom_end = cache->ends[row];
+    strlcpy(bed_feature->name, cache->strings + cache->name_offsets[row],
+	    BL_BED_NAME_MAX_CHARS + 1);
+    bed_feature->score = cache->scores[row];
+    bed_feature->strand = cache->strands[row];
+    bed_feature->thick_start = cache->thick_starts[row];
+    bed_feature->thick_end = cache->thick_ends[row];
+    strlcpy(bed_feature->item_rgb, cache->strings + cache->rgb_offsets[row],
+	    BL_BED_ITEM_RGB_MAX_CHARS + 1);
+    bed_feature->block_count = cache->block_counts[row];
+    if ( bed_feature->block_count > 0 )
+    {
+	blocks = (uint64_t *)cache->blocks + cache->block_offsets[row];
+	bed_feature->block_sizes = blocks;
+	bed_feature->block_starts = blocks + bed_feature->block_count;
+    }
+    else
+	bed_feature->block_sizes = bed_feature->block_starts = NULL;
+    bed_feature->fields = cache->fields[row];
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-cache.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Export all features in a BED cache to bed_stream in BED format,
+ *      using bl_bed_write(3).  Features are written in cache order,
+ *      i.e. grouped by chromosome and sorted by start position.
+ *
+ *  Arguments:
+ *      bed_stream: FILE stream to which BED features are written
+ *      cache:      Pointer to an open bl_bed_cache_t structure
+ *      field_mask: Bit mask indicating which fields to output, as for
+ *                  bl_bed_write(3)
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE on error or a corrupt row
+ *
+ *  Examples:
+ *      bl_bed_cache_write_bed(stdout, &cache, BL_BED_FIELD_ALL);
+ *
+ *  See also:
+ *      bl_bed_cache_get(3), bl_bed_write(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_cache_write_bed(FILE *bed_stream, bl_bed_cache_t *cache,
+			       bed_field_mask_t field_mask)
+
+{
+    bl_bed_t    bed_feature = BL_BED_INIT;
+    size_t      row;
+
+    for (row = 0; row < cache->feature_count; ++row)
+    {
+	if ( (bl_bed_cache_get(cache, row, &bed_feature) != BL_DATA_OK) ||
+	     (bl_bed_write(bed_stream, &bed_feature, field_mask)
+		!= BL_WRITE_OK) )
+	    return BL_WRITE_FAILURE;
+    }
+    return ferror(bed_stream) ? BL_WRITE_FAILURE : BL_WRITE_OK;
+}
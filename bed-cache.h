@@ -0,0 +1,122 @@
+#ifndef _bed_cache_h_
+#define _bed_cache_h_
+
+#include <sys/types.h>      // ssize_t
+
+#ifndef _bed_h_
+#include "bed.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+#define BL_BED_CACHE_MAGIC      "BLBEDC\r\n"
+#define BL_BED_CACHE_VERSION    1
+#define BL_BED_CACHE_BYTE_ORDER 0x01020304  // Reads differently if swapped
+
+/*
+ *  On-disk layout of a binary BED cache.  The header is followed by
+ *  the chromosome table and one column per BED field, each starting
+ *  on an 8-byte boundary at the offset recorded here.  Chromosomes are
+ *  kept in the order they first appear in the BED input and features
+ *  are sorted by start position within each, so each chromosome is a
+ *  contiguous run of rows.  A second table lists the chromosomes in
+ *  strcmp() order for lookup by name.  Names, RGB strings and
+ *  chromosome names live in a single string arena, block sizes and
+ *  starts in a single uint64_t arena.  Integers are stored in native
+ *  byte order, so a cache is not portable between architectures.
+ */
+typedef struct
+{
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    byte_order;
+    uint64_t    file_size;
+    uint64_t    feature_count;
+    uint64_t    chrom_count;
+    uint64_t    string_bytes;
+    uint64_t    block_values;
+    uint64_t    chroms_offset;
+    uint64_t    chrom_lookup_offset;
+    uint64_t    starts_offset;
+    uint64_t    ends_offset;
+    uint64_t    thick_starts_offset;
+    uint64_t    thick_ends_offset;
+    uint64_t    name_offsets_offset;
+    uint64_t    rgb_offsets_offset;
+    uint64_t    block_offsets_offset;
+    uint64_t    scores_offset;
+    uint64_t    block_counts_offset;
+    uint64_t    strands_offset;
+    uint64_t    fields_offset;
+    uint64_t    strings_offset;
+    uint64_t    blocks_offset;
+}   bl_bed_cache_header_t;
+
+typedef struct
+{
+    uint64_t    name_offset;    // Into string arena
+    uint64_t    first;          // First row
+    uint64_t    count;
+    uint64_t    max_end;        // Largest end of any feature
+}   bl_bed_cache_chrom_t;
+
+/*
+ *  A memory-mapped cache.  All pointers refer to the read-only mapping
+ *  and remain valid until bl_bed_cache_close().
+ */
+typedef struct
+{
+    void                        *map;
+    size_t                      map_size;
+    const bl_bed_cache_header_t *header;
+    const bl_bed_cache_chrom_t  *chroms;
+    const uint64_t              *chrom_lookup;  // chroms[] sorted by name
+    size_t                      feature_count;
+    size_t                      chrom_count;
+    const uint64_t              *starts;
+    const uint64_t              *ends;
+    const uint64_t              *thick_starts;
+    const uint64_t              *thick_ends;
+    const uint64_t              *name_offsets;
+    const uint64_t              *rgb_offsets;
+    const uint64_t              *block_offsets;
+    const uint16_t              *scores;
+    const uint16_t              *block_counts;
+    const char                  *strands;
+    const uint8_t               *fields;
+    const char                  *strings;
+    const uint64_t              *blocks;
+}   bl_bed_cache_t;
+
+#define BL_BED_CACHE_INIT \
+	{ NULL, 0, NULL, NULL, NULL, 0, 0, NULL, NULL, NULL, NULL, NULL, \
+	  NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
+
+/* Not generated by gen-get-set */
+#define BL_BED_CACHE_FEATURE_COUNT(ptr)     ((ptr)->feature_count)
+#define BL_BED_CACHE_CHROM_COUNT(ptr)       ((ptr)->chrom_count)
+#define BL_BED_CACHE_CHROM_NAME(ptr,c)      ((ptr)->strings + (ptr)->chroms[c].name_offset)
+#define BL_BED_CACHE_CHROM_FIRST(ptr,c)     ((ptr)->chroms[c].first)
+#define BL_BED_CACHE_CHROM_COUNT_AE(ptr,c)  ((ptr)->chroms[c].count)
+#define BL_BED_CACHE_CHROM_MAX_END(ptr,c)   ((ptr)->chroms[c].max_end)
+#define BL_BED_CACHE_START(ptr,r)           ((ptr)->starts[r])
+#define BL_BED_CACHE_END(ptr,r)             ((ptr)->ends[r])
+// "" if the offset is corrupt, which bl_bed_cache_get() reports
+#define BL_BED_CACHE_NAME(ptr,r) \
+	((ptr)->name_offsets[r] < (ptr)->header->string_bytes ? \
+	 (ptr)->strings + (ptr)->name_offsets[r] : "")
+#define BL_BED_CACHE_SCORE(ptr,r)           ((ptr)->scores[r])
+#define BL_BED_CACHE_STRAND(ptr,r)          ((ptr)->strands[r])
+#define BL_BED_CACHE_FIELDS(ptr,r)          ((ptr)->fields[r])
+
+/* bed-cache.c */
+int bl_bed_cache_create(const char *filename, FILE *bed_stream);
+int bl_bed_cache_open(bl_bed_cache_t *cache, const char *filename);
+void bl_bed_cache_close(bl_bed_cache_t *cache);
+ssize_t bl_bed_cache_find_chrom(bl_bed_cache_t *cache, const char *chrom);
+int bl_bed_cache_get(bl_bed_cache_t *cache, size_t row, bl_bed_t *bed_feature);
+int bl_bed_cache_write_bed(FILE *bed_stream, bl_bed_cache_t *cache, bed_field_mask_t field_mask);
+
+#endif  // _bed_cache_h_
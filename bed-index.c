@@ -0,0 +1,398 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <sys/param.h>  // MIN(), MAX()
+#include <xtend.h>
+#include "bed-index.h"
+#include "biolibc.h"
+
+// Subtrees this small are scanned linearly
+#define BED_INDEX_SCAN_LEVEL    3
+
+typedef struct
+{
+    const char  *chrom;
+    uint64_t    start;
+    uint64_t    end;
+    size_t      feature;
+}   bed_index_sort_t;
+
+static int  bed_index_sort_cmp(const void *p1, const void *p2)
+
+{
+    const bed_index_sort_t  *e1 = p1, *e2 = p2;
+    int     cmp;
+
+    if ( (cmp = strcmp(e1->chrom, e2->chrom)) != 0 )
+	return cmp;
+    if ( e1->start != e2->start )
+	return e1->start < e2->start ? -1 : 1;
+    // Keep input order for equal starts
+    return e1->feature < e2->feature ? -1 : e1->feature > e2->feature;
+}
+
+
+/*
+ *  Fill in max_end for the implicit tree over entries[0 .. count-1]
+ *  and return the level of the root.
+ */
+
+static int  bed_index_augment(bl_bed_index_entry_t *entries, size_t count)
+
+{
+    size_t      c, last_c = 0, x, step;
+    uint64_t    last = 0, left_end, right_end, max_end;
+    int         level;
+
+    // Leaves (level 0) are at even indexes
+    for (c = 0; c < count; c += 2)
+    {
+	last_c = c;
+	last = entries[c].max_end = entries[c].end;
+    }
+    for (level = 1; ((size_t)1 << level) <= count; ++level)
+    {
+	x = (size_t)1 << (level - 1);
+	step = x << 2;
+	for (c = (x << 1) - 1; c < count; c += step)
+	{
+	    left_end = entries[c - x].max_end;
+	    // A missing right child stands for the rightmost subtree
+	    right_end = c + x < count ? entries[c + x].max_end : last;
+	    max_end = MAX(entries[c].end, MAX(left_end, right_end));
+	    entries[c].max_end = max_end;
+	}
+	last_c = (last_c >> level) & 1 ? last_c - x : last_c + x;
+	if ( (last_c < count) && (entries[last_c].max_end > last) )
+	    last = entries[last_c].max_end;
+    }
+    return level - 1;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Build an immutable interval index over an array of BED features
+ *      for fast overlap queries with bl_bed_index_query(3).  Features
+ *      need not be sorted.  Only the chromosome, start, and end are
+ *      copied, so the index does not refer to features after it is
+ *      built, but query results are indexes into the same array.
+ *
+ *      The index is an implicit augmented interval tree stored in flat
+ *      arrays, with no per-node pointers.  Building takes O(n log n)
+ *      time for sorting, and each query takes O(log n + k) time for k
+ *      overlapping features.
+ *
+ *  Arguments:
+ *      index:      Pointer to the bl_bed_index_t structure to fill in
+ *      features:   Array of BED features
+ *      count:      Number of features
+ *
+ *  Examples:
+ *      bl_bed_index_t      index;
+ *      bl_bed_index_hits_t hits = BL_BED_INDEX_HITS_INIT;
+ *      size_t              c;
+ *
+ *      bl_bed_index_build(&index, annotations, annotation_count);
+ *      bl_bed_index_query(&index, BL_BED_CHROM(&peak),
+ *                         BL_BED_CHROM_START(&peak), BL_BED_CHROM_END(&peak),
+ *                         &hits);
+ *      for (c = 0; c < BL_BED_INDEX_HITS_COUNT(&hits); ++c)
+ *          printf("%s\n", BL_BED_NAME(&annotations[
+ *                 BL_BED_INDEX_HITS_FEATURES_AE(&hits, c)]));
+ *      bl_bed_index_hits_free(&hits);
+ *      bl_bed_index_free(&index);
+ *
+ *  See also:
+ *      bl_bed_index_query(3), bl_bed_index_free(3), bl_bed_gff_cmp(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_index_build(bl_bed_index_t *index, bl_bed_t features[],
+			   size_t count)
+
+{
+    bed_index_sort_t        *sorted;
+    bl_bed_index_chrom_t    *chrom;
+    size_t                  c, chrom_max = 0;
+
+    index->entries = NULL;
+    index->entry_count = 0;
+    index->chroms = NULL;
+    index->chrom_count = 0;
+    if ( count == 0 )
+	return;
+
+    if ( (sorted = xt_malloc(count, sizeof(*sorted))) == NULL )
+    {
+	fprintf(stderr, "bl_bed_index_build(): Could not allocate sort array.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = 0; c < count; ++c)
+    {
+	sorted[c].chrom = BL_BED_CHROM(&features[c]);
+	sorted[c].start = BL_BED_CHROM_START(&features[c]);
+	sorted[c].end = BL_BED_CHROM_END(&features[c]);
+	sorted[c].feature = c;
+    }
+    qsort(sorted, count, sizeof(*sorted), bed_index_sort_cmp);
+
+    if ( (index->entries = xt_malloc(count, sizeof(*index->entries))) == NULL )
+    {
+	fprintf(stderr, "bl_bed_index_build(): Could not allocate entries.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = 0; c < count; ++c)
+    {
+	if ( (c == 0) || (strcmp(sorted[c].chrom, sorted[c - 1].chrom) != 0) )
+	{
+	    if ( index->chrom_count == chrom_max )
+	    {
+		chrom_max = chrom_max == 0 ? 32 : chrom_max * 2;
+		if ( (index->chroms = xt_realloc(index->chroms, chrom_max,
+			sizeof(*index->chroms))) == NULL )
+		{
+		    fprintf(stderr, "bl_bed_index_build(): Could not allocate chroms.\n");
+		    exit(EX_UNAVAILABLE);
+		}
+	    }
+	    chrom = &index->chroms[index->chrom_count++];
+	    if ( (chrom->chrom = strdup(sorted[c].chrom)) == NULL )
+	    {
+		fprintf(stderr, "bl_bed_index_build(): Could not allocate chrom.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	    chrom->first = c;
+	    chrom->count = 0;
+	}
+	index->entries[c].start = sorted[c].start;
+	index->entries[c].end = sorted[c].end;
+	index->entries[c].feature = sorted[c].feature;
+	++index->chroms[index->chrom_count - 1].count;
+    }
+    index->entry_count = count;
+    free(sorted);
+
+    for (c = 0; c < index->chrom_count; ++c)
+    {
+	chrom = &index->chroms[c];
+	chrom->root_level = bed_index_augment(index->entries + chrom->first,
+					      chrom->count);
+    }
+}
+
+
+static int  bed_index_chrom_cmp(const void *key, const void *p)
+
+{
+    return strcmp(key, ((const bl_bed_index_chrom_t *)p)->chrom);
+}
+
+
+static void bed_index_add_hit(bl_bed_index_hits_t *hits,
+			      bl_bed_index_entry_t *entry,
+			      uint64_t start, uint64_t end)
+
+{
+    if ( hits->count == hits->max )
+    {
+	hits->max = hits->max == 0 ? 64 : hits->max * 2;
+	if ( ((hits->features = xt_realloc(hits->features, hits->max,
+		sizeof(*hits->features))) == NULL) ||
+	     ((hits->overlaps = xt_realloc(hits->overlaps, hits->max,
+		sizeof(*hits->overlaps))) == NULL) )
+	{
+	    fprintf(stderr, "bl_bed_index_query(): Could not allocate hits.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    hits->features[hits->count] = entry->feature;
+    // 1-based inclusive, as in bl_bed_gff_cmp()
+    bl_overlap_set_all(&hits->overlaps[hits->count],
+		       entry->end - entry->start, end - start,
+		       MAX(entry->start, start) + 1, MIN(entry->end, end));
+    ++hits->count;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Find all indexed features overlapping a region, using BED
+ *      coordinates: start is 0-based and end is not inclusive.  For a
+ *      1-based, inclusive region such as a GFF feature, pass start - 1
+ *      and end.  Features overlap the region if they share at least one
+ *      base, so empty features never match.
+ *
+ *      Hits replace the previous contents of hits, in order of feature
+ *      start.  For each hit, hits->features holds the feature's index in
+ *      the array given to bl_bed_index_build(3), and hits->overlaps holds
+ *      the details, with the indexed feature as feature 1 and the query
+ *      as feature 2, and 1-based inclusive positions, as from
+ *      bl_bed_gff_cmp(3).
+ *
+ *      The index is not modified, so it can be queried from multiple
+ *      threads, each with its own hits.
+ *
+ *  Arguments:
+ *      index:  Pointer to an index from bl_bed_index_build(3)
+ *      chrom:  Chromosome of the region
+ *      start:  0-based start of the region
+ *      end:    End of the region, not inclusive
+ *      hits:   Pointer to a bl_bed_index_hits_t initialized with
+ *              BL_BED_INDEX_HITS_INIT, reused across queries
+ *
+ *  Returns:
+ *      The number of overlapping features
+ *
+ *  See also:
+ *      bl_bed_index_build(3), bl_bed_index_hits_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  bl_bed_index_query(bl_bed_index_t *index, const char *chrom,
+			   uint64_t start, uint64_t end,
+			   bl_bed_index_hits_t *hits)
+
+{
+    bl_bed_index_chrom_t    *ch;
+    bl_bed_index_entry_t    *entries;
+    struct
+    {
+	size_t  x;          // Node index
+	int     level;
+	bool    left_done;
+    }   stack[128], node;
+    size_t  count, c, first, last, left;
+    int     top = 0;
+
+    hits->count = 0;
+    if ( (index->chrom_count == 0) || (start >= end) ||
+	 ((ch = bsearch(chrom, index->chroms, index->chrom_count,
+			sizeof(*index->chroms), bed_index_chrom_cmp)) == NULL) )
+	return 0;
+    entries = index->entries + ch->first;
+    count = ch->count;
+
+    // Top-down traversal, which yields hits in order of start
+    stack[top].x = ((size_t)1 << ch->root_level) - 1;
+    stack[top].level = ch->root_level;
+    stack[top++].left_done = false;
+    while ( top > 0 )
+    {
+	node = stack[--top];
+	if ( node.level <= BED_INDEX_SCAN_LEVEL )
+	{
+	    first = node.x >> node.level << node.level;
+	    last = first + ((size_t)1 << (node.level + 1)) - 1;
+	    if ( last > count )
+		last = count;
+	    for (c = first; (c < last) && (entries[c].start < end); ++c)
+		if ( start < entries[c].end )
+		    bed_index_add_hit(hits, &entries[c], start, end);
+	}
+	else if ( ! node.left_done )
+	{
+	    // Revisit this node after its left subtree
+	    left = node.x - ((size_t)1 << (node.level - 1));
+	    stack[top].x = node.x;
+	    stack[top].level = node.level;
+	    stack[top++].left_done = true;
+	    // Left child may be past the end, standing for a partial subtree
+	    if ( (left >= count) || (entries[left].max_end > start) )
+	    {
+		stack[top].x = left;
+		stack[top].level = node.level - 1;
+		stack[top++].left_done = false;
+	    }
+	}
+	else if ( (node.x < count) && (entries[node.x].start < end) )
+	{
+	    if ( start < entries[node.x].end )
+		bed_index_add_hit(hits, &entries[node.x], start, end);
+	    stack[top].x = node.x + ((size_t)1 << (node.level - 1));
+	    stack[top].level = node.level - 1;
+	    stack[top++].left_done = false;
+	}
+    }
+    return hits->count;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory allocated by bl_bed_index_build(3).
+ *
+ *  Arguments:
+ *      index:  Pointer to an index from bl_bed_index_build(3)
+ *
+ *  See also:
+ *      bl_bed_index_build(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_index_free(bl_bed_index_t *index)
+
+{
+    size_t  c;
+
+    for (c = 0; c < index->chrom_count; ++c)
+	free(index->chroms[c].chrom);
+    free(index->chroms);
+    free(index->entries);
+    index->chroms = NULL;
+    index->entries = NULL;
+    index->chrom_count = index->entry_count = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free the arrays in a bl_bed_index_hits_t filled by
+ *      bl_bed_index_query(3).  The structure can be reused afterward.
+ *
+ *  Arguments:
+ *      hits:   Pointer to a bl_bed_index_hits_t structure
+ *
+ *  See also:
+ *      bl_bed_index_query(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_index_hits_free(bl_bed_index_hits_t *hits)
+
+{
+    free(hits->features);
+    free(hits->overlaps);
+    hits->features = NULL;
+    hits->overlaps = NULL;
+    hits->count = hits->max = 0;
+}
@@ -0,0 +1,68 @@
+#ifndef _bed_index_h_
+#define _bed_index_h_
+
+#ifndef _bed_h_
+#include "bed.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+/*
+ *  Immutable interval index over an array of BED features: an implicit
+ *  augmented interval tree (as in cgranges) laid out in flat arrays.
+ *  Entries for each chromosome are sorted by start, and the tree is
+ *  implicit in the array order: a node at index i has level equal to
+ *  the number of trailing 1 bits in i, and max_end is the largest end
+ *  in its subtree.
+ */
+typedef struct
+{
+    uint64_t    start;      // 0-based, as in BED
+    uint64_t    end;        // Not inclusive
+    uint64_t    max_end;    // Largest end in subtree
+    size_t      feature;    // Index into the array given to build
+}   bl_bed_index_entry_t;
+
+typedef struct
+{
+    char        *chrom;
+    size_t      first;      // Index of first entry
+    size_t      count;
+    int         root_level;
+}   bl_bed_index_chrom_t;
+
+typedef struct
+{
+    bl_bed_index_entry_t    *entries;
+    size_t                  entry_count;
+    bl_bed_index_chrom_t    *chroms;    // Sorted by name for bsearch()
+    size_t                  chrom_count;
+}   bl_bed_index_t;
+
+// Results of bl_bed_index_query(), reused across queries
+typedef struct
+{
+    size_t          *features;
+    bl_overlap_t    *overlaps;
+    size_t          count;
+    size_t          max;
+}   bl_bed_index_hits_t;
+
+#define BL_BED_INDEX_HITS_INIT  { NULL, NULL, 0, 0 }
+
+/* Not generated by gen-get-set */
+#define BL_BED_INDEX_ENTRY_COUNT(ptr)       ((ptr)->entry_count)
+#define BL_BED_INDEX_CHROM_COUNT(ptr)       ((ptr)->chrom_count)
+#define BL_BED_INDEX_HITS_COUNT(ptr)        ((ptr)->count)
+#define BL_BED_INDEX_HITS_FEATURES_AE(ptr,c)    ((ptr)->features[c])
+#define BL_BED_INDEX_HITS_OVERLAPS_AE(ptr,c)    (&(ptr)->overlaps[c])
+
+/* bed-index.c */
+void bl_bed_index_build(bl_bed_index_t *index, bl_bed_t features[], size_t count);
+size_t bl_bed_index_query(bl_bed_index_t *index, const char *chrom, uint64_t start, uint64_t end, bl_bed_index_hits_t *hits);
+void bl_bed_index_free(bl_bed_index_t *index);
+void bl_bed_index_hits_free(bl_bed_index_hits_t *hits);
+
+#endif  // _bed_index_h_
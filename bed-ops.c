@@ -0,0 +1,792 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <sys/param.h>  // MIN(), MAX()
+#include <xtend.h>
+#include "bed-ops.h"
+#include "biostring.h"
+#include "biolibc.h"
+
+static void bed_ops_input_init(bl_bed_ops_input_t *input, FILE *bed_stream)
+
+{
+    static bl_bed_t bed_init = BL_BED_INIT;
+
+    bl_bed_reader_init(&input->reader, bed_stream, BL_BED_FIELD_ALL, 0);
+    input->feature = bed_init;
+    input->have_feature = false;
+    input->primed = false;
+    input->features_read = 0;
+    *input->last_chrom = '\0';
+    input->last_start = 0;
+}
+
+
+/*
+ *  Compare chromosome names in sort order.  Runs of features on the
+ *  same chromosome are the common case, so check for that first.
+ */
+
+static int  bed_ops_chrom_cmp(const char *chrom1, const char *chrom2)
+
+{
+    if ( strcmp(chrom1, chrom2) == 0 )
+	return 0;
+    return bl_chrom_name_cmp(chrom1, chrom2);
+}
+
+
+/*
+ *  Read the next feature from an input and check that the input is
+ *  sorted.
+ */
+
+static int  bed_ops_read(bl_bed_ops_input_t *input, bl_bed_t *feature,
+			 const char *caller)
+
+{
+    int     status, cmp = 1;
+
+    if ( (status = bl_bed_reader_read(&input->reader, feature))
+	    != BL_READ_OK )
+	return status;
+
+    if ( input->features_read > 0 )
+    {
+	cmp = bed_ops_chrom_cmp(BL_BED_CHROM(feature), input->last_chrom);
+	if ( (cmp < 0) ||
+	     ((cmp == 0) && (BL_BED_CHROM_START(feature) < input->last_start)) )
+	{
+	    fprintf(stderr, "%s(): BED input is not sorted: %s %" PRIu64
+		    " follows %s %" PRIu64 "\n", caller,
+		    BL_BED_CHROM(feature), BL_BED_CHROM_START(feature),
+		    input->last_chrom, input->last_start);
+	    return BL_READ_MISMATCH;
+	}
+    }
+    if ( (input->features_read == 0) || (cmp != 0) )
+	strlcpy(input->last_chrom, BL_BED_CHROM(feature),
+		BL_CHROM_MAX_CHARS + 1);
+    input->last_start = BL_BED_CHROM_START(feature);
+    ++input->features_read;
+    return BL_READ_OK;
+}
+
+
+/* Replace the lookahead feature of an input.  EOF is not an error. */
+
+static int  bed_ops_lookahead(bl_bed_ops_input_t *input, const char *caller)
+
+{
+    int     status;
+
+    input->primed = true;
+    status = bed_ops_read(input, &input->feature, caller);
+    input->have_feature = (status == BL_READ_OK);
+    return status == BL_READ_EOF ? BL_READ_OK : status;
+}
+
+
+/* Set a BED3 output feature. */
+
+static void bed_ops_set_interval(bl_bed_t *bed_feature, const char *chrom,
+				 uint64_t start, uint64_t end)
+
+{
+    if ( BL_BED_CHROM(bed_feature) != chrom )
+	strlcpy(BL_BED_CHROM(bed_feature), chrom, BL_CHROM_MAX_CHARS + 1);
+    BL_BED_SET_CHROM_START(bed_feature, start);
+    BL_BED_SET_CHROM_END(bed_feature, end);
+    BL_BED_SET_BLOCK_COUNT(bed_feature, 0);
+    BL_BED_SET_FIELDS(bed_feature, 3);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Prepare to merge overlapping features from a sorted BED stream,
+ *      as with "bedtools merge".  Features on the same chromosome that
+ *      overlap, touch, or are separated by no more than max_gap bases
+ *      are combined into a single BED3 feature, returned one at a time
+ *      by bl_bed_merge_next(3).  Only one input feature is held in
+ *      memory at a time.
+ *
+ *      The input must be sorted by chromosome in bl_chrom_name_cmp(3)
+ *      order and by start position within each chromosome.
+ *
+ *  Arguments:
+ *      merge:      Pointer to the bl_bed_merge_t structure to initialize
+ *      bed_stream: Sorted BED input positioned at the first feature
+ *      max_gap:    Largest gap between features that are merged,
+ *                  0 to merge only overlapping and adjacent features
+ *
+ *  Examples:
+ *      bl_bed_merge_t  merge;
+ *      bl_bed_t        merged_feature = BL_BED_INIT;
+ *
+ *      bl_bed_merge_init(&merge, stdin, 0);
+ *      while ( bl_bed_merge_next(&merge, &merged_feature) == BL_READ_OK )
+ *          bl_bed_write(stdout, &merged_feature, BL_BED_FIELD_ALL);
+ *      bl_bed_merge_free(&merge);
+ *
+ *  See also:
+ *      bl_bed_merge_next(3), bl_bed_merge_free(3),
+ *      bl_bed_complement_init(3), bl_bed_subtract_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_merge_init(bl_bed_merge_t *merge, FILE *bed_stream,
+			  uint64_t max_gap)
+
+{
+    bed_ops_input_init(&merge->input, bed_stream);
+    merge->max_gap = max_gap;
+    merge->merged_count = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Return the next merged feature from a stream prepared by
+ *      bl_bed_merge_init(3).  merged_feature is set to a BED3 feature
+ *      spanning a maximal run of overlapping or nearby input features,
+ *      and BL_BED_MERGE_MERGED_COUNT(merge) to the number of input
+ *      features in the run.  Merged features are returned in sorted
+ *      order.
+ *
+ *  Arguments:
+ *      merge:          Pointer to a bl_bed_merge_t structure
+ *      merged_feature: Pointer to a bl_bed_t structure to receive the
+ *                      merged feature
+ *
+ *  Returns:
+ *      BL_READ_OK if a merged feature was returned,
+ *      BL_READ_EOF if there are no more features,
+ *      BL_READ_MISMATCH if the input is not sorted,
+ *      Other BL_READ_* errors from bl_bed_read(3)
+ *
+ *  Examples:
+ *      while ( bl_bed_merge_next(&merge, &merged_feature) == BL_READ_OK )
+ *          bl_bed_write(stdout, &merged_feature, BL_BED_FIELD_ALL);
+ *
+ *  See also:
+ *      bl_bed_merge_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_merge_next(bl_bed_merge_t *merge, bl_bed_t *merged_feature)
+
+{
+    bl_bed_ops_input_t  *input = &merge->input;
+    bl_bed_t            *next = &input->feature;
+    uint64_t            end;
+    int                 status;
+
+    if ( !input->primed &&
+	 ((status = bed_ops_lookahead(input, "bl_bed_merge_next"))
+	    != BL_READ_OK) )
+	return status;
+    if ( !input->have_feature )
+	return BL_READ_EOF;
+
+    bed_ops_set_interval(merged_feature, BL_BED_CHROM(next),
+			 BL_BED_CHROM_START(next), BL_BED_CHROM_END(next));
+    end = BL_BED_CHROM_END(next);
+    merge->merged_count = 1;
+    while ( ((status = bed_ops_lookahead(input, "bl_bed_merge_next"))
+		== BL_READ_OK) && input->have_feature &&
+	    (strcmp(BL_BED_CHROM(next), BL_BED_CHROM(merged_feature)) == 0) &&
+	    (BL_BED_CHROM_START(next) <= end + merge->max_gap) )
+    {
+	end = MAX(end, BL_BED_CHROM_END(next));
+	++merge->merged_count;
+    }
+    if ( status != BL_READ_OK )
+	return status;
+    BL_BED_SET_CHROM_END(merged_feature, end);
+    return BL_READ_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free memory used by a bl_bed_merge_t structure.  The input
+ *      stream is not closed.
+ *
+ *  Arguments:
+ *      merge:  Pointer to a bl_bed_merge_t structure
+ *
+ *  See also:
+ *      bl_bed_merge_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_merge_free(bl_bed_merge_t *merge)
+
+{
+    bl_bed_reader_close(&merge->input.reader);
+}
+
+
+/*
+ *  Read the next "chrom<TAB>length" line from a genome file, skipping
+ *  comments and ignoring any further columns, as in a samtools .fai.
+ */
+
+static int  bed_complement_read_genome(bl_bed_complement_t *complement)
+
+{
+    char    len_str[BL_POSITION_MAX_DIGITS + 1], *end;
+    size_t  len;
+    int     delim;
+
+    do
+    {
+	delim = tsv_read_field(complement->genome_stream, complement->chrom,
+			       BL_CHROM_MAX_CHARS, &len);
+	if ( delim == EOF )
+	    return BL_READ_EOF;
+	if ( *complement->chrom == '#' && (delim != '\n') )
+	    tsv_skip_rest_of_line(complement->genome_stream);
+    }   while ( *complement->chrom == '#' );
+
+    if ( delim == '\n' )
+    {
+	fprintf(stderr, "bl_bed_complement_next(): No length for %s in "
+		"genome file.\n", complement->chrom);
+	return BL_READ_TRUNCATED;
+    }
+    delim = tsv_read_field(complement->genome_stream, len_str,
+			   BL_POSITION_MAX_DIGITS, &len);
+    complement->chrom_len = strtoull(len_str, &end, 10);
+    if ( (delim == EOF) || (len == 0) || (*end != '\0') )
+    {
+	fprintf(stderr, "bl_bed_complement_next(): Invalid length for %s "
+		"in genome file: %s\n", complement->chrom, len_str);
+	return BL_READ_TRUNCATED;
+    }
+    if ( delim != '\n' )
+	tsv_skip_rest_of_line(complement->genome_stream);
+    return BL_READ_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Prepare to compute the complement of a sorted BED stream, i.e.
+ *      the intervals of each chromosome not covered by any feature, as
+ *      with "bedtools complement".  Chromosome lengths are read from
+ *      genome_stream, which contains one "chrom<TAB>length" line per
+ *      chromosome, e.g. a samtools .fai file.  Additional columns and
+ *      lines beginning with '#' are ignored.  Chromosomes with no
+ *      features are returned whole.
+ *
+ *      The genome file and the BED input must list chromosomes in the
+ *      same order, bl_chrom_name_cmp(3) order for sorted BED, and every
+ *      chromosome in the BED input must be in the genome file.  Only
+ *      one feature and one genome line are held in memory at a time.
+ *
+ *  Arguments:
+ *      complement:     Pointer to the bl_bed_complement_t structure to
+ *                      initialize
+ *      bed_stream:     Sorted BED input positioned at the first feature
+ *      genome_stream:  Chromosome lengths
+ *
+ *  Examples:
+ *      bl_bed_complement_t complement;
+ *      bl_bed_t            gap_feature = BL_BED_INIT;
+ *
+ *      bl_bed_complement_init(&complement, bed_stream, genome_stream);
+ *      while ( bl_bed_complement_next(&complement, &gap_feature)
+ *                  == BL_READ_OK )
+ *          bl_bed_write(stdout, &gap_feature, BL_BED_FIELD_ALL);
+ *      bl_bed_complement_free(&complement);
+ *
+ *  See also:
+ *      bl_bed_complement_next(3), bl_bed_complement_free(3),
+ *      bl_bed_merge_init(3), bl_bed_subtract_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_complement_init(bl_bed_complement_t *complement,
+			       FILE *bed_stream, FILE *genome_stream)
+
+{
+    bed_ops_input_init(&complement->input, bed_stream);
+    complement->genome_stream = genome_stream;
+    *complement->chrom = '\0';
+    complement->chrom_len = 0;
+    complement->pos = 0;
+    complement->have_chrom = false;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Return the next uncovered interval from a complement prepared by
+ *      bl_bed_complement_init(3).  gap_feature is set to a BED3 feature
+ *      for the interval.  Intervals are returned in genome file order.
+ *      Features extending past the end of a chromosome are clipped.
+ *
+ *  Arguments:
+ *      complement:     Pointer to a bl_bed_complement_t structure
+ *      gap_feature:    Pointer to a bl_bed_t structure to receive the
+ *                      interval
+ *
+ *  Returns:
+ *      BL_READ_OK if an interval was returned,
+ *      BL_READ_EOF if there are no more intervals,
+ *      BL_READ_MISMATCH if the BED input is not sorted or contains a
+ *      chromosome not found in the genome file in the same order,
+ *      BL_READ_TRUNCATED if the genome file is invalid,
+ *      Other BL_READ_* errors from bl_bed_read(3)
+ *
+ *  Examples:
+ *      while ( bl_bed_complement_next(&complement, &gap_feature)
+ *                  == BL_READ_OK )
+ *          bl_bed_write(stdout, &gap_feature, BL_BED_FIELD_ALL);
+ *
+ *  See also:
+ *      bl_bed_complement_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_complement_next(bl_bed_complement_t *complement,
+			       bl_bed_t *gap_feature)
+
+{
+    bl_bed_ops_input_t  *input = &complement->input;
+    bl_bed_t            *next = &input->feature;
+    uint64_t            start;
+    int                 status, cmp;
+    bool                gap;
+
+    if ( !input->primed &&
+	 ((status = bed_ops_lookahead(input, "bl_bed_complement_next"))
+	    != BL_READ_OK) )
+	return status;
+
+    while ( true )
+    {
+	if ( !complement->have_chrom )
+	{
+	    if ( (status = bed_complement_read_genome(complement))
+		    != BL_READ_OK )
+	    {
+		if ( (status == BL_READ_EOF) && input->have_feature )
+		{
+		    fprintf(stderr, "bl_bed_complement_next(): %s is not in "
+			    "the genome file.\n", BL_BED_CHROM(next));
+		    return BL_READ_MISMATCH;
+		}
+		return status;
+	    }
+	    complement->have_chrom = true;
+	    complement->pos = 0;
+	}
+
+	if ( input->have_feature )
+	{
+	    cmp = bed_ops_chrom_cmp(BL_BED_CHROM(next), complement->chrom);
+	    if ( cmp < 0 )
+	    {
+		fprintf(stderr, "bl_bed_complement_next(): %s is not in the "
+			"genome file or is out of order.\n", BL_BED_CHROM(next));
+		return BL_READ_MISMATCH;
+	    }
+	    else if ( cmp == 0 )
+	    {
+		start = MIN(BL_BED_CHROM_START(next), complement->chrom_len);
+		if ( (gap = (start > complement->pos)) )
+		    bed_ops_set_interval(gap_feature, complement->chrom,
+					 complement->pos, start);
+		complement->pos = MAX(complement->pos, BL_BED_CHROM_END(next));
+		if ( (status = bed_ops_lookahead(input,
+			"bl_bed_complement_next")) != BL_READ_OK )
+		    return status;
+		if ( gap )
+		    return BL_READ_OK;
+		continue;
+	    }
+	}
+
+	// No more features on this chromosome
+	complement->have_chrom = false;
+	if ( complement->pos < complement->chrom_len )
+	{
+	    bed_ops_set_interval(gap_feature, complement->chrom,
+				 complement->pos, complement->chrom_len);
+	    return BL_READ_OK;
+	}
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free memory used by a bl_bed_complement_t structure.  The input
+ *      streams are not closed.
+ *
+ *  Arguments:
+ *      complement: Pointer to a bl_bed_complement_t structure
+ *
+ *  See also:
+ *      bl_bed_complement_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_complement_free(bl_bed_complement_t *complement)
+
+{
+    bl_bed_reader_close(&complement->input.reader);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Prepare to subtract the features in one sorted BED stream from
+ *      those in another, as with "bedtools subtract".  Each feature
+ *      from bed_stream1 is returned with the parts covered by any
+ *      feature in bed_stream2 removed, possibly splitting it into
+ *      several pieces.
+ *
+ *      Both inputs must be sorted by chromosome in bl_chrom_name_cmp(3)
+ *      order and by start position within each chromosome.  Features
+ *      from bed_stream2 are merged as they are read, and only those
+ *      that may overlap the current or a later feature from bed_stream1
+ *      are kept, so memory use is bounded by the longest feature in
+ *      bed_stream1 rather than the size of either input.
+ *
+ *  Arguments:
+ *      subtract:       Pointer to the bl_bed_subtract_t structure to
+ *                      initialize
+ *      bed_stream1:    Sorted BED features to subtract from
+ *      bed_stream2:    Sorted BED features to subtract
+ *
+ *  Examples:
+ *      bl_bed_subtract_t   subtract;
+ *      bl_bed_t            bed_feature = BL_BED_INIT;
+ *
+ *      bl_bed_subtract_init(&subtract, targets_stream, blacklist_stream);
+ *      while ( bl_bed_subtract_next(&subtract, &bed_feature) == BL_READ_OK )
+ *          bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+ *      bl_bed_subtract_free(&subtract);
+ *
+ *  See also:
+ *      bl_bed_subtract_next(3), bl_bed_subtract_free(3),
+ *      bl_bed_merge_init(3), bl_bed_complement_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_subtract_init(bl_bed_subtract_t *subtract,
+			     FILE *bed_stream1, FILE *bed_stream2)
+
+{
+    static bl_bed_t bed_init = BL_BED_INIT;
+
+    bed_ops_input_init(&subtract->input1, bed_stream1);
+    bed_ops_input_init(&subtract->input2, bed_stream2);
+    subtract->feature = bed_init;
+    subtract->have_feature = false;
+    subtract->cut = false;
+    subtract->pos = 0;
+    *subtract->window_chrom = '\0';
+    subtract->window = NULL;
+    subtract->window_first = 0;
+    subtract->window_pos = 0;
+    subtract->window_count = 0;
+    subtract->window_max = 0;
+}
+
+
+/* Append an interval to the window, merging it with the last if they meet. */
+
+static void bed_subtract_window_add(bl_bed_subtract_t *subtract,
+				    uint64_t start, uint64_t end)
+
+{
+    bl_bed_ops_interval_t   *last;
+
+    if ( subtract->window_count > subtract->window_first )
+    {
+	last = &subtract->window[subtract->window_count - 1];
+	if ( start <= last->end )
+	{
+	    last->end = MAX(last->end, end);
+	    return;
+	}
+    }
+
+    if ( subtract->window_count == subtract->window_max )
+    {
+	if ( subtract->window_first > 0 )
+	{
+	    // Reclaim space of intervals pruned from the front
+	    subtract->window_count -= subtract->window_first;
+	    memmove(subtract->window, subtract->window + subtract->window_first,
+		    subtract->window_count * sizeof(*subtract->window));
+	    subtract->window_first = 0;
+	}
+	else
+	{
+	    subtract->window_max = subtract->window_max == 0 ? 64 :
+				   subtract->window_max * 2;
+	    if ( (subtract->window = xt_realloc(subtract->window,
+		    subtract->window_max, sizeof(*subtract->window))) == NULL )
+	    {
+		fprintf(stderr, "bl_bed_subtract_next(): Could not allocate window.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	}
+    }
+    subtract->window[subtract->window_count].start = start;
+    subtract->window[subtract->window_count].end = end;
+    ++subtract->window_count;
+}
+
+
+/*
+ *  Drop window intervals that end before the new feature from input1
+ *  and add those from input2 that start before it ends.
+ */
+
+static int  bed_subtract_advance_window(bl_bed_subtract_t *subtract)
+
+{
+    bl_bed_t    *feature = &subtract->feature,
+		*next = &subtract->input2.feature;
+    int         status, cmp;
+
+    if ( strcmp(subtract->window_chrom, BL_BED_CHROM(feature)) != 0 )
+    {
+	strlcpy(subtract->window_chrom, BL_BED_CHROM(feature),
+		BL_CHROM_MAX_CHARS + 1);
+	subtract->window_first = subtract->window_count = 0;
+    }
+    else
+	while ( (subtract->window_first < subtract->window_count) &&
+		(subtract->window[subtract->window_first].end <=
+		    BL_BED_CHROM_START(feature)) )
+	    ++subtract->window_first;
+
+    while ( subtract->input2.have_feature )
+    {
+	cmp = bed_ops_chrom_cmp(BL_BED_CHROM(next), BL_BED_CHROM(feature));
+	if ( (cmp > 0) ||
+	     ((cmp == 0) &&
+	      (BL_BED_CHROM_START(next) >= BL_BED_CHROM_END(feature))) )
+	    break;
+	// Features ending before this one cannot overlap later ones either
+	if ( (cmp == 0) &&
+	     (BL_BED_CHROM_END(next) > BL_BED_CHROM_START(feature)) )
+	    bed_subtract_window_add(subtract, BL_BED_CHROM_START(next),
+				    BL_BED_CHROM_END(next));
+	if ( (status = bed_ops_lookahead(&subtract->input2,
+		"bl_bed_subtract_next")) != BL_READ_OK )
+	    return status;
+    }
+    subtract->window_pos = subtract->window_first;
+    return BL_READ_OK;
+}
+
+
+/* Return a piece of the current feature. */
+
+static void bed_subtract_set_piece(bl_bed_subtract_t *subtract,
+				   bl_bed_t *bed_feature,
+				   uint64_t start, uint64_t end)
+
+{
+    *bed_feature = subtract->feature;
+    BL_BED_SET_CHROM_START(bed_feature, start);
+    BL_BED_SET_CHROM_END(bed_feature, end);
+    // thickStart and blocks no longer apply to a piece
+    if ( subtract->cut )
+    {
+	BL_BED_SET_FIELDS(bed_feature, MIN(BL_BED_FIELDS(bed_feature), 6));
+	BL_BED_SET_BLOCK_COUNT(bed_feature, 0);
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Return the next feature or piece of a feature from a
+ *      subtraction prepared by bl_bed_subtract_init(3).  Features from
+ *      the first input that do not overlap the second are returned
+ *      unchanged.  Features that do are returned as one piece for each
+ *      uncovered part, with all fields copied from the original except
+ *      chromStart and chromEnd.  Since thickStart, thickEnd and blocks
+ *      would no longer be meaningful, pieces have at most 6 fields.
+ *      Features that are completely covered are omitted.
+ *
+ *      Pieces of each feature are returned in order, but since the
+ *      features in the first input may overlap each other, pieces of
+ *      consecutive features may not be sorted relative to each other.
+ *
+ *      Block arrays in bed_feature, if any, point into memory owned by
+ *      the subtract structure and are valid only until the next call.
+ *
+ *  Arguments:
+ *      subtract:       Pointer to a bl_bed_subtract_t structure
+ *      bed_feature:    Pointer to a bl_bed_t structure to receive the
+ *                      feature or piece
+ *
+ *  Returns:
+ *      BL_READ_OK if a feature or piece was returned,
+ *      BL_READ_EOF if there are no more features,
+ *      BL_READ_MISMATCH if either input is not sorted,
+ *      Other BL_READ_* errors from bl_bed_read(3)
+ *
+ *  Examples:
+ *      while ( bl_bed_subtract_next(&subtract, &bed_feature) == BL_READ_OK )
+ *          bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+ *
+ *  See also:
+ *      bl_bed_subtract_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_subtract_next(bl_bed_subtract_t *subtract,
+			     bl_bed_t *bed_feature)
+
+{
+    bl_bed_ops_interval_t   *interval;
+    uint64_t                start, end;
+    int                     status;
+
+    if ( !subtract->input2.primed &&
+	 ((status = bed_ops_lookahead(&subtract->input2,
+		"bl_bed_subtract_next")) != BL_READ_OK) )
+	return status;
+
+    while ( true )
+    {
+	if ( !subtract->have_feature )
+	{
+	    if ( (status = bed_ops_read(&subtract->input1, &subtract->feature,
+		    "bl_bed_subtract_next")) != BL_READ_OK )
+		return status;
+	    subtract->have_feature = true;
+	    subtract->cut = false;
+	    subtract->pos = BL_BED_CHROM_START(&subtract->feature);
+	    if ( (status = bed_subtract_advance_window(subtract))
+		    != BL_READ_OK )
+		return status;
+	}
+
+	end = BL_BED_CHROM_END(&subtract->feature);
+	while ( (subtract->window_pos < subtract->window_count) &&
+		(subtract->window[subtract->window_pos].start < end) )
+	{
+	    interval = &subtract->window[subtract->window_pos++];
+	    if ( interval->end <= subtract->pos )
+		continue;
+	    start = subtract->pos;
+	    subtract->pos = interval->end;
+	    subtract->cut = true;
+	    if ( interval->start > start )
+	    {
+		bed_subtract_set_piece(subtract, bed_feature, start,
+				       interval->start);
+		return BL_READ_OK;
+	    }
+	}
+
+	subtract->have_feature = false;
+	if ( subtract->pos < end )
+	{
+	    bed_subtract_set_piece(subtract, bed_feature, subtract->pos, end);
+	    return BL_READ_OK;
+	}
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed-ops.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free memory used by a bl_bed_subtract_t structure.  The input
+ *      streams are not closed.
+ *
+ *  Arguments:
+ *      subtract:   Pointer to a bl_bed_subtract_t structure
+ *
+ *  See also:
+ *      bl_bed_subtract_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_subtract_free(bl_bed_subtract_t *subtract)
+
+{
+    bl_bed_reader_close(&subtract->input1.reader);
+    bl_bed_reader_close(&subtract->input2.reader);
+    free(subtract->window);
+    subtract->window = NULL;
+    subtract->window_first = subtract->window_pos = 0;
+    subtract->window_count = subtract->window_max = 0;
+}
@@ -0,0 +1,93 @@
+#ifndef _bed_ops_h_
+#define _bed_ops_h_
+
+#ifndef _STDBOOL_H_
+#include <stdbool.h>
+#endif
+
+#ifndef _bed_h_
+#include "bed.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+/*
+ *  A sorted BED input to the streaming set operations.  Features are
+ *  read through a bl_bed_reader_t, so no memory is allocated per
+ *  feature.
+ */
+typedef struct
+{
+    bl_bed_reader_t reader;
+    bl_bed_t        feature;        // Lookahead
+    bool            have_feature;
+    bool            primed;         // First lookahead read attempted
+    uint64_t        features_read;
+    char            last_chrom[BL_CHROM_MAX_CHARS + 1];    // Sort order check
+    uint64_t        last_start;
+}   bl_bed_ops_input_t;
+
+typedef struct
+{
+    uint64_t    start;
+    uint64_t    end;
+}   bl_bed_ops_interval_t;
+
+typedef struct
+{
+    bl_bed_ops_input_t  input;
+    uint64_t            max_gap;        // Merge features this close
+    uint64_t            merged_count;   // Input features in last output
+}   bl_bed_merge_t;
+
+typedef struct
+{
+    bl_bed_ops_input_t  input;
+    FILE                *genome_stream;
+    char                chrom[BL_CHROM_MAX_CHARS + 1];
+    uint64_t            chrom_len;
+    uint64_t            pos;            // Start of next gap
+    bool                have_chrom;
+}   bl_bed_complement_t;
+
+typedef struct
+{
+    bl_bed_ops_input_t      input1;     // Features to subtract from
+    bl_bed_ops_input_t      input2;     // Features to subtract
+
+    bl_bed_t                feature;    // Current feature from input1
+    bool                    have_feature;
+    bool                    cut;        // Part of feature removed
+    uint64_t                pos;        // Start of rest of feature
+
+    /*
+     *  Merged input2 intervals on window_chrom that may overlap the
+     *  current or a later feature from input1, sorted and disjoint.
+     */
+    char                    window_chrom[BL_CHROM_MAX_CHARS + 1];
+    bl_bed_ops_interval_t   *window;
+    size_t                  window_first;
+    size_t                  window_pos;     // Next to test against feature
+    size_t                  window_count;
+    size_t                  window_max;
+}   bl_bed_subtract_t;
+
+/* Not generated by gen-get-set */
+#define BL_BED_MERGE_MERGED_COUNT(ptr)      ((ptr)->merged_count)
+#define BL_BED_COMPLEMENT_CHROM(ptr)        ((ptr)->chrom)
+#define BL_BED_COMPLEMENT_CHROM_LEN(ptr)    ((ptr)->chrom_len)
+
+/* bed-ops.c */
+void bl_bed_merge_init(bl_bed_merge_t *merge, FILE *bed_stream, uint64_t max_gap);
+int bl_bed_merge_next(bl_bed_merge_t *merge, bl_bed_t *merged_feature);
+void bl_bed_merge_free(bl_bed_merge_t *merge);
+void bl_bed_complement_init(bl_bed_complement_t *complement, FILE *bed_stream, FILE *genome_stream);
+int bl_bed_complement_next(bl_bed_complement_t *complement, bl_bed_t *gap_feature);
+void bl_bed_complement_free(bl_bed_complement_t *complement);
+void bl_bed_subtract_init(bl_bed_subtract_t *subtract, FILE *bed_stream1, FILE *bed_stream2);
+int bl_bed_subtract_next(bl_bed_subtract_t *subtract, bl_bed_t *bed_feature);
+void bl_bed_subtract_free(bl_bed_subtract_t *subtract);
+
+#endif  // _bed_ops_h_
@@ -76,61 +76,57 @@ FILE    *bl_bed_skip_header(FILE *bed_stream)
 }
 
 
-/***************************************************************************
- *  Library:
- *      #include <biolibc/bed.h>
- *      -lbiolibc -lxtend
- *
- *  Description:
- *      Read next entry (line) from a BED file.  The line must have at
- *      least the first 3 fields (chrom, start, and end).  It may
- *      have up to 12 fields, all of which must be in the correct order
- *      according to the BED specification.
- *
- *      If field_mask is not BL_BED_FIELD_ALL, fields not indicated by a 1
- *      in the bit mask are discarded rather than stored in bed_feature.
- *      Possible mask values are:
- *
- *      BL_BED_FIELD_ALL
- *      BL_BED_FIELD_NAME
- *      BL_BED_FIELD_SCORE
- *      BL_BED_FIELD_STRAND
- *      BL_BED_FIELD_THICK
- *      BL_BED_FIELD_RGB
- *      BL_BED_FIELD_BLOCK
- *
- *      The chrom, start, and end fields are required and therefore have
- *      no corresponding mask bits. The thickStart and thickEnd fields must
- *      occur together or not at all, so only a single bit BL_BED_FIELD_THICK
- *      selects both of them.  Likewise, blockCount, blockSizes and
- *      blockStarts must all be present or omitted, so BL_BED_FIELD_BLOCK
- *      masks all three.
- *
- *  Arguments:
- *      bed_stream:     A FILE stream from which to read the line
- *      bed_feature:    Pointer to a bl_bed_t structure
- *      field_mask:     Bit mask indicating which fields to store in bed_feature
- *
- *  Returns:
- *      BL_READ_OK on successful read
- *      BL_READ_EOF if EOF is encountered at the start of a line
- *      BL_READ_TRUNCATED if EOF or bad data is encountered elsewhere
- *
- *  Examples:
- *      bl_bed_read(stdin, &bed_feature, BL_BED_FIELD_ALL);
- *      bl_bed_read(bed_stream, &bed_feature,
- *                       BL_BED_FIELD_NAME|BL_BED_FIELD_SCORE);
- *
- *  See also:
- *      bl_bed_write(3)
- *
- *  History: 
- *  Date        Name        Modification
- *  2021-04-05  Jason Bacon Begin
- ***************************************************************************/
+/*
+ *  Carve count values from the reader's arena, moving on to the next
+ *  chunk, or adding one, when the current chunk is full.
+ */
 
-int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
-			 bed_field_mask_t field_mask)
+static uint64_t *bed_arena_alloc(bl_bed_reader_t *reader, size_t count)
+
+{
+    bl_bed_arena_chunk_t    *chunk;
+    size_t                  size;
+    uint64_t                *values;
+
+    while ( (reader->chunk != NULL) &&
+	    (reader->chunk_used + count > reader->chunk->size) &&
+	    (reader->chunk->next != NULL) )
+    {
+	reader->chunk = reader->chunk->next;
+	reader->chunk_used = 0;
+    }
+    if ( (reader->chunk == NULL) ||
+	 (reader->chunk_used + count > reader->chunk->size) )
+    {
+	size = MAX(count, BL_BED_ARENA_CHUNK_VALUES);
+	if ( (chunk = malloc(sizeof(*chunk) + size * sizeof(uint64_t)))
+		== NULL )
+	{
+	    fputs("bl_bed_read(): Cannot allocate block arena.\n", stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+	chunk->next = NULL;
+	chunk->size = size;
+	if ( reader->chunk == NULL )
+	    reader->first_chunk = chunk;
+	else
+	    reader->chunk->next = chunk;
+	reader->chunk = chunk;
+	reader->chunk_used = 0;
+    }
+    values = reader->chunk->values + reader->chunk_used;
+    reader->chunk_used += count;
+    return values;
+}
+
+
+/*
+ *  Parse one BED line.  Block arrays come from the reader's arena if
+ *  reader is not NULL, otherwise they are allocated with xt_malloc().
+ */
+
+static int  bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
+		     bed_field_mask_t field_mask, bl_bed_reader_t *reader)
 
 {
     char    *end,
@@ -148,8 +144,6 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
     unsigned long   block_count;
     unsigned    c;
     
-    // FIXME: Respect field_mask
-    
     // Chromosome
     if ( tsv_read_field(bed_stream, bed_feature->chrom,
 			BL_CHROM_MAX_CHARS, &len) == EOF )
@@ -200,12 +194,27 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
     }
 
     bed_feature->fields = 3;
+    bed_feature->block_count = 0;
+    if ( reader != NULL )
+	bed_feature->block_sizes = bed_feature->block_starts = NULL;
     
+    /*
+     *  Fields not selected by field_mask are skipped without copying or
+     *  conversion and set to the placeholders used by bl_bed_write().
+     */
+
     // Read NAME field if present
     if ( delim != '\n' )
     {
-	if ( (delim = tsv_read_field(bed_stream, bed_feature->name,
-			    BL_BED_NAME_MAX_CHARS, &len)) == EOF )
+	if ( field_mask & BL_BED_FIELD_NAME )
+	    delim = tsv_read_field(bed_stream, bed_feature->name,
+				   BL_BED_NAME_MAX_CHARS, &len);
+	else
+	{
+	    delim = tsv_skip_field(bed_stream);
+	    *bed_feature->name = '\0';
+	}
+	if ( delim == EOF )
 	{
 	    fprintf(stderr, "bl_bed_read(): Got EOF reading name: %s.\n",
 		    bed_feature->name);
@@ -217,14 +226,17 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
     // Read SCORE if present
     if ( delim != '\n' )
     {
-	if ( (delim = tsv_read_field(bed_stream, score_str,
-			    BL_POSITION_MAX_DIGITS, &len)) == EOF )
+	if ( field_mask & BL_BED_FIELD_SCORE )
+	    delim = tsv_read_field(bed_stream, score_str,
+				   BL_BED_SCORE_MAX_DIGITS, &len);
+	else
+	    delim = tsv_skip_field(bed_stream);
+	if ( delim == EOF )
 	{
-	    fprintf(stderr, "bl_bed_read(): Got EOF reading score: %s.\n",
-		    score_str);
+	    fputs("bl_bed_read(): Got EOF reading score.\n", stderr);
 	    return BL_READ_TRUNCATED;
 	}
-	else
+	if ( field_mask & BL_BED_FIELD_SCORE )
 	{
 	    bed_feature->score = strtoul(score_str, &end, 10);
 	    if ( (*end != '\0') || (bed_feature->score > 1000) )
@@ -235,42 +247,55 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
 		return BL_READ_TRUNCATED;
 	    }
 	}
+	else
+	    bed_feature->score = 0;
 	++bed_feature->fields;
     }
     
     // Read strand if present
     if ( delim != '\n' )
     {
-	if ( (delim = tsv_read_field(bed_stream, strand,
-			    BL_BED_STRAND_MAX_CHARS, &len)) == EOF )
+	if ( field_mask & BL_BED_FIELD_STRAND )
+	    delim = tsv_read_field(bed_stream, strand,
+				   BL_BED_STRAND_MAX_CHARS, &len);
+	else
+	    delim = tsv_skip_field(bed_stream);
+	if ( delim == EOF )
 	{
 	    fprintf(stderr, "bl_bed_read(): Got EOF reading strand: %s.\n",
 		    bed_feature->name);
 	    return BL_READ_TRUNCATED;
 	}
-	if ( (len != 1) || ((*strand != '+') && (*strand != '-') && (*strand != '.')) )
+	if ( field_mask & BL_BED_FIELD_STRAND )
 	{
-	    fprintf(stderr, "bl_bed_read(): Strand must be + or - or .: %s\n",
-		    strand);
-	    return BL_READ_TRUNCATED;
+	    if ( (len != 1) || ((*strand != '+') && (*strand != '-') && (*strand != '.')) )
+	    {
+		fprintf(stderr, "bl_bed_read(): Strand must be + or - or .: %s\n",
+			strand);
+		return BL_READ_TRUNCATED;
+	    }
+	    bed_feature->strand = *strand;
 	}
-	bed_feature->strand = *strand;
+	else
+	    bed_feature->strand = '.';
 	++bed_feature->fields;
     }
     
     // Read thick start position if present
     // Must be followed by thick end position, > or < for + or - strand
-    // Feature start position
     if ( delim != '\n' )
     {
-	if ( tsv_read_field(bed_stream, thick_start_str,
-			    BL_POSITION_MAX_DIGITS, &len) == EOF )
+	if ( field_mask & BL_BED_FIELD_THICK )
+	    delim = tsv_read_field(bed_stream, thick_start_str,
+				   BL_POSITION_MAX_DIGITS, &len);
+	else
+	    delim = tsv_skip_field(bed_stream);
+	if ( delim == EOF )
 	{
-	    fprintf(stderr, "bl_bed_read(): Got EOF reading thick start "
-		    "POS: %s.\n", thick_start_str);
+	    fputs("bl_bed_read(): Got EOF reading thick start POS.\n", stderr);
 	    return BL_READ_TRUNCATED;
 	}
-	else
+	else if ( field_mask & BL_BED_FIELD_THICK )
 	{
 	    bed_feature->thick_start =
 		strtoul(thick_start_str, &end, 10);
@@ -289,14 +314,17 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
 	    return BL_READ_TRUNCATED;
 	}
     
-	if ( tsv_read_field(bed_stream, thick_end_str,
-			    BL_POSITION_MAX_DIGITS, &len) == EOF )
+	if ( field_mask & BL_BED_FIELD_THICK )
+	    delim = tsv_read_field(bed_stream, thick_end_str,
+				   BL_POSITION_MAX_DIGITS, &len);
+	else
+	    delim = tsv_skip_field(bed_stream);
+	if ( delim == EOF )
 	{
-	    fprintf(stderr, "bl_bed_read(): Got EOF reading thick end "
-		    "POS: %s.\n", thick_end_str);
+	    fputs("bl_bed_read(): Got EOF reading thick end POS.\n", stderr);
 	    return BL_READ_TRUNCATED;
 	}
-	else
+	else if ( field_mask & BL_BED_FIELD_THICK )
 	{
 	    bed_feature->thick_end =
 		strtoul(thick_end_str, &end, 10);
@@ -308,14 +336,26 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
 		return BL_READ_TRUNCATED;
 	    }
 	}
+	else
+	{
+	    bed_feature->thick_start = bed_feature->chrom_start;
+	    bed_feature->thick_end = bed_feature->chrom_end;
+	}
 	bed_feature->fields += 2;
     }
 
     // Read RGB string field if present
     if ( delim != '\n' )
     {
-	if ( (delim = tsv_read_field(bed_stream, bed_feature->item_rgb,
-			    BL_BED_ITEM_RGB_MAX_CHARS, &len)) == EOF )
+	if ( field_mask & BL_BED_FIELD_RGB )
+	    delim = tsv_read_field(bed_stream, bed_feature->item_rgb,
+				   BL_BED_ITEM_RGB_MAX_CHARS, &len);
+	else
+	{
+	    delim = tsv_skip_field(bed_stream);
+	    strlcpy(bed_feature->item_rgb, "0", BL_BED_ITEM_RGB_MAX_CHARS + 1);
+	}
+	if ( delim == EOF )
 	{
 	    fprintf(stderr, "bl_bed_read(): Got EOF reading RGB: %s.\n",
 		    bed_feature->name);
@@ -329,13 +369,26 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
      *  Must be followed by comma-separated list of sizes
      *  and comma-separated list of start positions
      */
-    if ( delim != '\n' )
+    if ( (delim != '\n') && !(field_mask & BL_BED_FIELD_BLOCK) )
+    {
+	// Skip count, sizes, and starts, leaving block_count 0
+	if ( ((delim = tsv_skip_field(bed_stream)) != '\t') ||
+	     ((delim = tsv_skip_field(bed_stream)) != '\t') ||
+	     ((delim = tsv_skip_field(bed_stream)) == EOF) )
+	{
+	    fputs("bl_bed_read(): Incomplete block count, sizes, and starts.\n",
+		  stderr);
+	    return BL_READ_TRUNCATED;
+	}
+	bed_feature->fields += 3;
+    }
+    else if ( delim != '\n' )
     {
 	if ( (delim = tsv_read_field(bed_stream, block_count_str,
 			    BL_BED_BLOCK_COUNT_MAX_DIGITS, &len)) == EOF )
 	{
 	    fprintf(stderr, "bl_bed_read(): Got EOF reading block count: %s.\n",
-		    score_str);
+		    block_count_str);
 	    return BL_READ_TRUNCATED;
 	}
 	else
@@ -345,24 +398,35 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
 	    {
 		fprintf(stderr,
 			"bl_bed_read(): Invalid block count: %s\n",
-			score_str);
+			block_count_str);
 		return BL_READ_TRUNCATED;
 	    }
 	    bed_feature->block_count = block_count;
 	}
-	bed_feature->block_sizes = xt_malloc(bed_feature->block_count,
-					sizeof(*bed_feature->block_sizes));
-	if ( bed_feature->block_sizes == NULL )
+	if ( reader != NULL )
 	{
-	    fputs("bl_bed_read(): Cannot allocate block_sizes.\n", stderr);
-	    exit(EX_UNAVAILABLE);
+	    // Sizes and starts are adjacent in one arena allocation
+	    bed_feature->block_sizes = bed_arena_alloc(reader,
+					2 * bed_feature->block_count);
+	    bed_feature->block_starts = bed_feature->block_sizes +
+					bed_feature->block_count;
 	}
-	bed_feature->block_starts = xt_malloc(bed_feature->block_count,
-					sizeof(*bed_feature->block_starts));
-	if ( bed_feature->block_starts == NULL )
+	else
 	{
-	    fputs("bl_bed_read(): Cannot allocate block_starts.\n", stderr);
-	    exit(EX_UNAVAILABLE);
+	    bed_feature->block_sizes = xt_malloc(bed_feature->block_count,
+					    sizeof(*bed_feature->block_sizes));
+	    if ( bed_feature->block_sizes == NULL )
+	    {
+		fputs("bl_bed_read(): Cannot allocate block_sizes.\n", stderr);
+		exit(EX_UNAVAILABLE);
+	    }
+	    bed_feature->block_starts = xt_malloc(bed_feature->block_count,
+					    sizeof(*bed_feature->block_starts));
+	    if ( bed_feature->block_starts == NULL )
+	    {
+		fputs("bl_bed_read(): Cannot allocate block_starts.\n", stderr);
+		exit(EX_UNAVAILABLE);
+	    }
 	}
 	if ( delim == '\n' )
 	{
@@ -376,6 +440,16 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
 	{
 	    delim = dsv_read_field(bed_stream, block_size_str,
 			    BL_BED_BLOCK_SIZE_MAX_DIGITS, ",\t", &len);
+	    // UCSC tools write a comma after the last value
+	    if ( (len == 0) && (delim != ',') && (c > 0) )
+		break;
+	    // Extra values would overrun the array
+	    if ( c == bed_feature->block_count )
+	    {
+		fprintf(stderr, "bl_bed_read(): More than %u sizes.\n",
+			bed_feature->block_count);
+		return BL_READ_MISMATCH;
+	    }
 	    bed_feature->block_sizes[c++] = strtoul(block_size_str, &end, 10);
 	    //fprintf(stderr, "Block size[%u] = %s\n", c-1, block_size_str);
 	    if ( *end != '\0' )
@@ -403,6 +477,15 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
 	{
 	    delim = dsv_read_field(bed_stream, block_start_str,
 			    BL_BED_BLOCK_START_MAX_DIGITS, ",\t", &len);
+	    if ( (len == 0) && (delim != ',') && (c > 0) )
+		break;
+	    // Extra values would overrun the array
+	    if ( c == bed_feature->block_count )
+	    {
+		fprintf(stderr, "bl_bed_read(): More than %u starts.\n",
+			bed_feature->block_count);
+		return BL_READ_MISMATCH;
+	    }
 	    bed_feature->block_starts[c++] = strtoul(block_start_str, &end, 10);
 	    //fprintf(stderr, "Block start[%u] = %s\n", c-1, block_start_str);
 	    if ( *end != '\0' )
@@ -414,7 +497,7 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
 	}   while ( delim == ',' );
 	if ( c != bed_feature->block_count )
 	{
-	    fprintf(stderr, "bl_bed_read(): Block count = %u  Sizes = %u\n",
+	    fprintf(stderr, "bl_bed_read(): Block count = %u  Starts = %u\n",
 		    bed_feature->block_count, c);
 	    return BL_READ_MISMATCH;
 	}
@@ -436,6 +519,365 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
 }
 
 
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Read next entry (line) from a BED file.  The line must have at
+ *      least the first 3 fields (chrom, start, and end).  It may
+ *      have up to 12 fields, all of which must be in the correct order
+ *      according to the BED specification.
+ *
+ *      If field_mask is not BL_BED_FIELD_ALL, fields not indicated by a 1
+ *      in the bit mask are discarded rather than stored in bed_feature.
+ *      Discarded fields are skipped without conversion or allocation,
+ *      and set to the same markers written by bl_bed_write(3): an empty
+ *      name, score 0, strand '.', thick start and end equal to start and
+ *      end, RGB "0", and a block count of 0.
+ *      Possible mask values are:
+ *
+ *      BL_BED_FIELD_ALL
+ *      BL_BED_FIELD_NAME
+ *      BL_BED_FIELD_SCORE
+ *      BL_BED_FIELD_STRAND
+ *      BL_BED_FIELD_THICK
+ *      BL_BED_FIELD_RGB
+ *      BL_BED_FIELD_BLOCK
+ *
+ *      The chrom, start, and end fields are required and therefore have
+ *      no corresponding mask bits. The thickStart and thickEnd fields must
+ *      occur together or not at all, so only a single bit BL_BED_FIELD_THICK
+ *      selects both of them.  Likewise, blockCount, blockSizes and
+ *      blockStarts must all be present or omitted, so BL_BED_FIELD_BLOCK
+ *      masks all three.
+ *
+ *  Arguments:
+ *      bed_stream:     A FILE stream from which to read the line
+ *      bed_feature:    Pointer to a bl_bed_t structure
+ *      field_mask:     Bit mask indicating which fields to store in bed_feature
+ *
+ *  Returns:
+ *      BL_READ_OK on successful read
+ *      BL_READ_EOF if EOF is encountered at the start of a line
+ *      BL_READ_TRUNCATED if EOF or bad data is encountered elsewhere
+ *
+ *  Examples:
+ *      bl_bed_read(stdin, &bed_feature, BL_BED_FIELD_ALL);
+ *      bl_bed_read(bed_stream, &bed_feature,
+ *                       BL_BED_FIELD_NAME|BL_BED_FIELD_SCORE);
+ *
+ *  See also:
+ *      bl_bed_write(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2021-04-05  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
+			 bed_field_mask_t field_mask)
+
+{
+    return bed_read(bed_stream, bed_feature, field_mask, NULL);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free the block arrays allocated by bl_bed_read(3) for a BED12
+ *      feature and reset the block count.  Not to be used on features
+ *      read with bl_bed_reader_read(3), whose blocks belong to the
+ *      reader's arena.
+ *
+ *  Arguments:
+ *      bed_feature:    Pointer to a bl_bed_t structure
+ *
+ *  Examples:
+ *      bl_bed_t    bed_feature = BL_BED_INIT;
+ *
+ *      while ( bl_bed_read(stdin, &bed_feature, BL_BED_FIELD_ALL)
+ *                  == BL_READ_OK )
+ *      {
+ *          bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+ *          bl_bed_free(&bed_feature);
+ *      }
+ *
+ *  See also:
+ *      bl_bed_read(3), bl_bed_reader_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_free(bl_bed_t *bed_feature)
+
+{
+    free(bed_feature->block_sizes);
+    free(bed_feature->block_starts);
+    bed_feature->block_sizes = bed_feature->block_starts = NULL;
+    bed_feature->block_count = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a BED reader context for an open stream.  Features
+ *      read with bl_bed_reader_read(3) get their block_sizes and
+ *      block_starts arrays from an arena owned by the reader rather
+ *      than from a separate malloc() per feature, and the arena memory
+ *      is reused, so reading BED12 files neither allocates per line
+ *      nor leaks.
+ *
+ *      By default, the arena is reclaimed at the start of each read,
+ *      so block arrays are valid only until the next read, which is
+ *      all that a filter processing one feature at a time needs.  If
+ *      flags includes BL_BED_READER_KEEP_BLOCKS, block arrays remain
+ *      valid until bl_bed_reader_reset(3) or bl_bed_reader_close(3),
+ *      so features can be collected in an array and processed
+ *      together.
+ *
+ *      See bl_bed_read(3) for field_mask values.
+ *
+ *  Arguments:
+ *      reader:         Pointer to the bl_bed_reader_t structure to initialize
+ *      bed_stream:     Open FILE stream positioned at the first feature
+ *      field_mask:     Bit mask indicating which fields to store
+ *      flags:          0 or BL_BED_READER_KEEP_BLOCKS
+ *
+ *  Examples:
+ *      bl_bed_reader_t reader;
+ *      bl_bed_t        bed_feature = BL_BED_INIT;
+ *
+ *      bl_bed_reader_init(&reader, stdin, BL_BED_FIELD_ALL, 0);
+ *      while ( bl_bed_reader_read(&reader, &bed_feature) == BL_READ_OK )
+ *          bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+ *      bl_bed_reader_close(&reader);
+ *
+ *  See also:
+ *      bl_bed_reader_read(3), bl_bed_reader_reset(3),
+ *      bl_bed_reader_close(3), bl_bed_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_reader_init(bl_bed_reader_t *reader, FILE *bed_stream,
+			   bed_field_mask_t field_mask, int flags)
+
+{
+    reader->stream = bed_stream;
+    reader->field_mask = field_mask;
+    reader->flags = flags;
+    reader->first_chunk = NULL;
+    reader->chunk = NULL;
+    reader->chunk_used = 0;
+    reader->features_read = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Read the next feature from a BED reader's stream, as with
+ *      bl_bed_read(3), but with block arrays taken from the reader's
+ *      arena.  The block arrays must not be freed by the caller and
+ *      bl_bed_free(3) must not be used on the feature.
+ *
+ *  Arguments:
+ *      reader:         Pointer to a bl_bed_reader_t initialized by
+ *                      bl_bed_reader_init(3)
+ *      bed_feature:    Pointer to a bl_bed_t structure
+ *
+ *  Returns:
+ *      Same as bl_bed_read(3)
+ *
+ *  Examples:
+ *      while ( bl_bed_reader_read(&reader, &bed_feature) == BL_READ_OK )
+ *          ...
+ *
+ *  See also:
+ *      bl_bed_reader_init(3), bl_bed_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_reader_read(bl_bed_reader_t *reader, bl_bed_t *bed_feature)
+
+{
+    int     status;
+
+    if ( !(reader->flags & BL_BED_READER_KEEP_BLOCKS) )
+	bl_bed_reader_reset(reader);
+    status = bed_read(reader->stream, bed_feature, reader->field_mask,
+		      reader);
+    if ( status == BL_READ_OK )
+	++reader->features_read;
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Reclaim all block arrays carved from a BED reader's arena,
+ *      keeping the memory for reuse by subsequent reads.  Block arrays
+ *      of features read before the reset, including those returned by
+ *      bl_bed_reader_blocks32(3), are no longer valid.  This is done
+ *      automatically before each read unless the reader was initialized
+ *      with BL_BED_READER_KEEP_BLOCKS.
+ *
+ *  Arguments:
+ *      reader: Pointer to a bl_bed_reader_t structure
+ *
+ *  Examples:
+ *      // Process features one chromosome at a time
+ *      bl_bed_reader_init(&reader, stdin, BL_BED_FIELD_ALL,
+ *                         BL_BED_READER_KEEP_BLOCKS);
+ *      ...
+ *      process_chrom(features, count);
+ *      count = 0;
+ *      bl_bed_reader_reset(&reader);
+ *
+ *  See also:
+ *      bl_bed_reader_init(3), bl_bed_reader_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_reader_reset(bl_bed_reader_t *reader)
+
+{
+    reader->chunk = reader->first_chunk;
+    reader->chunk_used = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Get copies of the block sizes and starts of a BED feature as
+ *      32-bit values, allocated from a BED reader's arena.  Block starts
+ *      are relative to chromStart, so 32 bits suffice for any real
+ *      transcript, and the compact arrays halve the memory and cache
+ *      footprint for code that keeps many features or scans their
+ *      blocks repeatedly.  The arrays have the same lifetime as block
+ *      arrays read by the reader.
+ *
+ *  Arguments:
+ *      reader:         Pointer to a bl_bed_reader_t structure
+ *      bed_feature:    Pointer to a bl_bed_t structure with blocks
+ *      block_sizes:    Address of a pointer to receive the sizes
+ *      block_starts:   Address of a pointer to receive the starts
+ *
+ *  Returns:
+ *      BL_DATA_OK on success, or BL_DATA_OUT_OF_RANGE if a size or
+ *      start does not fit in 32 bits, in which case the pointers are
+ *      set to NULL
+ *
+ *  Examples:
+ *      uint32_t    *sizes, *starts;
+ *
+ *      if ( bl_bed_reader_blocks32(&reader, &bed_feature, &sizes, &starts)
+ *              == BL_DATA_OK )
+ *          for (c = 0; c < BL_BED_BLOCK_COUNT(&bed_feature); ++c)
+ *              exon_bases += sizes[c];
+ *
+ *  See also:
+ *      bl_bed_reader_read(3), bl_bed_reader_reset(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_bed_reader_blocks32(bl_bed_reader_t *reader, bl_bed_t *bed_feature,
+			       uint32_t **block_sizes, uint32_t **block_starts)
+
+{
+    size_t      c, count = bed_feature->block_count;
+    uint32_t    *values;
+
+    *block_sizes = *block_starts = NULL;
+    for (c = 0; c < count; ++c)
+	if ( (bed_feature->block_sizes[c] > UINT32_MAX) ||
+	     (bed_feature->block_starts[c] > UINT32_MAX) )
+	    return BL_DATA_OUT_OF_RANGE;
+
+    // Two uint32_t per arena value
+    values = (uint32_t *)bed_arena_alloc(reader, count);
+    for (c = 0; c < count; ++c)
+    {
+	values[c] = bed_feature->block_sizes[c];
+	values[count + c] = bed_feature->block_starts[c];
+    }
+    *block_sizes = values;
+    *block_starts = values + count;
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/bed.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free the arena of a BED reader.  The stream is not closed.
+ *
+ *  Arguments:
+ *      reader: Pointer to a bl_bed_reader_t structure
+ *
+ *  Examples:
+ *      bl_bed_reader_close(&reader);
+ *
+ *  See also:
+ *      bl_bed_reader_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_bed_reader_close(bl_bed_reader_t *reader)
+
+{
+    bl_bed_arena_chunk_t    *chunk, *next;
+
+    for (chunk = reader->first_chunk; chunk != NULL; chunk = next)
+    {
+	next = chunk->next;
+	free(chunk);
+    }
+    reader->first_chunk = reader->chunk = NULL;
+    reader->chunk_used = 0;
+}
+
+
 /***************************************************************************
  *  Library:
  *      #include <biolibc/bed.h>
@@ -448,7 +890,10 @@ int     bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature,
  *
  *      If field_mask is not BL_BED_FIELD_ALL, fields not indicated by a 1
  *      in the bit mask are written as an appropriate marker for that field,
- *      such as a '.', rather than writing the real data.
+ *      such as a '.', rather than writing the real data.  Since BED
+ *      columns are positional, markers are written only when needed to
+ *      place a later selected field, and trailing unselected fields are
+ *      omitted.  An empty name is written as '.'.
  *      Possible mask values are:
  *
  *      BL_BED_FIELD_NAME
@@ -491,25 +936,56 @@ int     bl_bed_write(FILE *bed_stream, bl_bed_t *bed_feature,
 				bed_field_mask_t field_mask)
 
 {
-    unsigned    c;
+    unsigned    c, last, fields = bed_feature->fields;
+    
+    /*
+     *  Columns are positional, so an unselected field is written as a
+     *  marker if a later selected field is written.  Block columns are
+     *  omitted if there are no blocks, e.g. when read with the block
+     *  fields masked out.
+     */
+    if ( (fields > 9) && (field_mask & BL_BED_FIELD_BLOCK) &&
+	 (bed_feature->block_count > 0) )
+	last = 12;
+    else if ( (fields > 8) && (field_mask & BL_BED_FIELD_RGB) )
+	last = 9;
+    else if ( (fields > 6) && (field_mask & BL_BED_FIELD_THICK) )
+	last = 8;
+    else if ( (fields > 5) && (field_mask & BL_BED_FIELD_STRAND) )
+	last = 6;
+    else if ( (fields > 4) && (field_mask & BL_BED_FIELD_SCORE) )
+	last = 5;
+    else if ( (fields > 3) && (field_mask & BL_BED_FIELD_NAME) )
+	last = 4;
+    else
+	last = 3;
     
-    // FIXME: Respect field_mask
     // FIXME: Check fprintf() return codes
     fprintf(bed_stream, "%s\t%" PRIu64 "\t%" PRIu64,
 	    bed_feature->chrom,
 	    bed_feature->chrom_start, bed_feature->chrom_end);
-    if ( bed_feature->fields > 3 )
-	fprintf(bed_stream, "\t%s", bed_feature->name);
-    if ( bed_feature->fields > 4 )
-	fprintf(bed_stream, "\t%u", bed_feature->score);
-    if ( bed_feature->fields > 5 )
-	fprintf(bed_stream, "\t%c", bed_feature->strand);
-    if ( bed_feature->fields > 6 )
-	fprintf(bed_stream, "\t%" PRIu64 "\t%" PRIu64,
-		bed_feature->thick_start, bed_feature->thick_end);
-    if ( bed_feature->fields > 8 )
-	fprintf(bed_stream, "\t%s", bed_feature->item_rgb);
-    if ( bed_feature->fields > 9 )
+    if ( last > 3 )
+	fprintf(bed_stream, "\t%s", (field_mask & BL_BED_FIELD_NAME) &&
+		(*bed_feature->name != '\0') ? bed_feature->name : ".");
+    if ( last > 4 )
+	fprintf(bed_stream, "\t%u", field_mask & BL_BED_FIELD_SCORE ?
+		bed_feature->score : 0);
+    if ( last > 5 )
+	fprintf(bed_stream, "\t%c", field_mask & BL_BED_FIELD_STRAND ?
+		bed_feature->strand : '.');
+    if ( last > 6 )
+    {
+	if ( field_mask & BL_BED_FIELD_THICK )
+	    fprintf(bed_stream, "\t%" PRIu64 "\t%" PRIu64,
+		    bed_feature->thick_start, bed_feature->thick_end);
+	else
+	    fprintf(bed_stream, "\t%" PRIu64 "\t%" PRIu64,
+		    bed_feature->chrom_start, bed_feature->chrom_end);
+    }
+    if ( last > 8 )
+	fprintf(bed_stream, "\t%s", field_mask & BL_BED_FIELD_RGB ?
+		bed_feature->item_rgb : "0");
+    if ( last > 9 )
     {
 	fprintf(bed_stream, "\t%u\t", bed_feature->block_count);
 	for (c = 0; c < bed_feature->block_count - 1; ++c)
@@ -56,6 +56,37 @@ typedef unsigned int            bed_field_mask_t;
 #define BL_BED_FIELD_BLOCK     0x20
 #define BL_BED_FIELD_ALL       0xff
 
+// Values per arena chunk, enough for thousands of BED12 transcripts
+#define BL_BED_ARENA_CHUNK_VALUES   65536
+
+// bl_bed_reader_init() flags
+#define BL_BED_READER_KEEP_BLOCKS   0x01    // Keep blocks until reset
+
+typedef struct bl_bed_arena_chunk
+{
+    struct bl_bed_arena_chunk   *next;
+    size_t                      size;       // Capacity in values
+    uint64_t                    values[];
+}   bl_bed_arena_chunk_t;
+
+/*
+ *  BED stream reader context.  Block arrays are carved from a list of
+ *  arena chunks owned by the reader instead of being allocated for
+ *  each feature.  Chunks are reused after bl_bed_reader_reset(), or on
+ *  every read unless BL_BED_READER_KEEP_BLOCKS is set, so reading a
+ *  BED12 file needs no allocation once the arena has grown to fit.
+ */
+typedef struct
+{
+    FILE                    *stream;
+    bed_field_mask_t        field_mask;
+    int                     flags;
+    bl_bed_arena_chunk_t    *first_chunk;
+    bl_bed_arena_chunk_t    *chunk;         // Chunk being carved
+    size_t                  chunk_used;     // Values used in chunk
+    uint64_t                features_read;
+}   bl_bed_reader_t;
+
 /*
  *  Generated by /home/bacon/scripts/gen-get-set
  *
@@ -83,6 +114,11 @@ typedef unsigned int            bed_field_mask_t;
 #define BL_BED_BLOCK_STARTS(ptr)        ((ptr)->block_starts)
 #define BL_BED_FIELDS(ptr)              ((ptr)->fields)
 
+/* Not generated by gen-get-set */
+#define BL_BED_READER_STREAM(ptr)           ((ptr)->stream)
+#define BL_BED_READER_FIELD_MASK(ptr)       ((ptr)->field_mask)
+#define BL_BED_READER_FEATURES_READ(ptr)    ((ptr)->features_read)
+
 /*
  *  Generated by /home/bacon/scripts/gen-get-set
  *
@@ -125,7 +161,7 @@ typedef unsigned int            bed_field_mask_t;
 #include "gff.h"
 #endif
 
-#ifndef _bl_overlap_h
+#ifndef _bl_overlap_h_
 #include "overlap.h"
 #endif
 
@@ -135,6 +171,12 @@ int bl_bed_read(FILE *bed_stream, bl_bed_t *bed_feature, bed_field_mask_t field_
 int bl_bed_write(FILE *bed_stream, bl_bed_t *bed_feature, bed_field_mask_t field_mask);
 void bl_bed_check_order(bl_bed_t *bed_feature, char last_chrom[], uint64_t last_start);
 int bl_bed_gff_cmp(bl_bed_t *bed_feature, bl_gff_t *gff_feature, bl_overlap_t *overlap);
+void bl_bed_free(bl_bed_t *bed_feature);
+void bl_bed_reader_init(bl_bed_reader_t *reader, FILE *bed_stream, bed_field_mask_t field_mask, int flags);
+int bl_bed_reader_read(bl_bed_reader_t *reader, bl_bed_t *bed_feature);
+void bl_bed_reader_reset(bl_bed_reader_t *reader);
+int bl_bed_reader_blocks32(bl_bed_reader_t *reader, bl_bed_t *bed_feature, uint32_t **block_sizes, uint32_t **block_starts);
+void bl_bed_reader_close(bl_bed_reader_t *reader);
 
 /* bed-mutators.c */
 int bl_bed_set_chrom_ae(bl_bed_t *bl_bed_ptr, size_t c, char new_chrom_element);
@@ -1,6 +1,20 @@
 #ifndef _biostring_h_
 #define _biostring_h_
 
+#ifndef _STDINT_H_
+#include <stdint.h>
+#endif
+
+#ifndef _STDDEF_H_
+#include <stddef.h>
+#endif
+
+#define BL_U64_MAX_DIGITS   20  // 18446744073709551615
+
 int     bl_chrom_name_cmp(const char *n1, const char *n2);
 
+/* int-to-str.c */
+size_t bl_u64_to_str(char *dest, uint64_t val);
+size_t bl_i64_to_str(char *dest, int64_t val);
+
 #endif  // _biostring_h_
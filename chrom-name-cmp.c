@@ -3,6 +3,8 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <string.h>
+#include <stdbool.h>
 #include "biolibc.h"
 
 /***************************************************************************
@@ -17,7 +19,11 @@
  *      Characters that follow must be a chrom number or letter.
  *      Numbers are considered less than letters (e.g. 22 < X).  As such,
  *      if either is a letter, they are compared lexically.  If both are
- *      numbers, they are converted to integers and compared numerically.
+ *      numbers, they are converted to integers and compared numerically,
+ *      and comparison continues with any characters following the
+ *      numbers, so names of unplaced contigs such as chr1_KI270706v1_random
+ *      are ordered as well.  The order is total and consistent, as
+ *      required for sorting.
  *
  *      Use bl_chrom_name_cmp() only if you need to know which string is
  *      < or >.  If only checking for equality/inequality, strcmp() will be
@@ -37,45 +43,55 @@
  *  History: 
  *  Date        Name        Modification
  *  2020-05-07  Jason Bacon Begin
+ *  2026-10-18  Jason Bacon Compare past numbers instead of exiting
  ***************************************************************************/
 
 int     bl_chrom_name_cmp(const char *name1, const char *name2)
 
 {
-    const char      *p1 = name1, *p2 = name2;
-    char            *end;
+    const char      *p1 = name1, *p2 = name2,
+		    *start1 = name1, *start2 = name2;
+    char            *end1, *end2;
     unsigned long   c1, c2;
 
-    /* Skip identical portions of strings, e.g. "chr" prefix */
-    while ( (*p1 == *p2) && (*p1 != '\0') )
-	++p1, ++p2;
-    
-    /*
-     *  Next should be a number or letter ID such as X or Y.  If either
-     *  ID is not a number, simply compare lexically.
-     *  ISO character order will take care of it since letters come after
-     *  digits (chrX > chr22) and everything comes after null
-     *  (chr22 > chr2).  This also handles the case where the names are
-     *  the same (both *p1 and *p2 are '\0') or we reached the end of one
-     *  of them (chr2, chr22).
-     */
-    if ( !isdigit(*p1) || !isdigit(*p2) )
-	return *p1 - *p2;
-
-    /* Both IDs are numeric, so perform an integer compare */
-    c1 = strtoul(p1, &end, 10);
-    if ( *end != '\0' )
-    {
-	fprintf(stderr,
-		"bl_chrom_name_cmp(): Invalid chrom ID: %s\n", name1);
-	exit(EX_DATAERR);
-    }
-    c2 = strtoul(p2, &end, 10);
-    if ( *end != '\0' )
+    while ( true )
     {
-	fprintf(stderr,
-		"bl_chrom_name_cmp(): Invalid chrom ID: %s\n", name2);
-	exit(EX_DATAERR);
+	/* Skip identical portions of strings, e.g. "chr" prefix */
+	while ( (*p1 == *p2) && (*p1 != '\0') )
+	    ++p1, ++p2;
+	
+	/*
+	 *  If the names differ within a number, back up to its first
+	 *  digit, so that chr10 is compared to chr2 as 10 vs 2 rather
+	 *  than 0 vs nothing.
+	 */
+	if ( isdigit(*p1) || isdigit(*p2) )
+	    while ( (p1 > start1) && (p2 > start2) && isdigit(p1[-1]) )
+		--p1, --p2;
+	
+	/*
+	 *  Next should be a number or letter ID such as X or Y.  If either
+	 *  ID is not a number, simply compare lexically.
+	 *  ISO character order will take care of it since letters come after
+	 *  digits (chrX > chr22) and everything comes after null.
+	 */
+	if ( !isdigit(*p1) || !isdigit(*p2) )
+	{
+	    if ( *p1 != *p2 )
+		return (unsigned char)*p1 - (unsigned char)*p2;
+	    // Equal apart from leading zeros: keep the order total
+	    return strcmp(name1, name2);
+	}
+	
+	/*
+	 *  Both IDs are numeric, so perform an integer compare.  If equal,
+	 *  continue with what follows, e.g. the rest of chr1_KI270706v1.
+	 */
+	c1 = strtoul(p1, &end1, 10);
+	c2 = strtoul(p2, &end2, 10);
+	if ( c1 != c2 )
+	    return c1 < c2 ? -1 : 1;
+	p1 = start1 = end1;
+	p2 = start2 = end2;
     }
-    return c1 - c2;
 }
@@ -0,0 +1,733 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <sysexits.h>
+#include <sys/types.h>  // ssize_t
+#include <sys/param.h>  // MAX()
+#include <xtend.h>
+#include "feature-sort.h"
+#include "biostring.h"
+#include "biolibc.h"
+
+// Fewer keys than this per thread are not worth a thread
+#define FEATURE_SORT_MIN_SLICE  16384
+
+// Key as stored in run files, followed by the text of the line
+typedef struct
+{
+    uint64_t    start;
+    uint64_t    end;
+    uint32_t    contig;
+    uint32_t    len;
+}   feature_sort_record_t;
+
+// One slice of the current run, sorted by a worker thread
+typedef struct
+{
+    bl_feature_sort_key_t   *keys;
+    size_t                  count;
+}   feature_sort_slice_t;
+
+// Sort a contig table copy by name for ranking
+typedef struct
+{
+    const char  *name;
+    uint32_t    id;
+}   feature_sort_contig_t;
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/feature-sort.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a memory-bounded sort of BED or GFF features by
+ *      chrom, start, and end, with chroms in bl_chrom_name_cmp(3) order
+ *      and features with equal keys in input order.
+ *
+ *      Features are added with bl_feature_sort_add_stream(3).  Each time
+ *      the text and keys of the features held in memory would exceed
+ *      mem_limit, they are sorted in parallel by up to threads threads,
+ *      and written to a temporary file as a sorted run.
+ *      bl_feature_sort_write(3) then merges the runs, or sorts in memory
+ *      if everything fit, and writes the sorted features.
+ *
+ *  Arguments:
+ *      sort:       Pointer to the bl_feature_sort_t structure to initialize
+ *      format:     BL_FEATURE_SORT_BED or BL_FEATURE_SORT_GFF
+ *      mem_limit:  Memory for one run, e.g. BL_FEATURE_SORT_MEM_DEFAULT
+ *      threads:    Maximum number of threads for sorting a run
+ *
+ *  Examples:
+ *      bl_feature_sort_t   sort;
+ *      FILE                *header_stream;
+ *
+ *      header_stream = bl_bed_skip_header(stdin);
+ *      bl_feature_sort_init(&sort, BL_FEATURE_SORT_BED,
+ *                           BL_FEATURE_SORT_MEM_DEFAULT, 4);
+ *      if ( bl_feature_sort_add_stream(&sort, stdin) == BL_READ_OK )
+ *          bl_feature_sort_write(&sort, stdout);
+ *      bl_feature_sort_free(&sort);
+ *
+ *  See also:
+ *      bl_feature_sort_add_stream(3), bl_feature_sort_write(3),
+ *      bl_feature_sort_free(3), bl_chrom_name_cmp(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_feature_sort_init(bl_feature_sort_t *sort, int format,
+			     size_t mem_limit, unsigned threads)
+
+{
+    memset(sort, 0, sizeof(*sort));
+    sort->format = format;
+    sort->mem_limit = mem_limit;
+    sort->threads = threads == 0 ? 1 : threads;
+    sort->ranks_valid = true;
+}
+
+
+/* Look up a contig ID by name, adding the contig if new */
+
+static uint32_t feature_sort_contig(bl_feature_sort_t *sort, const char *chrom)
+
+{
+    size_t      low = 0, high = sort->contig_count, mid;
+    uint32_t    id;
+    int         cmp;
+
+    // Input is often grouped by contig
+    if ( (sort->contig_count > 0) &&
+	 (strcmp(sort->contigs[sort->last_contig], chrom) == 0) )
+	return sort->last_contig;
+
+    while ( low < high )
+    {
+	mid = (low + high) / 2;
+	cmp = strcmp(sort->contigs[sort->lookup[mid]], chrom);
+	if ( cmp == 0 )
+	    return sort->last_contig = sort->lookup[mid];
+	else if ( cmp < 0 )
+	    low = mid + 1;
+	else
+	    high = mid;
+    }
+
+    if ( sort->contig_count == sort->contig_max )
+    {
+	sort->contig_max = sort->contig_max == 0 ? 64 : sort->contig_max * 2;
+	sort->contigs = xt_realloc(sort->contigs, sort->contig_max,
+				   sizeof(*sort->contigs));
+	sort->lookup = xt_realloc(sort->lookup, sort->contig_max,
+				  sizeof(*sort->lookup));
+	sort->ranks = xt_realloc(sort->ranks, sort->contig_max,
+				 sizeof(*sort->ranks));
+	if ( (sort->contigs == NULL) || (sort->lookup == NULL) ||
+	     (sort->ranks == NULL) )
+	{
+	    fputs("bl_feature_sort_add_stream(): Cannot allocate contigs.\n",
+		  stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    id = sort->contig_count++;
+    if ( (sort->contigs[id] = strdup(chrom)) == NULL )
+    {
+	fputs("bl_feature_sort_add_stream(): Cannot allocate contig name.\n",
+	      stderr);
+	exit(EX_UNAVAILABLE);
+    }
+    memmove(sort->lookup + low + 1, sort->lookup + low,
+	    (sort->contig_count - 1 - low) * sizeof(*sort->lookup));
+    sort->lookup[low] = id;
+    sort->ranks_valid = false;
+    return sort->last_contig = id;
+}
+
+
+static int  feature_sort_contig_cmp(const void *p1, const void *p2)
+
+{
+    return bl_chrom_name_cmp(((const feature_sort_contig_t *)p1)->name,
+			     ((const feature_sort_contig_t *)p2)->name);
+}
+
+
+/*
+ *  Rank contigs in bl_chrom_name_cmp() order.  Comparing names once per
+ *  contig here lets features be compared by integer rank.  The order is
+ *  total, so ranks of runs sorted before more contigs were seen are
+ *  consistent with the final ranks.
+ */
+
+static void feature_sort_rank(bl_feature_sort_t *sort)
+
+{
+    feature_sort_contig_t   *table;
+    size_t                  c;
+
+    if ( sort->ranks_valid )
+	return;
+    if ( (table = xt_malloc(sort->contig_count, sizeof(*table))) == NULL )
+    {
+	fputs("bl_feature_sort_add_stream(): Cannot allocate rank table.\n",
+	      stderr);
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = 0; c < sort->contig_count; ++c)
+    {
+	table[c].name = sort->contigs[c];
+	table[c].id = c;
+    }
+    qsort(table, sort->contig_count, sizeof(*table), feature_sort_contig_cmp);
+    for (c = 0; c < sort->contig_count; ++c)
+	sort->ranks[table[c].id] = c;
+    free(table);
+    sort->ranks_valid = true;
+}
+
+
+static int  feature_sort_key_cmp(const void *p1, const void *p2)
+
+{
+    const bl_feature_sort_key_t *k1 = p1, *k2 = p2;
+
+    if ( k1->rank != k2->rank )
+	return k1->rank < k2->rank ? -1 : 1;
+    if ( k1->start != k2->start )
+	return k1->start < k2->start ? -1 : 1;
+    if ( k1->end != k2->end )
+	return k1->end < k2->end ? -1 : 1;
+    // Keep input order, which makes the sort stable
+    if ( k1->offset != k2->offset )
+	return k1->offset < k2->offset ? -1 : 1;
+    return 0;
+}
+
+
+/*
+ *  Min-heap of source indexes ordered by their current keys in heads[],
+ *  shared by the merge of sorted slices and the merge of runs.
+ */
+
+static void feature_sort_sift_down(size_t *heap, size_t count,
+				   bl_feature_sort_key_t *heads, size_t pos)
+
+{
+    size_t  child, top = heap[pos];
+
+    while ( (child = 2 * pos + 1) < count )
+    {
+	if ( (child + 1 < count) &&
+	     (feature_sort_key_cmp(&heads[heap[child + 1]],
+				   &heads[heap[child]]) < 0) )
+	    ++child;
+	if ( feature_sort_key_cmp(&heads[heap[child]], &heads[top]) >= 0 )
+	    break;
+	heap[pos] = heap[child];
+	pos = child;
+    }
+    heap[pos] = top;
+}
+
+
+static void feature_sort_heapify(size_t *heap, size_t count,
+				 bl_feature_sort_key_t *heads)
+
+{
+    size_t  c;
+
+    for (c = 0; c < count; ++c)
+	heap[c] = c;
+    for (c = count / 2; c > 0; --c)
+	feature_sort_sift_down(heap, count, heads, c - 1);
+}
+
+
+static void *feature_sort_worker(void *data)
+
+{
+    feature_sort_slice_t    *slice = data;
+
+    qsort(slice->keys, slice->count, sizeof(*slice->keys),
+	  feature_sort_key_cmp);
+    return NULL;
+}
+
+
+/*
+ *  Sort the current run in slices on worker threads and merge the
+ *  slices, writing lines to stream, or keyed records to a run file if
+ *  spill is true.
+ */
+
+static void feature_sort_run(bl_feature_sort_t *sort, FILE *stream,
+			     bool spill)
+
+{
+    feature_sort_slice_t    *slices;
+    feature_sort_record_t   record;
+    bl_feature_sort_key_t   *heads, *key;
+    pthread_t               *tids;
+    size_t                  *heap, *pos, slice_count, c, count, s;
+
+    if ( sort->key_count == 0 )
+	return;
+    feature_sort_rank(sort);
+    for (c = 0; c < sort->key_count; ++c)
+	sort->keys[c].rank = sort->ranks[sort->keys[c].contig];
+
+    slice_count = sort->key_count / FEATURE_SORT_MIN_SLICE;
+    if ( slice_count > sort->threads )
+	slice_count = sort->threads;
+    if ( slice_count == 0 )
+	slice_count = 1;
+    slices = xt_malloc(slice_count, sizeof(*slices));
+    tids = xt_malloc(slice_count, sizeof(*tids));
+    heads = xt_malloc(slice_count, sizeof(*heads));
+    heap = xt_malloc(slice_count, sizeof(*heap));
+    pos = xt_malloc(slice_count, sizeof(*pos));
+    if ( (slices == NULL) || (tids == NULL) || (heads == NULL) ||
+	 (heap == NULL) || (pos == NULL) )
+    {
+	fputs("bl_feature_sort_write(): Cannot allocate slices.\n", stderr);
+	exit(EX_UNAVAILABLE);
+    }
+
+    // The calling thread sorts slice 0
+    for (s = 0; s < slice_count; ++s)
+    {
+	pos[s] = sort->key_count * s / slice_count;
+	slices[s].keys = sort->keys + pos[s];
+	slices[s].count = sort->key_count * (s + 1) / slice_count - pos[s];
+	if ( (s > 0) && (pthread_create(&tids[s], NULL, feature_sort_worker,
+					&slices[s]) != 0) )
+	{
+	    fprintf(stderr, "bl_feature_sort_write(): Could not create thread.\n");
+	    exit(EX_OSERR);
+	}
+    }
+    feature_sort_worker(&slices[0]);
+    for (s = 1; s < slice_count; ++s)
+	pthread_join(tids[s], NULL);
+
+    // Merge slices, all of which are nonempty
+    count = slice_count;
+    for (s = 0; s < count; ++s)
+	heads[s] = slices[s].keys[0];
+    feature_sort_heapify(heap, count, heads);
+    while ( count > 0 )
+    {
+	s = heap[0];
+	key = &heads[s];
+	if ( spill )
+	{
+	    record.start = key->start;
+	    record.end = key->end;
+	    record.contig = key->contig;
+	    record.len = key->len;
+	    fwrite(&record, sizeof(record), 1, stream);
+	}
+	fwrite(sort->text + key->offset, key->len, 1, stream);
+	if ( ++pos[s] == sort->key_count * (s + 1) / slice_count )
+	    heap[0] = heap[--count];
+	else
+	    heads[s] = sort->keys[pos[s]];
+	feature_sort_sift_down(heap, count, heads, 0);
+    }
+
+    free(slices);
+    free(tids);
+    free(heads);
+    free(heap);
+    free(pos);
+}
+
+
+/* Sort the current run and write it to a new temp file */
+
+static void feature_sort_spill(bl_feature_sort_t *sort)
+
+{
+    FILE    *run;
+
+    if ( (run = tmpfile()) == NULL )
+    {
+	fputs("bl_feature_sort_add_stream(): Could not create run file.\n",
+	      stderr);
+	exit(EX_CANTCREAT);
+    }
+    feature_sort_run(sort, run, true);
+    if ( (fflush(run) != 0) || ferror(run) )
+    {
+	fputs("bl_feature_sort_add_stream(): Could not write run file.\n",
+	      stderr);
+	exit(EX_IOERR);
+    }
+    rewind(run);
+
+    if ( sort->run_count == sort->run_max )
+    {
+	sort->run_max = sort->run_max == 0 ? 16 : sort->run_max * 2;
+	sort->runs = xt_realloc(sort->runs, sort->run_max, sizeof(*sort->runs));
+	if ( sort->runs == NULL )
+	{
+	    fputs("bl_feature_sort_add_stream(): Cannot allocate runs.\n",
+		  stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    sort->runs[sort->run_count++] = run;
+    sort->text_used = 0;
+    sort->key_count = 0;
+}
+
+
+/*
+ *  Parse chrom, start, and end from a null-terminated line.  Only the
+ *  key columns are examined.
+ */
+
+static int  feature_sort_parse(bl_feature_sort_t *sort, const char *line,
+			       bl_feature_sort_key_t *key)
+
+{
+    char        chrom[BL_CHROM_MAX_CHARS + 1], *end;
+    const char  *p;
+    size_t      len;
+    unsigned    c;
+
+    if ( (p = strchr(line, '\t')) == NULL )
+	return BL_READ_TRUNCATED;
+    if ( (len = p - line) > BL_CHROM_MAX_CHARS )
+	return BL_READ_OVERFLOW;
+    memcpy(chrom, line, len);
+    chrom[len] = '\0';
+    ++p;
+
+    // GFF source and feature type precede start
+    if ( sort->format == BL_FEATURE_SORT_GFF )
+	for (c = 0; c < 2; ++c)
+	{
+	    if ( (p = strchr(p, '\t')) == NULL )
+		return BL_READ_TRUNCATED;
+	    ++p;
+	}
+
+    if ( !isdigit(*p) )
+	return BL_READ_TRUNCATED;
+    key->start = strtoull(p, &end, 10);
+    if ( *end != '\t' )
+	return BL_READ_TRUNCATED;
+    p = end + 1;
+    if ( !isdigit(*p) )
+	return BL_READ_TRUNCATED;
+    key->end = strtoull(p, &end, 10);
+    if ( (*end != '\t') && (*end != '\n') && (*end != '\r') && (*end != '\0') )
+	return BL_READ_TRUNCATED;
+
+    key->contig = feature_sort_contig(sort, chrom);
+    return BL_READ_OK;
+}
+
+
+/* Append a parsed line to the current run, spilling it first if full */
+
+static void feature_sort_add_line(bl_feature_sort_t *sort, const char *line,
+				  size_t len, bl_feature_sort_key_t *key)
+
+{
+    size_t  needed = len + 1;   // Newline may be missing at EOF
+
+    if ( (sort->key_count > 0) &&
+	 (sort->text_used + needed +
+	  (sort->key_count + 1) * sizeof(*sort->keys) > sort->mem_limit) )
+	feature_sort_spill(sort);
+
+    if ( sort->text_used + needed > sort->text_max )
+    {
+	sort->text_max = MAX(sort->text_max * 2, sort->text_used + needed);
+	sort->text_max = MAX(sort->text_max, 65536);
+	if ( (sort->text = xt_realloc(sort->text, sort->text_max, 1)) == NULL )
+	{
+	    fputs("bl_feature_sort_add_stream(): Cannot allocate text.\n",
+		  stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    if ( sort->key_count == sort->key_max )
+    {
+	sort->key_max = sort->key_max == 0 ? 4096 : sort->key_max * 2;
+	sort->keys = xt_realloc(sort->keys, sort->key_max, sizeof(*sort->keys));
+	if ( sort->keys == NULL )
+	{
+	    fputs("bl_feature_sort_add_stream(): Cannot allocate keys.\n",
+		  stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+
+    memcpy(sort->text + sort->text_used, line, len);
+    if ( line[len - 1] != '\n' )
+	sort->text[sort->text_used + len++] = '\n';
+    key->offset = sort->text_used;
+    key->len = len;
+    sort->keys[sort->key_count++] = *key;
+    sort->text_used += len;
+    ++sort->features;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/feature-sort.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add all features from a BED or GFF stream to a sort, spilling
+ *      sorted runs to temporary files whenever the features held in
+ *      memory reach the sort's mem_limit.  May be called for several
+ *      streams to sort them together.
+ *
+ *      Lines are stored as text, so all columns are written back
+ *      exactly as read.  Only chrom, start, and end are parsed.
+ *      Comment lines, BED track and browser lines, and blank lines are
+ *      discarded, so headers should be saved first with
+ *      bl_bed_skip_header(3) or bl_gff_skip_header(3).  Reading a GFF
+ *      stream stops at a ##FASTA line, leaving the sequences unread.
+ *
+ *  Arguments:
+ *      sort:   Pointer to a bl_feature_sort_t initialized with
+ *              bl_feature_sort_init(3)
+ *      stream: FILE stream from which features are read
+ *
+ *  Returns:
+ *      BL_READ_OK on success
+ *      BL_READ_OVERFLOW if a chrom name is too long
+ *      BL_READ_TRUNCATED if a line is missing or has invalid key fields
+ *
+ *  See also:
+ *      bl_feature_sort_init(3), bl_feature_sort_write(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_feature_sort_add_stream(bl_feature_sort_t *sort, FILE *stream)
+
+{
+    bl_feature_sort_key_t   key;
+    char                    *line = NULL;
+    size_t                  line_max = 0;
+    ssize_t                 len;
+    int                     status = BL_READ_OK;
+
+    while ( (len = getline(&line, &line_max, stream)) > 0 )
+    {
+	if ( *line == '#' )
+	{
+	    if ( (sort->format == BL_FEATURE_SORT_GFF) &&
+		 (strncmp(line, "##FASTA", 7) == 0) )
+		break;
+	    continue;
+	}
+	if ( (*line == '\n') || ((sort->format == BL_FEATURE_SORT_BED) &&
+	     ((strncmp(line, "track", 5) == 0) ||
+	      (strncmp(line, "browser", 7) == 0))) )
+	    continue;
+	if ( (status = feature_sort_parse(sort, line, &key)) != BL_READ_OK )
+	{
+	    fprintf(stderr, "bl_feature_sort_add_stream(): Invalid feature: %s",
+		    line);
+	    if ( line[len - 1] != '\n' )
+		putc('\n', stderr);
+	    break;
+	}
+	feature_sort_add_line(sort, line, len, &key);
+    }
+    free(line);
+    return status;
+}
+
+
+/* Read the next record of a run into heads[run] and its text into line */
+
+static bool feature_sort_run_next(bl_feature_sort_t *sort, size_t run,
+				  bl_feature_sort_key_t *heads,
+				  char **line, size_t *line_max)
+
+{
+    feature_sort_record_t   record;
+    FILE                    *stream = sort->runs[run];
+
+    if ( fread(&record, sizeof(record), 1, stream) != 1 )
+    {
+	if ( ferror(stream) )
+	{
+	    fputs("bl_feature_sort_write(): Could not read run file.\n", stderr);
+	    exit(EX_IOERR);
+	}
+	return false;
+    }
+    if ( record.len > *line_max )
+    {
+	*line_max = record.len;
+	if ( (*line = xt_realloc(*line, *line_max, 1)) == NULL )
+	{
+	    fputs("bl_feature_sort_write(): Cannot allocate line.\n", stderr);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    if ( fread(*line, record.len, 1, stream) != 1 )
+    {
+	fputs("bl_feature_sort_write(): Truncated run file.\n", stderr);
+	exit(EX_IOERR);
+    }
+    heads[run].start = record.start;
+    heads[run].end = record.end;
+    heads[run].contig = record.contig;
+    heads[run].rank = sort->ranks[record.contig];
+    heads[run].len = record.len;
+    heads[run].offset = run;    // Earlier runs first for equal keys
+    return true;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/feature-sort.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Write all features added to a sort in sorted order.  If all
+ *      features fit within mem_limit, they are sorted in memory using
+ *      multiple threads.  Otherwise, the remaining features are spilled
+ *      as a final run and all runs are merged.  The output is a plain
+ *      BED or GFF stream, which can be read back with bl_bed_read(3) or
+ *      bl_gff_read(3) by writing it to a tmpfile(3), e.g. to process
+ *      features with the bl_bed_*() and bl_gff_*() functions.  Only one
+ *      bl_feature_sort_write() is allowed per sort.
+ *
+ *  Arguments:
+ *      sort:   Pointer to a bl_feature_sort_t structure
+ *      stream: FILE stream to which sorted features are written
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success
+ *      BL_WRITE_FAILURE if an error occurred on stream
+ *
+ *  Examples:
+ *      FILE    *sorted = tmpfile();
+ *
+ *      bl_feature_sort_write(&sort, sorted);
+ *      rewind(sorted);
+ *      while ( bl_bed_read(sorted, &bed_feature, BL_BED_FIELD_ALL)
+ *              == BL_READ_OK )
+ *          bl_bed_write(stdout, &bed_feature, BL_BED_FIELD_ALL);
+ *
+ *  See also:
+ *      bl_feature_sort_init(3), bl_feature_sort_add_stream(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_feature_sort_write(bl_feature_sort_t *sort, FILE *stream)
+
+{
+    bl_feature_sort_key_t   *heads;
+    char                    **lines;
+    size_t                  *heap, *line_maxes, count, r;
+
+    if ( sort->run_count == 0 )
+    {
+	feature_sort_run(sort, stream, false);
+	return ferror(stream) ? BL_WRITE_FAILURE : BL_WRITE_OK;
+    }
+
+    if ( sort->key_count > 0 )
+	feature_sort_spill(sort);
+    feature_sort_rank(sort);
+
+    heads = xt_malloc(sort->run_count, sizeof(*heads));
+    heap = xt_malloc(sort->run_count, sizeof(*heap));
+    lines = xt_malloc(sort->run_count, sizeof(*lines));
+    line_maxes = xt_malloc(sort->run_count, sizeof(*line_maxes));
+    if ( (heads == NULL) || (heap == NULL) || (lines == NULL) ||
+	 (line_maxes == NULL) )
+    {
+	fputs("bl_feature_sort_write(): Cannot allocate runs.\n", stderr);
+	exit(EX_UNAVAILABLE);
+    }
+
+    // Runs are never empty, so every run has a first record
+    for (r = 0; r < sort->run_count; ++r)
+    {
+	lines[r] = NULL;
+	line_maxes[r] = 0;
+	feature_sort_run_next(sort, r, heads, &lines[r], &line_maxes[r]);
+    }
+    count = sort->run_count;
+    feature_sort_heapify(heap, count, heads);
+    while ( count > 0 )
+    {
+	r = heap[0];
+	fwrite(lines[r], heads[r].len, 1, stream);
+	if ( !feature_sort_run_next(sort, r, heads, &lines[r], &line_maxes[r]) )
+	    heap[0] = heap[--count];
+	feature_sort_sift_down(heap, count, heads, 0);
+    }
+
+    for (r = 0; r < sort->run_count; ++r)
+	free(lines[r]);
+    free(lines);
+    free(line_maxes);
+    free(heads);
+    free(heap);
+    return ferror(stream) ? BL_WRITE_FAILURE : BL_WRITE_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/feature-sort.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory and temporary files of a sort.
+ *
+ *  Arguments:
+ *      sort:   Pointer to a bl_feature_sort_t structure
+ *
+ *  See also:
+ *      bl_feature_sort_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_feature_sort_free(bl_feature_sort_t *sort)
+
+{
+    size_t  c;
+
+    for (c = 0; c < sort->run_count; ++c)
+	fclose(sort->runs[c]);
+    for (c = 0; c < sort->contig_count; ++c)
+	free(sort->contigs[c]);
+    free(sort->runs);
+    free(sort->contigs);
+    free(sort->lookup);
+    free(sort->ranks);
+    free(sort->text);
+    free(sort->keys);
+    bl_feature_sort_init(sort, sort->format, sort->mem_limit, sort->threads);
+}
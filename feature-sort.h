@@ -0,0 +1,84 @@
+#ifndef _feature_sort_h_
+#define _feature_sort_h_
+
+#ifndef _STDIO_H_
+#include <stdio.h>
+#endif
+
+#ifndef _STDINT_H_
+#include <stdint.h>
+#endif
+
+#ifndef _STDBOOL_H_
+#include <stdbool.h>
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+// Formats for bl_feature_sort_init()
+#define BL_FEATURE_SORT_BED         0
+#define BL_FEATURE_SORT_GFF         1
+
+// mem_limit for bl_feature_sort_init()
+#define BL_FEATURE_SORT_MEM_DEFAULT ((size_t)256 * 1024 * 1024)
+
+/*
+ *  Sort key for one feature.  Lines are kept as text, so all columns are
+ *  written back exactly as read, and only chrom, start, and end are
+ *  parsed.  rank is the position of the contig in bl_chrom_name_cmp()
+ *  order, filled in from contig just before sorting or merging.
+ */
+typedef struct
+{
+    uint64_t    start;
+    uint64_t    end;
+    size_t      offset;     // Of line in text
+    uint32_t    len;        // Including newline
+    uint32_t    contig;     // ID, in order of first appearance
+    uint32_t    rank;
+}   bl_feature_sort_key_t;
+
+typedef struct
+{
+    int                     format;     // BL_FEATURE_SORT_BED or _GFF
+    size_t                  mem_limit;  // For text and keys of one run
+    unsigned                threads;
+    uint64_t                features;   // Added so far
+
+    // Current run
+    char                    *text;
+    size_t                  text_used;
+    size_t                  text_max;
+    bl_feature_sort_key_t   *keys;
+    size_t                  key_count;
+    size_t                  key_max;
+
+    // Sorted runs spilled to temp files
+    FILE                    **runs;
+    size_t                  run_count;
+    size_t                  run_max;
+
+    // Contig names by ID, and IDs sorted by name for lookup
+    char                    **contigs;
+    uint32_t                *lookup;
+    uint32_t                *ranks;     // Indexed by ID
+    size_t                  contig_count;
+    size_t                  contig_max;
+    uint32_t                last_contig;    // Most recent lookup
+    bool                    ranks_valid;
+}   bl_feature_sort_t;
+
+/* Not generated by gen-get-set */
+#define BL_FEATURE_SORT_FEATURES(ptr)       ((ptr)->features)
+#define BL_FEATURE_SORT_RUN_COUNT(ptr)      ((ptr)->run_count)
+#define BL_FEATURE_SORT_CONTIG_COUNT(ptr)   ((ptr)->contig_count)
+
+/* feature-sort.c */
+void bl_feature_sort_init(bl_feature_sort_t *sort, int format, size_t mem_limit, unsigned threads);
+int bl_feature_sort_add_stream(bl_feature_sort_t *sort, FILE *stream);
+int bl_feature_sort_write(bl_feature_sort_t *sort, FILE *stream);
+void bl_feature_sort_free(bl_feature_sort_t *sort);
+
+#endif  // _feature_sort_h_
@@ -0,0 +1,110 @@
+#include <stdint.h>
+#include <string.h>
+#include "biostring.h"
+
+static const char   Digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/biostring.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Convert an unsigned 64-bit integer to decimal, two digits at a
+ *      time, without the format parsing overhead of printf().  Used by
+ *      the writers to assemble lines in memory.  The result is not
+ *      null-terminated.
+ *
+ *  Arguments:
+ *      dest:   Character array with room for at least
+ *              BL_U64_MAX_DIGITS characters
+ *      val:    Value to convert
+ *
+ *  Returns:
+ *      The number of characters stored in dest
+ *
+ *  Examples:
+ *      char    *p = buff;
+ *
+ *      p += bl_u64_to_str(p, BL_SAM_POS(&sam_alignment));
+ *      *p++ = '\t';
+ *
+ *  See also:
+ *      bl_i64_to_str(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  bl_u64_to_str(char *dest, uint64_t val)
+
+{
+    char    temp[BL_U64_MAX_DIGITS], *p = temp + BL_U64_MAX_DIGITS;
+    size_t  len;
+    
+    while ( val >= 100 )
+    {
+	p -= 2;
+	memcpy(p, Digit_pairs + (val % 100) * 2, 2);
+	val /= 100;
+    }
+    if ( val >= 10 )
+    {
+	p -= 2;
+	memcpy(p, Digit_pairs + val * 2, 2);
+    }
+    else
+	*--p = '0' + val;
+    len = temp + BL_U64_MAX_DIGITS - p;
+    memcpy(dest, p, len);
+    return len;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/biostring.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Convert a signed 64-bit integer to decimal.  See bl_u64_to_str(3).
+ *      The result is not null-terminated.
+ *
+ *  Arguments:
+ *      dest:   Character array with room for at least
+ *              BL_U64_MAX_DIGITS + 1 characters
+ *      val:    Value to convert
+ *
+ *  Returns:
+ *      The number of characters stored in dest
+ *
+ *  See also:
+ *      bl_u64_to_str(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  bl_i64_to_str(char *dest, int64_t val)
+
+{
+    if ( val < 0 )
+    {
+	*dest = '-';
+	// Negate as unsigned so INT64_MIN does not overflow
+	return bl_u64_to_str(dest + 1, -(uint64_t)val) + 1;
+    }
+    return bl_u64_to_str(dest, val);
+}
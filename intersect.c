@@ -0,0 +1,429 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <sys/param.h>  // MIN(), MAX()
+#include <xtend.h>
+#include "intersect.h"
+#include "biostring.h"
+#include "biolibc.h"
+
+/*
+ *  Free memory allocated by bl_bed_read() or bl_gff_read() for the
+ *  previous contents of a feature.
+ */
+
+static void intersect_feature_clear(bl_intersect_feature_t *feature)
+
+{
+    if ( feature->format == BL_INTERSECT_GFF )
+    {
+	free(feature->gff.attributes);
+	free(feature->gff.feature_id);
+	feature->gff.attributes = NULL;
+	feature->gff.feature_id = NULL;
+    }
+    else
+    {
+	free(feature->bed.block_sizes);
+	free(feature->bed.block_starts);
+	feature->bed.block_sizes = NULL;
+	feature->bed.block_starts = NULL;
+	feature->bed.block_count = 0;
+    }
+}
+
+
+static bl_intersect_feature_t *intersect_feature_get(bl_intersect_t *intersect,
+						    int format)
+
+{
+    bl_intersect_feature_t  *feature;
+    static bl_bed_t         bed_init = BL_BED_INIT;
+    static bl_gff_t         gff_init = BL_GFF_INIT;
+
+    if ( intersect->pool_count > 0 )
+    {
+	feature = intersect->pool[--intersect->pool_count];
+	// Pooled features are cleared, so the union can be switched
+	if ( feature->format == format )
+	    return feature;
+    }
+    else if ( (feature = xt_malloc(1, sizeof(*feature))) == NULL )
+    {
+	fprintf(stderr, "bl_intersect_next(): Could not allocate feature.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    feature->format = format;
+    if ( format == BL_INTERSECT_GFF )
+	feature->gff = gff_init;
+    else
+	feature->bed = bed_init;
+    return feature;
+}
+
+
+static void intersect_feature_put(bl_intersect_t *intersect,
+				  bl_intersect_feature_t *feature)
+
+{
+    if ( intersect->pool_count == intersect->pool_max )
+    {
+	intersect->pool_max = intersect->pool_max == 0 ? 64 :
+			      intersect->pool_max * 2;
+	if ( (intersect->pool = xt_realloc(intersect->pool,
+		intersect->pool_max, sizeof(*intersect->pool))) == NULL )
+	{
+	    fprintf(stderr, "bl_intersect_next(): Could not allocate pool.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    intersect_feature_clear(feature);
+    intersect->pool[intersect->pool_count++] = feature;
+}
+
+
+/*
+ *  Read the next feature from an input into feature, skipping GFF
+ *  "###" terminators, and check that the input is sorted.
+ */
+
+static int  intersect_read(bl_intersect_input_t *input,
+			   bl_intersect_feature_t *feature, int which)
+
+{
+    int     status, cmp;
+
+    do
+    {
+	intersect_feature_clear(feature);
+	if ( input->format == BL_INTERSECT_GFF )
+	{
+	    status = bl_gff_read(input->stream, &feature->gff,
+				 BL_GFF_FIELD_ALL);
+	    feature->chrom = BL_GFF_SEQUENCE(&feature->gff);
+	    // GFF is 1-based, inclusive
+	    feature->start = BL_GFF_START(&feature->gff) - 1;
+	    feature->end = BL_GFF_END(&feature->gff);
+	}
+	else
+	{
+	    status = bl_bed_read(input->stream, &feature->bed,
+				 BL_BED_FIELD_ALL);
+	    feature->chrom = BL_BED_CHROM(&feature->bed);
+	    feature->start = BL_BED_CHROM_START(&feature->bed);
+	    feature->end = BL_BED_CHROM_END(&feature->bed);
+	}
+    }   while ( (status == BL_READ_OK) &&
+		(input->format == BL_INTERSECT_GFF) &&
+		(strcmp(BL_GFF_FEATURE(&feature->gff), "###") == 0) );
+    if ( status != BL_READ_OK )
+	return status;
+
+    if ( input->features_read > 0 )
+    {
+	cmp = bl_chrom_name_cmp(feature->chrom, input->last_chrom);
+	if ( (cmp < 0) || ((cmp == 0) && (feature->start < input->last_start)) )
+	{
+	    fprintf(stderr, "bl_intersect_next(): Input %d is not sorted: "
+		    "%s %" PRIu64 " follows %s %" PRIu64 "\n", which,
+		    feature->chrom, feature->start, input->last_chrom,
+		    input->last_start);
+	    return BL_READ_MISMATCH;
+	}
+    }
+    if ( (input->features_read == 0) ||
+	 (strcmp(feature->chrom, input->last_chrom) != 0) )
+	strlcpy(input->last_chrom, feature->chrom, BL_CHROM_MAX_CHARS + 1);
+    input->last_start = feature->start;
+    ++input->features_read;
+    return BL_READ_OK;
+}
+
+
+static int  intersect_read_lookahead(bl_intersect_t *intersect)
+
+{
+    int     status;
+
+    if ( intersect->lookahead == NULL )
+	intersect->lookahead = intersect_feature_get(intersect,
+						     intersect->input2.format);
+    status = intersect_read(&intersect->input2, intersect->lookahead, 2);
+    if ( status != BL_READ_OK )
+    {
+	intersect_feature_put(intersect, intersect->lookahead);
+	intersect->lookahead = NULL;
+    }
+    return status;
+}
+
+
+static void intersect_window_add(bl_intersect_t *intersect,
+				 bl_intersect_feature_t *feature)
+
+{
+    if ( intersect->window_count == intersect->window_max )
+    {
+	intersect->window_max = intersect->window_max == 0 ? 64 :
+				intersect->window_max * 2;
+	if ( (intersect->window = xt_realloc(intersect->window,
+		intersect->window_max, sizeof(*intersect->window))) == NULL )
+	{
+	    fprintf(stderr, "bl_intersect_next(): Could not allocate window.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    intersect->window[intersect->window_count++] = feature;
+    if ( intersect->window_count > intersect->max_window )
+	intersect->max_window = intersect->window_count;
+}
+
+
+/*
+ *  Bring the window up to date for a new feature1: drop features from
+ *  input2 that end before it starts, since later features from input1
+ *  start no earlier, then add features from input2 that start before
+ *  it ends.
+ */
+
+static int  intersect_advance_window(bl_intersect_t *intersect)
+
+{
+    bl_intersect_feature_t  *f1 = intersect->feature1, *f2;
+    size_t  c, kept;
+    int     cmp, status;
+
+    for (c = kept = 0; c < intersect->window_count; ++c)
+    {
+	f2 = intersect->window[c];
+	if ( (strcmp(f2->chrom, f1->chrom) == 0) && (f2->end > f1->start) )
+	    intersect->window[kept++] = f2;
+	else
+	    intersect_feature_put(intersect, f2);
+    }
+    intersect->window_count = kept;
+
+    while ( intersect->lookahead != NULL )
+    {
+	f2 = intersect->lookahead;
+	cmp = bl_chrom_name_cmp(f2->chrom, f1->chrom);
+	if ( (cmp > 0) || ((cmp == 0) && (f2->start >= f1->end)) )
+	    break;
+	if ( (cmp == 0) && (f2->end > f1->start) )
+	{
+	    intersect_window_add(intersect, f2);
+	    intersect->lookahead = NULL;
+	}
+	// Else f2 is on an earlier chrom or ends first: reuse for next read
+	if ( ((status = intersect_read_lookahead(intersect)) != BL_READ_OK) &&
+	     (status != BL_READ_EOF) )
+	    return status;
+    }
+    return BL_READ_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/intersect.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a streaming intersect of two sorted feature files,
+ *      each of which may be BED (BL_INTERSECT_BED) or GFF
+ *      (BL_INTERSECT_GFF).  bl_intersect_next(3) then produces every
+ *      pair of overlapping features, one from each input, in a single
+ *      sweep over both inputs, i.e. O(n + m + k) for n and m features
+ *      and k overlaps.  Only the features from input 2 that may still
+ *      overlap a feature from input 1 are held in memory.
+ *
+ *      Both inputs must be sorted by chromosome in bl_chrom_name_cmp(3)
+ *      order, as checked by bl_bed_check_order(3), and then by start
+ *      position.  Headers must be skipped first, e.g. with
+ *      bl_bed_skip_header(3) or bl_gff_skip_header(3).  GFF "###"
+ *      terminators are ignored.
+ *
+ *  Arguments:
+ *      intersect:  Pointer to the bl_intersect_t structure to initialize
+ *      stream1:    First input, e.g. peaks
+ *      format1:    BL_INTERSECT_BED or BL_INTERSECT_GFF
+ *      stream2:    Second input, e.g. annotations
+ *      format2:    BL_INTERSECT_BED or BL_INTERSECT_GFF
+ *
+ *  Examples:
+ *      bl_intersect_t  intersect;
+ *
+ *      bl_intersect_init(&intersect, bed_stream, BL_INTERSECT_BED,
+ *                        gff_stream, BL_INTERSECT_GFF);
+ *      while ( bl_intersect_next(&intersect) == BL_READ_OK )
+ *          printf("%s\t%s\t%" PRIu64 "\n",
+ *                 BL_BED_NAME(BL_INTERSECT_FEATURE_BED(
+ *                      BL_INTERSECT_FEATURE1(&intersect))),
+ *                 BL_GFF_FEATURE(BL_INTERSECT_FEATURE_GFF(
+ *                      BL_INTERSECT_FEATURE2(&intersect))),
+ *                 BL_OVERLAP_OVERLAP_LEN(BL_INTERSECT_OVERLAP(&intersect)));
+ *      bl_intersect_free(&intersect);
+ *
+ *  See also:
+ *      bl_intersect_next(3), bl_intersect_free(3), bl_bed_gff_cmp(3),
+ *      bl_bed_index_build(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_intersect_init(bl_intersect_t *intersect,
+			  FILE *stream1, int format1,
+			  FILE *stream2, int format2)
+
+{
+    intersect->input1.stream = stream1;
+    intersect->input1.format = format1;
+    intersect->input1.features_read = 0;
+    intersect->input2.stream = stream2;
+    intersect->input2.format = format2;
+    intersect->input2.features_read = 0;
+    *intersect->input1.last_chrom = *intersect->input2.last_chrom = '\0';
+    intersect->input1.last_start = intersect->input2.last_start = 0;
+
+    intersect->feature1 = intersect->feature2 = NULL;
+    intersect->window = NULL;
+    intersect->window_count = intersect->window_max = 0;
+    intersect->window_pos = 0;
+    intersect->lookahead = NULL;
+    intersect->pool = NULL;
+    intersect->pool_count = intersect->pool_max = 0;
+    intersect->started = false;
+    intersect->pairs = 0;
+    intersect->max_window = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/intersect.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Advance to the next pair of overlapping features.  The pair is
+ *      available through BL_INTERSECT_FEATURE1() and
+ *      BL_INTERSECT_FEATURE2() until the next call, and
+ *      BL_INTERSECT_OVERLAP() gives the overlap details, with positions
+ *      1-based and inclusive as from bl_bed_gff_cmp(3).
+ *
+ *      Pairs are produced in input 1 order, and for each feature from
+ *      input 1, in input 2 order.  Features are considered to overlap
+ *      if they share at least one base.
+ *
+ *  Arguments:
+ *      intersect:  Pointer to an initialized bl_intersect_t structure
+ *
+ *  Returns:
+ *      BL_READ_OK if another overlapping pair was found
+ *      BL_READ_EOF when input 1 is exhausted
+ *      BL_READ_MISMATCH if an input is not sorted
+ *      Other BL_READ_* errors from bl_bed_read(3) or bl_gff_read(3)
+ *
+ *  See also:
+ *      bl_intersect_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_intersect_next(bl_intersect_t *intersect)
+
+{
+    bl_intersect_feature_t  *f1, *f2;
+    int     status;
+
+    if ( ! intersect->started )
+    {
+	intersect->started = true;
+	intersect->feature1 = intersect_feature_get(intersect,
+						    intersect->input1.format);
+	if ( ((status = intersect_read_lookahead(intersect)) != BL_READ_OK) &&
+	     (status != BL_READ_EOF) )
+	    return status;
+    }
+    else if ( intersect->feature1 == NULL )
+	return BL_READ_EOF;
+
+    for (;;)
+    {
+	f1 = intersect->feature1;
+	while ( intersect->window_pos < intersect->window_count )
+	{
+	    f2 = intersect->window[intersect->window_pos++];
+	    if ( (f2->start < f1->end) && (f1->start < f2->end) )
+	    {
+		intersect->feature2 = f2;
+		bl_overlap_set_all(&intersect->overlap,
+				   f1->end - f1->start, f2->end - f2->start,
+				   MAX(f1->start, f2->start) + 1,
+				   MIN(f1->end, f2->end));
+		++intersect->pairs;
+		return BL_READ_OK;
+	    }
+	}
+
+	// Done with f1.  Window entries may still be compared to the next.
+	intersect->window_pos = 0;
+	intersect->feature2 = NULL;
+	if ( (status = intersect_read(&intersect->input1, f1, 1))
+		!= BL_READ_OK )
+	{
+	    intersect_feature_put(intersect, f1);
+	    intersect->feature1 = NULL;
+	    return status;
+	}
+	if ( (status = intersect_advance_window(intersect)) != BL_READ_OK )
+	    return status;
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/intersect.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory held by an intersect, including features in the
+ *      window.  The input streams are not closed.
+ *
+ *  Arguments:
+ *      intersect:  Pointer to an initialized bl_intersect_t structure
+ *
+ *  See also:
+ *      bl_intersect_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_intersect_free(bl_intersect_t *intersect)
+
+{
+    size_t  c;
+
+    if ( intersect->feature1 != NULL )
+	intersect_feature_put(intersect, intersect->feature1);
+    if ( intersect->lookahead != NULL )
+	intersect_feature_put(intersect, intersect->lookahead);
+    for (c = 0; c < intersect->window_count; ++c)
+	intersect_feature_put(intersect, intersect->window[c]);
+    for (c = 0; c < intersect->pool_count; ++c)
+	free(intersect->pool[c]);
+    free(intersect->pool);
+    free(intersect->window);
+    intersect->pool = NULL;
+    intersect->window = NULL;
+    intersect->feature1 = intersect->feature2 = intersect->lookahead = NULL;
+    intersect->pool_count = intersect->pool_max = 0;
+    intersect->window_count = intersect->window_max = 0;
+}
@@ -0,0 +1,95 @@
+#ifndef _intersect_h_
+#define _intersect_h_
+
+#ifndef _bed_h_
+#include "bed.h"
+#endif
+
+#ifndef _gff_h_
+#include "gff.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+// Input formats for bl_intersect_init()
+#define BL_INTERSECT_BED    0
+#define BL_INTERSECT_GFF    1
+
+/*
+ *  A feature from either input, with its position converted to BED
+ *  coordinates (0-based start, end not inclusive) so that BED and GFF
+ *  can be compared directly.
+ */
+typedef struct
+{
+    int         format;
+    const char  *chrom;     // Points into bed or gff
+    uint64_t    start;
+    uint64_t    end;
+    union
+    {
+	bl_bed_t    bed;
+	bl_gff_t    gff;
+    };
+}   bl_intersect_feature_t;
+
+typedef struct
+{
+    FILE        *stream;
+    int         format;
+    char        last_chrom[BL_CHROM_MAX_CHARS + 1];    // Sort order check
+    uint64_t    last_start;
+    uint64_t    features_read;
+}   bl_intersect_input_t;
+
+typedef struct
+{
+    bl_intersect_input_t    input1;
+    bl_intersect_input_t    input2;
+
+    bl_intersect_feature_t  *feature1;  // Current feature from input1
+    bl_intersect_feature_t  *feature2;  // Its current overlapping partner
+    bl_overlap_t            overlap;
+
+    /*
+     *  Features from input2 that may overlap the current or a later
+     *  feature from input1, in input order.
+     */
+    bl_intersect_feature_t  **window;
+    size_t                  window_count;
+    size_t                  window_max;
+    size_t                  window_pos;     // Next to test against feature1
+    bl_intersect_feature_t  *lookahead;     // Next from input2, or NULL
+
+    bl_intersect_feature_t  **pool;         // Spare features for reuse
+    size_t                  pool_count;
+    size_t                  pool_max;
+
+    bool                    started;
+    uint64_t                pairs;
+    size_t                  max_window;
+}   bl_intersect_t;
+
+/* Not generated by gen-get-set */
+#define BL_INTERSECT_FEATURE1(ptr)          ((ptr)->feature1)
+#define BL_INTERSECT_FEATURE2(ptr)          ((ptr)->feature2)
+#define BL_INTERSECT_OVERLAP(ptr)           (&(ptr)->overlap)
+#define BL_INTERSECT_PAIRS(ptr)             ((ptr)->pairs)
+#define BL_INTERSECT_MAX_WINDOW(ptr)        ((ptr)->max_window)
+#define BL_INTERSECT_FEATURES1_READ(ptr)    ((ptr)->input1.features_read)
+#define BL_INTERSECT_FEATURES2_READ(ptr)    ((ptr)->input2.features_read)
+#define BL_INTERSECT_FEATURE_FORMAT(ptr)    ((ptr)->format)
+#define BL_INTERSECT_FEATURE_CHROM(ptr)     ((ptr)->chrom)
+#define BL_INTERSECT_FEATURE_START(ptr)     ((ptr)->start)
+#define BL_INTERSECT_FEATURE_END(ptr)       ((ptr)->end)
+#define BL_INTERSECT_FEATURE_BED(ptr)       (&(ptr)->bed)
+#define BL_INTERSECT_FEATURE_GFF(ptr)       (&(ptr)->gff)
+
+/* intersect.c */
+void bl_intersect_init(bl_intersect_t *intersect, FILE *stream1, int format1, FILE *stream2, int format2);
+int bl_intersect_next(bl_intersect_t *intersect);
+void bl_intersect_free(bl_intersect_t *intersect);
+
+#endif  // _intersect_h_
@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>   // PRIu64
+#include "overlap-stats.h"
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/overlap-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize an overlap statistics accumulator.  Pairs are added
+ *      with bl_overlap_stats_add(3) or bl_overlap_stats_add_batch(3),
+ *      which update totals of overlap and feature lengths, the
+ *      fractions of each feature covered, Jaccard indexes, and
+ *      histograms of overlap length and fractions.  Results are read
+ *      with the BL_OVERLAP_STATS_*() macros or written with
+ *      bl_overlap_stats_write(3).
+ *
+ *  Arguments:
+ *      stats:  Pointer to the bl_overlap_stats_t structure to initialize
+ *
+ *  Examples:
+ *      bl_overlap_stats_t  stats;
+ *
+ *      bl_overlap_stats_init(&stats);
+ *      while ( ... )
+ *      {
+ *          if ( bl_bed_gff_cmp(&bed_feature, &gff_feature, &overlap) == 0 )
+ *              bl_overlap_stats_add(&stats, &overlap);
+ *      }
+ *      bl_overlap_stats_write(stdout, &stats);
+ *
+ *  See also:
+ *      bl_overlap_stats_add(3), bl_overlap_stats_merge(3),
+ *      bl_overlap_stats_write(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_overlap_stats_init(bl_overlap_stats_t *stats)
+
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->overlap_len_min = UINT64_MAX;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/overlap-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add one pair of features to an overlap statistics accumulator in
+ *      constant time.  A pair with overlap_len or either feature length
+ *      0, such as those reported by bl_bed_gff_cmp(3) for features that
+ *      do not overlap, is counted in pairs only.  Fraction histogram
+ *      bins are 1/BL_OVERLAP_STATS_FRACTION_BINS wide, with an extra
+ *      bin for features covered completely.  Length histogram bin b
+ *      counts overlaps of 2^b through 2^(b+1) - 1 bases.
+ *
+ *  Arguments:
+ *      stats:      Pointer to an initialized bl_overlap_stats_t structure
+ *      overlap:    Pointer to a bl_overlap_t structure
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_INVALID if overlap_len exceeds a feature length, in which
+ *      case the statistics are left unchanged
+ *
+ *  See also:
+ *      bl_overlap_stats_init(3), bl_overlap_stats_add_batch(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_overlap_stats_add(bl_overlap_stats_t *stats, bl_overlap_t *overlap)
+
+{
+    uint64_t    len = overlap->overlap_len,
+		len1 = overlap->feature1_len,
+		len2 = overlap->feature2_len,
+		union_len;
+
+    if ( (len == 0) || (len1 == 0) || (len2 == 0) )
+    {
+	++stats->pairs;
+	return BL_DATA_OK;
+    }
+    if ( (len > len1) || (len > len2) )
+	return BL_DATA_INVALID;
+
+    ++stats->pairs;
+    ++stats->overlapping;
+    stats->overlap_len_sum += len;
+    if ( len < stats->overlap_len_min )
+	stats->overlap_len_min = len;
+    if ( len > stats->overlap_len_max )
+	stats->overlap_len_max = len;
+    stats->feature1_len_sum += len1;
+    stats->feature2_len_sum += len2;
+    union_len = len1 + len2 - len;
+    stats->union_len_sum += union_len;
+    stats->fraction1_sum += (double)len / len1;
+    stats->fraction2_sum += (double)len / len2;
+    stats->jaccard_sum += (double)len / union_len;
+
+    // len > 0, so clzll() is defined
+    ++stats->len_hist[63 - __builtin_clzll(len)];
+    ++stats->fraction1_hist[len * BL_OVERLAP_STATS_FRACTION_BINS / len1];
+    ++stats->fraction2_hist[len * BL_OVERLAP_STATS_FRACTION_BINS / len2];
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/overlap-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add an array of pairs to an overlap statistics accumulator, e.g.
+ *      the results of bl_overlap_batch(3).  Equivalent to calling
+ *      bl_overlap_stats_add(3) for each element.
+ *
+ *  Arguments:
+ *      stats:      Pointer to an initialized bl_overlap_stats_t structure
+ *      overlaps:   Array of bl_overlap_t structures
+ *      count:      Number of elements in overlaps
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_INVALID if any pair is invalid.  Valid pairs are still
+ *      added.
+ *
+ *  See also:
+ *      bl_overlap_stats_add(3), bl_overlap_batch(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_overlap_stats_add_batch(bl_overlap_stats_t *stats,
+				   bl_overlap_t *overlaps, size_t count)
+
+{
+    size_t  c;
+    int     status = BL_DATA_OK;
+
+    for (c = 0; c < count; ++c)
+	if ( bl_overlap_stats_add(stats, &overlaps[c]) != BL_DATA_OK )
+	    status = BL_DATA_INVALID;
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/overlap-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add the statistics in src to dest, e.g. to combine results from
+ *      threads that each processed part of the input.  src is not
+ *      modified.
+ *
+ *  Arguments:
+ *      dest:   Pointer to the bl_overlap_stats_t structure to add to
+ *      src:    Pointer to the bl_overlap_stats_t structure to add
+ *
+ *  See also:
+ *      bl_overlap_stats_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_overlap_stats_merge(bl_overlap_stats_t *dest,
+			       bl_overlap_stats_t *src)
+
+{
+    size_t  c;
+
+    dest->pairs += src->pairs;
+    dest->overlapping += src->overlapping;
+    dest->overlap_len_sum += src->overlap_len_sum;
+    if ( src->overlap_len_min < dest->overlap_len_min )
+	dest->overlap_len_min = src->overlap_len_min;
+    if ( src->overlap_len_max > dest->overlap_len_max )
+	dest->overlap_len_max = src->overlap_len_max;
+    dest->feature1_len_sum += src->feature1_len_sum;
+    dest->feature2_len_sum += src->feature2_len_sum;
+    dest->union_len_sum += src->union_len_sum;
+    dest->fraction1_sum += src->fraction1_sum;
+    dest->fraction2_sum += src->fraction2_sum;
+    dest->jaccard_sum += src->jaccard_sum;
+    for (c = 0; c < BL_OVERLAP_STATS_LEN_BINS; ++c)
+	dest->len_hist[c] += src->len_hist[c];
+    for (c = 0; c <= BL_OVERLAP_STATS_FRACTION_BINS; ++c)
+    {
+	dest->fraction1_hist[c] += src->fraction1_hist[c];
+	dest->fraction2_hist[c] += src->fraction2_hist[c];
+    }
+}
+
+
+/* Write nonzero bins of a fraction histogram */
+static void overlap_stats_write_fractions(FILE *stream, const char *tag,
+					  uint64_t *hist)
+
+{
+    size_t  c;
+
+    for (c = 0; c < BL_OVERLAP_STATS_FRACTION_BINS; ++c)
+	if ( hist[c] != 0 )
+	    fprintf(stream, "%s\t%.2f\t%.2f\t%" PRIu64 "\n", tag,
+		    (double)c / BL_OVERLAP_STATS_FRACTION_BINS,
+		    (double)(c + 1) / BL_OVERLAP_STATS_FRACTION_BINS, hist[c]);
+    if ( hist[c] != 0 )
+	fprintf(stream, "%s\t1.00\t1.00\t%" PRIu64 "\n", tag, hist[c]);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/overlap-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Write a compact summary of an overlap statistics accumulator as
+ *      tab-separated lines, one "name value" line per statistic
+ *      followed by "name low high count" lines for the nonzero bins of
+ *      each histogram.  Length bins are inclusive at both ends, fraction
+ *      bins include the low end only, except the final 1.00 bin.
+ *      "jaccard" is the total overlap over the total union length of
+ *      overlapping pairs, while the "mean_" statistics average
+ *      per-pair values.
+ *
+ *  Arguments:
+ *      stream: FILE stream to which the summary is written
+ *      stats:  Pointer to a bl_overlap_stats_t structure
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success
+ *      BL_WRITE_FAILURE if an error occurred on stream
+ *
+ *  Examples:
+ *      bl_overlap_stats_write(stdout, &stats);
+ *
+ *  See also:
+ *      bl_overlap_stats_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_overlap_stats_write(FILE *stream, bl_overlap_stats_t *stats)
+
+{
+    size_t  c;
+
+    fprintf(stream, "pairs\t%" PRIu64 "\n"
+		    "overlapping\t%" PRIu64 "\n"
+		    "overlap_len_sum\t%" PRIu64 "\n"
+		    "overlap_len_min\t%" PRIu64 "\n"
+		    "overlap_len_max\t%" PRIu64 "\n"
+		    "mean_overlap_len\t%.2f\n"
+		    "mean_fraction1\t%.4f\n"
+		    "mean_fraction2\t%.4f\n"
+		    "mean_jaccard\t%.4f\n"
+		    "jaccard\t%.4f\n",
+	    stats->pairs, stats->overlapping, stats->overlap_len_sum,
+	    stats->overlapping == 0 ? 0 : stats->overlap_len_min,
+	    stats->overlap_len_max,
+	    BL_OVERLAP_STATS_MEAN_OVERLAP_LEN(stats),
+	    BL_OVERLAP_STATS_MEAN_FRACTION1(stats),
+	    BL_OVERLAP_STATS_MEAN_FRACTION2(stats),
+	    BL_OVERLAP_STATS_MEAN_JACCARD(stats),
+	    BL_OVERLAP_STATS_JACCARD(stats));
+    for (c = 0; c < BL_OVERLAP_STATS_LEN_BINS; ++c)
+	if ( stats->len_hist[c] != 0 )
+	    fprintf(stream, "len_hist\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\n",
+		    (uint64_t)1 << c, ((uint64_t)2 << c) - 1, stats->len_hist[c]);
+    overlap_stats_write_fractions(stream, "fraction1_hist",
+				  stats->fraction1_hist);
+    overlap_stats_write_fractions(stream, "fraction2_hist",
+				  stats->fraction2_hist);
+    return ferror(stream) ? BL_WRITE_FAILURE : BL_WRITE_OK;
+}
@@ -0,0 +1,75 @@
+#ifndef _overlap_stats_h_
+#define _overlap_stats_h_
+
+#ifndef _STDIO_H_
+#include <stdio.h>
+#endif
+
+#ifndef _STDINT_H_
+#include <stdint.h>
+#endif
+
+#ifndef _bl_overlap_h_
+#include "overlap.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+#define BL_OVERLAP_STATS_LEN_BINS       64  // By floor(log2(overlap_len))
+#define BL_OVERLAP_STATS_FRACTION_BINS  20  // Plus one for exactly 1.0
+
+/*
+ *  Totals over many bl_overlap_t pairs.  Lengths and fractions are
+ *  summed over overlapping pairs only.  Updated in constant time per
+ *  pair by bl_overlap_stats_add().
+ */
+typedef struct
+{
+    uint64_t    pairs;              // All pairs added
+    uint64_t    overlapping;        // Pairs with overlap_len > 0
+    uint64_t    overlap_len_sum;
+    uint64_t    overlap_len_min;
+    uint64_t    overlap_len_max;
+    uint64_t    feature1_len_sum;
+    uint64_t    feature2_len_sum;
+    uint64_t    union_len_sum;      // Denominator of total Jaccard index
+    double      fraction1_sum;      // overlap_len / feature1_len
+    double      fraction2_sum;      // overlap_len / feature2_len
+    double      jaccard_sum;        // overlap_len / union length
+    uint64_t    len_hist[BL_OVERLAP_STATS_LEN_BINS];
+    uint64_t    fraction1_hist[BL_OVERLAP_STATS_FRACTION_BINS + 1];
+    uint64_t    fraction2_hist[BL_OVERLAP_STATS_FRACTION_BINS + 1];
+}   bl_overlap_stats_t;
+
+/* Not generated by gen-get-set */
+#define BL_OVERLAP_STATS_PAIRS(ptr)             ((ptr)->pairs)
+#define BL_OVERLAP_STATS_OVERLAPPING(ptr)       ((ptr)->overlapping)
+#define BL_OVERLAP_STATS_OVERLAP_LEN_SUM(ptr)   ((ptr)->overlap_len_sum)
+#define BL_OVERLAP_STATS_OVERLAP_LEN_MIN(ptr)   ((ptr)->overlap_len_min)
+#define BL_OVERLAP_STATS_OVERLAP_LEN_MAX(ptr)   ((ptr)->overlap_len_max)
+#define BL_OVERLAP_STATS_LEN_HIST_AE(ptr,c)     ((ptr)->len_hist[c])
+#define BL_OVERLAP_STATS_FRACTION1_HIST_AE(ptr,c) ((ptr)->fraction1_hist[c])
+#define BL_OVERLAP_STATS_FRACTION2_HIST_AE(ptr,c) ((ptr)->fraction2_hist[c])
+#define BL_OVERLAP_STATS_MEAN_OVERLAP_LEN(ptr) \
+	((ptr)->overlapping == 0 ? 0.0 : \
+	 (double)(ptr)->overlap_len_sum / (ptr)->overlapping)
+#define BL_OVERLAP_STATS_MEAN_FRACTION1(ptr) \
+	((ptr)->overlapping == 0 ? 0.0 : (ptr)->fraction1_sum / (ptr)->overlapping)
+#define BL_OVERLAP_STATS_MEAN_FRACTION2(ptr) \
+	((ptr)->overlapping == 0 ? 0.0 : (ptr)->fraction2_sum / (ptr)->overlapping)
+#define BL_OVERLAP_STATS_MEAN_JACCARD(ptr) \
+	((ptr)->overlapping == 0 ? 0.0 : (ptr)->jaccard_sum / (ptr)->overlapping)
+#define BL_OVERLAP_STATS_JACCARD(ptr) \
+	((ptr)->union_len_sum == 0 ? 0.0 : \
+	 (double)(ptr)->overlap_len_sum / (ptr)->union_len_sum)
+
+/* overlap-stats.c */
+void bl_overlap_stats_init(bl_overlap_stats_t *stats);
+int bl_overlap_stats_add(bl_overlap_stats_t *stats, bl_overlap_t *overlap);
+int bl_overlap_stats_add_batch(bl_overlap_stats_t *stats, bl_overlap_t *overlaps, size_t count);
+void bl_overlap_stats_merge(bl_overlap_stats_t *dest, bl_overlap_stats_t *src);
+int bl_overlap_stats_write(FILE *stream, bl_overlap_stats_t *stats);
+
+#endif  // _overlap_stats_h_
@@ -1,4 +1,5 @@
 #ifndef _bl_overlap_h_
+#define _bl_overlap_h_
 
 #ifndef _STDIO_H_
 #include <stdio.h>
@@ -61,6 +62,7 @@ typedef struct
 /* overlap.c */
 int bl_overlap_set_all(bl_overlap_t *overlap, uint64_t feature1_len, uint64_t feature2_len, uint64_t overlap_start, uint64_t overlap_end);
 int bl_overlap_print(FILE *stream, bl_overlap_t *overlap, char *feature1_name, char *feature2_name);
+size_t bl_overlap_batch(bl_overlap_t *overlaps, uint64_t query_start, uint64_t query_end, const uint64_t *starts, const uint64_t *ends, size_t count);
 
 /* overlap-mutators.c */
 int bl_overlap_set_feature1_len(bl_overlap_t *bl_overlap_ptr, uint64_t new_feature1_len);
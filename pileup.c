@@ -0,0 +1,512 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "pileup.h"
+#include "biolibc.h"
+
+#define BL_PILEUP_START_READS   256
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/pileup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a bl_pileup_t structure for assembling pileup columns
+ *      from a SAM stream sorted by RNAME and POS.
+ *
+ *      Alignments are added with bl_pileup_push(3) and columns are
+ *      retrieved with bl_pileup_next(3).  Reads are filtered with
+ *      bl_sam_buff_alignment_ok(3) using the MAPQ minimum in sam_buff,
+ *      and input order is checked with bl_sam_buff_check_order(3).
+ *      Discard statistics accumulate in sam_buff as usual.  If
+ *      BL_SAM_BUFF_SEQ_ENCODING(sam_buff) is not BL_SEQ_ASCII, the
+ *      sequences of active reads are packed to save memory.
+ *
+ *  Arguments:
+ *      pileup:     Pointer to the bl_pileup_t structure to initialize
+ *      sam_buff:   Pointer to an initialized bl_sam_buff_t structure
+ *
+ *  Examples:
+ *      bl_sam_buff_t   sam_buff;
+ *      bl_pileup_t     pileup;
+ *
+ *      bl_sam_buff_init(&sam_buff, 20);
+ *      bl_pileup_init(&pileup, &sam_buff);
+ *
+ *  See also:
+ *      bl_pileup_push(3), bl_pileup_next(3), bl_pileup_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_pileup_init(bl_pileup_t *pileup, bl_sam_buff_t *sam_buff)
+
+{
+    pileup->sam_buff = sam_buff;
+
+    pileup->read_count = 0;
+    pileup->read_max = BL_PILEUP_START_READS;
+    if ( (pileup->reads = xt_malloc(pileup->read_max,
+	    sizeof(*pileup->reads))) == NULL )
+    {
+	fprintf(stderr, "bl_pileup_init(): Could not allocate reads.\n");
+	exit(EX_UNAVAILABLE);
+    }
+
+    pileup->spare_count = 0;
+    pileup->spare_max = BL_PILEUP_START_READS;
+    if ( (pileup->spares = xt_malloc(pileup->spare_max,
+	    sizeof(*pileup->spares))) == NULL )
+    {
+	fprintf(stderr, "bl_pileup_init(): Could not allocate spares.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    pileup->pending = NULL;
+
+    pileup->entry_count = 0;
+    pileup->entry_max = BL_PILEUP_START_READS;
+    if ( (pileup->entries = xt_malloc(pileup->entry_max,
+	    sizeof(*pileup->entries))) == NULL )
+    {
+	fprintf(stderr, "bl_pileup_init(): Could not allocate entries.\n");
+	exit(EX_UNAVAILABLE);
+    }
+
+    *pileup->rname = '\0';
+    pileup->pos = 0;
+    pileup->push_pos = 0;
+    pileup->advance = false;
+    pileup->finished = false;
+}
+
+
+/*
+ *  Make a private copy of an alignment, reusing a retired bl_sam_t
+ *  if possible.  The structure alone is over 16k, so recycling saves
+ *  a lot of malloc() traffic at high depth.
+ */
+
+static bl_sam_t *pileup_copy_alignment(bl_pileup_t *pileup,
+				       bl_sam_t *sam_alignment)
+
+{
+    bl_sam_t    *copy;
+
+    if ( pileup->spare_count > 0 )
+	copy = pileup->spares[--pileup->spare_count];
+    else if ( (copy = xt_malloc(1, sizeof(*copy))) == NULL )
+    {
+	fprintf(stderr, "bl_pileup_push(): Could not allocate alignment.\n");
+	exit(EX_UNAVAILABLE);
+    }
+
+    bl_sam_copy(copy, sam_alignment);
+    if ( (BL_SAM_CIGAR_OP_COUNT(copy) == 0) &&
+	 (bl_sam_cigar_parse(copy) != BL_DATA_OK) )
+    {
+	fprintf(stderr, "bl_pileup_push(): Invalid CIGAR: %s\n",
+		BL_SAM_CIGAR(copy));
+	fprintf(stderr, "qname = %s rname = %s\n",
+		BL_SAM_QNAME(copy), BL_SAM_RNAME(copy));
+	exit(EX_DATAERR);
+    }
+
+    // SEQ "*" is not a base
+    if ( (copy->seq_len == 1) && (*copy->seq == '*') )
+	copy->seq_len = 0;
+
+    if ( BL_SAM_BUFF_SEQ_ENCODING(pileup->sam_buff) != BL_SEQ_ASCII )
+	bl_sam_pack_seq(copy, BL_SAM_BUFF_SEQ_ENCODING(pileup->sam_buff));
+    return copy;
+}
+
+
+static void pileup_retire_alignment(bl_pileup_t *pileup,
+				    bl_sam_t *sam_alignment)
+
+{
+    bl_sam_free(sam_alignment);
+    if ( pileup->spare_count == pileup->spare_max )
+    {
+	pileup->spare_max *= 2;
+	if ( (pileup->spares = xt_realloc(pileup->spares,
+		pileup->spare_max, sizeof(*pileup->spares))) == NULL )
+	{
+	    fprintf(stderr, "bl_pileup_next(): Could not allocate spares.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    pileup->spares[pileup->spare_count++] = sam_alignment;
+}
+
+
+static void pileup_activate(bl_pileup_t *pileup, bl_sam_t *sam_alignment)
+
+{
+    bl_pileup_read_t    *read;
+
+    if ( pileup->read_count == pileup->read_max )
+    {
+	pileup->read_max *= 2;
+	if ( (pileup->reads = xt_realloc(pileup->reads,
+		pileup->read_max, sizeof(*pileup->reads))) == NULL )
+	{
+	    fprintf(stderr, "bl_pileup_push(): Could not allocate reads.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+
+    // First read after a gap in coverage
+    if ( pileup->read_count == 0 )
+    {
+	strlcpy(pileup->rname, BL_SAM_RNAME(sam_alignment),
+		BL_SAM_RNAME_MAX_CHARS + 1);
+	pileup->pos = BL_SAM_POS(sam_alignment);
+	pileup->advance = false;
+    }
+    pileup->push_pos = BL_SAM_POS(sam_alignment);
+
+    read = &pileup->reads[pileup->read_count++];
+    read->alignment = sam_alignment;
+    read->op = 0;
+    read->op_ref_start = BL_SAM_POS(sam_alignment);
+    read->op_query_start = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/pileup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add the next alignment from a sorted SAM stream to a pileup.
+ *      Alignments that are unmapped, have no CIGAR or a CIGAR with no
+ *      reference bases, or fail bl_sam_buff_alignment_ok(3) are
+ *      ignored.  The pileup keeps its own copy, so sam_alignment may be
+ *      reused immediately.  The CIGAR is decoded if the alignment was
+ *      not read with BL_SAM_FIELD_CIGAR_OPS.
+ *
+ *      After each push, call bl_pileup_next(3) until it returns
+ *      BL_PILEUP_NEED_INPUT before pushing another alignment.
+ *
+ *  Arguments:
+ *      pileup:         Pointer to a bl_pileup_t structure
+ *      sam_alignment:  Pointer to the alignment just read
+ *
+ *  Returns:
+ *      true if the alignment was added to the pileup
+ *      false if it was filtered out
+ *
+ *  See also:
+ *      bl_pileup_init(3), bl_pileup_next(3), bl_pileup_finish(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    bl_pileup_push(bl_pileup_t *pileup, bl_sam_t *sam_alignment)
+
+{
+    if ( pileup->pending != NULL )
+    {
+	fprintf(stderr, "bl_pileup_push(): Called before bl_pileup_next() "
+		"returned BL_PILEUP_NEED_INPUT.\n");
+	exit(EX_SOFTWARE);
+    }
+
+    bl_sam_buff_check_order(pileup->sam_buff, sam_alignment);
+    if ( ! bl_sam_buff_alignment_ok(pileup->sam_buff, sam_alignment) ||
+	 (BL_SAM_POS(sam_alignment) == 0) ||
+	 (bl_sam_cigar_ref_len(BL_SAM_CIGAR(sam_alignment)) == 0) )
+	return false;
+
+    /*
+     *  Reads on a new RNAME wait until columns on the current one are
+     *  drained by bl_pileup_next().
+     */
+    if ( ((pileup->read_count > 0) || pileup->advance) &&
+	 (strcmp(BL_SAM_RNAME(sam_alignment), pileup->rname) != 0) )
+	pileup->pending = pileup_copy_alignment(pileup, sam_alignment);
+    else
+	pileup_activate(pileup, pileup_copy_alignment(pileup, sam_alignment));
+    return true;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/pileup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Indicate that there is no more input, so that bl_pileup_next(3)
+ *      returns all remaining columns and then BL_PILEUP_EOF.
+ *
+ *  Arguments:
+ *      pileup:     Pointer to a bl_pileup_t structure
+ *
+ *  See also:
+ *      bl_pileup_push(3), bl_pileup_next(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_pileup_finish(bl_pileup_t *pileup)
+
+{
+    pileup->finished = true;
+}
+
+
+/*
+ *  Fill in a pileup entry for read at the current column, moving the
+ *  CIGAR cursor forward as needed.  Ops that do not consume the
+ *  reference (I, S, H, P) are passed over.
+ */
+
+static void pileup_fill_entry(bl_pileup_t *pileup, bl_pileup_read_t *read,
+			      bl_pileup_entry_t *entry)
+
+{
+    bl_sam_t    *alignment = read->alignment;
+    uint32_t    *ops = BL_SAM_CIGAR_OPS(alignment);
+    unsigned    count = BL_SAM_CIGAR_OP_COUNT(alignment),
+		code, next;
+    uint64_t    ref_len, offset;
+
+    for (;;)
+    {
+	code = BL_SAM_CIGAR_OP(ops[read->op]);
+	ref_len = BL_SAM_CIGAR_CONSUMES_REF(code) ?
+		  BL_SAM_CIGAR_OP_LEN(ops[read->op]) : 0;
+	if ( pileup->pos < read->op_ref_start + ref_len )
+	    break;
+	read->op_ref_start += ref_len;
+	if ( BL_SAM_CIGAR_CONSUMES_QUERY(code) )
+	    read->op_query_start += BL_SAM_CIGAR_OP_LEN(ops[read->op]);
+	++read->op;
+    }
+
+    offset = pileup->pos - read->op_ref_start;
+    entry->alignment = alignment;
+    entry->indel = 0;
+    entry->flags = 0;
+    if ( BL_SAM_CIGAR_CONSUMES_QUERY(code) )
+    {
+	entry->query_pos = read->op_query_start + offset;
+	if ( entry->query_pos < alignment->seq_len )
+	    entry->base = bl_sam_seq_base(alignment, entry->query_pos);
+	else
+	    entry->base = 'N';
+	if ( (entry->query_pos < alignment->qual_len) &&
+	     (alignment->qual_len == alignment->seq_len) )
+	    entry->qual = alignment->qual[entry->query_pos] - 33;
+	else
+	    entry->qual = BL_PILEUP_QUAL_NONE;
+    }
+    else
+    {
+	entry->query_pos = read->op_query_start;
+	entry->qual = BL_PILEUP_QUAL_NONE;
+	if ( code == BL_SAM_CIGAR_N )
+	{
+	    entry->base = '>';
+	    entry->flags |= BL_PILEUP_REF_SKIP;
+	}
+	else
+	{
+	    entry->base = '*';
+	    entry->flags |= BL_PILEUP_DEL;
+	}
+    }
+
+    // Indel following the last base of a match op
+    if ( (offset == ref_len - 1) && BL_SAM_CIGAR_CONSUMES_QUERY(code) )
+    {
+	for (next = read->op + 1; (next < count) &&
+		(BL_SAM_CIGAR_OP(ops[next]) == BL_SAM_CIGAR_P); ++next)
+	    ;
+	if ( next < count )
+	{
+	    if ( BL_SAM_CIGAR_OP(ops[next]) == BL_SAM_CIGAR_I )
+		entry->indel = BL_SAM_CIGAR_OP_LEN(ops[next]);
+	    else if ( BL_SAM_CIGAR_OP(ops[next]) == BL_SAM_CIGAR_D )
+		entry->indel = -(int)BL_SAM_CIGAR_OP_LEN(ops[next]);
+	}
+    }
+
+    if ( pileup->pos == BL_SAM_POS(alignment) )
+	entry->flags |= BL_PILEUP_HEAD;
+    if ( pileup->pos == BL_SAM_REF_END(alignment) )
+	entry->flags |= BL_PILEUP_TAIL;
+    if ( BL_SAM_FLAG(alignment) & BAM_FREVERSE )
+	entry->flags |= BL_PILEUP_REVERSE;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/pileup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Assemble the next complete pileup column.  A column is complete
+ *      once an alignment starting past it has been pushed, the RNAME
+ *      has changed, or bl_pileup_finish(3) has been called.  Positions
+ *      not covered by any read are skipped.
+ *
+ *      On success, BL_PILEUP_RNAME() and BL_PILEUP_POS() give the
+ *      column position, BL_PILEUP_DEPTH() the number of reads, and
+ *      BL_PILEUP_ENTRIES_AE() each read's query offset, base, Phred
+ *      quality, and indel state.  Deleted and skipped reference
+ *      positions are included, with base '*' and '>' respectively and
+ *      flags BL_PILEUP_DEL or BL_PILEUP_REF_SKIP.  An entry with
+ *      indel > 0 is followed by an insertion of that length, and one
+ *      with indel < 0 by a deletion.  Entries, and the alignments
+ *      they point to, are valid until the next call.
+ *
+ *      Each active read carries a CIGAR cursor that moves forward one
+ *      column at a time, so the cost per column is proportional to the
+ *      depth, not the total length of the CIGARs.
+ *
+ *  Arguments:
+ *      pileup:     Pointer to a bl_pileup_t structure
+ *
+ *  Returns:
+ *      BL_PILEUP_OK if a column is available
+ *      BL_PILEUP_NEED_INPUT if more alignments must be pushed
+ *      BL_PILEUP_EOF if finished and all columns have been returned
+ *
+ *  Examples:
+ *      bl_sam_t        sam_alignment = BL_SAM_ALIGNMENT_INIT;
+ *      bl_pileup_t     pileup;
+ *      size_t          c;
+ *
+ *      bl_pileup_init(&pileup, &sam_buff);
+ *      while ( bl_sam_read(stdin, &sam_alignment,
+ *                  BL_SAM_FIELD_ALL | BL_SAM_FIELD_CIGAR_OPS) == BL_READ_OK )
+ *      {
+ *          bl_pileup_push(&pileup, &sam_alignment);
+ *          while ( bl_pileup_next(&pileup) == BL_PILEUP_OK )
+ *              process_column(&pileup);
+ *      }
+ *      bl_pileup_finish(&pileup);
+ *      while ( bl_pileup_next(&pileup) == BL_PILEUP_OK )
+ *          process_column(&pileup);
+ *      bl_pileup_free(&pileup);
+ *
+ *  See also:
+ *      bl_pileup_init(3), bl_pileup_push(3), bl_pileup_finish(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_pileup_next(bl_pileup_t *pileup)
+
+{
+    size_t  c, kept;
+
+    // Retire reads that ended at the column last returned
+    if ( pileup->advance )
+    {
+	++pileup->pos;
+	for (c = kept = 0; c < pileup->read_count; ++c)
+	{
+	    if ( BL_SAM_REF_END(pileup->reads[c].alignment) < pileup->pos )
+		pileup_retire_alignment(pileup, pileup->reads[c].alignment);
+	    else
+		pileup->reads[kept++] = pileup->reads[c];
+	}
+	pileup->read_count = kept;
+	pileup->advance = false;
+    }
+    pileup->entry_count = 0;
+
+    if ( pileup->read_count == 0 )
+    {
+	if ( pileup->pending == NULL )
+	    return pileup->finished ? BL_PILEUP_EOF : BL_PILEUP_NEED_INPUT;
+	pileup_activate(pileup, pileup->pending);
+	pileup->pending = NULL;
+    }
+
+    // Reads are sorted by POS, so reads[0] has the leftmost start
+    if ( BL_SAM_POS(pileup->reads[0].alignment) > pileup->pos )
+	pileup->pos = BL_SAM_POS(pileup->reads[0].alignment);
+
+    // Another read could still start here
+    if ( (pileup->pos >= pileup->push_pos) && ! pileup->finished &&
+	 (pileup->pending == NULL) )
+	return BL_PILEUP_NEED_INPUT;
+
+    if ( pileup->read_count > pileup->entry_max )
+    {
+	pileup->entry_max = pileup->read_max;
+	if ( (pileup->entries = xt_realloc(pileup->entries,
+		pileup->entry_max, sizeof(*pileup->entries))) == NULL )
+	{
+	    fprintf(stderr, "bl_pileup_next(): Could not allocate entries.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+
+    for (c = 0; (c < pileup->read_count) &&
+		(BL_SAM_POS(pileup->reads[c].alignment) <= pileup->pos); ++c)
+	pileup_fill_entry(pileup, &pileup->reads[c],
+			  &pileup->entries[pileup->entry_count++]);
+    pileup->advance = true;
+    return BL_PILEUP_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/pileup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory allocated by a bl_pileup_t structure.  The
+ *      bl_sam_buff_t passed to bl_pileup_init(3) is not freed.
+ *
+ *  Arguments:
+ *      pileup:     Pointer to a bl_pileup_t structure
+ *
+ *  See also:
+ *      bl_pileup_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_pileup_free(bl_pileup_t *pileup)
+
+{
+    size_t  c;
+
+    for (c = 0; c < pileup->read_count; ++c)
+	pileup_retire_alignment(pileup, pileup->reads[c].alignment);
+    if ( pileup->pending != NULL )
+	pileup_retire_alignment(pileup, pileup->pending);
+    for (c = 0; c < pileup->spare_count; ++c)
+	free(pileup->spares[c]);
+    free(pileup->spares);
+    free(pileup->reads);
+    free(pileup->entries);
+    pileup->spares = NULL;
+    pileup->reads = NULL;
+    pileup->entries = NULL;
+    pileup->read_count = pileup->spare_count = pileup->entry_count = 0;
+    pileup->pending = NULL;
+}
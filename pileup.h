@@ -0,0 +1,96 @@
+#ifndef _pileup_h_
+#define _pileup_h_
+
+#ifndef _STDBOOL_H_
+#include <stdbool.h>
+#endif
+
+#ifndef _sam_buff_h_
+#include "sam-buff.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+// Return values for bl_pileup_next()
+#define BL_PILEUP_OK            0
+#define BL_PILEUP_NEED_INPUT    1
+#define BL_PILEUP_EOF           -1
+
+// bl_pileup_entry_t flags
+#define BL_PILEUP_DEL           0x01    // Deletion, base is '*'
+#define BL_PILEUP_REF_SKIP      0x02    // Skipped region (N), base is '>'
+#define BL_PILEUP_HEAD          0x04    // First reference position of read
+#define BL_PILEUP_TAIL          0x08    // Last reference position of read
+#define BL_PILEUP_REVERSE       0x10    // Read is on the reverse strand
+
+#define BL_PILEUP_QUAL_NONE     255     // QUAL was "*"
+
+typedef struct
+{
+    bl_sam_t        *alignment;
+    size_t          query_pos;  // 0-based offset in SEQ, next base if DEL
+    int             indel;      // Length of following I (> 0) or D (< 0)
+    char            base;
+    unsigned char   qual;       // Phred score
+    unsigned char   flags;
+}   bl_pileup_entry_t;
+
+/*
+ *  Per-read CIGAR cursor.  Advanced one column at a time, so each read
+ *  costs O(1) per column regardless of CIGAR length.
+ */
+typedef struct
+{
+    bl_sam_t        *alignment;
+    unsigned        op;             // Index of current CIGAR op
+    uint64_t        op_ref_start;   // Reference position where op starts
+    size_t          op_query_start; // SEQ offset where op starts
+}   bl_pileup_read_t;
+
+typedef struct
+{
+    bl_sam_buff_t       *sam_buff;  // MAPQ filter, order check, stats
+
+    bl_pileup_read_t    *reads;     // Active reads, sorted by POS
+    size_t              read_count;
+    size_t              read_max;
+    bl_sam_t            **spares;   // Retired bl_sam_t structures
+    size_t              spare_count;
+    size_t              spare_max;
+    bl_sam_t            *pending;   // First read on the next RNAME
+
+    bl_pileup_entry_t   *entries;   // Current column
+    size_t              entry_count;
+    size_t              entry_max;
+
+    char                rname[BL_SAM_RNAME_MAX_CHARS + 1];
+    uint64_t            pos;        // Current column
+    uint64_t            push_pos;   // POS of last read pushed
+    bool                advance;    // Move to the next column
+    bool                finished;   // No more input
+}   bl_pileup_t;
+
+/* Not generated by gen-get-set */
+#define BL_PILEUP_RNAME(ptr)            ((ptr)->rname)
+#define BL_PILEUP_POS(ptr)              ((ptr)->pos)
+#define BL_PILEUP_DEPTH(ptr)            ((ptr)->entry_count)
+#define BL_PILEUP_ENTRIES(ptr)          ((ptr)->entries)
+#define BL_PILEUP_ENTRIES_AE(ptr,c)     ((ptr)->entries[c])
+
+#define BL_PILEUP_ENTRY_ALIGNMENT(ptr)  ((ptr)->alignment)
+#define BL_PILEUP_ENTRY_QUERY_POS(ptr)  ((ptr)->query_pos)
+#define BL_PILEUP_ENTRY_INDEL(ptr)      ((ptr)->indel)
+#define BL_PILEUP_ENTRY_BASE(ptr)       ((ptr)->base)
+#define BL_PILEUP_ENTRY_QUAL(ptr)       ((ptr)->qual)
+#define BL_PILEUP_ENTRY_FLAGS(ptr)      ((ptr)->flags)
+
+/* pileup.c */
+void bl_pileup_init(bl_pileup_t *pileup, bl_sam_buff_t *sam_buff);
+bool bl_pileup_push(bl_pileup_t *pileup, bl_sam_t *sam_alignment);
+void bl_pileup_finish(bl_pileup_t *pileup);
+int bl_pileup_next(bl_pileup_t *pileup);
+void bl_pileup_free(bl_pileup_t *pileup);
+
+#endif  // _pileup_h_
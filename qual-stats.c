@@ -0,0 +1,521 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "qual-stats.h"
+
+/*
+ *  The AVX2 kernel is compiled with a function target attribute and
+ *  chosen at run time with __builtin_cpu_supports(), so a default build
+ *  uses it on CPUs that have it, without -mavx2.  SSE2 is part of the
+ *  x86_64 baseline, so only other CPUs use the scalar code.
+ */
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__x86_64__) && defined(__GNUC__)
+#define QUAL_STATS_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__SSE2__)
+/*
+ *  Summarize 16 characters at a time, returning the number examined
+ *  so the caller can finish the tail.
+ */
+
+static size_t   qual_summarize_sse2(const unsigned char *q, size_t len,
+			unsigned char threshold, uint64_t *sum,
+			unsigned char *min, unsigned char *max,
+			size_t *at_least)
+
+{
+    const __m128i   zero = _mm_setzero_si128(),
+		    thresh = _mm_set1_epi8((char)threshold);
+    __m128i         v, vsum = zero, vmin = _mm_set1_epi8((char)0xff),
+		    vmax = zero;
+    uint64_t        lanes[2];
+    size_t          c;
+
+    for (c = 0; c + 16 <= len; c += 16)
+    {
+	v = _mm_loadu_si128((const __m128i *)(q + c));
+	vsum = _mm_add_epi64(vsum, _mm_sad_epu8(v, zero));
+	vmin = _mm_min_epu8(vmin, v);
+	vmax = _mm_max_epu8(vmax, v);
+	// v >= threshold iff max(v, threshold) == v
+	*at_least += __builtin_popcount(_mm_movemask_epi8(
+			_mm_cmpeq_epi8(_mm_max_epu8(v, thresh), v)));
+    }
+    _mm_storeu_si128((__m128i *)lanes, vsum);
+    *sum = lanes[0] + lanes[1];
+    vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 8));
+    vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 4));
+    vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 2));
+    vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 1));
+    *min = (unsigned char)_mm_cvtsi128_si32(vmin);
+    vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 8));
+    vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 4));
+    vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 2));
+    vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 1));
+    *max = (unsigned char)_mm_cvtsi128_si32(vmax);
+    return c;
+}
+#endif
+
+#if defined(QUAL_STATS_AVX2)
+/*
+ *  Summarize 32 characters at a time, returning the number examined
+ *  so the caller can finish the tail.
+ */
+
+__attribute__((target("avx2")))
+static size_t   qual_summarize_avx2(const unsigned char *q, size_t len,
+			unsigned char threshold, uint64_t *sum,
+			unsigned char *min, unsigned char *max,
+			size_t *at_least)
+
+{
+    const __m256i   zero = _mm256_setzero_si256(),
+		    thresh = _mm256_set1_epi8((char)threshold);
+    __m256i         v, vsum = zero, vmin = _mm256_set1_epi8((char)0xff),
+		    vmax = zero;
+    __m128i         m;
+    uint64_t        lanes[4];
+    size_t          c;
+
+    for (c = 0; c + 32 <= len; c += 32)
+    {
+	v = _mm256_loadu_si256((const __m256i *)(q + c));
+	vsum = _mm256_add_epi64(vsum, _mm256_sad_epu8(v, zero));
+	vmin = _mm256_min_epu8(vmin, v);
+	vmax = _mm256_max_epu8(vmax, v);
+	// v >= threshold iff max(v, threshold) == v
+	*at_least += __builtin_popcount(_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8(_mm256_max_epu8(v, thresh), v)));
+    }
+    _mm256_storeu_si256((__m256i *)lanes, vsum);
+    *sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    m = _mm_min_epu8(_mm256_castsi256_si128(vmin),
+		     _mm256_extracti128_si256(vmin, 1));
+    m = _mm_min_epu8(m, _mm_srli_si128(m, 8));
+    m = _mm_min_epu8(m, _mm_srli_si128(m, 4));
+    m = _mm_min_epu8(m, _mm_srli_si128(m, 2));
+    m = _mm_min_epu8(m, _mm_srli_si128(m, 1));
+    *min = (unsigned char)_mm_cvtsi128_si32(m);
+    m = _mm_max_epu8(_mm256_castsi256_si128(vmax),
+		     _mm256_extracti128_si256(vmax, 1));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 8));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 4));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 2));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 1));
+    *max = (unsigned char)_mm_cvtsi128_si32(m);
+    return c;
+}
+#endif
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/qual-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Compute the sum, minimum, maximum, and number of characters at
+ *      or above threshold for a QUAL string in a single pass.  The
+ *      string is examined in place and need not be null-terminated.
+ *      Values are raw characters, not adjusted for the Phred offset,
+ *      so threshold must include the offset as well.
+ *
+ *      With SSE2 (all x86_64), 16 characters are processed at a time,
+ *      or 32 on CPUs with AVX2, which is detected at run time.  A scan
+ *      over a whole run is therefore limited by memory bandwidth rather
+ *      than instruction count.
+ *
+ *  Arguments:
+ *      qual:       QUAL characters
+ *      len:        Number of characters in qual
+ *      threshold:  Raw character value for the at_least count
+ *      summary:    Pointer to a bl_qual_summary_t to receive the results
+ *
+ *  Examples:
+ *      bl_qual_summary_t   summary;
+ *
+ *      bl_qual_summarize(BL_SAM_QUAL(&sam_alignment),
+ *                        BL_SAM_QUAL_LEN(&sam_alignment),
+ *                        BL_QUAL_PHRED33 + 30, &summary);
+ *      if ( summary.min - BL_QUAL_PHRED33 < 10 )
+ *          ...
+ *
+ *  See also:
+ *      bl_qual_stats_add(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_qual_summarize(const char *qual, size_t len,
+			  unsigned char threshold, bl_qual_summary_t *summary)
+
+{
+    const unsigned char *q = (const unsigned char *)qual;
+    size_t              c = 0, at_least = 0;
+    uint64_t            sum = 0;
+    unsigned char       min = 255, max = 0;
+
+#if defined(QUAL_STATS_AVX2)
+    if ( __builtin_cpu_supports("avx2") )
+	c = qual_summarize_avx2(q, len, threshold, &sum, &min, &max, &at_least);
+    else
+#endif
+#if defined(__SSE2__)
+	c = qual_summarize_sse2(q, len, threshold, &sum, &min, &max, &at_least);
+#endif
+
+    for (; c < len; ++c)
+    {
+	sum += q[c];
+	if ( q[c] < min )
+	    min = q[c];
+	if ( q[c] > max )
+	    max = q[c];
+	at_least += q[c] >= threshold;
+    }
+
+    summary->sum = sum;
+    summary->len = len;
+    summary->at_least = at_least;
+    summary->min = min;
+    summary->max = max;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/qual-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a streaming quality statistics accumulator.  QUAL
+ *      strings are added with bl_qual_stats_add(3) or
+ *      bl_qual_stats_add_sam(3), which update overall and per-cycle
+ *      sums, the Phred score histogram, histograms of per-read mean and
+ *      minimum scores, and the number of bases scoring at least
+ *      threshold.  Results are read with the BL_QUAL_STATS_*() macros
+ *      and bl_qual_stats_cycle_mean(3).
+ *
+ *  Arguments:
+ *      stats:      Pointer to the bl_qual_stats_t structure to initialize
+ *      offset:     BL_QUAL_PHRED33 or BL_QUAL_PHRED64
+ *      threshold:  Phred score for BL_QUAL_STATS_AT_LEAST()
+ *
+ *  Examples:
+ *      bl_qual_stats_t stats;
+ *
+ *      bl_qual_stats_init(&stats, BL_QUAL_PHRED33, 30);
+ *      while ( bl_sam_read(stdin, &sam_alignment, BL_SAM_FIELD_ALL)
+ *              == BL_READ_OK )
+ *          bl_qual_stats_add_sam(&stats, &sam_alignment);
+ *      printf("Mean %f, Q30 %f\n", BL_QUAL_STATS_MEAN(&stats),
+ *             BL_QUAL_STATS_FRACTION_AT_LEAST(&stats));
+ *      bl_qual_stats_free(&stats);
+ *
+ *  See also:
+ *      bl_qual_stats_add(3), bl_qual_stats_cycle_mean(3),
+ *      bl_qual_stats_merge(3), bl_qual_stats_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_qual_stats_init(bl_qual_stats_t *stats, unsigned offset,
+			   unsigned threshold)
+
+{
+    stats->offset = offset;
+    stats->threshold = threshold;
+    stats->reads = stats->bases = stats->sum = stats->at_least = 0;
+    memset(stats->hist, 0, sizeof(stats->hist));
+    memset(stats->mean_hist, 0, sizeof(stats->mean_hist));
+    memset(stats->min_hist, 0, sizeof(stats->min_hist));
+    stats->cycle_sums = NULL;
+    stats->length_hist = NULL;
+    stats->cycle_max = 0;
+    stats->cycle_array_size = 0;
+}
+
+
+static void qual_stats_grow(bl_qual_stats_t *stats, size_t len)
+
+{
+    size_t  new_size;
+
+    for (new_size = stats->cycle_array_size == 0 ? 256 :
+			stats->cycle_array_size;
+	 new_size < len + 1; new_size *= 2)
+	;
+    if ( ((stats->cycle_sums = xt_realloc(stats->cycle_sums, new_size,
+			sizeof(*stats->cycle_sums))) == NULL) ||
+	 ((stats->length_hist = xt_realloc(stats->length_hist, new_size,
+			sizeof(*stats->length_hist))) == NULL) )
+    {
+	fprintf(stderr, "qual_stats_grow(): Could not allocate cycle arrays.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memset(stats->cycle_sums + stats->cycle_array_size, 0,
+	   (new_size - stats->cycle_array_size) * sizeof(*stats->cycle_sums));
+    memset(stats->length_hist + stats->cycle_array_size, 0,
+	   (new_size - stats->cycle_array_size) * sizeof(*stats->length_hist));
+    stats->cycle_array_size = new_size;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/qual-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add one read's QUAL string to a statistics accumulator.  The
+ *      string is examined in place, e.g. directly from a bl_sam_t or a
+ *      FASTQ buffer, and need not be null-terminated.  A missing QUAL
+ *      ("*") is ignored.  If any character is outside the range for the
+ *      accumulator's Phred offset, the read is rejected and the
+ *      statistics are left unchanged.
+ *
+ *  Arguments:
+ *      stats:  Pointer to an initialized bl_qual_stats_t structure
+ *      qual:   QUAL characters
+ *      len:    Number of characters in qual
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_NOT_FOUND if QUAL is empty or "*"
+ *      BL_DATA_INVALID if a character is out of range
+ *
+ *  See also:
+ *      bl_qual_stats_init(3), bl_qual_stats_add_sam(3), bl_qual_summarize(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_qual_stats_add(bl_qual_stats_t *stats, const char *qual, size_t len)
+
+{
+    bl_qual_summary_t   summary;
+    const unsigned char *q = (const unsigned char *)qual;
+    uint64_t            *cycle_sums;
+    size_t              c;
+    unsigned            threshold, offset = stats->offset;
+
+    if ( (len == 0) || ((len == 1) && (*qual == '*')) )
+	return BL_DATA_NOT_FOUND;
+
+    threshold = stats->offset + stats->threshold;
+    bl_qual_summarize(qual, len, threshold > 255 ? 255 : threshold, &summary);
+    if ( (summary.min < stats->offset) || (summary.max > BL_QUAL_CHAR_MAX) )
+	return BL_DATA_INVALID;
+    if ( threshold > 255 )
+	summary.at_least = 0;
+
+    ++stats->reads;
+    stats->bases += len;
+    stats->sum += summary.sum - (uint64_t)len * stats->offset;
+    stats->at_least += summary.at_least;
+    ++stats->mean_hist[(summary.sum + len / 2) / len - stats->offset];
+    ++stats->min_hist[summary.min - stats->offset];
+
+    if ( len >= stats->cycle_array_size )
+	qual_stats_grow(stats, len);
+    if ( len > stats->cycle_max )
+	stats->cycle_max = len;
+    ++stats->length_hist[len];
+
+    // Raw characters in cycle_sums, offset removed by cycle_mean()
+    cycle_sums = stats->cycle_sums;
+    for (c = 0; c < len; ++c)
+    {
+	++stats->hist[q[c] - offset];
+	cycle_sums[c] += q[c];
+    }
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/qual-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add the QUAL field of a SAM alignment to a statistics
+ *      accumulator.  Equivalent to bl_qual_stats_add(3) with
+ *      BL_SAM_QUAL() and BL_SAM_QUAL_LEN().  The alignment must have
+ *      been read with BL_SAM_FIELD_QUAL.
+ *
+ *  Arguments:
+ *      stats:          Pointer to an initialized bl_qual_stats_t structure
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      Same as bl_qual_stats_add(3)
+ *
+ *  See also:
+ *      bl_qual_stats_add(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_qual_stats_add_sam(bl_qual_stats_t *stats, bl_sam_t *sam_alignment)
+
+{
+    if ( BL_SAM_QUAL(sam_alignment) == NULL )
+	return BL_DATA_NOT_FOUND;
+    return bl_qual_stats_add(stats, BL_SAM_QUAL(sam_alignment),
+			     BL_SAM_QUAL_LEN(sam_alignment));
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/qual-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Compute the mean Phred score at a given cycle (0-based position
+ *      within the read) over all reads long enough to reach it.
+ *
+ *  Arguments:
+ *      stats:  Pointer to an initialized bl_qual_stats_t structure
+ *      cycle:  0-based position within reads
+ *
+ *  Returns:
+ *      Mean Phred score at cycle, or 0.0 if no read reaches it
+ *
+ *  See also:
+ *      bl_qual_stats_add(3), BL_QUAL_STATS_CYCLE_MAX()
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+double  bl_qual_stats_cycle_mean(bl_qual_stats_t *stats, size_t cycle)
+
+{
+    uint64_t    reads = 0;
+    size_t      len;
+
+    if ( cycle >= stats->cycle_max )
+	return 0.0;
+    for (len = cycle + 1; len <= stats->cycle_max; ++len)
+	reads += stats->length_hist[len];
+    return (double)stats->cycle_sums[cycle] / reads - stats->offset;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/qual-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add the statistics in src to dest, e.g. to combine results from
+ *      threads that each processed part of the input.  src is not
+ *      modified.  Either side may be empty.  If src's per-cycle arrays
+ *      were released by bl_qual_stats_free(3), only its totals and
+ *      histograms are added.
+ *
+ *  Arguments:
+ *      dest:   Pointer to the bl_qual_stats_t structure to add to
+ *      src:    Pointer to a bl_qual_stats_t with the same offset and
+ *              threshold
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_INVALID if offset or threshold differ
+ *
+ *  See also:
+ *      bl_qual_stats_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_qual_stats_merge(bl_qual_stats_t *dest, bl_qual_stats_t *src)
+
+{
+    size_t  c;
+
+    if ( (dest->offset != src->offset) || (dest->threshold != src->threshold) )
+	return BL_DATA_INVALID;
+    
+    // Nothing to add from an empty accumulator
+    if ( src->reads == 0 )
+	return BL_DATA_OK;
+
+    dest->reads += src->reads;
+    dest->bases += src->bases;
+    dest->sum += src->sum;
+    dest->at_least += src->at_least;
+    for (c = 0; c < BL_QUAL_HIST_SIZE; ++c)
+    {
+	dest->hist[c] += src->hist[c];
+	dest->mean_hist[c] += src->mean_hist[c];
+	dest->min_hist[c] += src->min_hist[c];
+    }
+    
+    // Per-cycle arrays are NULL until a read is added or after free
+    if ( src->cycle_sums == NULL )
+	return BL_DATA_OK;
+    if ( (dest->cycle_sums == NULL) ||
+	 (src->cycle_max >= dest->cycle_array_size) )
+	qual_stats_grow(dest, src->cycle_max);
+    for (c = 0; c <= src->cycle_max; ++c)
+    {
+	dest->cycle_sums[c] += src->cycle_sums[c];
+	dest->length_hist[c] += src->length_hist[c];
+    }
+    if ( src->cycle_max > dest->cycle_max )
+	dest->cycle_max = src->cycle_max;
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/qual-stats.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free the per-cycle arrays of a statistics accumulator.  Overall
+ *      totals and histograms are left intact.
+ *
+ *  Arguments:
+ *      stats:  Pointer to an initialized bl_qual_stats_t structure
+ *
+ *  See also:
+ *      bl_qual_stats_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_qual_stats_free(bl_qual_stats_t *stats)
+
+{
+    free(stats->cycle_sums);
+    free(stats->length_hist);
+    stats->cycle_sums = NULL;
+    stats->length_hist = NULL;
+    stats->cycle_max = 0;
+    stats->cycle_array_size = 0;
+}
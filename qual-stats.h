@@ -0,0 +1,86 @@
+#ifndef _qual_stats_h_
+#define _qual_stats_h_
+
+#ifndef _STDINT_H_
+#include <stdint.h>
+#endif
+
+#ifndef _STDDEF_H_
+#include <stddef.h>
+#endif
+
+#ifndef _sam_h_
+#include "sam.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+#define BL_QUAL_PHRED33         33      // Sanger / Illumina 1.8+
+#define BL_QUAL_PHRED64         64      // Illumina 1.3 - 1.7
+#define BL_QUAL_CHAR_MAX        126     // '~'
+#define BL_QUAL_HIST_SIZE       (BL_QUAL_CHAR_MAX + 1)
+
+/*
+ *  Results of one pass over a QUAL string, in raw characters (not
+ *  adjusted for the Phred offset).  Filled in by bl_qual_summarize().
+ */
+typedef struct
+{
+    uint64_t        sum;
+    size_t          len;
+    size_t          at_least;   // Characters >= threshold
+    unsigned char   min;
+    unsigned char   max;
+}   bl_qual_summary_t;
+
+typedef struct
+{
+    unsigned        offset;     // BL_QUAL_PHRED33 or BL_QUAL_PHRED64
+    unsigned        threshold;  // Phred score for at_least counts
+
+    uint64_t        reads;
+    uint64_t        bases;
+    uint64_t        sum;        // Phred scores
+    uint64_t        at_least;   // Bases with Phred >= threshold
+    uint64_t        hist[BL_QUAL_HIST_SIZE];        // Bases by Phred
+    uint64_t        mean_hist[BL_QUAL_HIST_SIZE];   // Reads by mean Phred
+    uint64_t        min_hist[BL_QUAL_HIST_SIZE];    // Reads by min Phred
+
+    /*
+     *  Per-cycle sums of raw characters.  The number of reads reaching
+     *  each cycle is derived from length_hist when needed.
+     */
+    uint64_t        *cycle_sums;
+    uint64_t        *length_hist;
+    size_t          cycle_max;  // Length of the longest read
+    size_t          cycle_array_size;
+}   bl_qual_stats_t;
+
+/* Not generated by gen-get-set */
+#define BL_QUAL_STATS_OFFSET(ptr)           ((ptr)->offset)
+#define BL_QUAL_STATS_THRESHOLD(ptr)        ((ptr)->threshold)
+#define BL_QUAL_STATS_READS(ptr)            ((ptr)->reads)
+#define BL_QUAL_STATS_BASES(ptr)            ((ptr)->bases)
+#define BL_QUAL_STATS_SUM(ptr)              ((ptr)->sum)
+#define BL_QUAL_STATS_AT_LEAST(ptr)         ((ptr)->at_least)
+#define BL_QUAL_STATS_HIST_AE(ptr,c)        ((ptr)->hist[c])
+#define BL_QUAL_STATS_MEAN_HIST_AE(ptr,c)   ((ptr)->mean_hist[c])
+#define BL_QUAL_STATS_MIN_HIST_AE(ptr,c)    ((ptr)->min_hist[c])
+#define BL_QUAL_STATS_CYCLE_MAX(ptr)        ((ptr)->cycle_max)
+#define BL_QUAL_STATS_MEAN(ptr) \
+	((ptr)->bases == 0 ? 0.0 : (double)(ptr)->sum / (ptr)->bases)
+#define BL_QUAL_STATS_FRACTION_AT_LEAST(ptr) \
+	((ptr)->bases == 0 ? 0.0 : (double)(ptr)->at_least / (ptr)->bases)
+
+/* qual-stats.c */
+void bl_qual_summarize(const char *qual, size_t len, unsigned char threshold, bl_qual_summary_t *summary);
+void bl_qual_stats_init(bl_qual_stats_t *stats, unsigned offset, unsigned threshold);
+int bl_qual_stats_add(bl_qual_stats_t *stats, const char *qual, size_t len);
+int bl_qual_stats_add_sam(bl_qual_stats_t *stats, bl_sam_t *sam_alignment);
+double bl_qual_stats_cycle_mean(bl_qual_stats_t *stats, size_t cycle);
+int bl_qual_stats_merge(bl_qual_stats_t *dest, bl_qual_stats_t *src);
+void bl_qual_stats_free(bl_qual_stats_t *stats);
+
+#endif  // _qual_stats_h_
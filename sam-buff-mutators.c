@@ -1237,3 +1237,291 @@ int     bl_sam_buff_set_unmapped_alignments(bl_sam_buff_t *bl_sam_buff_ptr, uint
 	return BL_DATA_OK;
     }
 }
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-buff.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Mutator for seq_encoding member in a bl_sam_buff_t structure.
+ *      Use this function to set seq_encoding in a bl_sam_buff_t variable
+ *      from non-member functions.  This function performs a direct
+ *      assignment for scalar or pointer structure members.  If
+ *      seq_encoding is a pointer, data previously pointed to should
+ *      generally be freed before calling this function to avoid memory
+ *      leaks.
+ *
+ *      Note that there is an equivalent macro (), which performs
+ *      this function with no data verification or function call overhead.
+ *      Use the macro version to maximize performance where the validity
+ *      of new_seq_encoding is guaranteed by other means.
+ *      
+ *
+ *  Arguments:
+ *      bl_sam_buff_ptr Pointer to the bl_bed_t structure to set
+ *      new_seq_encoding The new value for seq_encoding
+ *
+ *  Returns:
+ *      BL_DATA_OK if the new value is acceptable and assigned
+ *      BL_DATA_OUT_OF_RANGE otherwise
+ *
+ *  Examples:
+ *      bl_sam_buff_t   bl_sam_buff;
+ *      int             new_seq_encoding;
+ *
+ *      bl_sam_buff_set_seq_encoding(&bl_sam_buff, new_seq_encoding);
+ *
+ *  See also:
+ *      (3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  gen-get-set Auto-generated from sam-buff.h
+ ***************************************************************************/
+
+int     bl_sam_buff_set_seq_encoding(bl_sam_buff_t *bl_sam_buff_ptr, int new_seq_encoding)
+
+{
+    /* Must be an encoding known to bl_sam_pack_seq() */
+    if ( (new_seq_encoding < BL_SEQ_ASCII) || (new_seq_encoding > BL_SEQ_NT4) )
+	return BL_DATA_OUT_OF_RANGE;
+    else
+    {
+	bl_sam_buff_ptr->seq_encoding = new_seq_encoding;
+	return BL_DATA_OK;
+    }
+}
+
+
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-buff.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Mutator for mem_budget member in a bl_sam_buff_t structure.
+ *      Use this function to set mem_budget in a bl_sam_buff_t variable
+ *      from non-member functions.  This function performs a direct
+ *      assignment for scalar or pointer structure members.  If
+ *      mem_budget is a pointer, data previously pointed to should
+ *      generally be freed before calling this function to avoid memory
+ *      leaks.
+ *
+ *      Note that there is an equivalent macro (), which performs
+ *      this function with no data verification or function call overhead.
+ *      Use the macro version to maximize performance where the validity
+ *      of new_mem_budget is guaranteed by other means.
+ *      
+ *
+ *  Arguments:
+ *      bl_sam_buff_ptr Pointer to the bl_bed_t structure to set
+ *      new_mem_budget  The new value for mem_budget
+ *
+ *  Returns:
+ *      BL_DATA_OK if the new value is acceptable and assigned
+ *      BL_DATA_OUT_OF_RANGE otherwise
+ *
+ *  Examples:
+ *      bl_sam_buff_t   bl_sam_buff;
+ *      size_t          new_mem_budget;
+ *
+ *      bl_sam_buff_set_mem_budget(&bl_sam_buff, new_mem_budget);
+ *
+ *  See also:
+ *      (3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  gen-get-set Auto-generated from sam-buff.h
+ ***************************************************************************/
+
+int     bl_sam_buff_set_mem_budget(bl_sam_buff_t *bl_sam_buff_ptr, size_t new_mem_budget)
+
+{
+    /* The newest alignment is always kept, so any nonzero budget works */
+    if ( new_mem_budget == 0 )
+	return BL_DATA_OUT_OF_RANGE;
+    else
+    {
+	bl_sam_buff_ptr->mem_budget = new_mem_budget;
+	return BL_DATA_OK;
+    }
+}
+
+
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-buff.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Mutator for spilled_alignments member in a bl_sam_buff_t structure.
+ *      Use this function to set spilled_alignments in a bl_sam_buff_t variable
+ *      from non-member functions.  This function performs a direct
+ *      assignment for scalar or pointer structure members.  If
+ *      spilled_alignments is a pointer, data previously pointed to should
+ *      generally be freed before calling this function to avoid memory
+ *      leaks.
+ *
+ *      Note that there is an equivalent macro (), which performs
+ *      this function with no data verification or function call overhead.
+ *      Use the macro version to maximize performance where the validity
+ *      of new_spilled_alignments is guaranteed by other means.
+ *      
+ *
+ *  Arguments:
+ *      bl_sam_buff_ptr Pointer to the bl_bed_t structure to set
+ *      new_spilled_alignments The new value for spilled_alignments
+ *
+ *  Returns:
+ *      BL_DATA_OK if the new value is acceptable and assigned
+ *      BL_DATA_OUT_OF_RANGE otherwise
+ *
+ *  Examples:
+ *      bl_sam_buff_t   bl_sam_buff;
+ *      uint64_t        new_spilled_alignments;
+ *
+ *      bl_sam_buff_set_spilled_alignments(&bl_sam_buff, new_spilled_alignments);
+ *
+ *  See also:
+ *      (3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  gen-get-set Auto-generated from sam-buff.h
+ ***************************************************************************/
+
+int     bl_sam_buff_set_spilled_alignments(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_spilled_alignments)
+
+{
+    /* FIXME: Replace this with a proper sanity check */
+    if ( 0 )
+	return BL_DATA_OUT_OF_RANGE;
+    else
+    {
+	bl_sam_buff_ptr->spilled_alignments = new_spilled_alignments;
+	return BL_DATA_OK;
+    }
+}
+
+
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-buff.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Mutator for spilled_bytes member in a bl_sam_buff_t structure.
+ *      Use this function to set spilled_bytes in a bl_sam_buff_t variable
+ *      from non-member functions.  This function performs a direct
+ *      assignment for scalar or pointer structure members.  If
+ *      spilled_bytes is a pointer, data previously pointed to should
+ *      generally be freed before calling this function to avoid memory
+ *      leaks.
+ *
+ *      Note that there is an equivalent macro (), which performs
+ *      this function with no data verification or function call overhead.
+ *      Use the macro version to maximize performance where the validity
+ *      of new_spilled_bytes is guaranteed by other means.
+ *      
+ *
+ *  Arguments:
+ *      bl_sam_buff_ptr Pointer to the bl_bed_t structure to set
+ *      new_spilled_bytes The new value for spilled_bytes
+ *
+ *  Returns:
+ *      BL_DATA_OK if the new value is acceptable and assigned
+ *      BL_DATA_OUT_OF_RANGE otherwise
+ *
+ *  Examples:
+ *      bl_sam_buff_t   bl_sam_buff;
+ *      uint64_t        new_spilled_bytes;
+ *
+ *      bl_sam_buff_set_spilled_bytes(&bl_sam_buff, new_spilled_bytes);
+ *
+ *  See also:
+ *      (3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  gen-get-set Auto-generated from sam-buff.h
+ ***************************************************************************/
+
+int     bl_sam_buff_set_spilled_bytes(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_spilled_bytes)
+
+{
+    /* FIXME: Replace this with a proper sanity check */
+    if ( 0 )
+	return BL_DATA_OUT_OF_RANGE;
+    else
+    {
+	bl_sam_buff_ptr->spilled_bytes = new_spilled_bytes;
+	return BL_DATA_OK;
+    }
+}
+
+
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-buff.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Mutator for max_spill_count member in a bl_sam_buff_t structure.
+ *      Use this function to set max_spill_count in a bl_sam_buff_t variable
+ *      from non-member functions.  This function performs a direct
+ *      assignment for scalar or pointer structure members.  If
+ *      max_spill_count is a pointer, data previously pointed to should
+ *      generally be freed before calling this function to avoid memory
+ *      leaks.
+ *
+ *      Note that there is an equivalent macro (), which performs
+ *      this function with no data verification or function call overhead.
+ *      Use the macro version to maximize performance where the validity
+ *      of new_max_spill_count is guaranteed by other means.
+ *      
+ *
+ *  Arguments:
+ *      bl_sam_buff_ptr Pointer to the bl_bed_t structure to set
+ *      new_max_spill_count The new value for max_spill_count
+ *
+ *  Returns:
+ *      BL_DATA_OK if the new value is acceptable and assigned
+ *      BL_DATA_OUT_OF_RANGE otherwise
+ *
+ *  Examples:
+ *      bl_sam_buff_t   bl_sam_buff;
+ *      uint64_t        new_max_spill_count;
+ *
+ *      bl_sam_buff_set_max_spill_count(&bl_sam_buff, new_max_spill_count);
+ *
+ *  See also:
+ *      (3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  gen-get-set Auto-generated from sam-buff.h
+ ***************************************************************************/
+
+int     bl_sam_buff_set_max_spill_count(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_max_spill_count)
+
+{
+    /* FIXME: Replace this with a proper sanity check */
+    if ( 0 )
+	return BL_DATA_OUT_OF_RANGE;
+    else
+    {
+	bl_sam_buff_ptr->max_spill_count = new_max_spill_count;
+	return BL_DATA_OK;
+    }
+}
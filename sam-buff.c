@@ -4,9 +4,36 @@
 #include <sys/param.h>  // MIN()
 #include <xtend.h>
 #include <inttypes.h>
+#include <unistd.h>     // ftruncate()
 #include "sam-buff.h"
 #include "biostring.h"
 
+// Bytes of serialized alignments written or read with one call
+#define SAM_BUFF_SPILL_BATCH    ((size_t)1024 * 1024)
+
+// Spilled slots have an offset in the spill file
+#define SAM_BUFF_SPILLED(b, c) \
+	(((b)->spill_offsets != NULL) && ((b)->spill_offsets[c] >= 0))
+
+// Approximate bl_sam_footprint() of spilled slot c once reloaded
+#define SAM_BUFF_RELOAD_FOOTPRINT(b, c) \
+	((b)->spill_sizes[c] + sizeof(bl_sam_t))
+
+// Spill file offset paired with its slot, for sorting by offset
+typedef struct
+{
+    off_t   offset;
+    size_t  slot;
+}   sam_buff_spilled_t;
+
+static void sam_buff_grow(bl_sam_buff_t *sam_buff);
+static void sam_buff_spill(bl_sam_buff_t *sam_buff, size_t end);
+static void sam_buff_spill_write(bl_sam_buff_t *sam_buff, size_t bytes);
+static void sam_buff_reload(bl_sam_buff_t *sam_buff, size_t first,
+			    size_t max_mem);
+static void sam_buff_spill_buff_grow(bl_sam_buff_t *sam_buff, size_t bytes);
+static void sam_buff_spill_compact(bl_sam_buff_t *sam_buff);
+
 /***************************************************************************
  *  Library:
  *      #include <biolibc/sam-buff.h>
@@ -67,10 +94,19 @@ void    bl_sam_buff_check_order(bl_sam_buff_t *sam_buff,
  *      alignments.  This is useful, for example, when scanning a SAM
  *      stream for alignments overlapping a certain region or position.
  *      The buffer array is set to a
- *      reasonable initial size and extended as far as BL_SAM_BUFF_MAX_SIZE
- *      by bl_sam_buff_add_alignment(3) if needed.  A minimum MAPQ value
+ *      reasonable initial size and extended by
+ *      bl_sam_buff_add_alignment(3) if needed.  A minimum MAPQ value
  *      is stored in the bl_sam_buff_t structure for filtering with
  *      bl_sam_buff_alignment_ok(3).
+ *
+ *      Buffered alignments are held to a memory budget of
+ *      BL_SAM_BUFF_DEFAULT_BUDGET bytes, as reported by
+ *      bl_sam_footprint(3), which can be changed with
+ *      bl_sam_buff_set_mem_budget(3).  See bl_sam_buff_add_alignment(3).
+ *
+ *      Buffered sequences are stored as ASCII by default.  Use
+ *      bl_sam_buff_set_seq_encoding() to store them packed with
+ *      BL_SEQ_NT16 or BL_SEQ_NT4 instead.  See bl_sam_pack_seq(3).
  *  
  *  Arguments:
  *      sam_buff:   Pointer to a the bl_sam_buff_t structure to initialize
@@ -94,6 +130,16 @@ void    bl_sam_buff_init(bl_sam_buff_t *sam_buff, unsigned int mapq_min)
     sam_buff->max_count = 0;
     sam_buff->previous_pos = 0;
     *sam_buff->previous_rname = '\0';
+    sam_buff->seq_encoding = BL_SEQ_ASCII;
+    sam_buff->mem_budget = BL_SAM_BUFF_DEFAULT_BUDGET;
+    sam_buff->mem_used = 0;
+    sam_buff->spill_stream = NULL;
+    sam_buff->spill_offsets = NULL;
+    sam_buff->spill_sizes = NULL;
+    sam_buff->spill_write_pos = 0;
+    sam_buff->spill_count = 0;
+    sam_buff->spill_buff = NULL;
+    sam_buff->spill_buff_size = 0;
     
     sam_buff->mapq_min = mapq_min;
     sam_buff->mapq_low = UINT64_MAX;
@@ -109,14 +155,18 @@ void    bl_sam_buff_init(bl_sam_buff_t *sam_buff, unsigned int mapq_min)
     sam_buff->max_discarded_score = 0;
     sam_buff->discarded_trailing = 0;
     sam_buff->unmapped_alignments = 0;
+    sam_buff->spilled_alignments = 0;
+    sam_buff->spilled_bytes = 0;
+    sam_buff->max_spill_count = 0;
     
     /*
      *  Dynamically allocating the pointers is probably senseless since they
      *  take very little space compared to the alignment data.  By the time
      *  the pointer array takes a significant amount of RAM, you're probably
-     *  already thrashing to accomodate the sequence data.  The pointer array
-     *  size is capped by BL_SAM_BUFF_MAX_SIZE to prevent memory exhaustion.
-     *  We may save a few megabytes with this, though.
+     *  already thrashing to accomodate the sequence data.  In-memory
+     *  alignments are capped at BL_SAM_BUFF_MAX_SIZE to prevent memory
+     *  exhaustion, and only spilled alignments extend the pointer array
+     *  beyond that.  We may save a few megabytes with this, though.
      */
     sam_buff->alignments =
 	(bl_sam_t **)xt_malloc(sam_buff->buff_size,
@@ -132,15 +182,31 @@ void    bl_sam_buff_init(bl_sam_buff_t *sam_buff, unsigned int mapq_min)
  *      -lbiolibc -lxtend
  *
  *  Description:
- *      Add a new alignment to the buffer, expanding the array as needed
- *      up to BL_SAM_BUFF_MAX_SIZE.
+ *      Add a new alignment to the end of the buffer, expanding the array
+ *      as needed.  The buffered copy's sequence is packed if
+ *      BL_SAM_BUFF_SEQ_ENCODING() is not BL_SEQ_ASCII.
+ *
+ *      Memory use is measured by the resident size of each alignment,
+ *      including the bl_sam_t structure itself, as reported by
+ *      bl_sam_footprint(3).  If adding the alignment exceeds
+ *      BL_SAM_BUFF_MEM_BUDGET() bytes or BL_SAM_BUFF_MAX_SIZE in-memory
+ *      alignments, the oldest alignments are written to a temporary
+ *      file in a batch, freeing a quarter of the budget.  The newest
+ *      alignment is always kept in memory.  Spilled alignments remain
+ *      in the buffer, and all BL_SAM_BUFF_BUFFERED_COUNT() of them are
+ *      available from bl_sam_buff_alignment(3) or
+ *      BL_SAM_BUFF_ALIGNMENTS_AE(), which read them back as needed.
+ *      BL_SAM_BUFF_SPILLED_ALIGNMENTS(),
+ *      BL_SAM_BUFF_SPILLED_BYTES(), and BL_SAM_BUFF_MAX_SPILL_COUNT()
+ *      report how much spilling occurred.
  *  
  *  Arguments:
  *      sam_buff:   Pointer to bl_sam_buff_t structure where alignments are buffered
  *      sam_alignment:  New SAM alignment to add to buffer
  *
  *  See also:
- *      bl_sam_buff_init(3), bl_sam_buff_check_order(3)
+ *      bl_sam_buff_init(3), bl_sam_buff_check_order(3),
+ *      bl_sam_buff_alignment(3)
  *
  *  History: 
  *  Date        Name        Modification
@@ -151,9 +217,6 @@ void    bl_sam_buff_add_alignment(bl_sam_buff_t *sam_buff,
 			       bl_sam_t *sam_alignment)
 
 {
-    size_t  old_buff_size,
-	    c;
-
     bl_sam_buff_check_order(sam_buff, sam_alignment);
     
     sam_buff->mapq_low = MIN(sam_buff->mapq_low, BL_SAM_MAPQ(sam_alignment));
@@ -179,7 +242,11 @@ void    bl_sam_buff_add_alignment(bl_sam_buff_t *sam_buff,
 	bl_sam_free(sam_buff->alignments[sam_buff->buffered_count]);
     
     bl_sam_copy(sam_buff->alignments[sam_buff->buffered_count], sam_alignment);
-    
+    if ( sam_buff->seq_encoding != BL_SEQ_ASCII )
+	bl_sam_pack_seq(sam_buff->alignments[sam_buff->buffered_count],
+			sam_buff->seq_encoding);
+    sam_buff->mem_used +=
+	bl_sam_footprint(sam_buff->alignments[sam_buff->buffered_count]);
     ++sam_buff->buffered_count;
 
     if ( sam_buff->buffered_count > sam_buff->max_count )
@@ -188,15 +255,10 @@ void    bl_sam_buff_add_alignment(bl_sam_buff_t *sam_buff,
 	// fprintf(stderr, "sam_buff->max_count = %zu\n", sam_buff->max_count);
     }
     
-    if ( sam_buff->buffered_count == BL_SAM_BUFF_MAX_SIZE )
-    {
-	fprintf(stderr,
-		"bl_sam_buff_add_alignment(): Hit BL_SAM_BUFF_MAX_SIZE=%u.\n",
-		BL_SAM_BUFF_MAX_SIZE);
-	fprintf(stderr, "Terminating to prevent runaway memory use.\n");
-	fprintf(stderr, "Check your SAM input.\n");
-	exit(EX_DATAERR);
-    }
+    if ( (sam_buff->mem_used > sam_buff->mem_budget) ||
+	 (sam_buff->buffered_count - sam_buff->spill_count >=
+	    BL_SAM_BUFF_MAX_SIZE) )
+	sam_buff_spill(sam_buff, sam_buff->buffered_count - 1);
     
     if ( sam_buff->buffered_count == sam_buff->buff_size )
     {
@@ -206,15 +268,287 @@ void    bl_sam_buff_add_alignment(bl_sam_buff_t *sam_buff,
 	fprintf(stderr, "RNAME: %s  POS: %zu  LEN: %zu\n",
 		BL_SAM_RNAME(sam_alignment), BL_SAM_POS(sam_alignment),
 		BL_SAM_SEQ_LEN(sam_alignment));
-	old_buff_size = sam_buff->buff_size;
-	sam_buff->buff_size *= 2;
-	sam_buff->alignments =
-	    (bl_sam_t **)xt_realloc(sam_buff->alignments,
-					sam_buff->buff_size,
-					sizeof(bl_sam_t **));
+	sam_buff_grow(sam_buff);
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-buff.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Return buffered alignment c, reading it back from the spill file
+ *      if it was spilled by bl_sam_buff_add_alignment(3).  To stay within
+ *      the memory budget, older alignments may then be spilled, so
+ *      pointers to alignments before c returned by earlier calls are
+ *      only valid until the next call while BL_SAM_BUFF_SPILL_COUNT() is
+ *      nonzero.  Scanning the buffer from 0 up therefore keeps memory
+ *      use bounded.  BL_SAM_BUFF_ALIGNMENTS_AE() is a macro for this
+ *      function.
+ *
+ *  Arguments:
+ *      sam_buff:   Pointer to bl_sam_buff_t structure holding alignments
+ *      c:          Index of the alignment (0-based, oldest first)
+ *
+ *  Returns:
+ *      Pointer to the alignment, or NULL if c >= BL_SAM_BUFF_BUFFERED_COUNT()
+ *
+ *  Examples:
+ *      for (c = 0; c < BL_SAM_BUFF_BUFFERED_COUNT(&sam_buff); ++c)
+ *      {
+ *          alignment = bl_sam_buff_alignment(&sam_buff, c);
+ *          ...
+ *      }
+ *
+ *  See also:
+ *      bl_sam_buff_add_alignment(3), bl_sam_buff_shift(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+bl_sam_t    *bl_sam_buff_alignment(bl_sam_buff_t *sam_buff, size_t c)
+
+{
+    if ( c >= sam_buff->buffered_count )
+	return NULL;
+    if ( SAM_BUFF_SPILLED(sam_buff, c) )
+    {
+	sam_buff_reload(sam_buff, c, sam_buff->mem_budget / 4);
+	
+	// A scan from the head has already visited older alignments
+	if ( sam_buff->mem_used > sam_buff->mem_budget )
+	    sam_buff_spill(sam_buff, c);
+    }
+    return sam_buff->alignments[c];
+}
+
+
+static void sam_buff_grow(bl_sam_buff_t *sam_buff)
+
+{
+    size_t  old_buff_size,
+	    c;
+
+    old_buff_size = sam_buff->buff_size;
+    sam_buff->buff_size *= 2;
+    sam_buff->alignments =
+	(bl_sam_t **)xt_realloc(sam_buff->alignments,
+				    sam_buff->buff_size,
+				    sizeof(bl_sam_t **));
+    if ( sam_buff->alignments == NULL )
+    {
+	fprintf(stderr, "sam_buff_grow(): Could not allocate alignments.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = old_buff_size; c < sam_buff->buff_size; ++c)
+	sam_buff->alignments[c] = NULL;
+    
+    if ( sam_buff->spill_offsets != NULL )
+    {
+	if ( ((sam_buff->spill_offsets = xt_realloc(sam_buff->spill_offsets,
+		    sam_buff->buff_size,
+		    sizeof(*sam_buff->spill_offsets))) == NULL) ||
+	     ((sam_buff->spill_sizes = xt_realloc(sam_buff->spill_sizes,
+		    sam_buff->buff_size,
+		    sizeof(*sam_buff->spill_sizes))) == NULL) )
+	{
+	    fprintf(stderr, "sam_buff_grow(): Could not allocate spill offsets.\n");
+	    exit(EX_UNAVAILABLE);
+	}
 	for (c = old_buff_size; c < sam_buff->buff_size; ++c)
-	    sam_buff->alignments[c] = NULL;
+	{
+	    sam_buff->spill_offsets[c] = -1;
+	    sam_buff->spill_sizes[c] = 0;
+	}
+    }
+}
+
+
+static void sam_buff_spill_buff_grow(bl_sam_buff_t *sam_buff, size_t bytes)
+
+{
+    if ( bytes > sam_buff->spill_buff_size )
+    {
+	sam_buff->spill_buff_size = MAX(bytes, SAM_BUFF_SPILL_BATCH);
+	if ( (sam_buff->spill_buff = xt_realloc(sam_buff->spill_buff,
+		sam_buff->spill_buff_size, 1)) == NULL )
+	{
+	    fprintf(stderr, "sam_buff_spill_buff_grow(): Could not allocate spill buffer.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+}
+
+
+/*
+ *  Spill the oldest in-memory alignments before slot end, until memory
+ *  use is down to 3/4 of the budget and the in-memory count to 3/4 of
+ *  BL_SAM_BUFF_MAX_SIZE, so that spills happen in batches rather than
+ *  once per new alignment.  Alignments are serialized into spill_buff
+ *  and written SAM_BUFF_SPILL_BATCH bytes at a time.
+ */
+
+static void sam_buff_spill(bl_sam_buff_t *sam_buff, size_t end)
+
+{
+    size_t      c,
+		bytes,
+		batch_bytes,
+		mem_target = sam_buff->mem_budget - sam_buff->mem_budget / 4,
+		count_target = BL_SAM_BUFF_MAX_SIZE - BL_SAM_BUFF_MAX_SIZE / 4;
+    bl_sam_t    *sam_alignment;
+    
+    if ( sam_buff->spill_stream == NULL )
+    {
+	if ( (sam_buff->spill_stream = tmpfile()) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_buff_add_alignment(): Could not create spill file.\n");
+	    exit(EX_CANTCREAT);
+	}
+	fprintf(stderr, "bl_sam_buff_add_alignment(): Memory budget of %zu bytes exceeded.\n",
+		sam_buff->mem_budget);
+	fprintf(stderr, "Spilling alignments to disk at RNAME: %s  POS: %" PRIu64 "\n",
+		BL_SAM_RNAME(sam_buff->alignments[end]),
+		BL_SAM_POS(sam_buff->alignments[end]));
     }
+    if ( sam_buff->spill_offsets == NULL )
+    {
+	if ( ((sam_buff->spill_offsets = xt_malloc(sam_buff->buff_size,
+		    sizeof(*sam_buff->spill_offsets))) == NULL) ||
+	     ((sam_buff->spill_sizes = xt_malloc(sam_buff->buff_size,
+		    sizeof(*sam_buff->spill_sizes))) == NULL) )
+	{
+	    fprintf(stderr, "bl_sam_buff_add_alignment(): Could not allocate spill offsets.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	for (c = 0; c < sam_buff->buff_size; ++c)
+	{
+	    sam_buff->spill_offsets[c] = -1;
+	    sam_buff->spill_sizes[c] = 0;
+	}
+    }
+    
+    // Switching from reading to writing requires a seek
+    if ( fseeko(sam_buff->spill_stream, sam_buff->spill_write_pos,
+		SEEK_SET) != 0 )
+    {
+	fprintf(stderr, "bl_sam_buff_add_alignment(): Could not seek spill file.\n");
+	exit(EX_IOERR);
+    }
+    
+    batch_bytes = 0;
+    for (c = 0; (c < end) &&
+		((sam_buff->mem_used > mem_target) ||
+		 (sam_buff->buffered_count - sam_buff->spill_count > count_target));
+	 ++c)
+    {
+	if ( (sam_alignment = sam_buff->alignments[c]) == NULL )
+	    continue;
+	
+	bytes = bl_sam_serialized_size(sam_alignment);
+	if ( (batch_bytes > 0) && (batch_bytes + bytes > SAM_BUFF_SPILL_BATCH) )
+	{
+	    sam_buff_spill_write(sam_buff, batch_bytes);
+	    batch_bytes = 0;
+	}
+	sam_buff_spill_buff_grow(sam_buff, batch_bytes + bytes);
+	bl_sam_serialize_mem(sam_buff->spill_buff + batch_bytes, sam_alignment);
+	sam_buff->spill_offsets[c] = sam_buff->spill_write_pos + batch_bytes;
+	sam_buff->spill_sizes[c] = bytes;
+	batch_bytes += bytes;
+	
+	sam_buff->mem_used -= MIN(bl_sam_footprint(sam_alignment),
+				  sam_buff->mem_used);
+	bl_sam_free(sam_alignment);
+	free(sam_alignment);
+	sam_buff->alignments[c] = NULL;
+	++sam_buff->spill_count;
+	++sam_buff->spilled_alignments;
+    }
+    if ( batch_bytes > 0 )
+	sam_buff_spill_write(sam_buff, batch_bytes);
+    
+    if ( sam_buff->spill_count > sam_buff->max_spill_count )
+	sam_buff->max_spill_count = sam_buff->spill_count;
+}
+
+
+static void sam_buff_spill_write(bl_sam_buff_t *sam_buff, size_t bytes)
+
+{
+    if ( fwrite(sam_buff->spill_buff, 1, bytes, sam_buff->spill_stream)
+	    != bytes )
+    {
+	fprintf(stderr, "bl_sam_buff_add_alignment(): Could not write spill file.\n");
+	exit(EX_IOERR);
+    }
+    sam_buff->spill_write_pos += bytes;
+    sam_buff->spilled_bytes += bytes;
+}
+
+
+/*
+ *  Read spilled alignment first back into memory, along with those in
+ *  the following slots that were spilled with it, in one read of up to
+ *  SAM_BUFF_SPILL_BATCH bytes, while their memory use stays within
+ *  max_mem.  At least one alignment is always read.
+ */
+
+static void sam_buff_reload(bl_sam_buff_t *sam_buff, size_t first,
+			    size_t max_mem)
+
+{
+    size_t      c,
+		end,
+		bytes,
+		mem;
+    char        *p;
+    
+    bytes = sam_buff->spill_sizes[first];
+    mem = SAM_BUFF_RELOAD_FOOTPRINT(sam_buff, first);
+    for (end = first + 1; (end < sam_buff->buffered_count) &&
+	    SAM_BUFF_SPILLED(sam_buff, end) &&
+	    (sam_buff->spill_offsets[end] ==
+		sam_buff->spill_offsets[end - 1] +
+		(off_t)sam_buff->spill_sizes[end - 1]) &&
+	    (bytes + sam_buff->spill_sizes[end] <= SAM_BUFF_SPILL_BATCH) &&
+	    (mem + SAM_BUFF_RELOAD_FOOTPRINT(sam_buff, end) <= max_mem); ++end)
+    {
+	bytes += sam_buff->spill_sizes[end];
+	mem += SAM_BUFF_RELOAD_FOOTPRINT(sam_buff, end);
+    }
+    
+    sam_buff_spill_buff_grow(sam_buff, bytes);
+    if ( (fseeko(sam_buff->spill_stream, sam_buff->spill_offsets[first],
+		 SEEK_SET) != 0) ||
+	 (fread(sam_buff->spill_buff, 1, bytes, sam_buff->spill_stream)
+		!= bytes) )
+    {
+	fprintf(stderr, "sam_buff_reload(): Could not read spill file.\n");
+	exit(EX_IOERR);
+    }
+    
+    for (c = first, p = sam_buff->spill_buff; c < end; ++c)
+    {
+	if ( (sam_buff->alignments[c] = xt_malloc(1, sizeof(bl_sam_t))) == NULL )
+	{
+	    fprintf(stderr, "sam_buff_reload(): Could not allocate alignments.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	p += bl_sam_deserialize_mem(p, sam_buff->alignments[c]);
+	sam_buff->mem_used += bl_sam_footprint(sam_buff->alignments[c]);
+	sam_buff->spill_offsets[c] = -1;
+	sam_buff->spill_sizes[c] = 0;
+	--sam_buff->spill_count;
+    }
+    
+    // Reuse the file from the beginning once drained
+    if ( sam_buff->spill_count == 0 )
+	sam_buff->spill_write_pos = 0;
 }
 
 
@@ -277,13 +611,25 @@ void    bl_sam_buff_out_of_order(bl_sam_buff_t *sam_buff, bl_sam_t *sam_alignmen
 void    bl_sam_buff_free_alignment(bl_sam_buff_t *sam_buff, size_t c)
 
 {
-    bl_sam_free(sam_buff->alignments[c]);
-    bl_sam_init(sam_buff->alignments[c], 0, BL_SAM_FIELD_ALL);
-    if ( sam_buff->alignments[c] != NULL )
+    size_t  bytes;
+    
+    // Spilled: just forget it, bl_sam_buff_shift() reclaims the space
+    if ( SAM_BUFF_SPILLED(sam_buff, c) )
     {
-	free(sam_buff->alignments[c]);
-	sam_buff->alignments[c] = NULL;
+	sam_buff->spill_offsets[c] = -1;
+	sam_buff->spill_sizes[c] = 0;
+	if ( --sam_buff->spill_count == 0 )
+	    sam_buff->spill_write_pos = 0;
+	return;
     }
+    if ( sam_buff->alignments[c] == NULL )
+	return;
+    
+    bytes = bl_sam_footprint(sam_buff->alignments[c]);
+    sam_buff->mem_used -= MIN(bytes, sam_buff->mem_used);
+    bl_sam_free(sam_buff->alignments[c]);
+    free(sam_buff->alignments[c]);
+    sam_buff->alignments[c] = NULL;
 }
 
 
@@ -294,7 +640,12 @@ void    bl_sam_buff_free_alignment(bl_sam_buff_t *sam_buff, size_t c)
  *
  *  Description:
  *      Free nelem SAM alignments at the head of the queue and shift
- *      remaining elements forward nelem positions.
+ *      remaining elements forward nelem positions.  Alignments spilled
+ *      to disk by bl_sam_buff_add_alignment(3) are then read back,
+ *      oldest first, as far as the memory budget allows.  Once most of
+ *      the spill file belongs to alignments that have been shifted out,
+ *      the rest are moved to the start of the file, so its size stays
+ *      proportional to the spilled alignments still buffered.
  *  
  *  Arguments:
  *      sam_buff:   Pointer to bl_sam_buff_t structure holding alignments
@@ -333,7 +684,124 @@ void    bl_sam_buff_shift(bl_sam_buff_t *sam_buff, size_t nelem)
     while ( c < sam_buff->buffered_count )
 	sam_buff->alignments[c++] = NULL;
     
+    if ( sam_buff->spill_offsets != NULL )
+    {
+	for (c = 0; c < sam_buff->buffered_count - nelem; ++c)
+	{
+	    sam_buff->spill_offsets[c] = sam_buff->spill_offsets[c + nelem];
+	    sam_buff->spill_sizes[c] = sam_buff->spill_sizes[c + nelem];
+	}
+	while ( c < sam_buff->buffered_count )
+	{
+	    sam_buff->spill_offsets[c] = -1;
+	    sam_buff->spill_sizes[c++] = 0;
+	}
+    }
+    
     sam_buff->buffered_count -= nelem;
+    
+    /*
+     *  Read back spilled alignments, oldest first, up to half the budget.
+     *  Stopping short of the 3/4 left by sam_buff_spill() keeps alignments
+     *  from bouncing to disk and back as new ones are added.
+     */
+    for (c = 0; (sam_buff->spill_count > 0) &&
+		(c < sam_buff->buffered_count) &&
+		(sam_buff->buffered_count - sam_buff->spill_count <
+		    BL_SAM_BUFF_MAX_SIZE - 1); ++c)
+    {
+	if ( SAM_BUFF_SPILLED(sam_buff, c) )
+	{
+	    if ( sam_buff->mem_used + SAM_BUFF_RELOAD_FOOTPRINT(sam_buff, c) >
+		    sam_buff->mem_budget / 2 )
+		break;
+	    sam_buff_reload(sam_buff, c,
+			    sam_buff->mem_budget / 2 - sam_buff->mem_used);
+	}
+    }
+    
+    if ( sam_buff->spill_count > 0 )
+	sam_buff_spill_compact(sam_buff);
+}
+
+
+static int  sam_buff_spilled_cmp(const void *p1, const void *p2)
+
+{
+    const sam_buff_spilled_t *s1 = p1, *s2 = p2;
+    
+    return s1->offset < s2->offset ? -1 : s1->offset > s2->offset;
+}
+
+
+/*
+ *  Spilling only appends to the file, and alignments shifted out leave
+ *  dead space behind.  When dead space exceeds both the live data and
+ *  SAM_BUFF_SPILL_BATCH, move the live records to the start of the file.
+ *  Records are moved in order of offset, so each is read before
+ *  anything is written over it.
+ */
+
+static void sam_buff_spill_compact(bl_sam_buff_t *sam_buff)
+
+{
+    sam_buff_spilled_t  *spilled;
+    size_t              c, s, bytes, live_bytes;
+    off_t               new_pos;
+    
+    for (c = 0, live_bytes = 0; c < sam_buff->buffered_count; ++c)
+	live_bytes += sam_buff->spill_sizes[c];
+    if ( (size_t)sam_buff->spill_write_pos - live_bytes <=
+	    MAX(live_bytes, SAM_BUFF_SPILL_BATCH) )
+	return;
+    
+    if ( (spilled = xt_malloc(sam_buff->spill_count,
+			      sizeof(*spilled))) == NULL )
+    {
+	fprintf(stderr, "sam_buff_spill_compact(): Could not allocate offsets.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = 0, s = 0; c < sam_buff->buffered_count; ++c)
+    {
+	if ( SAM_BUFF_SPILLED(sam_buff, c) )
+	{
+	    spilled[s].offset = sam_buff->spill_offsets[c];
+	    spilled[s++].slot = c;
+	}
+    }
+    qsort(spilled, s, sizeof(*spilled), sam_buff_spilled_cmp);
+    
+    for (c = 0, new_pos = 0; c < s; ++c)
+    {
+	bytes = sam_buff->spill_sizes[spilled[c].slot];
+	if ( spilled[c].offset != new_pos )
+	{
+	    sam_buff_spill_buff_grow(sam_buff, bytes);
+	    if ( (fseeko(sam_buff->spill_stream, spilled[c].offset,
+			 SEEK_SET) != 0) ||
+		 (fread(sam_buff->spill_buff, 1, bytes,
+			sam_buff->spill_stream) != bytes) ||
+		 (fseeko(sam_buff->spill_stream, new_pos, SEEK_SET) != 0) ||
+		 (fwrite(sam_buff->spill_buff, 1, bytes,
+			 sam_buff->spill_stream) != bytes) )
+	    {
+		fprintf(stderr, "sam_buff_spill_compact(): Could not move spilled alignment.\n");
+		exit(EX_IOERR);
+	    }
+	    sam_buff->spill_offsets[spilled[c].slot] = new_pos;
+	}
+	new_pos += bytes;
+    }
+    sam_buff->spill_write_pos = new_pos;
+    free(spilled);
+    
+    // Return the dead space to the file system
+    if ( (fflush(sam_buff->spill_stream) != 0) ||
+	 (ftruncate(fileno(sam_buff->spill_stream), new_pos) != 0) )
+    {
+	fprintf(stderr, "sam_buff_spill_compact(): Could not truncate spill file.\n");
+	exit(EX_IOERR);
+    }
 }
 
 
@@ -398,3 +866,57 @@ bool    bl_sam_buff_alignment_ok(bl_sam_buff_t *sam_buff,
     else
 	return true;
 }
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-buff.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all alignments in a SAM buffer, the buffer array, and the
+ *      spill file if one was created.  Statistics are left intact.
+ *
+ *  Arguments:
+ *      sam_buff:   Pointer to bl_sam_buff_t structure
+ *
+ *  See also:
+ *      bl_sam_buff_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_buff_free(bl_sam_buff_t *sam_buff)
+
+{
+    size_t  c;
+    
+    for (c = 0; c < sam_buff->buff_size; ++c)
+    {
+	if ( sam_buff->alignments[c] != NULL )
+	{
+	    bl_sam_free(sam_buff->alignments[c]);
+	    free(sam_buff->alignments[c]);
+	}
+    }
+    free(sam_buff->alignments);
+    sam_buff->alignments = NULL;
+    sam_buff->buffered_count = sam_buff->buff_size = 0;
+    sam_buff->mem_used = 0;
+    if ( sam_buff->spill_stream != NULL )
+    {
+	fclose(sam_buff->spill_stream);
+	sam_buff->spill_stream = NULL;
+    }
+    free(sam_buff->spill_offsets);
+    free(sam_buff->spill_sizes);
+    free(sam_buff->spill_buff);
+    sam_buff->spill_offsets = NULL;
+    sam_buff->spill_sizes = NULL;
+    sam_buff->spill_buff = NULL;
+    sam_buff->spill_buff_size = 0;
+    sam_buff->spill_count = 0;
+    sam_buff->spill_write_pos = 0;
+}
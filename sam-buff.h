@@ -14,8 +14,14 @@
     256k was not enough for a few of the SRA CRAMs.
     NWD976804 needed more than 512k.  Bad data?
     Of 55k samples, only about 11% reached a sam buffer of > 8k.
-    Set an upper limit to prevent runaway memory use and error out
-    with EX_DATAERR to tell script not to retry.
+    Memory use is capped by a budget (BL_SAM_BUFF_DEFAULT_BUDGET by
+    default) on the resident size of buffered alignments, as reported by
+    bl_sam_footprint(), rather than a count.  At roughly 16 KiB per
+    bl_sam_t, the default holds about 64k short-read alignments.  When the budget or
+    BL_SAM_BUFF_MAX_SIZE in-memory alignments is exceeded, the oldest
+    are spilled to a temporary file in batches and read back when
+    accessed or when the buffer is shifted, so pathological loci slow
+    down instead of terminating the process.
 
     From sam-buff-stats script:
     
@@ -31,13 +37,7 @@
 */
 #define     BL_SAM_BUFF_START_SIZE     4096
 #define     BL_SAM_BUFF_MAX_SIZE       524288
-
-/*
- *  Copied from htslib/sam.h to avoid an htslib dependency.  It should be
- *  safe to assume this will never change, since changing it would break
- *  all existing SAM/BAM/CRAM files.
- */
-#define     BAM_FUNMAP  4
+#define     BL_SAM_BUFF_DEFAULT_BUDGET ((size_t)1024 * 1024 * 1024)
 
 // FIXME: Move this to samio when complete?
 typedef struct
@@ -48,6 +48,24 @@ typedef struct
     size_t      max_count;
     uint64_t    previous_pos;
     char        previous_rname[BL_SAM_RNAME_MAX_CHARS + 1];
+    int         seq_encoding;   // BL_SEQ_* encoding for buffered copies
+    size_t      mem_budget;     // Bytes allowed for buffered alignments
+    size_t      mem_used;       // Per bl_sam_footprint()
+    
+    /*
+     *  The oldest alignments when over budget.  A spilled alignment
+     *  leaves NULL in alignments[] and its location in spill_offsets[]
+     *  and spill_sizes[], which are -1 and 0 for other slots.  Use
+     *  bl_sam_buff_alignment() or BL_SAM_BUFF_ALIGNMENTS_AE() to read
+     *  it back.
+     */
+    FILE        *spill_stream;
+    off_t       *spill_offsets;
+    size_t      *spill_sizes;
+    off_t       spill_write_pos;
+    size_t      spill_count;
+    char        *spill_buff;    // Serialized batch being written or read
+    size_t      spill_buff_size;
     
     // Use 64 bits to accommodate large sums
     uint64_t    mapq_min,
@@ -62,7 +80,10 @@ typedef struct
 		discarded_trailing,
 		min_discarded_score,
 		max_discarded_score,
-		unmapped_alignments;
+		unmapped_alignments,
+		spilled_alignments,
+		spilled_bytes,
+		max_spill_count;
 }   bl_sam_buff_t;
 
 /*
@@ -77,12 +98,21 @@ typedef struct
 
 #define BL_SAM_BUFF_BUFF_SIZE(ptr)      ((ptr)->buff_size)
 #define BL_SAM_BUFF_ALIGNMENTS(ptr)     ((ptr)->alignments)
-#define BL_SAM_BUFF_ALIGNMENTS_AE(ptr,c) ((ptr)->alignments[c])
 #define BL_SAM_BUFF_BUFFERED_COUNT(ptr) ((ptr)->buffered_count)
 #define BL_SAM_BUFF_MAX_COUNT(ptr)      ((ptr)->max_count)
 #define BL_SAM_BUFF_PREVIOUS_POS(ptr)   ((ptr)->previous_pos)
 #define BL_SAM_BUFF_PREVIOUS_RNAME(ptr) ((ptr)->previous_rname)
 #define BL_SAM_BUFF_PREVIOUS_RNAME_AE(ptr,c) ((ptr)->previous_rname[c])
+#define BL_SAM_BUFF_SEQ_ENCODING(ptr)   ((ptr)->seq_encoding)
+#define BL_SAM_BUFF_MEM_BUDGET(ptr)     ((ptr)->mem_budget)
+#define BL_SAM_BUFF_MEM_USED(ptr)       ((ptr)->mem_used)
+#define BL_SAM_BUFF_SPILL_STREAM(ptr)   ((ptr)->spill_stream)
+#define BL_SAM_BUFF_SPILL_OFFSETS(ptr)  ((ptr)->spill_offsets)
+#define BL_SAM_BUFF_SPILL_OFFSETS_AE(ptr,c) ((ptr)->spill_offsets[c])
+#define BL_SAM_BUFF_SPILL_SIZES(ptr)    ((ptr)->spill_sizes)
+#define BL_SAM_BUFF_SPILL_SIZES_AE(ptr,c) ((ptr)->spill_sizes[c])
+#define BL_SAM_BUFF_SPILL_WRITE_POS(ptr) ((ptr)->spill_write_pos)
+#define BL_SAM_BUFF_SPILL_COUNT(ptr)    ((ptr)->spill_count)
 #define BL_SAM_BUFF_MAPQ_MIN(ptr)       ((ptr)->mapq_min)
 #define BL_SAM_BUFF_MAPQ_LOW(ptr)       ((ptr)->mapq_low)
 #define BL_SAM_BUFF_MAPQ_HIGH(ptr)      ((ptr)->mapq_high)
@@ -96,6 +126,9 @@ typedef struct
 #define BL_SAM_BUFF_MIN_DISCARDED_SCORE(ptr) ((ptr)->min_discarded_score)
 #define BL_SAM_BUFF_MAX_DISCARDED_SCORE(ptr) ((ptr)->max_discarded_score)
 #define BL_SAM_BUFF_UNMAPPED_ALIGNMENTS(ptr) ((ptr)->unmapped_alignments)
+#define BL_SAM_BUFF_SPILLED_ALIGNMENTS(ptr) ((ptr)->spilled_alignments)
+#define BL_SAM_BUFF_SPILLED_BYTES(ptr)  ((ptr)->spilled_bytes)
+#define BL_SAM_BUFF_MAX_SPILL_COUNT(ptr) ((ptr)->max_spill_count)
 /*
  *  Generated by /home/bacon/scripts/gen-get-set
  *
@@ -120,6 +153,8 @@ typedef struct
 #define BL_SAM_BUFF_SET_PREVIOUS_POS(ptr,val)   ((ptr)->previous_pos = (val))
 #define BL_SAM_BUFF_SET_PREVIOUS_RNAME_CPY(ptr,val,array_size) strlcpy((ptr)->previous_rname,val,array_size)
 #define BL_SAM_BUFF_SET_PREVIOUS_RNAME_AE(ptr,c,val) ((ptr)->previous_rname[c] = (val))
+#define BL_SAM_BUFF_SET_SEQ_ENCODING(ptr,val)   ((ptr)->seq_encoding = (val))
+#define BL_SAM_BUFF_SET_MEM_BUDGET(ptr,val)     ((ptr)->mem_budget = (val))
 #define BL_SAM_BUFF_SET_MAPQ_MIN(ptr,val)       ((ptr)->mapq_min = (val))
 #define BL_SAM_BUFF_SET_MAPQ_LOW(ptr,val)       ((ptr)->mapq_low = (val))
 #define BL_SAM_BUFF_SET_MAPQ_HIGH(ptr,val)      ((ptr)->mapq_high = (val))
@@ -133,8 +168,13 @@ typedef struct
 #define BL_SAM_BUFF_SET_MIN_DISCARDED_SCORE(ptr,val) ((ptr)->min_discarded_score = (val))
 #define BL_SAM_BUFF_SET_MAX_DISCARDED_SCORE(ptr,val) ((ptr)->max_discarded_score = (val))
 #define BL_SAM_BUFF_SET_UNMAPPED_ALIGNMENTS(ptr,val) ((ptr)->unmapped_alignments = (val))
+#define BL_SAM_BUFF_SET_SPILLED_ALIGNMENTS(ptr,val) ((ptr)->spilled_alignments = (val))
+#define BL_SAM_BUFF_SET_SPILLED_BYTES(ptr,val) ((ptr)->spilled_bytes = (val))
+#define BL_SAM_BUFF_SET_MAX_SPILL_COUNT(ptr,val) ((ptr)->max_spill_count = (val))
 
 /* Not generated by gen-get-set */
+// Reads back spilled alignments, so never NULL for c < buffered_count
+#define BL_SAM_BUFF_ALIGNMENTS_AE(ptr,c) bl_sam_buff_alignment(ptr,c)
 #define BL_SAM_BUFF_INC_TOTAL_ALIGNMENTS(b)    (++(b)->total_alignments)
 #define BL_SAM_BUFF_INC_TRAILING_ALIGNMENTS(b) (++(b)->trailing_alignments)
 #define BL_SAM_BUFF_INC_DISCARDED_TRAILING(b)  (++(b)->discarded_trailing)
@@ -143,10 +183,12 @@ typedef struct
 void bl_sam_buff_check_order(bl_sam_buff_t *sam_buff, bl_sam_t *sam_alignment);
 void bl_sam_buff_init(bl_sam_buff_t *sam_buff, unsigned int mapq_min);
 void bl_sam_buff_add_alignment(bl_sam_buff_t *sam_buff, bl_sam_t *sam_alignment);
+bl_sam_t *bl_sam_buff_alignment(bl_sam_buff_t *sam_buff, size_t c);
 void bl_sam_buff_out_of_order(bl_sam_buff_t *sam_buff, bl_sam_t *sam_alignment);
 void bl_sam_buff_free_alignment(bl_sam_buff_t *sam_buff, size_t c);
 void bl_sam_buff_shift(bl_sam_buff_t *sam_buff, size_t nelem);
 bool bl_sam_buff_alignment_ok(bl_sam_buff_t *sam_buff, bl_sam_t *sam_alignment);
+void bl_sam_buff_free(bl_sam_buff_t *sam_buff);
 
 /* sam-buff-mutators.c */
 int bl_sam_buff_set_buff_size(bl_sam_buff_t *bl_sam_buff_ptr, size_t new_buff_size);
@@ -171,5 +213,10 @@ int bl_sam_buff_set_discarded_trailing(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t
 int bl_sam_buff_set_min_discarded_score(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_min_discarded_score);
 int bl_sam_buff_set_max_discarded_score(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_max_discarded_score);
 int bl_sam_buff_set_unmapped_alignments(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_unmapped_alignments);
+int bl_sam_buff_set_seq_encoding(bl_sam_buff_t *bl_sam_buff_ptr, int new_seq_encoding);
+int bl_sam_buff_set_mem_budget(bl_sam_buff_t *bl_sam_buff_ptr, size_t new_mem_budget);
+int bl_sam_buff_set_spilled_alignments(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_spilled_alignments);
+int bl_sam_buff_set_spilled_bytes(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_spilled_bytes);
+int bl_sam_buff_set_max_spill_count(bl_sam_buff_t *bl_sam_buff_ptr, uint64_t new_max_spill_count);
 
 #endif  // _sam_buff_h_
@@ -0,0 +1,371 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam.h"
+#include "biolibc.h"
+
+#define BL_SAM_CIGAR_START_OPS  16
+
+/*
+ *  Map CIGAR characters to op code + 1, so that 0 marks an invalid
+ *  character.  Avoids strchr() in the inner loop.
+ */
+static const unsigned char  Cigar_codes[256] =
+{
+    ['M'] = BL_SAM_CIGAR_M + 1,
+    ['I'] = BL_SAM_CIGAR_I + 1,
+    ['D'] = BL_SAM_CIGAR_D + 1,
+    ['N'] = BL_SAM_CIGAR_N + 1,
+    ['S'] = BL_SAM_CIGAR_S + 1,
+    ['H'] = BL_SAM_CIGAR_H + 1,
+    ['P'] = BL_SAM_CIGAR_P + 1,
+    ['='] = BL_SAM_CIGAR_EQ + 1,
+    ['X'] = BL_SAM_CIGAR_X + 1
+};
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Decode the CIGAR string of a SAM alignment into an array of
+ *      BAM-style packed operations (length << 4 | op code) and update
+ *      the cached reference end position.  The ops array is reused
+ *      and extended as needed across calls, so decoding a stream of
+ *      alignments into the same bl_sam_t structure does not allocate
+ *      memory after the first few records.
+ *
+ *      bl_sam_read(3) calls this function automatically when
+ *      BL_SAM_FIELD_CIGAR_OPS is set in field_mask.  The decoded ops
+ *      are accessible via BL_SAM_CIGAR_OPS(), BL_SAM_CIGAR_OPS_AE() and
+ *      BL_SAM_CIGAR_OP_COUNT(), and are examined using
+ *      BL_SAM_CIGAR_OP() and BL_SAM_CIGAR_OP_LEN().
+ *
+ *      A CIGAR of "*" (unavailable) produces 0 operations.  Operation
+ *      lengths are limited to BL_SAM_CIGAR_OP_LEN_MAX (2^28 - 1), as
+ *      in BAM, since the length is stored in 28 bits.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure with pos and cigar
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_INVALID if the CIGAR string is malformed or an
+ *      operation is longer than BL_SAM_CIGAR_OP_LEN_MAX
+ *
+ *  Examples:
+ *      bl_sam_t    sam_alignment = BL_SAM_ALIGNMENT_INIT;
+ *      unsigned    c;
+ *
+ *      bl_sam_read(stdin, &sam_alignment,
+ *                  BL_SAM_FIELD_ALL | BL_SAM_FIELD_CIGAR_OPS);
+ *      for (c = 0; c < BL_SAM_CIGAR_OP_COUNT(&sam_alignment); ++c)
+ *          printf("%u%c\n",
+ *              BL_SAM_CIGAR_OP_LEN(BL_SAM_CIGAR_OPS_AE(&sam_alignment, c)),
+ *              BL_SAM_CIGAR_OP_CHARS[BL_SAM_CIGAR_OP(
+ *                  BL_SAM_CIGAR_OPS_AE(&sam_alignment, c))]);
+ *
+ *  See also:
+ *      bl_sam_read(3), bl_sam_update_ref_end(3), bl_sam_query_to_ref(3),
+ *      bl_sam_ref_to_query(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_cigar_parse(bl_sam_t *sam_alignment)
+
+{
+    const char  *p;
+    uint64_t    len;
+    unsigned    code;
+
+    sam_alignment->cigar_op_count = 0;
+    if ( strcmp(sam_alignment->cigar, "*") != 0 )
+    {
+	for (p = sam_alignment->cigar; *p != '\0'; ++p)
+	{
+	    for (len = 0; (*p >= '0') && (*p <= '9') &&
+			  (len <= BL_SAM_CIGAR_OP_LEN_MAX); ++p)
+		len = len * 10 + *p - '0';
+	    if ( len > BL_SAM_CIGAR_OP_LEN_MAX )
+	    {
+		fprintf(stderr, "bl_sam_cigar_parse(): Operation length "
+			"exceeds %u in %s.\n", BL_SAM_CIGAR_OP_LEN_MAX,
+			sam_alignment->cigar);
+		sam_alignment->cigar_op_count = 0;
+		bl_sam_update_ref_end(sam_alignment);
+		return BL_DATA_INVALID;
+	    }
+	    if ( (code = Cigar_codes[(unsigned char)*p]) == 0 )
+	    {
+		sam_alignment->cigar_op_count = 0;
+		bl_sam_update_ref_end(sam_alignment);
+		return BL_DATA_INVALID;
+	    }
+
+	    if ( sam_alignment->cigar_op_count == sam_alignment->cigar_op_max )
+	    {
+		sam_alignment->cigar_op_max =
+		    sam_alignment->cigar_op_max == 0 ?
+		    BL_SAM_CIGAR_START_OPS : sam_alignment->cigar_op_max * 2;
+		sam_alignment->cigar_ops = xt_realloc(sam_alignment->cigar_ops,
+		    sam_alignment->cigar_op_max,
+		    sizeof(*sam_alignment->cigar_ops));
+		if ( sam_alignment->cigar_ops == NULL )
+		{
+		    fprintf(stderr, "bl_sam_cigar_parse(): Could not allocate cigar_ops.\n");
+		    exit(EX_UNAVAILABLE);
+		}
+	    }
+	    sam_alignment->cigar_ops[sam_alignment->cigar_op_count++] =
+		BL_SAM_CIGAR_PACK(len, code - 1);
+	}
+    }
+    bl_sam_update_ref_end(sam_alignment);
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Compute the number of reference bases spanned by a CIGAR string,
+ *      i.e. the sum of the lengths of M, D, N, =, and X operations.
+ *      This scans the string without storing the operations and is
+ *      used when only the reference span of an alignment is needed.
+ *
+ *  Arguments:
+ *      cigar:  A SAM CIGAR string
+ *
+ *  Returns:
+ *      The reference length covered by the CIGAR, or 0 for "*"
+ *
+ *  See also:
+ *      bl_sam_cigar_parse(3), bl_sam_update_ref_end(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+uint64_t    bl_sam_cigar_ref_len(const char *cigar)
+
+{
+    const char  *p;
+    uint64_t    len, ref_len;
+    unsigned    code;
+
+    ref_len = 0;
+    for (p = cigar; *p != '\0'; ++p)
+    {
+	for (len = 0; (*p >= '0') && (*p <= '9'); ++p)
+	    len = len * 10 + *p - '0';
+	if ( (code = Cigar_codes[(unsigned char)*p]) == 0 )
+	    break;
+	if ( BL_SAM_CIGAR_CONSUMES_REF(code - 1) )
+	    ref_len += len;
+    }
+    return ref_len;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Recompute the cached reference end position of an alignment,
+ *      accessible via BL_SAM_REF_END().  The reference end is the last
+ *      reference position (1-based, inclusive) covered by the alignment.
+ *      Decoded CIGAR operations are used if present, otherwise the CIGAR
+ *      string is scanned.  If the alignment has no usable CIGAR (e.g.
+ *      "*" for an unmapped read), the sequence length is used instead.
+ *
+ *      Call this after modifying pos, cigar, or seq_len of an alignment
+ *      with the mutator macros.  bl_sam_read(3), bl_sam_cigar_parse(3),
+ *      and the mutator functions, e.g. bl_sam_set_pos(3), keep ref_end
+ *      up to date automatically.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  See also:
+ *      bl_sam_cigar_parse(3), bl_sam_cigar_ref_len(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_update_ref_end(bl_sam_t *sam_alignment)
+
+{
+    uint64_t    ref_len;
+    unsigned    c;
+
+    if ( sam_alignment->cigar_op_count > 0 )
+    {
+	ref_len = 0;
+	for (c = 0; c < sam_alignment->cigar_op_count; ++c)
+	    if ( BL_SAM_CIGAR_CONSUMES_REF(
+		    BL_SAM_CIGAR_OP(sam_alignment->cigar_ops[c])) )
+		ref_len += BL_SAM_CIGAR_OP_LEN(sam_alignment->cigar_ops[c]);
+    }
+    else
+	ref_len = bl_sam_cigar_ref_len(sam_alignment->cigar);
+
+    if ( ref_len == 0 )
+	ref_len = sam_alignment->seq_len;
+    if ( ref_len == 0 )
+	sam_alignment->ref_end = sam_alignment->pos;
+    else
+	sam_alignment->ref_end = sam_alignment->pos + ref_len - 1;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Map a 0-based offset within the read sequence (SEQ) to the
+ *      1-based reference position it is aligned to, using the decoded
+ *      CIGAR operations.  Bases in insertions and soft clips are not
+ *      aligned to any reference position.
+ *
+ *      The CIGAR must have been decoded by bl_sam_cigar_parse(3), e.g.
+ *      by reading with BL_SAM_FIELD_CIGAR_OPS.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure with decoded CIGAR
+ *      query_pos:      0-based offset into SEQ
+ *
+ *  Returns:
+ *      The 1-based reference position aligned to query_pos, or 0 if
+ *      the base is inserted, clipped, or beyond the end of the read
+ *
+ *  See also:
+ *      bl_sam_ref_to_query(3), bl_sam_cigar_parse(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+uint64_t    bl_sam_query_to_ref(bl_sam_t *sam_alignment, size_t query_pos)
+
+{
+    uint64_t    ref_pos;
+    size_t      q;
+    unsigned    c, code;
+    uint32_t    len;
+
+    ref_pos = sam_alignment->pos;
+    q = 0;
+    for (c = 0; c < sam_alignment->cigar_op_count; ++c)
+    {
+	code = BL_SAM_CIGAR_OP(sam_alignment->cigar_ops[c]);
+	len = BL_SAM_CIGAR_OP_LEN(sam_alignment->cigar_ops[c]);
+	if ( BL_SAM_CIGAR_CONSUMES_QUERY(code) )
+	{
+	    if ( query_pos < q + len )
+	    {
+		if ( BL_SAM_CIGAR_CONSUMES_REF(code) )
+		    return ref_pos + (query_pos - q);
+		else
+		    return 0;
+	    }
+	    q += len;
+	}
+	if ( BL_SAM_CIGAR_CONSUMES_REF(code) )
+	    ref_pos += len;
+    }
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Map a 1-based reference position to the 0-based offset of the
+ *      read base aligned to it, using the decoded CIGAR operations.
+ *      The CIGAR op covering ref_pos is returned so the caller can
+ *      distinguish aligned bases (M, =, X) from deletions (D) and
+ *      skipped regions (N).  For D and N, *query_pos is set to the
+ *      offset of the next read base after the gap.
+ *
+ *      The CIGAR must have been decoded by bl_sam_cigar_parse(3), e.g.
+ *      by reading with BL_SAM_FIELD_CIGAR_OPS.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure with decoded CIGAR
+ *      ref_pos:        1-based reference position
+ *      query_pos:      Pointer to receive the 0-based offset into SEQ
+ *
+ *  Returns:
+ *      The BL_SAM_CIGAR_* op code covering ref_pos, or -1 if ref_pos
+ *      is outside the aligned region
+ *
+ *  Examples:
+ *      size_t  q;
+ *
+ *      if ( bl_sam_ref_to_query(&sam_alignment, vcf_pos, &q) ==
+ *              BL_SAM_CIGAR_M )
+ *          allele = BL_SAM_SEQ_AE(&sam_alignment, q);
+ *
+ *  See also:
+ *      bl_sam_query_to_ref(3), bl_sam_cigar_parse(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_ref_to_query(bl_sam_t *sam_alignment, uint64_t ref_pos,
+			    size_t *query_pos)
+
+{
+    uint64_t    r;
+    size_t      q;
+    unsigned    c, code;
+    uint32_t    len;
+
+    if ( ref_pos < sam_alignment->pos )
+	return -1;
+
+    r = sam_alignment->pos;
+    q = 0;
+    for (c = 0; c < sam_alignment->cigar_op_count; ++c)
+    {
+	code = BL_SAM_CIGAR_OP(sam_alignment->cigar_ops[c]);
+	len = BL_SAM_CIGAR_OP_LEN(sam_alignment->cigar_ops[c]);
+	if ( BL_SAM_CIGAR_CONSUMES_REF(code) )
+	{
+	    if ( ref_pos < r + len )
+	    {
+		if ( BL_SAM_CIGAR_CONSUMES_QUERY(code) )
+		    *query_pos = q + (ref_pos - r);
+		else
+		    *query_pos = q;
+		return code;
+	    }
+	    r += len;
+	}
+	if ( BL_SAM_CIGAR_CONSUMES_QUERY(code) )
+	    q += len;
+    }
+    return -1;
+}
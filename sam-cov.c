@@ -0,0 +1,464 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-cov.h"
+#include "biostring.h"
+
+static void sam_cov_write(bl_sam_cov_t *cov, const void *data, size_t bytes)
+
+{
+    if ( fwrite(data, 1, bytes, cov->stream) != bytes )
+	cov->write_failed = true;
+}
+
+
+static void sam_cov_write_chunk(bl_sam_cov_t *cov)
+
+{
+    uint32_t    len;
+
+    if ( cov->chunk_count == 0 )
+	return;
+    len = strlen(cov->rname);
+    sam_cov_write(cov, &len, sizeof(len));
+    sam_cov_write(cov, cov->rname, len);
+    sam_cov_write(cov, &cov->chunk_start, sizeof(cov->chunk_start));
+    sam_cov_write(cov, &cov->chunk_count, sizeof(cov->chunk_count));
+    sam_cov_write(cov, cov->chunk, cov->chunk_count * sizeof(*cov->chunk));
+    cov->chunk_count = 0;
+}
+
+
+static void sam_cov_write_run(bl_sam_cov_t *cov)
+
+{
+    char    line[BL_SAM_RNAME_MAX_CHARS + 3 * BL_U64_MAX_DIGITS + 4], *p;
+    size_t  len;
+
+    if ( (cov->window_start == cov->run_start) ||
+	 ((cov->run_depth == 0) && ! (cov->flags & BL_SAM_COV_ZERO)) )
+	return;
+    len = strlen(cov->rname);
+    memcpy(line, cov->rname, len);
+    p = line + len;
+    *p++ = '\t';
+    p += bl_u64_to_str(p, cov->run_start - 1);
+    *p++ = '\t';
+    // run_end is not stored: the run always ends where the next begins
+    p += bl_u64_to_str(p, cov->window_start - 1);
+    *p++ = '\t';
+    p += bl_u64_to_str(p, cov->run_depth);
+    *p++ = '\n';
+    sam_cov_write(cov, line, p - line);
+}
+
+
+/*
+ *  Report depth for positions start through end - 1.  BED-graph runs
+ *  are extended while the depth stays the same.  cov->window_start must
+ *  be end on return, as sam_cov_write_run() uses it.
+ */
+
+static void sam_cov_emit(bl_sam_cov_t *cov, uint64_t start, uint64_t end,
+			 uint32_t depth)
+
+{
+    if ( start == end )
+	return;
+    if ( cov->format == BL_SAM_COV_BEDGRAPH )
+    {
+	if ( depth != cov->run_depth )
+	{
+	    cov->window_start = start;
+	    sam_cov_write_run(cov);
+	    cov->run_start = start;
+	    cov->run_depth = depth;
+	}
+    }
+    else if ( depth != 0 )
+    {
+	if ( cov->chunk_start + cov->chunk_count != start )
+	{
+	    sam_cov_write_chunk(cov);
+	    cov->chunk_start = start;
+	}
+	for (; start < end; ++start)
+	{
+	    if ( cov->chunk_count == BL_SAM_COV_CHUNK_MAX )
+	    {
+		sam_cov_write_chunk(cov);
+		cov->chunk_start = start;
+	    }
+	    cov->chunk[cov->chunk_count++] = depth;
+	}
+    }
+    cov->window_start = end;
+}
+
+
+/*
+ *  Finalize all positions before limit.  No alignment added later can
+ *  start before the current POS, so these depths can no longer change.
+ */
+
+static void sam_cov_flush(bl_sam_cov_t *cov, uint64_t limit)
+
+{
+    uint64_t    p, end, run_start;
+    size_t      mask = cov->window_size - 1;
+    int32_t     delta;
+
+    if ( limit <= cov->window_start )
+	return;
+    end = limit < cov->max_end + 1 ? limit : cov->max_end + 1;
+    if ( end < cov->window_start )
+	end = cov->window_start;
+    run_start = cov->window_start;
+    for (p = cov->window_start; p < end; ++p)
+    {
+	if ( (delta = cov->diff[p & mask]) != 0 )
+	{
+	    sam_cov_emit(cov, run_start, p, cov->depth);
+	    cov->diff[p & mask] = 0;
+	    cov->depth += delta;
+	    run_start = p;
+	}
+    }
+    if ( end > run_start )
+	sam_cov_emit(cov, run_start, end, cov->depth);
+
+    // Past the last covered position, jump straight to limit
+    if ( limit > end )
+    {
+	if ( cov->diff[end & mask] != 0 )
+	{
+	    cov->depth += cov->diff[end & mask];
+	    cov->diff[end & mask] = 0;
+	}
+	sam_cov_emit(cov, end, limit, cov->depth);
+    }
+}
+
+
+static void sam_cov_finish_contig(bl_sam_cov_t *cov)
+
+{
+    if ( *cov->rname == '\0' )
+	return;
+    sam_cov_flush(cov, cov->max_end + 2);
+    if ( cov->format == BL_SAM_COV_BEDGRAPH )
+    {
+	// Zero-depth tail has no known end, so leave it off
+	cov->window_start = cov->max_end + 1;
+	if ( cov->run_depth != 0 )
+	    sam_cov_write_run(cov);
+    }
+    else
+	sam_cov_write_chunk(cov);
+    cov->window_start = cov->run_start = 1;
+    cov->run_depth = 0;
+    cov->max_end = 0;
+    cov->depth = 0;
+}
+
+
+/*
+ *  Make room for positions up through end + 1, keeping pending
+ *  differences at their positions modulo the new size.
+ */
+
+static void sam_cov_grow(bl_sam_cov_t *cov, uint64_t end)
+
+{
+    int32_t     *old_diff = cov->diff;
+    size_t      old_mask = cov->window_size - 1, new_size, new_mask;
+    uint64_t    p;
+
+    for (new_size = cov->window_size; new_size < end + 2 - cov->window_start;
+	 new_size *= 2)
+	;
+    if ( (cov->diff = xt_malloc(new_size, sizeof(*cov->diff))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_cov_add(): Could not allocate window.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memset(cov->diff, 0, new_size * sizeof(*cov->diff));
+    new_mask = new_size - 1;
+    for (p = cov->window_start; p <= cov->max_end + 1; ++p)
+	cov->diff[p & new_mask] = old_diff[p & old_mask];
+    free(old_diff);
+    cov->window_size = new_size;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-cov.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a coverage accumulator for computing per-base depth
+ *      from a sorted SAM stream.  Each alignment added with
+ *      bl_sam_cov_add(3) records only a start and end event per aligned
+ *      block in a difference array, rather than incrementing every
+ *      position it covers.  Depths are finalized and written to stream
+ *      as the stream moves past them, so memory use is bounded by the
+ *      span of the alignments overlapping the current position rather
+ *      than the genome size.
+ *
+ *      With format BL_SAM_COV_BEDGRAPH, output is BED-graph lines
+ *      (RNAME, 0-based start, end, depth), one per run of equal depth.
+ *      Zero-depth runs are omitted unless flags includes
+ *      BL_SAM_COV_ZERO.  With BL_SAM_COV_BINARY, output is chunks of
+ *      32-bit depths as described in sam-cov.h.
+ *
+ *      Alignments are filtered by bl_sam_buff_alignment_ok(3) using the
+ *      MAPQ minimum in sam_buff, and input order is checked with
+ *      bl_sam_buff_check_order(3), as for bl_pileup_push(3).  Only
+ *      M, =, and X operations count as coverage unless flags includes
+ *      BL_SAM_COV_DELETIONS, in which case D does as well.
+ *
+ *  Arguments:
+ *      cov:        Pointer to the bl_sam_cov_t structure to initialize
+ *      sam_buff:   Pointer to an initialized bl_sam_buff_t structure
+ *      stream:     FILE stream to which depths are written
+ *      format:     BL_SAM_COV_BEDGRAPH or BL_SAM_COV_BINARY
+ *      flags:      0 or one or more of BL_SAM_COV_DELETIONS and
+ *                  BL_SAM_COV_ZERO, combined with |
+ *
+ *  Examples:
+ *      bl_sam_buff_t   sam_buff;
+ *      bl_sam_cov_t    cov;
+ *      bl_sam_t        sam_alignment;
+ *
+ *      bl_sam_buff_init(&sam_buff, 20);
+ *      bl_sam_init(&sam_alignment, BL_SAM_SEQ_MAX_CHARS, BL_SAM_FIELD_ALL);
+ *      bl_sam_cov_init(&cov, &sam_buff, stdout, BL_SAM_COV_BEDGRAPH, 0);
+ *      while ( bl_sam_read(stdin, &sam_alignment,
+ *                  BL_SAM_FIELD_ALL | BL_SAM_FIELD_CIGAR_OPS) == BL_READ_OK )
+ *          bl_sam_cov_add(&cov, &sam_alignment);
+ *      bl_sam_cov_finish(&cov);
+ *      bl_sam_cov_free(&cov);
+ *
+ *  See also:
+ *      bl_sam_cov_add(3), bl_sam_cov_finish(3), bl_sam_cov_free(3),
+ *      bl_pileup_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_cov_init(bl_sam_cov_t *cov, bl_sam_buff_t *sam_buff,
+			FILE *stream, int format, unsigned flags)
+
+{
+    cov->sam_buff = sam_buff;
+    cov->stream = stream;
+    cov->format = format;
+    cov->flags = flags;
+
+    cov->window_size = BL_SAM_COV_START_WINDOW;
+    if ( (cov->diff = xt_malloc(cov->window_size, sizeof(*cov->diff))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_cov_init(): Could not allocate window.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memset(cov->diff, 0, cov->window_size * sizeof(*cov->diff));
+    cov->window_start = 1;
+    cov->max_end = 0;
+    cov->depth = 0;
+
+    *cov->rname = '\0';
+    cov->run_start = 1;
+    cov->run_depth = 0;
+    cov->chunk = NULL;
+    if ( (format == BL_SAM_COV_BINARY) &&
+	 ((cov->chunk = xt_malloc(BL_SAM_COV_CHUNK_MAX,
+				  sizeof(*cov->chunk))) == NULL) )
+    {
+	fprintf(stderr, "bl_sam_cov_init(): Could not allocate chunk.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    cov->chunk_count = 0;
+    cov->chunk_start = 0;
+    cov->write_failed = false;
+    cov->alignments_counted = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-cov.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add the next alignment from a sorted SAM stream to a coverage
+ *      accumulator.  Alignments that are unmapped, have no CIGAR or a
+ *      CIGAR with no reference bases, or fail bl_sam_buff_alignment_ok(3)
+ *      are ignored.  Depths at positions before this alignment's POS
+ *      are written out, as are all remaining depths on the previous
+ *      RNAME if this alignment starts a new one.
+ *
+ *      The CIGAR is decoded in place if the alignment was not read
+ *      with BL_SAM_FIELD_CIGAR_OPS.  sam_alignment is not retained.
+ *
+ *  Arguments:
+ *      cov:            Pointer to an initialized bl_sam_cov_t structure
+ *      sam_alignment:  Pointer to the alignment just read
+ *
+ *  Returns:
+ *      true if the alignment was counted
+ *      false if it was filtered out
+ *
+ *  See also:
+ *      bl_sam_cov_init(3), bl_sam_cov_finish(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    bl_sam_cov_add(bl_sam_cov_t *cov, bl_sam_t *sam_alignment)
+
+{
+    uint64_t    ref_pos, block_start;
+    uint32_t    op, len;
+    unsigned    c;
+    size_t      mask;
+    bool        counted;
+
+    bl_sam_buff_check_order(cov->sam_buff, sam_alignment);
+    if ( ! bl_sam_buff_alignment_ok(cov->sam_buff, sam_alignment) ||
+	 (BL_SAM_POS(sam_alignment) == 0) ||
+	 (bl_sam_cigar_ref_len(BL_SAM_CIGAR(sam_alignment)) == 0) )
+	return false;
+
+    if ( (BL_SAM_CIGAR_OP_COUNT(sam_alignment) == 0) &&
+	 (bl_sam_cigar_parse(sam_alignment) != BL_DATA_OK) )
+    {
+	fprintf(stderr, "bl_sam_cov_add(): Invalid CIGAR: %s\n",
+		BL_SAM_CIGAR(sam_alignment));
+	fprintf(stderr, "qname = %s rname = %s\n",
+		BL_SAM_QNAME(sam_alignment), BL_SAM_RNAME(sam_alignment));
+	exit(EX_DATAERR);
+    }
+
+    if ( strcmp(BL_SAM_RNAME(sam_alignment), cov->rname) != 0 )
+    {
+	sam_cov_finish_contig(cov);
+	strlcpy(cov->rname, BL_SAM_RNAME(sam_alignment),
+		BL_SAM_RNAME_MAX_CHARS + 1);
+    }
+    sam_cov_flush(cov, BL_SAM_POS(sam_alignment));
+
+    if ( BL_SAM_REF_END(sam_alignment) + 2 - cov->window_start >
+	 cov->window_size )
+	sam_cov_grow(cov, BL_SAM_REF_END(sam_alignment));
+    mask = cov->window_size - 1;
+
+    /*
+     *  Adjacent counted operations (e.g. 10=1X10=) form one block, so
+     *  they cost one pair of events.
+     */
+    ref_pos = block_start = BL_SAM_POS(sam_alignment);
+    for (c = 0; c < BL_SAM_CIGAR_OP_COUNT(sam_alignment); ++c)
+    {
+	op = BL_SAM_CIGAR_OP(BL_SAM_CIGAR_OPS_AE(sam_alignment, c));
+	len = BL_SAM_CIGAR_OP_LEN(BL_SAM_CIGAR_OPS_AE(sam_alignment, c));
+	if ( ! BL_SAM_CIGAR_CONSUMES_REF(op) )
+	    continue;
+	counted = (op == BL_SAM_CIGAR_M) || (op == BL_SAM_CIGAR_EQ) ||
+		  (op == BL_SAM_CIGAR_X) ||
+		  ((op == BL_SAM_CIGAR_D) && (cov->flags & BL_SAM_COV_DELETIONS));
+	if ( ! counted )
+	{
+	    if ( ref_pos > block_start )
+	    {
+		++cov->diff[block_start & mask];
+		--cov->diff[ref_pos & mask];
+	    }
+	    block_start = ref_pos + len;
+	}
+	ref_pos += len;
+    }
+    if ( ref_pos > block_start )
+    {
+	++cov->diff[block_start & mask];
+	--cov->diff[ref_pos & mask];
+    }
+
+    if ( ref_pos - 1 > cov->max_end )
+	cov->max_end = ref_pos - 1;
+    ++cov->alignments_counted;
+    return true;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-cov.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Indicate that there is no more input and write all remaining
+ *      depths.  The stream is flushed but not closed.
+ *
+ *  Arguments:
+ *      cov:    Pointer to an initialized bl_sam_cov_t structure
+ *
+ *  Returns:
+ *      BL_WRITE_OK if all output was written successfully
+ *      BL_WRITE_FAILURE if any write failed
+ *
+ *  See also:
+ *      bl_sam_cov_add(3), bl_sam_cov_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_cov_finish(bl_sam_cov_t *cov)
+
+{
+    sam_cov_finish_contig(cov);
+    *cov->rname = '\0';
+    if ( fflush(cov->stream) != 0 )
+	cov->write_failed = true;
+    return cov->write_failed ? BL_WRITE_FAILURE : BL_WRITE_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-cov.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory allocated by a coverage accumulator.  Depths not
+ *      yet written by bl_sam_cov_finish(3) are discarded.  The
+ *      bl_sam_buff_t passed to bl_sam_cov_init(3) is not freed.
+ *
+ *  Arguments:
+ *      cov:    Pointer to an initialized bl_sam_cov_t structure
+ *
+ *  See also:
+ *      bl_sam_cov_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_cov_free(bl_sam_cov_t *cov)
+
+{
+    free(cov->diff);
+    free(cov->chunk);
+    cov->diff = NULL;
+    cov->chunk = NULL;
+    cov->window_size = 0;
+}
@@ -0,0 +1,76 @@
+#ifndef _sam_cov_h_
+#define _sam_cov_h_
+
+#ifndef _sam_buff_h_
+#include "sam-buff.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+// Output formats for bl_sam_cov_init()
+#define BL_SAM_COV_BEDGRAPH     0
+#define BL_SAM_COV_BINARY       1
+
+// Flags for bl_sam_cov_init()
+#define BL_SAM_COV_DELETIONS    0x1 // Count D operations as covered
+#define BL_SAM_COV_ZERO         0x2 // Report zero-depth runs in BED-graph
+
+#define BL_SAM_COV_START_WINDOW 65536
+#define BL_SAM_COV_CHUNK_MAX    65536   // Binary depths per chunk
+
+/*
+ *  Binary output is a sequence of chunks, each covering consecutive
+ *  positions, in native byte order:
+ *
+ *      uint32_t    rname_len
+ *      char        rname[rname_len]    Not null-terminated
+ *      uint64_t    start               1-based position of depth[0]
+ *      uint32_t    count
+ *      uint32_t    depth[count]
+ *
+ *  Positions between chunks have depth 0.
+ */
+
+typedef struct
+{
+    bl_sam_buff_t   *sam_buff;  // MAPQ filter, order check, stats
+    FILE            *stream;
+    int             format;
+    unsigned        flags;
+
+    /*
+     *  Difference array over the active window, indexed by position
+     *  modulo window_size.  Positions before window_start are final.
+     */
+    int32_t         *diff;
+    size_t          window_size;    // Power of 2
+    uint64_t        window_start;
+    uint64_t        max_end;        // Last position covered so far
+    uint32_t        depth;          // At window_start - 1
+
+    char            rname[BL_SAM_RNAME_MAX_CHARS + 1];
+    uint64_t        run_start;      // BED-graph run being extended
+    uint32_t        run_depth;
+    uint32_t        *chunk;         // Binary depths not yet written
+    uint32_t        chunk_count;
+    uint64_t        chunk_start;
+    bool            write_failed;
+
+    uint64_t        alignments_counted;
+}   bl_sam_cov_t;
+
+/* Not generated by gen-get-set */
+#define BL_SAM_COV_FORMAT(ptr)              ((ptr)->format)
+#define BL_SAM_COV_FLAGS(ptr)               ((ptr)->flags)
+#define BL_SAM_COV_WINDOW_SIZE(ptr)         ((ptr)->window_size)
+#define BL_SAM_COV_ALIGNMENTS_COUNTED(ptr)  ((ptr)->alignments_counted)
+
+/* sam-cov.c */
+void bl_sam_cov_init(bl_sam_cov_t *cov, bl_sam_buff_t *sam_buff, FILE *stream, int format, unsigned flags);
+bool bl_sam_cov_add(bl_sam_cov_t *cov, bl_sam_t *sam_alignment);
+int bl_sam_cov_finish(bl_sam_cov_t *cov);
+void bl_sam_cov_free(bl_sam_cov_t *cov);
+
+#endif  // _sam_cov_h_
@@ -0,0 +1,602 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-demux.h"
+#include "biolibc.h"
+
+#define SAM_DEMUX_TABLE_START_SIZE  256
+
+/*
+ *  FNV-1a over a key that may not be null-terminated, such as an RG
+ *  value pointing into the tags buffer.
+ */
+
+static uint64_t sam_demux_hash(const char *key, size_t len)
+
+{
+    uint64_t    hash = 0xcbf29ce484222325ULL;
+
+    while ( len-- > 0 )
+    {
+	hash ^= (unsigned char)*key++;
+	hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+
+static bool sam_demux_key_eq(const char *stored, const char *key, size_t len)
+
+{
+    return (strncmp(stored, key, len) == 0) && (stored[len] == '\0');
+}
+
+
+static size_t   *sam_demux_table_alloc(size_t size)
+
+{
+    size_t  *table, c;
+
+    if ( (table = xt_malloc(size, sizeof(*table))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_demux_write(): Could not allocate table.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = 0; c < size; ++c)
+	table[c] = BL_SAM_DEMUX_NONE;
+    return table;
+}
+
+
+static void sam_demux_table_insert(bl_sam_demux_t *demux, size_t index)
+
+{
+    bl_sam_demux_output_t   *output = &demux->outputs[index];
+    size_t  slot, mask = demux->table_size - 1;
+
+    for (slot = sam_demux_hash(output->key, strlen(output->key)) & mask;
+	 demux->table[slot] != BL_SAM_DEMUX_NONE; slot = (slot + 1) & mask)
+	;
+    demux->table[slot] = index;
+}
+
+
+/*
+ *  Build the filename for a key.  '/' in a key would name a directory,
+ *  so it is replaced by '_'.
+ */
+
+static char *sam_demux_filename(bl_sam_demux_t *demux, const char *key)
+
+{
+    const char  *marker = strstr(demux->filename_template, "%s");
+    size_t      prefix_len = marker - demux->filename_template,
+		key_len = strlen(key),
+		suffix_len = strlen(marker + 2);
+    char        *filename, *p;
+
+    if ( (filename = xt_malloc(prefix_len + key_len + suffix_len + 1,
+	    sizeof(*filename))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_demux_write(): Could not allocate filename.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memcpy(filename, demux->filename_template, prefix_len);
+    memcpy(filename + prefix_len, key, key_len);
+    memcpy(filename + prefix_len + key_len, marker + 2, suffix_len + 1);
+    for (p = filename + prefix_len; p < filename + prefix_len + key_len; ++p)
+	if ( *p == '/' )
+	    *p = '_';
+    return filename;
+}
+
+
+/*
+ *  Find the output for a key, creating it if this is the first time
+ *  the key has been seen.  Outputs are not opened until first flushed.
+ */
+
+static size_t   sam_demux_output(bl_sam_demux_t *demux, const char *key,
+				 size_t len)
+
+{
+    bl_sam_demux_output_t   *output;
+    size_t  slot, mask, index, c;
+
+    if ( (demux->last_output != BL_SAM_DEMUX_NONE) &&
+	 sam_demux_key_eq(demux->outputs[demux->last_output].key, key, len) )
+	return demux->last_output;
+
+    mask = demux->table_size - 1;
+    for (slot = sam_demux_hash(key, len) & mask;
+	 (index = demux->table[slot]) != BL_SAM_DEMUX_NONE;
+	 slot = (slot + 1) & mask)
+    {
+	if ( sam_demux_key_eq(demux->outputs[index].key, key, len) )
+	    return demux->last_output = index;
+    }
+
+    if ( demux->output_count == demux->output_max )
+    {
+	demux->output_max = demux->output_max == 0 ? 64 : demux->output_max * 2;
+	if ( (demux->outputs = xt_realloc(demux->outputs, demux->output_max,
+		sizeof(*demux->outputs))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_demux_write(): Could not allocate outputs.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    index = demux->output_count++;
+    output = &demux->outputs[index];
+    if ( (output->key = xt_malloc(len + 1, sizeof(*output->key))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_demux_write(): Could not allocate key.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memcpy(output->key, key, len);
+    output->key[len] = '\0';
+    output->filename = sam_demux_filename(demux, output->key);
+    output->created = false;
+    output->lru_prev = output->lru_next = BL_SAM_DEMUX_NONE;
+
+    // Writer with no stream yet, see sam_demux_open()
+    output->writer.stream = NULL;
+    output->writer.fd = -1;
+    output->writer.owns_stream = true;
+    output->writer.field_mask = demux->field_mask;
+    output->writer.buff_size = demux->buff_size;
+    output->writer.buff_len = 0;
+    if ( (output->writer.buff = xt_malloc(output->writer.buff_size,
+	    sizeof(*output->writer.buff))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_demux_write(): Could not allocate buff.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    output->writer.alignments_written = 0;
+
+    // Keep load factor <= 1/2
+    if ( demux->output_count * 2 > demux->table_size )
+    {
+	free(demux->table);
+	demux->table_size *= 2;
+	demux->table = sam_demux_table_alloc(demux->table_size);
+	for (c = 0; c < demux->output_count; ++c)
+	    sam_demux_table_insert(demux, c);
+    }
+    else
+	sam_demux_table_insert(demux, index);
+    return demux->last_output = index;
+}
+
+
+static void sam_demux_lru_unlink(bl_sam_demux_t *demux, size_t index)
+
+{
+    bl_sam_demux_output_t   *output = &demux->outputs[index];
+
+    if ( output->lru_prev == BL_SAM_DEMUX_NONE )
+	demux->lru_head = output->lru_next;
+    else
+	demux->outputs[output->lru_prev].lru_next = output->lru_next;
+    if ( output->lru_next == BL_SAM_DEMUX_NONE )
+	demux->lru_tail = output->lru_prev;
+    else
+	demux->outputs[output->lru_next].lru_prev = output->lru_prev;
+    output->lru_prev = output->lru_next = BL_SAM_DEMUX_NONE;
+}
+
+
+static void sam_demux_lru_push(bl_sam_demux_t *demux, size_t index)
+
+{
+    bl_sam_demux_output_t   *output = &demux->outputs[index];
+
+    output->lru_prev = BL_SAM_DEMUX_NONE;
+    output->lru_next = demux->lru_head;
+    if ( demux->lru_head != BL_SAM_DEMUX_NONE )
+	demux->outputs[demux->lru_head].lru_prev = index;
+    else
+	demux->lru_tail = index;
+    demux->lru_head = index;
+}
+
+
+/*
+ *  Close the stream for an output.  Anything in its buffer stays there
+ *  until the output is next flushed, which reopens the file for append.
+ */
+
+static void sam_demux_close_stream(bl_sam_demux_t *demux, size_t index)
+
+{
+    bl_sam_demux_output_t   *output = &demux->outputs[index];
+
+    sam_demux_lru_unlink(demux, index);
+    xt_fclose(output->writer.stream);
+    output->writer.stream = NULL;
+    output->writer.fd = -1;
+    --demux->open_count;
+}
+
+
+/*
+ *  Make sure an output is open, closing the least recently used open
+ *  output if max_open are already open.  The first open truncates the
+ *  file and writes the header.  Later opens append.
+ */
+
+static int  sam_demux_open(bl_sam_demux_t *demux, size_t index)
+
+{
+    bl_sam_demux_output_t   *output = &demux->outputs[index];
+    FILE    *stream;
+
+    if ( output->writer.stream != NULL )
+    {
+	if ( demux->lru_head != index )
+	{
+	    sam_demux_lru_unlink(demux, index);
+	    sam_demux_lru_push(demux, index);
+	}
+	return BL_WRITE_OK;
+    }
+
+    /*
+     *  The victim may have buffered alignments since its last flush.
+     *  Buffers are written with write(2), not through the stream, so
+     *  they survive the close and are written when next flushed.
+     */
+    if ( demux->open_count == demux->max_open )
+	sam_demux_close_stream(demux, demux->lru_tail);
+
+    if ( (stream = xt_fopen(output->filename,
+			    output->created ? "a" : "w")) == NULL )
+    {
+	fprintf(stderr, "bl_sam_demux_write(): Could not open %s: %s\n",
+		output->filename, strerror(errno));
+	return BL_WRITE_FAILURE;
+    }
+    if ( ! output->created )
+    {
+	if ( (demux->header != NULL) && (fputs(demux->header, stream) == EOF) )
+	{
+	    xt_fclose(stream);
+	    return BL_WRITE_FAILURE;
+	}
+	fflush(stream);
+	output->created = true;
+    }
+    output->writer.stream = stream;
+    output->writer.fd = fileno(stream);
+    ++demux->open_count;
+    ++demux->opens;
+    sam_demux_lru_push(demux, index);
+    return BL_WRITE_OK;
+}
+
+
+static int  sam_demux_flush_output(bl_sam_demux_t *demux, size_t index)
+
+{
+    if ( demux->outputs[index].writer.buff_len == 0 )
+	return BL_WRITE_OK;
+    if ( sam_demux_open(demux, index) != BL_WRITE_OK )
+	return BL_WRITE_FAILURE;
+    return bl_sam_writer_flush(&demux->outputs[index].writer);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-demux.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a demultiplexer that routes alignments to one output
+ *      file per contig (key_type BL_SAM_DEMUX_RNAME) or per read group
+ *      (BL_SAM_DEMUX_RG), so that a SAM stream can be split in a
+ *      single pass.
+ *
+ *      Output filenames are made by replacing the "%s" in
+ *      filename_template with the key.  Alignments with RNAME "*" use
+ *      the key BL_SAM_DEMUX_UNMAPPED ("unmapped") and alignments without
+ *      an RG tag use BL_SAM_DEMUX_UNASSIGNED ("unassigned").  Any '/' in
+ *      a key is replaced by '_'.
+ *
+ *      Each output has its own BL_SAM_DEMUX_BUFF_SIZE buffer, and a file
+ *      is only open while its buffer is being flushed or until it is
+ *      displaced by a more recently flushed output.  At most max_open
+ *      files are open at once, so the number of outputs is not limited
+ *      by the process descriptor limit.  Displaced files are reopened
+ *      for append when next flushed.
+ *
+ *      BL_SAM_DEMUX_RG routes on the RG tag, which is only available if
+ *      input is read with BL_SAM_FIELD_TAGS in the field mask passed to
+ *      bl_sam_read(3) or bl_sam_reader_init(3).  Otherwise, every
+ *      alignment is routed to "unassigned".  Since output of the tags
+ *      also requires it, bl_sam_demux_init(3) terminates the process if
+ *      key_type is BL_SAM_DEMUX_RG and field_mask does not include
+ *      BL_SAM_FIELD_TAGS.
+ *
+ *  Arguments:
+ *      demux:              Pointer to the bl_sam_demux_t structure to
+ *                          initialize
+ *      filename_template:  Output filename containing one "%s"
+ *      key_type:           BL_SAM_DEMUX_RNAME or BL_SAM_DEMUX_RG
+ *      field_mask:         Fields to write, as for bl_sam_write(3)
+ *      max_open:           Maximum open files, 0 for
+ *                          BL_SAM_DEMUX_DEFAULT_MAX_OPEN
+ *
+ *  Examples:
+ *      bl_sam_demux_t  demux;
+ *
+ *      bl_sam_demux_init(&demux, "split/%s.sam", BL_SAM_DEMUX_RG,
+ *                        BL_SAM_FIELD_ALL | BL_SAM_FIELD_TAGS, 0);
+ *      bl_sam_demux_set_header(&demux, header_text);
+ *      while ( bl_sam_reader_read(&reader, &sam_alignment) == BL_READ_OK )
+ *          if ( bl_sam_demux_write(&demux, &sam_alignment) != BL_WRITE_OK )
+ *              break;
+ *      bl_sam_demux_close(&demux);
+ *
+ *  See also:
+ *      bl_sam_demux_set_header(3), bl_sam_demux_write(3),
+ *      bl_sam_demux_flush(3), bl_sam_demux_close(3), bl_sam_writer_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_demux_init(bl_sam_demux_t *demux, const char *filename_template,
+			  int key_type, sam_field_mask_t field_mask,
+			  size_t max_open)
+
+{
+    const char  *marker;
+
+    if ( ((marker = strstr(filename_template, "%s")) == NULL) ||
+	 (strstr(marker + 2, "%s") != NULL) )
+    {
+	fprintf(stderr, "bl_sam_demux_init(): Template must contain one %%s: %s\n",
+		filename_template);
+	exit(EX_USAGE);
+    }
+    if ( (key_type != BL_SAM_DEMUX_RNAME) && (key_type != BL_SAM_DEMUX_RG) )
+    {
+	fprintf(stderr, "bl_sam_demux_init(): Invalid key_type: %d\n", key_type);
+	exit(EX_USAGE);
+    }
+    if ( (key_type == BL_SAM_DEMUX_RG) && !(field_mask & BL_SAM_FIELD_TAGS) )
+    {
+	fprintf(stderr, "bl_sam_demux_init(): BL_SAM_DEMUX_RG requires BL_SAM_FIELD_TAGS.\n");
+	fprintf(stderr, "Input must also be read with BL_SAM_FIELD_TAGS.\n");
+	exit(EX_USAGE);
+    }
+    if ( (demux->filename_template = strdup(filename_template)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_demux_init(): Could not allocate template.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    demux->key_type = key_type;
+    demux->header = NULL;
+    demux->field_mask = field_mask;
+    demux->buff_size = BL_SAM_DEMUX_BUFF_SIZE;
+
+    demux->outputs = NULL;
+    demux->output_count = demux->output_max = 0;
+    demux->table_size = SAM_DEMUX_TABLE_START_SIZE;
+    demux->table = sam_demux_table_alloc(demux->table_size);
+    demux->last_output = BL_SAM_DEMUX_NONE;
+
+    demux->max_open = max_open == 0 ? BL_SAM_DEMUX_DEFAULT_MAX_OPEN : max_open;
+    demux->open_count = 0;
+    demux->lru_head = demux->lru_tail = BL_SAM_DEMUX_NONE;
+
+    demux->opens = 0;
+    demux->alignments_written = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-demux.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Set header text, such as the @HD, @SQ, @RG, and @PG lines of the
+ *      input, to be written at the start of every output file.  The text
+ *      is copied and must end with a newline.  Only files created after
+ *      the call receive the header, so call this before the first
+ *      bl_sam_demux_write(3).
+ *
+ *  Arguments:
+ *      demux:  Pointer to an initialized bl_sam_demux_t structure
+ *      header: Header lines, or NULL for none
+ *
+ *  See also:
+ *      bl_sam_demux_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_demux_set_header(bl_sam_demux_t *demux, const char *header)
+
+{
+    free(demux->header);
+    demux->header = NULL;
+    if ( (header != NULL) && ((demux->header = strdup(header)) == NULL) )
+    {
+	fprintf(stderr, "bl_sam_demux_set_header(): Could not allocate header.\n");
+	exit(EX_UNAVAILABLE);
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-demux.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Route an alignment to the output for its RNAME or RG, creating
+ *      the output the first time a key is seen.  With BL_SAM_DEMUX_RG,
+ *      the alignment must have been read with BL_SAM_FIELD_TAGS, or it
+ *      is routed to "unassigned".  The alignment is
+ *      appended to the output's buffer, which is flushed to the file
+ *      first if the alignment might not fit.
+ *
+ *  Arguments:
+ *      demux:          Pointer to an initialized bl_sam_demux_t structure
+ *      sam_alignment:  Pointer to the alignment to write
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success
+ *      BL_WRITE_FAILURE if an output could not be opened or written
+ *
+ *  See also:
+ *      bl_sam_demux_init(3), bl_sam_demux_close(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_demux_write(bl_sam_demux_t *demux, bl_sam_t *sam_alignment)
+
+{
+    const char  *key;
+    size_t      len, index;
+
+    if ( demux->key_type == BL_SAM_DEMUX_RG )
+    {
+	if ( bl_sam_get_tag_string(sam_alignment, "RG", &key, &len)
+		!= BL_DATA_OK )
+	{
+	    key = BL_SAM_DEMUX_UNASSIGNED;
+	    len = strlen(key);
+	}
+    }
+    else if ( strcmp(sam_alignment->rname, "*") == 0 )
+    {
+	key = BL_SAM_DEMUX_UNMAPPED;
+	len = strlen(key);
+    }
+    else
+    {
+	key = sam_alignment->rname;
+	len = strlen(key);
+    }
+
+    index = sam_demux_output(demux, key, len);
+    if ( ! bl_sam_writer_fits(&demux->outputs[index].writer, sam_alignment) &&
+	 (sam_demux_flush_output(demux, index) != BL_WRITE_OK) )
+	return BL_WRITE_FAILURE;
+
+    // Cannot flush unless the alignment is larger than the whole buffer
+    if ( bl_sam_writer_write(&demux->outputs[index].writer, sam_alignment)
+	    != BL_WRITE_OK )
+	return BL_WRITE_FAILURE;
+    ++demux->alignments_written;
+    return BL_WRITE_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-demux.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Write the buffers of all outputs to their files.  Outputs may be
+ *      opened and displaced in the process, as in bl_sam_demux_write(3).
+ *
+ *  Arguments:
+ *      demux:  Pointer to an initialized bl_sam_demux_t structure
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success
+ *      BL_WRITE_FAILURE if any output could not be opened or written
+ *
+ *  See also:
+ *      bl_sam_demux_write(3), bl_sam_demux_close(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_demux_flush(bl_sam_demux_t *demux)
+
+{
+    size_t  c;
+    int     status = BL_WRITE_OK;
+
+    // Open outputs first, to avoid displacing any of them
+    for (c = 0; c < demux->output_count; ++c)
+	if ( (demux->outputs[c].writer.stream != NULL) &&
+	     (sam_demux_flush_output(demux, c) != BL_WRITE_OK) )
+	    status = BL_WRITE_FAILURE;
+    for (c = 0; c < demux->output_count; ++c)
+	if ( sam_demux_flush_output(demux, c) != BL_WRITE_OK )
+	    status = BL_WRITE_FAILURE;
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-demux.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Flush all outputs, close all files, and free the demultiplexer.
+ *      Per-output counts should be read with
+ *      BL_SAM_DEMUX_OUTPUT_ALIGNMENTS() before closing.
+ *
+ *  Arguments:
+ *      demux:  Pointer to an initialized bl_sam_demux_t structure
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success
+ *      BL_WRITE_FAILURE if any output could not be opened or written
+ *
+ *  See also:
+ *      bl_sam_demux_init(3), bl_sam_demux_flush(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_demux_close(bl_sam_demux_t *demux)
+
+{
+    size_t  c;
+    int     status;
+
+    status = bl_sam_demux_flush(demux);
+    for (c = 0; c < demux->output_count; ++c)
+    {
+	if ( demux->outputs[c].writer.stream != NULL )
+	    sam_demux_close_stream(demux, c);
+	free(demux->outputs[c].writer.buff);
+	free(demux->outputs[c].key);
+	free(demux->outputs[c].filename);
+    }
+    free(demux->outputs);
+    free(demux->table);
+    free(demux->filename_template);
+    free(demux->header);
+    demux->outputs = NULL;
+    demux->table = NULL;
+    demux->filename_template = NULL;
+    demux->header = NULL;
+    demux->output_count = demux->output_max = demux->table_size = 0;
+    demux->last_output = BL_SAM_DEMUX_NONE;
+    return status;
+}
@@ -0,0 +1,81 @@
+#ifndef _sam_demux_h_
+#define _sam_demux_h_
+
+#ifndef _sam_h_
+#include "sam.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+// Routing keys for bl_sam_demux_init()
+#define BL_SAM_DEMUX_RNAME      0   // One output per contig
+#define BL_SAM_DEMUX_RG         1   // One output per RG:Z tag value
+
+// Keys used when an alignment has no RNAME or RG
+#define BL_SAM_DEMUX_UNMAPPED   "unmapped"
+#define BL_SAM_DEMUX_UNASSIGNED "unassigned"
+
+/*
+ *  Per-output buffers are smaller than BL_SAM_WRITER_BUFF_SIZE, since
+ *  there may be thousands of outputs.
+ */
+#define BL_SAM_DEMUX_BUFF_SIZE          (64 * 1024)
+#define BL_SAM_DEMUX_DEFAULT_MAX_OPEN   64
+
+#define BL_SAM_DEMUX_NONE       SIZE_MAX
+
+typedef struct
+{
+    char            *key;
+    char            *filename;
+    bl_sam_writer_t writer;     // stream is NULL while closed
+    bool            created;    // File has been truncated and given a header
+    size_t          lru_prev;   // Open outputs, most recently used first
+    size_t          lru_next;
+}   bl_sam_demux_output_t;
+
+typedef struct
+{
+    int                     key_type;
+    char                    *filename_template; // One %s, replaced by key
+    char                    *header;            // Written to each new file
+    sam_field_mask_t        field_mask;
+    size_t                  buff_size;
+
+    bl_sam_demux_output_t   *outputs;
+    size_t                  output_count;
+    size_t                  output_max;
+    size_t                  *table;             // Output index by key hash
+    size_t                  table_size;
+    size_t                  last_output;        // Sorted input repeats keys
+
+    size_t                  max_open;
+    size_t                  open_count;
+    size_t                  lru_head;
+    size_t                  lru_tail;
+
+    uint64_t                opens;
+    uint64_t                alignments_written;
+}   bl_sam_demux_t;
+
+/* Not generated by gen-get-set */
+#define BL_SAM_DEMUX_KEY_TYPE(ptr)          ((ptr)->key_type)
+#define BL_SAM_DEMUX_OUTPUT_COUNT(ptr)      ((ptr)->output_count)
+#define BL_SAM_DEMUX_OUTPUT_KEY(ptr,c)      ((ptr)->outputs[c].key)
+#define BL_SAM_DEMUX_OUTPUT_FILENAME(ptr,c) ((ptr)->outputs[c].filename)
+#define BL_SAM_DEMUX_OUTPUT_ALIGNMENTS(ptr,c) \
+	((ptr)->outputs[c].writer.alignments_written)
+#define BL_SAM_DEMUX_MAX_OPEN(ptr)          ((ptr)->max_open)
+#define BL_SAM_DEMUX_OPENS(ptr)             ((ptr)->opens)
+#define BL_SAM_DEMUX_ALIGNMENTS_WRITTEN(ptr) ((ptr)->alignments_written)
+
+/* sam-demux.c */
+void bl_sam_demux_init(bl_sam_demux_t *demux, const char *filename_template, int key_type, sam_field_mask_t field_mask, size_t max_open);
+void bl_sam_demux_set_header(bl_sam_demux_t *demux, const char *header);
+int bl_sam_demux_write(bl_sam_demux_t *demux, bl_sam_t *sam_alignment);
+int bl_sam_demux_flush(bl_sam_demux_t *demux);
+int bl_sam_demux_close(bl_sam_demux_t *demux);
+
+#endif  // _sam_demux_h_
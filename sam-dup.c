@@ -0,0 +1,461 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-dup.h"
+#include "biolibc.h"
+
+#define SAM_DUP_START_KEYS  1024
+
+static uint64_t sam_dup_hash(const bl_sam_dup_key_t *key)
+
+{
+    uint64_t    hash;
+
+    hash = key->pos5 * 0x9e3779b97f4a7c15ULL;
+    hash ^= (key->mate_pos + ((uint64_t)key->mate_contig << 32) + key->reverse)
+	    * 0xc2b2ae3d27d4eb4fULL;
+    return hash ^ (hash >> 29);
+}
+
+
+static uint32_t sam_dup_contig(bl_sam_dup_t *dup, const char *name)
+
+{
+    size_t  c;
+
+    for (c = dup->contig_count; c-- > 0; )
+	if ( strcmp(dup->contigs[c], name) == 0 )
+	    return c;
+    if ( dup->contig_count == dup->contig_max )
+    {
+	dup->contig_max = dup->contig_max == 0 ? 64 : dup->contig_max * 2;
+	if ( (dup->contigs = xt_realloc(dup->contigs, dup->contig_max,
+		sizeof(*dup->contigs))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_dup_mark(): Could not allocate contigs.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    if ( (dup->contigs[dup->contig_count] = strdup(name)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_dup_mark(): Could not allocate contig name.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    return dup->contig_count++;
+}
+
+
+/*
+ *  Total soft and hard clipping at the start and end of the alignment,
+ *  from the decoded CIGAR if present, otherwise from the CIGAR string.
+ */
+
+static void sam_dup_clips(bl_sam_t *sam_alignment, uint64_t *lead,
+			  uint64_t *trail)
+
+{
+    const char  *p;
+    uint32_t    op;
+    uint64_t    len;
+    unsigned    c;
+    bool        aligned = false;
+
+    *lead = *trail = 0;
+    if ( sam_alignment->cigar_op_count > 0 )
+    {
+	for (c = 0; c < sam_alignment->cigar_op_count; ++c)
+	{
+	    op = BL_SAM_CIGAR_OP(sam_alignment->cigar_ops[c]);
+	    if ( (op == BL_SAM_CIGAR_S) || (op == BL_SAM_CIGAR_H) )
+	    {
+		if ( aligned )
+		    *trail += BL_SAM_CIGAR_OP_LEN(sam_alignment->cigar_ops[c]);
+		else
+		    *lead += BL_SAM_CIGAR_OP_LEN(sam_alignment->cigar_ops[c]);
+	    }
+	    else
+		aligned = true;
+	}
+	return;
+    }
+
+    for (p = sam_alignment->cigar; *p != '\0'; ++p)
+    {
+	for (len = 0; (*p >= '0') && (*p <= '9'); ++p)
+	    len = len * 10 + *p - '0';
+	if ( (*p == 'S') || (*p == 'H') )
+	{
+	    if ( aligned )
+		*trail += len;
+	    else
+		*lead += len;
+	}
+	else if ( *p == '\0' )
+	    break;
+	else
+	    aligned = true;
+    }
+}
+
+
+/*
+ *  Rehash into max slots, dropping keys that can no longer be matched
+ *  from pos onward.
+ */
+
+static void sam_dup_rehash(bl_sam_dup_t *dup, size_t max, uint64_t pos)
+
+{
+    bl_sam_dup_key_t    *old_keys = dup->keys;
+    size_t              old_max = dup->key_max, c, mask, slot;
+
+    if ( (dup->keys = xt_malloc(max, sizeof(*dup->keys))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_dup_mark(): Could not allocate keys.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memset(dup->keys, 0, max * sizeof(*dup->keys));
+    dup->key_max = max;
+    dup->key_count = 0;
+    mask = max - 1;
+    for (c = 0; c < old_max; ++c)
+    {
+	if ( old_keys[c].used && (old_keys[c].pos5 + dup->window >= pos) )
+	{
+	    for (slot = sam_dup_hash(&old_keys[c]) & mask; dup->keys[slot].used;
+		 slot = (slot + 1) & mask)
+		;
+	    dup->keys[slot] = old_keys[c];
+	    ++dup->key_count;
+	}
+    }
+    free(old_keys);
+    dup->sweep_pos = pos;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-dup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a streaming duplicate marker for a coordinate-sorted
+ *      SAM stream.  Alignments are keyed on contig, unclipped 5'
+ *      position, strand, and mate contig and position (RNEXT/PNEXT).
+ *      The first alignment seen with a given key is considered unique
+ *      and any later alignment with the same key a duplicate.
+ *
+ *      Because the input is sorted, a key can only recur while the
+ *      stream is within a read length or so of its 5' position, so keys
+ *      are evicted once the stream is more than window bases past them.
+ *      Memory use is therefore bounded by the alignment density, not
+ *      by the size of the input.  window should be at least the longest
+ *      leading clip expected.  BL_SAM_DUP_DEFAULT_WINDOW suits short-read
+ *      data.
+ *
+ *      If flags includes BL_SAM_DUP_DROP, bl_sam_dup_read(3) and
+ *      bl_sam_dup_reader_read(3) skip duplicates instead of returning
+ *      them with BAM_FDUP set.
+ *
+ *      Input order is checked with bl_sam_buff_check_order(3) using
+ *      sam_buff, which may be shared with other consumers of the same
+ *      stream, as for bl_sam_cov_init(3).  Its MAPQ minimum is not
+ *      applied, since low quality alignments are still marked.
+ *
+ *  Arguments:
+ *      dup:        Pointer to the bl_sam_dup_t structure to initialize
+ *      sam_buff:   Pointer to an initialized bl_sam_buff_t structure
+ *      window:     Distance in bases after which keys are evicted
+ *      flags:      0 or BL_SAM_DUP_DROP
+ *
+ *  Examples:
+ *      bl_sam_buff_t   sam_buff;
+ *      bl_sam_dup_t    dup;
+ *      bl_sam_t        sam_alignment;
+ *
+ *      bl_sam_buff_init(&sam_buff, 0);
+ *      bl_sam_init(&sam_alignment, BL_SAM_SEQ_MAX_CHARS, BL_SAM_FIELD_ALL);
+ *      bl_sam_dup_init(&dup, &sam_buff, BL_SAM_DUP_DEFAULT_WINDOW,
+ *                      BL_SAM_DUP_DROP);
+ *      while ( bl_sam_dup_read(&dup, stdin, &sam_alignment,
+ *                              BL_SAM_FIELD_ALL) == BL_READ_OK )
+ *          process_alignment(&sam_alignment);
+ *      bl_sam_dup_free(&dup);
+ *
+ *  See also:
+ *      bl_sam_dup_mark(3), bl_sam_dup_read(3), bl_sam_dup_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_dup_init(bl_sam_dup_t *dup, bl_sam_buff_t *sam_buff,
+			uint64_t window, unsigned flags)
+
+{
+    dup->key_max = SAM_DUP_START_KEYS;
+    if ( (dup->keys = xt_malloc(dup->key_max, sizeof(*dup->keys))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_dup_init(): Could not allocate keys.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memset(dup->keys, 0, dup->key_max * sizeof(*dup->keys));
+    dup->key_count = 0;
+    dup->window = window;
+    dup->flags = flags;
+    dup->sam_buff = sam_buff;
+    dup->contigs = NULL;
+    dup->contig_count = dup->contig_max = 0;
+    dup->current_contig = SIZE_MAX;
+    dup->sweep_pos = 0;
+    dup->examined = dup->duplicates = dup->max_keys = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-dup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Check the next alignment of a coordinate-sorted stream against
+ *      recent alignments, setting BAM_FDUP if it duplicates one of them
+ *      and clearing it otherwise.  Unmapped, secondary, and
+ *      supplementary alignments are not examined and their FLAG is left
+ *      unchanged.  Alignments without a mapped mate are keyed with no
+ *      mate position, so they only duplicate other such alignments.
+ *
+ *      The unclipped 5' position is computed from POS, the reference
+ *      end (BL_SAM_REF_END()), and soft and hard clipping, so the CIGAR
+ *      field must have been read.
+ *
+ *      The first alignment of each duplicate set is kept, since the
+ *      stream cannot be held back to choose the best one.  Mates are
+ *      keyed independently, so the mates of a duplicate fragment are
+ *      marked consistently as long as both have the same POS/PNEXT as
+ *      those of the first fragment.
+ *
+ *  Arguments:
+ *      dup:            Pointer to an initialized bl_sam_dup_t structure
+ *      sam_alignment:  Pointer to the next alignment in the stream
+ *
+ *  Returns:
+ *      BL_SAM_DUP_UNIQUE if the alignment is the first with its key
+ *      BL_SAM_DUP_DUPLICATE if it duplicates an earlier alignment
+ *      BL_SAM_DUP_SKIPPED if it was not examined
+ *
+ *  See also:
+ *      bl_sam_dup_init(3), bl_sam_dup_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_dup_mark(bl_sam_dup_t *dup, bl_sam_t *sam_alignment)
+
+{
+    bl_sam_dup_key_t    key;
+    uint64_t            lead, trail, pos = BL_SAM_POS(sam_alignment);
+    uint32_t            contig;
+    size_t              mask, slot;
+
+    if ( BL_SAM_FLAG(sam_alignment) &
+	 (BAM_FUNMAP | BAM_FSECONDARY | BAM_FSUPPLEMENTARY) )
+	return BL_SAM_DUP_SKIPPED;
+
+    bl_sam_buff_check_order(dup->sam_buff, sam_alignment);
+    contig = sam_dup_contig(dup, BL_SAM_RNAME(sam_alignment));
+    if ( contig != dup->current_contig )
+    {
+	// Keys never match across contigs
+	memset(dup->keys, 0, dup->key_max * sizeof(*dup->keys));
+	dup->key_count = 0;
+	dup->current_contig = contig;
+	dup->sweep_pos = pos;
+    }
+    ++dup->examined;
+
+    sam_dup_clips(sam_alignment, &lead, &trail);
+    memset(&key, 0, sizeof(key));
+    key.reverse = (BL_SAM_FLAG(sam_alignment) & BAM_FREVERSE) != 0;
+    if ( key.reverse )
+	key.pos5 = BL_SAM_REF_END(sam_alignment) + trail;
+    else
+	key.pos5 = lead < pos ? pos - lead : 0;
+    if ( (BL_SAM_FLAG(sam_alignment) & BAM_FPAIRED) &&
+	 ! (BL_SAM_FLAG(sam_alignment) & BAM_FMUNMAP) &&
+	 (strcmp(BL_SAM_RNEXT(sam_alignment), "*") != 0) )
+    {
+	if ( strcmp(BL_SAM_RNEXT(sam_alignment), "=") == 0 )
+	    key.mate_contig = contig;
+	else
+	    key.mate_contig = sam_dup_contig(dup, BL_SAM_RNEXT(sam_alignment));
+	key.mate_pos = BL_SAM_PNEXT(sam_alignment);
+    }
+    else
+	key.mate_contig = UINT32_MAX;
+    key.used = true;
+
+    // Periodically drop keys the stream has moved past
+    if ( pos > dup->sweep_pos + dup->window )
+	sam_dup_rehash(dup, dup->key_max, pos);
+
+    mask = dup->key_max - 1;
+    for (slot = sam_dup_hash(&key) & mask; dup->keys[slot].used;
+	 slot = (slot + 1) & mask)
+    {
+	if ( (dup->keys[slot].pos5 == key.pos5) &&
+	     (dup->keys[slot].mate_pos == key.mate_pos) &&
+	     (dup->keys[slot].mate_contig == key.mate_contig) &&
+	     (dup->keys[slot].reverse == key.reverse) )
+	{
+	    BL_SAM_SET_FLAG(sam_alignment, BL_SAM_FLAG(sam_alignment) | BAM_FDUP);
+	    ++dup->duplicates;
+	    return BL_SAM_DUP_DUPLICATE;
+	}
+    }
+
+    BL_SAM_SET_FLAG(sam_alignment, BL_SAM_FLAG(sam_alignment) & ~BAM_FDUP);
+    dup->keys[slot] = key;
+    if ( ++dup->key_count > dup->max_keys )
+	dup->max_keys = dup->key_count;
+    if ( 2 * dup->key_count > dup->key_max )
+    {
+	sam_dup_rehash(dup, dup->key_max, pos);
+	if ( 2 * dup->key_count > dup->key_max / 2 )
+	    sam_dup_rehash(dup, dup->key_max * 2, pos);
+    }
+    return BL_SAM_DUP_UNIQUE;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-dup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Read the next alignment with bl_sam_read(3) and pass it through
+ *      bl_sam_dup_mark(3).  If dup was initialized with BL_SAM_DUP_DROP,
+ *      duplicates are skipped and the next non-duplicate is returned,
+ *      so callers see a deduplicated stream with no extra pass.
+ *      Skipped duplicates are read into sam_alignment, whose SEQ and
+ *      QUAL buffers bl_sam_read(3) grows to fit each record.
+ *
+ *  Arguments:
+ *      dup:            Pointer to an initialized bl_sam_dup_t structure
+ *      sam_stream:     FILE stream from which to read
+ *      sam_alignment:  Pointer to a bl_sam_t structure to receive the data
+ *      field_mask:     Fields to read, as for bl_sam_read(3).  Must
+ *                      include BL_SAM_FIELD_CIGAR.
+ *
+ *  Returns:
+ *      The return value of bl_sam_read(3)
+ *
+ *  See also:
+ *      bl_sam_dup_reader_read(3), bl_sam_dup_mark(3), bl_sam_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_dup_read(bl_sam_dup_t *dup, FILE *sam_stream,
+			bl_sam_t *sam_alignment, sam_field_mask_t field_mask)
+
+{
+    int     status;
+
+    while ( (status = bl_sam_read(sam_stream, sam_alignment, field_mask))
+	    == BL_READ_OK )
+    {
+	if ( (bl_sam_dup_mark(dup, sam_alignment) != BL_SAM_DUP_DUPLICATE) ||
+	     ! (dup->flags & BL_SAM_DUP_DROP) )
+	    break;
+    }
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-dup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Same as bl_sam_dup_read(3), but reading with
+ *      bl_sam_reader_read(3) from a reentrant reader context.
+ *
+ *  Arguments:
+ *      dup:            Pointer to an initialized bl_sam_dup_t structure
+ *      reader:         Pointer to an initialized bl_sam_reader_t.  Its
+ *                      field mask must include BL_SAM_FIELD_CIGAR.
+ *      sam_alignment:  Pointer to a bl_sam_t structure to receive the data
+ *
+ *  Returns:
+ *      The return value of bl_sam_reader_read(3)
+ *
+ *  See also:
+ *      bl_sam_dup_read(3), bl_sam_dup_mark(3), bl_sam_reader_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_dup_reader_read(bl_sam_dup_t *dup, bl_sam_reader_t *reader,
+			       bl_sam_t *sam_alignment)
+
+{
+    int     status;
+
+    while ( (status = bl_sam_reader_read(reader, sam_alignment))
+	    == BL_READ_OK )
+    {
+	if ( (bl_sam_dup_mark(dup, sam_alignment) != BL_SAM_DUP_DUPLICATE) ||
+	     ! (dup->flags & BL_SAM_DUP_DROP) )
+	    break;
+    }
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-dup.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory allocated by a duplicate marker.  Statistics
+ *      are left intact.
+ *
+ *  Arguments:
+ *      dup:    Pointer to an initialized bl_sam_dup_t structure
+ *
+ *  See also:
+ *      bl_sam_dup_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_dup_free(bl_sam_dup_t *dup)
+
+{
+    size_t  c;
+
+    for (c = 0; c < dup->contig_count; ++c)
+	free(dup->contigs[c]);
+    free(dup->contigs);
+    free(dup->keys);
+    dup->contigs = NULL;
+    dup->keys = NULL;
+    dup->contig_count = dup->contig_max = 0;
+    dup->key_count = dup->key_max = 0;
+}
@@ -0,0 +1,70 @@
+#ifndef _sam_dup_h_
+#define _sam_dup_h_
+
+#ifndef _sam_buff_h_
+#include "sam-buff.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+// Return values for bl_sam_dup_mark()
+#define BL_SAM_DUP_UNIQUE       0   // First alignment seen with its key
+#define BL_SAM_DUP_DUPLICATE    1   // BAM_FDUP set
+#define BL_SAM_DUP_SKIPPED      2   // Unmapped, secondary, or supplementary
+
+// Flags for bl_sam_dup_init()
+#define BL_SAM_DUP_DROP         0x1 // bl_sam_dup_read() skips duplicates
+
+/*
+ *  Keys are evicted once the stream is this far past their 5' position.
+ *  A forward read cannot match an evicted key unless its leading clip
+ *  is longer than the window.
+ */
+#define BL_SAM_DUP_DEFAULT_WINDOW   1024
+
+typedef struct
+{
+    uint64_t    pos5;           // Unclipped 5' position
+    uint64_t    mate_pos;       // PNEXT, 0 if no mapped mate
+    uint32_t    mate_contig;    // Index into contigs, UINT32_MAX if none
+    uint8_t     reverse;
+    bool        used;
+}   bl_sam_dup_key_t;
+
+typedef struct
+{
+    bl_sam_dup_key_t    *keys;      // Open-addressed, power of 2 slots
+    size_t              key_max;
+    size_t              key_count;
+    uint64_t            window;
+    unsigned            flags;
+    bl_sam_buff_t       *sam_buff;  // Order check
+
+    char                **contigs;  // RNAME and RNEXT values seen
+    size_t              contig_count;
+    size_t              contig_max;
+    size_t              current_contig;
+    uint64_t            sweep_pos;  // Position of last eviction pass
+
+    uint64_t            examined,
+			duplicates,
+			max_keys;
+}   bl_sam_dup_t;
+
+/* Not generated by gen-get-set */
+#define BL_SAM_DUP_WINDOW(ptr)          ((ptr)->window)
+#define BL_SAM_DUP_FLAGS(ptr)           ((ptr)->flags)
+#define BL_SAM_DUP_EXAMINED(ptr)        ((ptr)->examined)
+#define BL_SAM_DUP_DUPLICATES(ptr)      ((ptr)->duplicates)
+#define BL_SAM_DUP_MAX_KEYS(ptr)        ((ptr)->max_keys)
+
+/* sam-dup.c */
+void bl_sam_dup_init(bl_sam_dup_t *dup, bl_sam_buff_t *sam_buff, uint64_t window, unsigned flags);
+int bl_sam_dup_mark(bl_sam_dup_t *dup, bl_sam_t *sam_alignment);
+int bl_sam_dup_read(bl_sam_dup_t *dup, FILE *sam_stream, bl_sam_t *sam_alignment, sam_field_mask_t field_mask);
+int bl_sam_dup_reader_read(bl_sam_dup_t *dup, bl_sam_reader_t *reader, bl_sam_t *sam_alignment);
+void bl_sam_dup_free(bl_sam_dup_t *dup);
+
+#endif  // _sam_dup_h_
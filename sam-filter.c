@@ -0,0 +1,841 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-filter.h"
+
+enum
+{
+    SAM_FILTER_CONST,
+    SAM_FILTER_FLAG,
+    SAM_FILTER_MAPQ,
+    SAM_FILTER_POS,
+    SAM_FILTER_PNEXT,
+    SAM_FILTER_TLEN,
+    SAM_FILTER_QLEN,
+    SAM_FILTER_RLEN,
+    SAM_FILTER_RNAME_IN,
+    SAM_FILTER_RNEXT_IN,
+    SAM_FILTER_QNAME_IN,
+    SAM_FILTER_NOT,
+    SAM_FILTER_NEG,
+    SAM_FILTER_ABS,
+    SAM_FILTER_BIT_AND,
+    SAM_FILTER_BIT_OR,
+    SAM_FILTER_EQ,
+    SAM_FILTER_NE,
+    SAM_FILTER_LT,
+    SAM_FILTER_LE,
+    SAM_FILTER_GT,
+    SAM_FILTER_GE,
+    SAM_FILTER_AND,
+    SAM_FILTER_OR
+};
+
+// Tokens
+enum
+{
+    TOK_END,
+    TOK_NUM,
+    TOK_WORD,
+    TOK_STRING,
+    TOK_LPAREN,
+    TOK_RPAREN,
+    TOK_LBRACE,
+    TOK_RBRACE,
+    TOK_COMMA,
+    TOK_NOT,
+    TOK_MINUS,
+    TOK_BIT_AND,
+    TOK_BIT_OR,
+    TOK_AND,
+    TOK_OR,
+    TOK_EQ,
+    TOK_NE,
+    TOK_LT,
+    TOK_LE,
+    TOK_GT,
+    TOK_GE,
+    TOK_BAD
+};
+
+typedef struct
+{
+    const char  *name;
+    int         opcode;
+    sam_field_mask_t    field;
+}   filter_field_t;
+
+static const filter_field_t Numeric_fields[] =
+{
+    { "flag",   SAM_FILTER_FLAG,    BL_SAM_FIELD_FLAG },
+    { "mapq",   SAM_FILTER_MAPQ,    BL_SAM_FIELD_MAPQ },
+    { "pos",    SAM_FILTER_POS,     BL_SAM_FIELD_POS },
+    { "pnext",  SAM_FILTER_PNEXT,   BL_SAM_FIELD_PNEXT },
+    { "tlen",   SAM_FILTER_TLEN,    BL_SAM_FIELD_TLEN },
+    { "qlen",   SAM_FILTER_QLEN,    BL_SAM_FIELD_CIGAR },
+    { "rlen",   SAM_FILTER_RLEN,    BL_SAM_FIELD_CIGAR },
+    { NULL,     0,                  0 }
+};
+
+static const filter_field_t String_fields[] =
+{
+    { "rname",  SAM_FILTER_RNAME_IN,    BL_SAM_FIELD_RNAME },
+    // RNEXT "=" is compared as RNAME
+    { "rnext",  SAM_FILTER_RNEXT_IN,
+				BL_SAM_FIELD_RNEXT | BL_SAM_FIELD_RNAME },
+    { "qname",  SAM_FILTER_QNAME_IN,    BL_SAM_FIELD_QNAME },
+    { NULL,     0,                      0 }
+};
+
+typedef struct
+{
+    bl_sam_filter_t *filter;
+    const char      *expr;
+    const char      *p;
+    const char      *tok_start;
+    int             tok;
+    int64_t         num;
+    char            text[BL_SAM_QNAME_MAX_CHARS + 1];
+    int             depth;      // Stack depth after ops emitted so far
+    bool            error;
+}   filter_parser_t;
+
+static int  filter_or(filter_parser_t *parser);
+
+static void filter_error(filter_parser_t *parser, const char *message)
+
+{
+    if ( ! parser->error )
+	fprintf(stderr, "bl_sam_filter_compile(): %s at column %zu of \"%s\"\n",
+		message, (size_t)(parser->tok_start - parser->expr) + 1,
+		parser->expr);
+    parser->error = true;
+}
+
+
+/*
+ *  Characters that end an unquoted word.  Contig names may contain
+ *  anything else, e.g. "HLA-A*01:01:01:01" or "chrUn_KI270302v1".
+ */
+
+static bool filter_word_char(int ch)
+
+{
+    return (ch != '\0') && ! isspace((unsigned char)ch) &&
+	   (strchr("(){},!&|=<>\"", ch) == NULL);
+}
+
+
+static void filter_next(filter_parser_t *parser)
+
+{
+    const char  *p;
+    char        *end;
+    size_t      len;
+
+    while ( isspace((unsigned char)*parser->p) )
+	++parser->p;
+    p = parser->tok_start = parser->p;
+
+    switch(*p)
+    {
+	case '\0':
+	    parser->tok = TOK_END;
+	    return;
+	case '(':   parser->tok = TOK_LPAREN; break;
+	case ')':   parser->tok = TOK_RPAREN; break;
+	case '{':   parser->tok = TOK_LBRACE; break;
+	case '}':   parser->tok = TOK_RBRACE; break;
+	case ',':   parser->tok = TOK_COMMA; break;
+	case '-':   parser->tok = TOK_MINUS; break;
+	case '!':
+	    if ( p[1] == '=' )
+	    {
+		parser->tok = TOK_NE;
+		++p;
+	    }
+	    else
+		parser->tok = TOK_NOT;
+	    break;
+	case '&':
+	    if ( p[1] == '&' )
+	    {
+		parser->tok = TOK_AND;
+		++p;
+	    }
+	    else
+		parser->tok = TOK_BIT_AND;
+	    break;
+	case '|':
+	    if ( p[1] == '|' )
+	    {
+		parser->tok = TOK_OR;
+		++p;
+	    }
+	    else
+		parser->tok = TOK_BIT_OR;
+	    break;
+	case '=':
+	    if ( p[1] != '=' )
+	    {
+		parser->tok = TOK_BAD;
+		return;
+	    }
+	    parser->tok = TOK_EQ;
+	    ++p;
+	    break;
+	case '<':
+	    if ( p[1] == '=' )
+	    {
+		parser->tok = TOK_LE;
+		++p;
+	    }
+	    else
+		parser->tok = TOK_LT;
+	    break;
+	case '>':
+	    if ( p[1] == '=' )
+	    {
+		parser->tok = TOK_GE;
+		++p;
+	    }
+	    else
+		parser->tok = TOK_GT;
+	    break;
+	case '"':
+	    for (len = 0, ++p; (*p != '"') && (*p != '\0'); ++p)
+		if ( len < BL_SAM_QNAME_MAX_CHARS )
+		    parser->text[len++] = *p;
+	    parser->text[len] = '\0';
+	    if ( *p == '\0' )
+	    {
+		parser->tok = TOK_BAD;
+		return;
+	    }
+	    parser->tok = TOK_STRING;
+	    break;
+	default:
+	    if ( isdigit((unsigned char)*p) )
+	    {
+		parser->num = strtoll(p, &end, 0);
+		// Digits followed by word characters, e.g. contig "1_random"
+		if ( ! filter_word_char(*end) )
+		{
+		    parser->tok = TOK_NUM;
+		    p = end;
+		    for (len = 0; (parser->tok_start + len < end) &&
+				  (len < BL_SAM_QNAME_MAX_CHARS); ++len)
+			parser->text[len] = parser->tok_start[len];
+		    parser->text[len] = '\0';
+		    parser->p = p;
+		    return;
+		}
+	    }
+	    if ( ! filter_word_char((unsigned char)*p) )
+	    {
+		parser->tok = TOK_BAD;
+		return;
+	    }
+	    for (len = 0; filter_word_char((unsigned char)*p); ++p)
+		if ( len < BL_SAM_QNAME_MAX_CHARS )
+		    parser->text[len++] = *p;
+	    parser->text[len] = '\0';
+	    parser->tok = TOK_WORD;
+	    parser->p = p;
+	    return;
+    }
+    parser->p = p + 1;
+}
+
+
+/*
+ *  Append an op.  stack_change is the net effect on the evaluation
+ *  stack, checked here so that bl_sam_filter_eval() never overflows.
+ */
+
+static void filter_emit(filter_parser_t *parser, int opcode, int64_t value,
+			int stack_change)
+
+{
+    bl_sam_filter_t *filter = parser->filter;
+
+    if ( filter->op_count == filter->op_max )
+    {
+	filter->op_max = filter->op_max == 0 ? 32 : filter->op_max * 2;
+	if ( (filter->ops = xt_realloc(filter->ops, filter->op_max,
+		sizeof(*filter->ops))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_filter_compile(): Could not allocate ops.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    filter->ops[filter->op_count].opcode = opcode;
+    filter->ops[filter->op_count].value = value;
+    ++filter->op_count;
+    if ( (parser->depth += stack_change) > BL_SAM_FILTER_STACK_MAX )
+	filter_error(parser, "Expression nested too deeply");
+}
+
+
+static void filter_add_string(filter_parser_t *parser)
+
+{
+    bl_sam_filter_t *filter = parser->filter;
+
+    if ( filter->string_count == filter->string_max )
+    {
+	filter->string_max = filter->string_max == 0 ? 16 :
+			     filter->string_max * 2;
+	if ( (filter->strings = xt_realloc(filter->strings,
+		filter->string_max, sizeof(*filter->strings))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_filter_compile(): Could not allocate strings.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    if ( (filter->strings[filter->string_count++] =
+	    strdup(parser->text)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_filter_compile(): Could not allocate string.\n");
+	exit(EX_UNAVAILABLE);
+    }
+}
+
+
+static int  filter_strcmp(const void *a, const void *b)
+
+{
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+
+/*
+ *  rname == word, rname != word, rname in { word, ... }
+ *  Each compiles to a set membership test, so == is a set of one.
+ */
+
+static void filter_string_test(filter_parser_t *parser,
+			       const filter_field_t *field)
+
+{
+    bl_sam_filter_t     *filter = parser->filter;
+    bl_sam_filter_set_t set;
+    int                 op;
+    bool                list;
+
+    op = parser->tok;
+    if ( (op == TOK_WORD) && (strcmp(parser->text, "in") == 0) )
+	list = true;
+    else if ( (op == TOK_EQ) || (op == TOK_NE) )
+	list = false;
+    else
+    {
+	filter_error(parser, "Expected ==, !=, or in");
+	return;
+    }
+    filter_next(parser);
+
+    set.first = filter->string_count;
+    if ( list )
+    {
+	if ( parser->tok != TOK_LBRACE )
+	{
+	    filter_error(parser, "Expected {");
+	    return;
+	}
+	filter_next(parser);
+	while ( parser->tok != TOK_RBRACE )
+	{
+	    if ( (parser->tok != TOK_WORD) && (parser->tok != TOK_NUM) &&
+		 (parser->tok != TOK_STRING) )
+	    {
+		filter_error(parser, "Expected a name or }");
+		return;
+	    }
+	    filter_add_string(parser);
+	    filter_next(parser);
+	    if ( parser->tok == TOK_COMMA )
+		filter_next(parser);
+	}
+    }
+    else
+    {
+	if ( (parser->tok != TOK_WORD) && (parser->tok != TOK_NUM) &&
+	     (parser->tok != TOK_STRING) )
+	{
+	    filter_error(parser, "Expected a name");
+	    return;
+	}
+	filter_add_string(parser);
+    }
+    filter_next(parser);
+    set.count = filter->string_count - set.first;
+    qsort(filter->strings + set.first, set.count, sizeof(*filter->strings),
+	  filter_strcmp);
+
+    if ( filter->set_count == filter->set_max )
+    {
+	filter->set_max = filter->set_max == 0 ? 8 : filter->set_max * 2;
+	if ( (filter->sets = xt_realloc(filter->sets, filter->set_max,
+		sizeof(*filter->sets))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_filter_compile(): Could not allocate sets.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    filter->sets[filter->set_count] = set;
+    filter_emit(parser, field->opcode, filter->set_count++, 1);
+    filter->field_mask |= field->field;
+    if ( op == TOK_NE )
+	filter_emit(parser, SAM_FILTER_NOT, 0, 0);
+}
+
+
+static const filter_field_t *filter_find_field(const filter_field_t *fields,
+					      const char *name)
+
+{
+    for (; fields->name != NULL; ++fields)
+	if ( strcmp(fields->name, name) == 0 )
+	    return fields;
+    return NULL;
+}
+
+
+static void filter_primary(filter_parser_t *parser)
+
+{
+    const filter_field_t    *field;
+
+    switch(parser->tok)
+    {
+	case TOK_NUM:
+	    filter_emit(parser, SAM_FILTER_CONST, parser->num, 1);
+	    filter_next(parser);
+	    break;
+	case TOK_LPAREN:
+	    filter_next(parser);
+	    filter_or(parser);
+	    if ( parser->tok != TOK_RPAREN )
+		filter_error(parser, "Expected )");
+	    filter_next(parser);
+	    break;
+	case TOK_WORD:
+	    if ( (field = filter_find_field(Numeric_fields, parser->text))
+		    != NULL )
+	    {
+		filter_emit(parser, field->opcode, 0, 1);
+		parser->filter->field_mask |= field->field;
+		filter_next(parser);
+	    }
+	    else if ( (field = filter_find_field(String_fields, parser->text))
+		    != NULL )
+	    {
+		filter_next(parser);
+		filter_string_test(parser, field);
+	    }
+	    else if ( strcmp(parser->text, "abs") == 0 )
+	    {
+		filter_next(parser);
+		if ( parser->tok != TOK_LPAREN )
+		{
+		    filter_error(parser, "Expected (");
+		    return;
+		}
+		filter_primary(parser);
+		filter_emit(parser, SAM_FILTER_ABS, 0, 0);
+	    }
+	    else
+		filter_error(parser, "Unknown field");
+	    break;
+	default:
+	    filter_error(parser, "Expected a field, number, or (");
+	    break;
+    }
+}
+
+
+static void filter_unary(filter_parser_t *parser)
+
+{
+    if ( parser->tok == TOK_NOT )
+    {
+	filter_next(parser);
+	filter_unary(parser);
+	filter_emit(parser, SAM_FILTER_NOT, 0, 0);
+    }
+    else if ( parser->tok == TOK_MINUS )
+    {
+	filter_next(parser);
+	filter_unary(parser);
+	filter_emit(parser, SAM_FILTER_NEG, 0, 0);
+    }
+    else
+	filter_primary(parser);
+}
+
+
+/*
+ *  & and | bind tighter than comparisons (unlike C), so that
+ *  "flag & 4 == 0" means what it looks like.
+ */
+
+static void filter_bits(filter_parser_t *parser)
+
+{
+    int     tok;
+
+    filter_unary(parser);
+    while ( ! parser->error &&
+	    (((tok = parser->tok) == TOK_BIT_AND) || (tok == TOK_BIT_OR)) )
+    {
+	filter_next(parser);
+	filter_unary(parser);
+	filter_emit(parser, tok == TOK_BIT_AND ? SAM_FILTER_BIT_AND :
+			    SAM_FILTER_BIT_OR, 0, -1);
+    }
+}
+
+
+static void filter_compare(filter_parser_t *parser)
+
+{
+    static const int    opcodes[] =
+    {
+	[TOK_EQ] = SAM_FILTER_EQ, [TOK_NE] = SAM_FILTER_NE,
+	[TOK_LT] = SAM_FILTER_LT, [TOK_LE] = SAM_FILTER_LE,
+	[TOK_GT] = SAM_FILTER_GT, [TOK_GE] = SAM_FILTER_GE
+    };
+    int     tok;
+
+    filter_bits(parser);
+    tok = parser->tok;
+    if ( ! parser->error && (tok >= TOK_EQ) && (tok <= TOK_GE) )
+    {
+	filter_next(parser);
+	filter_bits(parser);
+	filter_emit(parser, opcodes[tok], 0, -1);
+    }
+}
+
+
+static void filter_and(filter_parser_t *parser)
+
+{
+    filter_compare(parser);
+    while ( ! parser->error && (parser->tok == TOK_AND) )
+    {
+	filter_next(parser);
+	filter_compare(parser);
+	filter_emit(parser, SAM_FILTER_AND, 0, -1);
+    }
+}
+
+
+static int  filter_or(filter_parser_t *parser)
+
+{
+    filter_and(parser);
+    while ( ! parser->error && (parser->tok == TOK_OR) )
+    {
+	filter_next(parser);
+	filter_and(parser);
+	filter_emit(parser, SAM_FILTER_OR, 0, -1);
+    }
+    return parser->error ? BL_DATA_INVALID : BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-filter.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Compile a filter expression over SAM fixed fields into a compact
+ *      postfix program for bl_sam_filter_eval(3).  Attached to a reader
+ *      with bl_sam_reader_set_filter(3), the filter runs before SEQ,
+ *      QUAL, and tags are copied, so rejected records are cheap.
+ *
+ *      Numeric fields are flag, mapq, pos, pnext, tlen, qlen (query
+ *      length from CIGAR, including soft clips), and rlen (reference
+ *      length from CIGAR).  Numbers may be decimal or 0x hex.  Operators,
+ *      from lowest to highest precedence, are:
+ *
+ *          ||
+ *          &&
+ *          ==  !=  <  <=  >  >=
+ *          &  |            (bitwise)
+ *          !  -            (unary)
+ *
+ *      Note that & and | bind more tightly than comparisons, unlike in
+ *      C.  abs(x) gives the absolute value, e.g. for tlen.
+ *
+ *      String fields rname, rnext, and qname can be tested with ==, !=,
+ *      or in, against unquoted names or "quoted strings":
+ *
+ *          rname == chrM
+ *          rname in { chr1, chr2, chrX }
+ *
+ *  Arguments:
+ *      filter: Pointer to a bl_sam_filter_t structure to fill in
+ *      expr:   Filter expression
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_INVALID on a syntax error, after reporting it to stderr
+ *
+ *  Examples:
+ *      bl_sam_filter_t filter;
+ *
+ *      // Primary, mapped, MAPQ 20+, proper insert size, on chr1-3
+ *      bl_sam_filter_compile(&filter,
+ *          "!(flag & 0x904) && mapq >= 20 && abs(tlen) <= 1000 "
+ *          "&& rname in {chr1, chr2, chr3} && qlen >= 50");
+ *
+ *  See also:
+ *      bl_sam_filter_eval(3), bl_sam_reader_set_filter(3),
+ *      bl_sam_filter_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_filter_compile(bl_sam_filter_t *filter, const char *expr)
+
+{
+    filter_parser_t parser;
+
+    filter->ops = NULL;
+    filter->op_count = filter->op_max = 0;
+    filter->strings = NULL;
+    filter->string_count = filter->string_max = 0;
+    filter->sets = NULL;
+    filter->set_count = filter->set_max = 0;
+    filter->field_mask = 0;
+
+    parser.filter = filter;
+    parser.expr = parser.p = expr;
+    parser.depth = 0;
+    parser.error = false;
+    filter_next(&parser);
+    filter_or(&parser);
+    if ( ! parser.error && (parser.tok != TOK_END) )
+	filter_error(&parser, "Unexpected input");
+    if ( parser.error )
+    {
+	bl_sam_filter_free(filter);
+	return BL_DATA_INVALID;
+    }
+    return BL_DATA_OK;
+}
+
+
+/*
+ *  Query (qlen) or reference (rlen) length from the CIGAR string, so
+ *  the filter does not depend on BL_SAM_FIELD_CIGAR_OPS.
+ */
+
+static int64_t  filter_cigar_len(bl_sam_t *sam_alignment, bool query)
+
+{
+    const char  *p;
+    int64_t     len, total = 0;
+
+    for (p = sam_alignment->cigar; *p != '\0'; ++p)
+    {
+	for (len = 0; isdigit((unsigned char)*p); ++p)
+	    len = len * 10 + *p - '0';
+	if ( *p == '\0' )
+	    break;
+	if ( query ? (strchr("MIS=X", *p) != NULL) :
+		     (strchr("MDN=X", *p) != NULL) )
+	    total += len;
+    }
+    return total;
+}
+
+
+static bool filter_in_set(bl_sam_filter_t *filter, int64_t set,
+			  const char *str)
+
+{
+    bl_sam_filter_set_t *s = &filter->sets[set];
+
+    return bsearch(&str, filter->strings + s->first, s->count,
+		   sizeof(*filter->strings), filter_strcmp) != NULL;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-filter.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Evaluate a compiled filter expression for one alignment.  Only
+ *      the fields used by the expression (BL_SAM_FILTER_FIELD_MASK())
+ *      need to have been read.  The filter is not modified, so it may
+ *      be shared by threads.
+ *
+ *  Arguments:
+ *      filter:         Pointer to a filter from bl_sam_filter_compile(3)
+ *      sam_alignment:  Pointer to the alignment to test
+ *
+ *  Returns:
+ *      true if the expression is non-zero for the alignment
+ *      false otherwise
+ *
+ *  See also:
+ *      bl_sam_filter_compile(3), bl_sam_reader_set_filter(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    bl_sam_filter_eval(bl_sam_filter_t *filter, bl_sam_t *sam_alignment)
+
+{
+    int64_t             stack[BL_SAM_FILTER_STACK_MAX], *sp = stack;
+    bl_sam_filter_op_t  *op, *end = filter->ops + filter->op_count;
+
+    if ( filter->op_count == 0 )
+	return true;
+
+    for (op = filter->ops; op < end; ++op)
+    {
+	switch(op->opcode)
+	{
+	    case SAM_FILTER_CONST:
+		*sp++ = op->value;
+		break;
+	    case SAM_FILTER_FLAG:
+		*sp++ = sam_alignment->flag;
+		break;
+	    case SAM_FILTER_MAPQ:
+		*sp++ = sam_alignment->mapq;
+		break;
+	    case SAM_FILTER_POS:
+		*sp++ = sam_alignment->pos;
+		break;
+	    case SAM_FILTER_PNEXT:
+		*sp++ = sam_alignment->pnext;
+		break;
+	    case SAM_FILTER_TLEN:
+		*sp++ = sam_alignment->tlen;
+		break;
+	    case SAM_FILTER_QLEN:
+		*sp++ = filter_cigar_len(sam_alignment, true);
+		break;
+	    case SAM_FILTER_RLEN:
+		*sp++ = filter_cigar_len(sam_alignment, false);
+		break;
+	    case SAM_FILTER_RNAME_IN:
+		*sp++ = filter_in_set(filter, op->value, sam_alignment->rname);
+		break;
+	    case SAM_FILTER_RNEXT_IN:
+		// "=" means same as RNAME
+		*sp++ = filter_in_set(filter, op->value,
+		    strcmp(sam_alignment->rnext, "=") == 0 ?
+		    sam_alignment->rname : sam_alignment->rnext);
+		break;
+	    case SAM_FILTER_QNAME_IN:
+		*sp++ = filter_in_set(filter, op->value, sam_alignment->qname);
+		break;
+	    case SAM_FILTER_NOT:
+		sp[-1] = ! sp[-1];
+		break;
+	    case SAM_FILTER_NEG:
+		sp[-1] = -sp[-1];
+		break;
+	    case SAM_FILTER_ABS:
+		if ( sp[-1] < 0 )
+		    sp[-1] = -sp[-1];
+		break;
+	    case SAM_FILTER_BIT_AND:
+		--sp;
+		sp[-1] &= *sp;
+		break;
+	    case SAM_FILTER_BIT_OR:
+		--sp;
+		sp[-1] |= *sp;
+		break;
+	    case SAM_FILTER_EQ:
+		--sp;
+		sp[-1] = sp[-1] == *sp;
+		break;
+	    case SAM_FILTER_NE:
+		--sp;
+		sp[-1] = sp[-1] != *sp;
+		break;
+	    case SAM_FILTER_LT:
+		--sp;
+		sp[-1] = sp[-1] < *sp;
+		break;
+	    case SAM_FILTER_LE:
+		--sp;
+		sp[-1] = sp[-1] <= *sp;
+		break;
+	    case SAM_FILTER_GT:
+		--sp;
+		sp[-1] = sp[-1] > *sp;
+		break;
+	    case SAM_FILTER_GE:
+		--sp;
+		sp[-1] = sp[-1] >= *sp;
+		break;
+	    case SAM_FILTER_AND:
+		--sp;
+		sp[-1] = sp[-1] && *sp;
+		break;
+	    case SAM_FILTER_OR:
+		--sp;
+		sp[-1] = sp[-1] || *sp;
+		break;
+	}
+    }
+    return stack[0] != 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-filter.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory allocated by bl_sam_filter_compile(3).
+ *
+ *  Arguments:
+ *      filter: Pointer to a compiled filter
+ *
+ *  See also:
+ *      bl_sam_filter_compile(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_filter_free(bl_sam_filter_t *filter)
+
+{
+    size_t  c;
+
+    for (c = 0; c < filter->string_count; ++c)
+	free(filter->strings[c]);
+    free(filter->strings);
+    free(filter->sets);
+    free(filter->ops);
+    filter->strings = NULL;
+    filter->sets = NULL;
+    filter->ops = NULL;
+    filter->string_count = filter->string_max = 0;
+    filter->set_count = filter->set_max = 0;
+    filter->op_count = filter->op_max = 0;
+}
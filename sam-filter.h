@@ -0,0 +1,55 @@
+#ifndef _sam_filter_h_
+#define _sam_filter_h_
+
+#ifndef _sam_h_
+#include "sam.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+#define BL_SAM_FILTER_STACK_MAX 64      // Deepest expression nesting
+
+typedef struct
+{
+    int         opcode;
+    int64_t     value;      // Constant, or index into sets
+}   bl_sam_filter_op_t;
+
+// Sorted range of strings for rname/rnext/qname == and in
+typedef struct
+{
+    size_t      first;
+    size_t      count;
+}   bl_sam_filter_set_t;
+
+/*
+ *  An expression compiled by bl_sam_filter_compile() into a postfix
+ *  (RPN) program.  Evaluation needs only a small stack on the caller's
+ *  stack, so one filter may be shared by readers in several threads.
+ */
+typedef struct bl_sam_filter
+{
+    bl_sam_filter_op_t  *ops;
+    size_t              op_count;
+    size_t              op_max;
+    char                **strings;
+    size_t              string_count;
+    size_t              string_max;
+    bl_sam_filter_set_t *sets;
+    size_t              set_count;
+    size_t              set_max;
+    sam_field_mask_t    field_mask;     // Fields the expression uses
+}   bl_sam_filter_t;
+
+/* Not generated by gen-get-set */
+#define BL_SAM_FILTER_FIELD_MASK(ptr)   ((ptr)->field_mask)
+#define BL_SAM_FILTER_OP_COUNT(ptr)     ((ptr)->op_count)
+
+/* sam-filter.c */
+int bl_sam_filter_compile(bl_sam_filter_t *filter, const char *expr);
+bool bl_sam_filter_eval(bl_sam_filter_t *filter, bl_sam_t *sam_alignment);
+void bl_sam_filter_free(bl_sam_filter_t *filter);
+
+#endif  // _sam_filter_h_
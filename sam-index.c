@@ -0,0 +1,816 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-index.h"
+#include "biolibc.h"
+
+// Positions beyond 2^29 share the last bins, as with BAI
+#define SAM_INDEX_MAX_POS   ((uint64_t)1 << 29)
+#define SAM_INDEX_CLAMP(p)  ((p) > SAM_INDEX_MAX_POS ? SAM_INDEX_MAX_POS : (p))
+
+/*
+ *  Bin containing 0-based, half-open region [beg, end).  Same scheme as
+ *  the SAM specification, section 5.3.
+ */
+
+static uint32_t sam_reg2bin(uint64_t beg, uint64_t end)
+
+{
+    --end;
+    if ( beg >> 14 == end >> 14 ) return ((1 << 15) - 1) / 7 + (beg >> 14);
+    if ( beg >> 17 == end >> 17 ) return ((1 << 12) - 1) / 7 + (beg >> 17);
+    if ( beg >> 20 == end >> 20 ) return ((1 << 9) - 1) / 7 + (beg >> 20);
+    if ( beg >> 23 == end >> 23 ) return ((1 << 6) - 1) / 7 + (beg >> 23);
+    if ( beg >> 26 == end >> 26 ) return ((1 << 3) - 1) / 7 + (beg >> 26);
+    return 0;
+}
+
+
+#define SAM_INDEX_LEVELS    6
+
+/*
+ *  Bins that may contain alignments overlapping [beg, end), as one range
+ *  of consecutive bin numbers per level.  beg and end must be clamped to
+ *  SAM_INDEX_MAX_POS, so level 0 is always bin 0.
+ */
+
+static void sam_reg2bin_ranges(uint64_t beg, uint64_t end,
+			       uint32_t first[], uint32_t last[])
+
+{
+    static const uint32_t   offset[SAM_INDEX_LEVELS] =
+				{ 0, 1, 9, 73, 585, 4681 };
+    static const unsigned   shift[SAM_INDEX_LEVELS] =
+				{ 29, 26, 23, 20, 17, 14 };
+    unsigned                l;
+
+    --end;
+    for (l = 0; l < SAM_INDEX_LEVELS; ++l)
+    {
+	first[l] = offset[l] + (beg >> shift[l]);
+	last[l] = offset[l] + (end >> shift[l]);
+    }
+}
+
+
+/*
+ *  Find a bin by binary search, adding it if not present
+ */
+
+static bl_sam_bin_t *sam_index_get_bin(bl_sam_index_ref_t *ref, uint32_t bin)
+
+{
+    size_t      low = 0, high = ref->bin_count, mid;
+
+    while ( low < high )
+    {
+	mid = (low + high) / 2;
+	if ( ref->bins[mid].bin < bin )
+	    low = mid + 1;
+	else
+	    high = mid;
+    }
+    if ( (low < ref->bin_count) && (ref->bins[low].bin == bin) )
+	return &ref->bins[low];
+
+    if ( ref->bin_count == ref->bin_max )
+    {
+	ref->bin_max = ref->bin_max == 0 ? 64 : ref->bin_max * 2;
+	if ( (ref->bins = xt_realloc(ref->bins, ref->bin_max,
+		sizeof(*ref->bins))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_index_build(): Could not allocate bins.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    memmove(ref->bins + low + 1, ref->bins + low,
+	    (ref->bin_count - low) * sizeof(*ref->bins));
+    ++ref->bin_count;
+    ref->bins[low].bin = bin;
+    ref->bins[low].chunk_count = 0;
+    ref->bins[low].chunk_max = 0;
+    ref->bins[low].chunks = NULL;
+    return &ref->bins[low];
+}
+
+
+static void sam_index_add_chunk(bl_sam_bin_t *bin, uint64_t beg, uint64_t end)
+
+{
+    // Consecutive alignments in the same bin extend one chunk
+    if ( (bin->chunk_count > 0) && (bin->chunks[bin->chunk_count - 1].end == beg) )
+    {
+	bin->chunks[bin->chunk_count - 1].end = end;
+	return;
+    }
+    if ( bin->chunk_count == bin->chunk_max )
+    {
+	bin->chunk_max = bin->chunk_max == 0 ? 4 : bin->chunk_max * 2;
+	if ( (bin->chunks = xt_realloc(bin->chunks, bin->chunk_max,
+		sizeof(*bin->chunks))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_index_build(): Could not allocate chunks.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    bin->chunks[bin->chunk_count].beg = beg;
+    bin->chunks[bin->chunk_count].end = end;
+    ++bin->chunk_count;
+}
+
+
+static void sam_index_add_linear(bl_sam_index_ref_t *ref, uint64_t beg,
+				 uint64_t end, uint64_t offset)
+
+{
+    size_t  w, first = beg >> BL_SAM_INDEX_MIN_SHIFT,
+	    last = (end - 1) >> BL_SAM_INDEX_MIN_SHIFT;
+
+    if ( last >= ref->linear_count )
+    {
+	if ( (ref->linear = xt_realloc(ref->linear, last + 1,
+		sizeof(*ref->linear))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_index_build(): Could not allocate linear.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	for (w = ref->linear_count; w <= last; ++w)
+	    ref->linear[w] = UINT64_MAX;
+	ref->linear_count = last + 1;
+    }
+    for (w = first; w <= last; ++w)
+	if ( offset < ref->linear[w] )
+	    ref->linear[w] = offset;
+}
+
+
+static bl_sam_index_ref_t *sam_index_add_ref(bl_sam_index_t *index,
+					     const char *rname)
+
+{
+    bl_sam_index_ref_t  *ref;
+
+    if ( index->ref_count == index->ref_max )
+    {
+	index->ref_max = index->ref_max == 0 ? 32 : index->ref_max * 2;
+	if ( (index->refs = xt_realloc(index->refs, index->ref_max,
+		sizeof(*index->refs))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_index_build(): Could not allocate refs.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    ref = &index->refs[index->ref_count++];
+    if ( (ref->rname = strdup(rname)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_index_build(): Could not allocate rname.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    ref->bins = NULL;
+    ref->bin_count = ref->bin_max = 0;
+    ref->linear = NULL;
+    ref->linear_count = 0;
+    return ref;
+}
+
+
+static void sam_index_finish_ref(bl_sam_index_ref_t *ref)
+
+{
+    size_t      w;
+    uint64_t    previous = 0;
+
+    // Empty windows inherit the offset of the previous window
+    for (w = 0; w < ref->linear_count; ++w)
+    {
+	if ( ref->linear[w] == UINT64_MAX )
+	    ref->linear[w] = previous;
+	else
+	    previous = ref->linear[w];
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Build a positional index for a coordinate-sorted, uncompressed
+ *      SAM file, so that alignments overlapping a region can be
+ *      retrieved with bl_sam_iter_init(3) and bl_sam_iter_next(3)
+ *      without reading the whole file.  Header lines are skipped.
+ *      Indexing stops at the first unplaced alignment (RNAME "*").
+ *
+ *      The index uses the BAI binning scheme and a 16 kb linear index
+ *      holding plain byte offsets, so sam_stream must be a regular
+ *      file, not a pipe.  BGZF-compressed SAM and BAM are not
+ *      supported.  Positions beyond 2^29 share the highest bins, which
+ *      is correct but less selective.
+ *
+ *  Arguments:
+ *      index:      Pointer to a bl_sam_index_t structure, initialized
+ *                  with BL_SAM_INDEX_INIT
+ *      sam_stream: FILE stream for a regular SAM file, positioned at
+ *                  the beginning
+ *
+ *  Returns:
+ *      BL_READ_OK on success
+ *      BL_READ_TRUNCATED if a SAM record is incomplete
+ *      BL_DATA_INVALID if the input is not sorted or not seekable
+ *
+ *  Examples:
+ *      bl_sam_index_t  index = BL_SAM_INDEX_INIT;
+ *      FILE            *sam_stream, *index_stream;
+ *
+ *      sam_stream = fopen("sample.sam", "r");
+ *      bl_sam_index_build(&index, sam_stream);
+ *      index_stream = fopen("sample.sam.bli", "w");
+ *      bl_sam_index_write(&index, index_stream);
+ *
+ *  See also:
+ *      bl_sam_index_write(3), bl_sam_index_read(3), bl_sam_iter_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_index_build(bl_sam_index_t *index, FILE *sam_stream)
+
+{
+    bl_sam_reader_t     reader;
+    bl_sam_t            sam_alignment = BL_SAM_ALIGNMENT_INIT;
+    bl_sam_index_ref_t  *ref = NULL;
+    off_t               beg, end;
+    uint64_t            previous_pos = 0, ref_beg, ref_end;
+    size_t              c;
+    int                 ch, status = BL_READ_OK;
+
+    bl_sam_reader_init(&reader, sam_stream,
+		       BL_SAM_FIELD_RNAME | BL_SAM_FIELD_POS |
+		       BL_SAM_FIELD_CIGAR);
+    for (;;)
+    {
+	if ( (beg = ftello(sam_stream)) == -1 )
+	{
+	    fprintf(stderr, "bl_sam_index_build(): Input is not seekable.\n");
+	    status = BL_DATA_INVALID;
+	    break;
+	}
+	if ( (ch = getc(sam_stream)) == '@' )
+	{
+	    while ( ((ch = getc(sam_stream)) != '\n') && (ch != EOF) )
+		;
+	    continue;
+	}
+	else if ( ch == EOF )
+	    break;
+	ungetc(ch, sam_stream);
+
+	if ( (status = bl_sam_reader_read(&reader, &sam_alignment))
+		!= BL_READ_OK )
+	{
+	    if ( status == BL_READ_EOF )
+		status = BL_READ_OK;
+	    break;
+	}
+	end = ftello(sam_stream);
+
+	if ( strcmp(BL_SAM_RNAME(&sam_alignment), "*") == 0 )
+	    break;
+	if ( (ref == NULL) || (strcmp(BL_SAM_RNAME(&sam_alignment),
+				       ref->rname) != 0) )
+	{
+	    for (c = 0; c < index->ref_count; ++c)
+	    {
+		if ( strcmp(index->refs[c].rname,
+			    BL_SAM_RNAME(&sam_alignment)) == 0 )
+		{
+		    fprintf(stderr, "bl_sam_index_build(): Input is not sorted: "
+			    "%s appears more than once.\n", index->refs[c].rname);
+		    status = BL_DATA_INVALID;
+		    break;
+		}
+	    }
+	    if ( status != BL_READ_OK )
+		break;
+	    if ( ref != NULL )
+		sam_index_finish_ref(ref);
+	    ref = sam_index_add_ref(index, BL_SAM_RNAME(&sam_alignment));
+	    previous_pos = 0;
+	}
+	if ( BL_SAM_POS(&sam_alignment) < previous_pos )
+	{
+	    fprintf(stderr, "bl_sam_index_build(): Input is not sorted: "
+		    "%s %" PRIu64 " follows %" PRIu64 ".\n", ref->rname,
+		    BL_SAM_POS(&sam_alignment), previous_pos);
+	    status = BL_DATA_INVALID;
+	    break;
+	}
+	previous_pos = BL_SAM_POS(&sam_alignment);
+
+	// 0-based, half-open, at least 1 base
+	ref_beg = BL_SAM_POS(&sam_alignment) == 0 ?
+		  0 : BL_SAM_POS(&sam_alignment) - 1;
+	ref_end = BL_SAM_REF_END(&sam_alignment);
+	if ( ref_end <= ref_beg )
+	    ref_end = ref_beg + 1;
+	ref_beg = SAM_INDEX_CLAMP(ref_beg);
+	ref_end = SAM_INDEX_CLAMP(ref_end);
+	if ( ref_end <= ref_beg )
+	    ref_beg = ref_end - 1;
+
+	sam_index_add_chunk(sam_index_get_bin(ref,
+			    sam_reg2bin(ref_beg, ref_end)), beg, end);
+	sam_index_add_linear(ref, ref_beg, ref_end, beg);
+    }
+    if ( ref != NULL )
+	sam_index_finish_ref(ref);
+    bl_sam_free(&sam_alignment);
+    bl_sam_reader_close(&reader);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Save an index built by bl_sam_index_build(3) so it can be
+ *      reloaded with bl_sam_index_read(3).  The file is binary in
+ *      native byte order and is not portable between big and little
+ *      endian hosts.
+ *
+ *  Arguments:
+ *      index:          Pointer to a bl_sam_index_t structure
+ *      index_stream:   FILE stream open for writing
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE otherwise
+ *
+ *  See also:
+ *      bl_sam_index_build(3), bl_sam_index_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_index_write(bl_sam_index_t *index, FILE *index_stream)
+
+{
+    bl_sam_index_ref_t  *ref;
+    bl_sam_bin_t        *bin;
+    uint64_t            count;
+    uint32_t            len;
+    size_t              r, b;
+
+    if ( fwrite(BL_SAM_INDEX_MAGIC, 8, 1, index_stream) != 1 )
+	return BL_WRITE_FAILURE;
+    count = index->ref_count;
+    if ( fwrite(&count, sizeof(count), 1, index_stream) != 1 )
+	return BL_WRITE_FAILURE;
+    for (r = 0; r < index->ref_count; ++r)
+    {
+	ref = &index->refs[r];
+	len = strlen(ref->rname);
+	count = ref->bin_count;
+	if ( (fwrite(&len, sizeof(len), 1, index_stream) != 1) ||
+	     (fwrite(ref->rname, 1, len, index_stream) != len) ||
+	     (fwrite(&count, sizeof(count), 1, index_stream) != 1) )
+	    return BL_WRITE_FAILURE;
+	for (b = 0; b < ref->bin_count; ++b)
+	{
+	    bin = &ref->bins[b];
+	    count = bin->chunk_count;
+	    if ( (fwrite(&bin->bin, sizeof(bin->bin), 1, index_stream) != 1) ||
+		 (fwrite(&count, sizeof(count), 1, index_stream) != 1) ||
+		 (fwrite(bin->chunks, sizeof(*bin->chunks), bin->chunk_count,
+			 index_stream) != bin->chunk_count) )
+		return BL_WRITE_FAILURE;
+	}
+	count = ref->linear_count;
+	if ( (fwrite(&count, sizeof(count), 1, index_stream) != 1) ||
+	     (fwrite(ref->linear, sizeof(*ref->linear), ref->linear_count,
+		     index_stream) != ref->linear_count) )
+	    return BL_WRITE_FAILURE;
+    }
+    return BL_WRITE_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Load an index saved by bl_sam_index_write(3).
+ *
+ *  Arguments:
+ *      index:          Pointer to a bl_sam_index_t structure, initialized
+ *                      with BL_SAM_INDEX_INIT
+ *      index_stream:   FILE stream open for reading
+ *
+ *  Returns:
+ *      BL_READ_OK on success
+ *      BL_READ_MISMATCH if the stream is not a biolibc SAM index
+ *      BL_READ_TRUNCATED if the index is incomplete
+ *
+ *  Examples:
+ *      bl_sam_index_t  index = BL_SAM_INDEX_INIT;
+ *
+ *      if ( bl_sam_index_read(&index, index_stream) != BL_READ_OK )
+ *
+ *  See also:
+ *      bl_sam_index_write(3), bl_sam_iter_init(3), bl_sam_index_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_index_read(bl_sam_index_t *index, FILE *index_stream)
+
+{
+    bl_sam_index_ref_t  *ref;
+    bl_sam_bin_t        *bin;
+    char                magic[8], rname[BL_SAM_RNAME_MAX_CHARS + 1];
+    uint64_t            ref_count, count;
+    uint32_t            len;
+    size_t              r, b;
+
+    if ( (fread(magic, 8, 1, index_stream) != 1) ||
+	 (memcmp(magic, BL_SAM_INDEX_MAGIC, 8) != 0) )
+	return BL_READ_MISMATCH;
+    if ( fread(&ref_count, sizeof(ref_count), 1, index_stream) != 1 )
+	return BL_READ_TRUNCATED;
+    for (r = 0; r < ref_count; ++r)
+    {
+	if ( (fread(&len, sizeof(len), 1, index_stream) != 1) ||
+	     (len > BL_SAM_RNAME_MAX_CHARS) ||
+	     (fread(rname, 1, len, index_stream) != len) )
+	    return BL_READ_TRUNCATED;
+	rname[len] = '\0';
+	ref = sam_index_add_ref(index, rname);
+
+	if ( fread(&count, sizeof(count), 1, index_stream) != 1 )
+	    return BL_READ_TRUNCATED;
+	ref->bin_count = ref->bin_max = count;
+	if ( (ref->bins = xt_malloc(count, sizeof(*ref->bins))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_index_read(): Could not allocate bins.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	for (b = 0; b < ref->bin_count; ++b)
+	{
+	    bin = &ref->bins[b];
+	    bin->chunks = NULL;
+	    bin->chunk_count = bin->chunk_max = 0;
+	}
+	for (b = 0; b < ref->bin_count; ++b)
+	{
+	    bin = &ref->bins[b];
+	    if ( (fread(&bin->bin, sizeof(bin->bin), 1, index_stream) != 1) ||
+		 (fread(&count, sizeof(count), 1, index_stream) != 1) )
+		return BL_READ_TRUNCATED;
+	    bin->chunk_count = bin->chunk_max = count;
+	    if ( (bin->chunks = xt_malloc(count, sizeof(*bin->chunks))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_index_read(): Could not allocate chunks.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	    if ( fread(bin->chunks, sizeof(*bin->chunks), count,
+		       index_stream) != count )
+		return BL_READ_TRUNCATED;
+	}
+
+	if ( fread(&count, sizeof(count), 1, index_stream) != 1 )
+	    return BL_READ_TRUNCATED;
+	ref->linear_count = count;
+	if ( (ref->linear = xt_malloc(count, sizeof(*ref->linear))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_index_read(): Could not allocate linear.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	if ( fread(ref->linear, sizeof(*ref->linear), count,
+		   index_stream) != count )
+	    return BL_READ_TRUNCATED;
+    }
+    return BL_READ_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory allocated by a bl_sam_index_t structure.
+ *
+ *  Arguments:
+ *      index:      Pointer to a bl_sam_index_t structure
+ *
+ *  See also:
+ *      bl_sam_index_build(3), bl_sam_index_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_index_free(bl_sam_index_t *index)
+
+{
+    size_t  r, b;
+
+    for (r = 0; r < index->ref_count; ++r)
+    {
+	for (b = 0; b < index->refs[r].bin_count; ++b)
+	    free(index->refs[r].bins[b].chunks);
+	free(index->refs[r].bins);
+	free(index->refs[r].linear);
+	free(index->refs[r].rname);
+    }
+    free(index->refs);
+    index->refs = NULL;
+    index->ref_count = index->ref_max = 0;
+}
+
+
+static int  sam_chunk_cmp(const void *p1, const void *p2)
+
+{
+    const bl_sam_chunk_t    *c1 = p1, *c2 = p2;
+
+    if ( c1->beg < c2->beg )
+	return -1;
+    else if ( c1->beg > c2->beg )
+	return 1;
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Prepare to iterate over the alignments overlapping a region of
+ *      an indexed SAM file.  Candidate chunks are gathered from every
+ *      bin that may hold overlapping alignments, chunks ending before
+ *      the linear index offset of the region start are dropped, and the
+ *      rest are sorted and merged so that the file is read forward
+ *      with as few seeks as possible.
+ *
+ *      reader must be open on the same uncompressed SAM file that was
+ *      indexed, and its field mask must include BL_SAM_FIELD_RNAME,
+ *      BL_SAM_FIELD_POS, and BL_SAM_FIELD_CIGAR.
+ *
+ *  Arguments:
+ *      iter:       Pointer to a bl_sam_iter_t structure to initialize
+ *      index:      Pointer to the index for the file
+ *      reader:     Pointer to a bl_sam_reader_t for the file
+ *      rname:      Reference sequence name of the region
+ *      beg:        First position of the region, 1-based
+ *      end:        Last position of the region, inclusive
+ *
+ *  Returns:
+ *      BL_DATA_OK on success, even if no alignments overlap the region
+ *      BL_DATA_INVALID if the reader field mask is inadequate or
+ *      the region is empty
+ *
+ *  Examples:
+ *      bl_sam_iter_t   iter;
+ *
+ *      bl_sam_iter_init(&iter, &index, &reader, "chr1", 1000000, 1001000);
+ *      while ( bl_sam_iter_next(&iter, &sam_alignment) == BL_READ_OK )
+ *          ...
+ *      bl_sam_iter_free(&iter);
+ *
+ *  See also:
+ *      bl_sam_iter_next(3), bl_sam_iter_free(3), bl_sam_index_build(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_iter_init(bl_sam_iter_t *iter, bl_sam_index_t *index,
+			 bl_sam_reader_t *reader, const char *rname,
+			 uint64_t beg, uint64_t end)
+
+{
+    bl_sam_index_ref_t  *ref = NULL;
+    bl_sam_bin_t        *bin;
+    uint32_t            first[SAM_INDEX_LEVELS], last[SAM_INDEX_LEVELS];
+    uint64_t            min_offset, region_beg, region_end;
+    size_t              r, l, c, low, high, mid, merged;
+    sam_field_mask_t    needed = BL_SAM_FIELD_RNAME | BL_SAM_FIELD_POS |
+				 BL_SAM_FIELD_CIGAR;
+
+    iter->reader = reader;
+    iter->chunks = NULL;
+    iter->chunk_count = iter->current_chunk = 0;
+    strlcpy(iter->rname, rname, BL_SAM_RNAME_MAX_CHARS + 1);
+    iter->beg = beg;
+    iter->end = end;
+    iter->done = true;
+
+    if ( (BL_SAM_READER_FIELD_MASK(reader) & needed) != needed )
+    {
+	fprintf(stderr, "bl_sam_iter_init(): Reader must read RNAME, POS, and CIGAR.\n");
+	return BL_DATA_INVALID;
+    }
+    if ( (beg == 0) || (end < beg) )
+	return BL_DATA_INVALID;
+
+    for (r = 0; r < index->ref_count; ++r)
+	if ( strcmp(index->refs[r].rname, rname) == 0 )
+	    ref = &index->refs[r];
+    if ( ref == NULL )
+	return BL_DATA_OK;
+
+    region_beg = SAM_INDEX_CLAMP(beg - 1);
+    region_end = SAM_INDEX_CLAMP(end);
+    if ( region_end <= region_beg )
+	region_beg = region_end - 1;
+
+    if ( ref->linear_count == 0 )
+	min_offset = 0;
+    else if ( (region_beg >> BL_SAM_INDEX_MIN_SHIFT) < ref->linear_count )
+	min_offset = ref->linear[region_beg >> BL_SAM_INDEX_MIN_SHIFT];
+    else
+	min_offset = ref->linear[ref->linear_count - 1];
+
+    /*
+     *  ref->bins holds only bins in use, sorted by number, so find the
+     *  start of each level's range and walk forward through it rather
+     *  than looking up every bin the region could touch.
+     */
+    sam_reg2bin_ranges(region_beg, region_end, first, last);
+    for (l = 0; l < SAM_INDEX_LEVELS; ++l)
+    {
+	for (low = 0, high = ref->bin_count; low < high; )
+	{
+	    mid = (low + high) / 2;
+	    if ( ref->bins[mid].bin < first[l] )
+		low = mid + 1;
+	    else
+		high = mid;
+	}
+	for (; (low < ref->bin_count) && (ref->bins[low].bin <= last[l]); ++low)
+	{
+	    bin = &ref->bins[low];
+	    if ( (iter->chunks = xt_realloc(iter->chunks,
+		    iter->chunk_count + bin->chunk_count,
+		    sizeof(*iter->chunks))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_iter_init(): Could not allocate chunks.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	    for (c = 0; c < bin->chunk_count; ++c)
+		if ( bin->chunks[c].end > min_offset )
+		    iter->chunks[iter->chunk_count++] = bin->chunks[c];
+	}
+    }
+
+    if ( iter->chunk_count == 0 )
+	return BL_DATA_OK;
+
+    qsort(iter->chunks, iter->chunk_count, sizeof(*iter->chunks),
+	  sam_chunk_cmp);
+    for (c = 1, merged = 0; c < iter->chunk_count; ++c)
+    {
+	if ( iter->chunks[c].beg <= iter->chunks[merged].end )
+	{
+	    if ( iter->chunks[c].end > iter->chunks[merged].end )
+		iter->chunks[merged].end = iter->chunks[c].end;
+	}
+	else
+	    iter->chunks[++merged] = iter->chunks[c];
+    }
+    iter->chunk_count = merged + 1;
+
+    if ( fseeko(BL_SAM_READER_STREAM(reader), iter->chunks[0].beg,
+		SEEK_SET) != 0 )
+    {
+	fprintf(stderr, "bl_sam_iter_init(): Input is not seekable.\n");
+	return BL_DATA_INVALID;
+    }
+    iter->offset = iter->chunks[0].beg;
+    iter->done = false;
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Read the next alignment overlapping the region given to
+ *      bl_sam_iter_init(3).  Alignments in the candidate chunks that
+ *      do not overlap the region are skipped, and iteration stops at
+ *      the first alignment starting past the end of the region.
+ *      Skipped alignments are read into sam_alignment, whose SEQ and
+ *      QUAL buffers bl_sam_reader_read(3) grows to fit each record.
+ *
+ *  Arguments:
+ *      iter:           Pointer to a bl_sam_iter_t structure
+ *      sam_alignment:  Pointer to a bl_sam_t structure to receive the alignment
+ *
+ *  Returns:
+ *      BL_READ_OK if an overlapping alignment was read
+ *      BL_READ_EOF if there are no more overlapping alignments
+ *      BL_READ_TRUNCATED if a SAM record is incomplete
+ *
+ *  See also:
+ *      bl_sam_iter_init(3), bl_sam_reader_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_iter_next(bl_sam_iter_t *iter, bl_sam_t *sam_alignment)
+
+{
+    FILE            *stream = BL_SAM_READER_STREAM(iter->reader);
+    bl_sam_chunk_t  *chunk;
+    int             status;
+
+    while ( ! iter->done )
+    {
+	chunk = &iter->chunks[iter->current_chunk];
+	if ( iter->offset >= chunk->end )
+	{
+	    if ( ++iter->current_chunk == iter->chunk_count )
+		break;
+	    chunk = &iter->chunks[iter->current_chunk];
+	    if ( iter->offset < chunk->beg )
+	    {
+		if ( fseeko(stream, chunk->beg, SEEK_SET) != 0 )
+		    break;
+		iter->offset = chunk->beg;
+	    }
+	    continue;
+	}
+
+	if ( (status = bl_sam_reader_read(iter->reader, sam_alignment))
+		!= BL_READ_OK )
+	{
+	    iter->done = true;
+	    return status;
+	}
+	iter->offset = ftello(stream);
+
+	if ( (strcmp(BL_SAM_RNAME(sam_alignment), iter->rname) != 0) ||
+	     (BL_SAM_POS(sam_alignment) > iter->end) )
+	    break;
+	if ( BL_SAM_REF_END(sam_alignment) >= iter->beg )
+	    return BL_READ_OK;
+    }
+    iter->done = true;
+    return BL_READ_EOF;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-index.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free memory allocated by bl_sam_iter_init(3).  The reader and
+ *      index are not affected.
+ *
+ *  Arguments:
+ *      iter:       Pointer to a bl_sam_iter_t structure
+ *
+ *  See also:
+ *      bl_sam_iter_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_iter_free(bl_sam_iter_t *iter)
+
+{
+    free(iter->chunks);
+    iter->chunks = NULL;
+    iter->chunk_count = iter->current_chunk = 0;
+    iter->done = true;
+}
@@ -0,0 +1,86 @@
+#ifndef _sam_index_h_
+#define _sam_index_h_
+
+#ifndef _SYS_TYPES_H_
+#include <sys/types.h>  // off_t
+#endif
+
+#ifndef _sam_h_
+#include "sam.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+/*
+ *  Positional index for coordinate-sorted SAM files, using the same
+ *  hierarchical binning and 16 kb linear index as BAI, but with plain
+ *  byte offsets into an uncompressed, seekable SAM file rather than
+ *  BGZF virtual offsets.
+ */
+#define BL_SAM_INDEX_MIN_SHIFT  14      // 16 kb linear index windows
+#define BL_SAM_INDEX_DEPTH      5
+#define BL_SAM_INDEX_MAX_BIN    37450   // ((1 << 18) - 1) / 7 + 1
+#define BL_SAM_INDEX_MAGIC      "BLSAI\001\000\000"
+
+typedef struct
+{
+    uint64_t    beg;        // Byte offset of first alignment in chunk
+    uint64_t    end;        // Byte offset following last alignment
+}   bl_sam_chunk_t;
+
+typedef struct
+{
+    uint32_t        bin;
+    size_t          chunk_count;
+    size_t          chunk_max;
+    bl_sam_chunk_t  *chunks;
+}   bl_sam_bin_t;
+
+typedef struct
+{
+    char            *rname;
+    bl_sam_bin_t    *bins;          // Sorted by bin number
+    size_t          bin_count;
+    size_t          bin_max;
+    uint64_t        *linear;        // Min offset of reads in each window
+    size_t          linear_count;
+}   bl_sam_index_ref_t;
+
+typedef struct
+{
+    bl_sam_index_ref_t  *refs;
+    size_t              ref_count;
+    size_t              ref_max;
+}   bl_sam_index_t;
+
+#define BL_SAM_INDEX_INIT   { NULL, 0, 0 }
+
+typedef struct
+{
+    bl_sam_reader_t *reader;
+    bl_sam_chunk_t  *chunks;        // Sorted and merged
+    size_t          chunk_count;
+    size_t          current_chunk;
+    uint64_t        offset;         // Offset of next alignment to read
+    char            rname[BL_SAM_RNAME_MAX_CHARS + 1];
+    uint64_t        beg;            // 1-based, inclusive
+    uint64_t        end;
+    bool            done;
+}   bl_sam_iter_t;
+
+/* Not generated by gen-get-set */
+#define BL_SAM_INDEX_REF_COUNT(ptr)         ((ptr)->ref_count)
+#define BL_SAM_INDEX_REF_RNAME(ptr,c)       ((ptr)->refs[c].rname)
+
+/* sam-index.c */
+int bl_sam_index_build(bl_sam_index_t *index, FILE *sam_stream);
+int bl_sam_index_write(bl_sam_index_t *index, FILE *index_stream);
+int bl_sam_index_read(bl_sam_index_t *index, FILE *index_stream);
+void bl_sam_index_free(bl_sam_index_t *index);
+int bl_sam_iter_init(bl_sam_iter_t *iter, bl_sam_index_t *index, bl_sam_reader_t *reader, const char *rname, uint64_t beg, uint64_t end);
+int bl_sam_iter_next(bl_sam_iter_t *iter, bl_sam_t *sam_alignment);
+void bl_sam_iter_free(bl_sam_iter_t *iter);
+
+#endif  // _sam_index_h_
@@ -0,0 +1,706 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-mate.h"
+#include "biolibc.h"
+
+#define SAM_MATE_FREE       0
+#define SAM_MATE_WAITING    1
+#define SAM_MATE_ORPHANED   2
+
+#define SAM_MATE_NO_CONTIG  SIZE_MAX
+#define SAM_MATE_TABLE_START_SIZE   1024
+
+/*
+ *  FNV-1a.  QNAMEs are short and often share long prefixes, which FNV
+ *  handles well enough for a linear-probed table.
+ */
+
+static uint64_t sam_mate_hash(const char *qname)
+
+{
+    uint64_t    hash = 0xcbf29ce484222325ULL;
+
+    while ( *qname != '\0' )
+    {
+	hash ^= (unsigned char)*qname++;
+	hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+
+static void *sam_mate_grow(void *array, size_t *max, size_t size,
+			   const char *what)
+
+{
+    *max = *max == 0 ? 64 : *max * 2;
+    if ( (array = xt_realloc(array, *max, size)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_mate_push(): Could not allocate %s.\n", what);
+	exit(EX_UNAVAILABLE);
+    }
+    return array;
+}
+
+
+static size_t   sam_mate_contig(bl_sam_mate_t *cache, const char *name)
+
+{
+    size_t  c;
+
+    for (c = cache->contig_count; c-- > 0; )
+	if ( strcmp(cache->contigs[c], name) == 0 )
+	    return c;
+    if ( cache->contig_count == cache->contig_max )
+    {
+	cache->contigs = sam_mate_grow(cache->contigs, &cache->contig_max,
+				       sizeof(*cache->contigs), "contigs");
+	if ( (cache->contig_done = xt_realloc(cache->contig_done,
+		cache->contig_max, sizeof(*cache->contig_done))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_mate_push(): Could not allocate contig_done.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    if ( (cache->contigs[cache->contig_count] = strdup(name)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_mate_push(): Could not allocate contig name.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    cache->contig_done[cache->contig_count] = false;
+    return cache->contig_count++;
+}
+
+
+/*
+ *  Arena storage
+ */
+
+static char *sam_mate_alloc(bl_sam_mate_t *cache, size_t bytes,
+			    uint32_t *block_index, size_t *offset)
+
+{
+    bl_sam_mate_block_t *block;
+    size_t              b;
+
+    if ( cache->current_block != SIZE_MAX )
+    {
+	block = &cache->blocks[cache->current_block];
+	if ( block->used + bytes > block->size )
+	{
+	    // Retire the current block, to be reused when its live count hits 0
+	    if ( block->live == 0 )
+		cache->free_blocks[cache->free_block_count++] = cache->current_block;
+	    cache->current_block = SIZE_MAX;
+	}
+    }
+
+    if ( cache->current_block == SIZE_MAX )
+    {
+	if ( (cache->free_block_count > 0) &&
+	     (cache->blocks[cache->free_blocks[cache->free_block_count - 1]].size
+		>= bytes) )
+	    cache->current_block = cache->free_blocks[--cache->free_block_count];
+	else
+	{
+	    if ( cache->block_count == cache->block_max )
+	    {
+		cache->blocks = sam_mate_grow(cache->blocks, &cache->block_max,
+					      sizeof(*cache->blocks), "blocks");
+		if ( (cache->free_blocks = xt_realloc(cache->free_blocks,
+			cache->block_max, sizeof(*cache->free_blocks))) == NULL )
+		{
+		    fprintf(stderr, "bl_sam_mate_push(): Could not allocate free_blocks.\n");
+		    exit(EX_UNAVAILABLE);
+		}
+	    }
+	    b = cache->block_count++;
+	    block = &cache->blocks[b];
+	    block->size = bytes > BL_SAM_MATE_BLOCK_SIZE ?
+			  bytes : BL_SAM_MATE_BLOCK_SIZE;
+	    if ( (block->data = xt_malloc(block->size, 1)) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_mate_push(): Could not allocate block.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	    cache->current_block = b;
+	}
+	cache->blocks[cache->current_block].used = 0;
+	cache->blocks[cache->current_block].live = 0;
+    }
+
+    block = &cache->blocks[cache->current_block];
+    *block_index = cache->current_block;
+    *offset = block->used;
+    block->used += bytes;
+    ++block->live;
+    return block->data + *offset;
+}
+
+
+static void sam_mate_release_block(bl_sam_mate_t *cache, uint32_t b)
+
+{
+    bl_sam_mate_block_t *block = &cache->blocks[b];
+
+    if ( --block->live == 0 )
+    {
+	if ( b == cache->current_block )
+	    block->used = 0;
+	else
+	    cache->free_blocks[cache->free_block_count++] = b;
+    }
+}
+
+
+/*
+ *  QNAME hash table, linear probing with backward-shift deletion
+ */
+
+static void sam_mate_table_insert(bl_sam_mate_t *cache, size_t e)
+
+{
+    size_t  mask = cache->table_size - 1, slot;
+
+    for (slot = cache->entries[e].hash & mask; cache->table[slot] != 0;
+	 slot = (slot + 1) & mask)
+	;
+    cache->table[slot] = e + 1;
+}
+
+
+static void sam_mate_table_resize(bl_sam_mate_t *cache)
+
+{
+    size_t  *old_table = cache->table, old_size = cache->table_size, c;
+
+    cache->table_size *= 2;
+    if ( (cache->table = xt_malloc(cache->table_size,
+	    sizeof(*cache->table))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_mate_push(): Could not allocate table.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memset(cache->table, 0, cache->table_size * sizeof(*cache->table));
+    for (c = 0; c < old_size; ++c)
+	if ( old_table[c] != 0 )
+	    sam_mate_table_insert(cache, old_table[c] - 1);
+    free(old_table);
+}
+
+
+static void sam_mate_table_delete(bl_sam_mate_t *cache, size_t e)
+
+{
+    size_t  mask = cache->table_size - 1, slot, next, home;
+
+    for (slot = cache->entries[e].hash & mask; cache->table[slot] != e + 1;
+	 slot = (slot + 1) & mask)
+	;
+
+    // Shift back entries that probed past the vacated slot
+    for (next = (slot + 1) & mask; cache->table[next] != 0;
+	 next = (next + 1) & mask)
+    {
+	home = cache->entries[cache->table[next] - 1].hash & mask;
+	if ( ((next - home) & mask) >= ((next - slot) & mask) )
+	{
+	    cache->table[slot] = cache->table[next];
+	    slot = next;
+	}
+    }
+    cache->table[slot] = 0;
+}
+
+
+/*
+ *  Min-heap of pending reads with mates on the current contig
+ */
+
+static void sam_mate_heap_push(bl_sam_mate_t *cache, size_t e)
+
+{
+    bl_sam_mate_heap_t  item, *heap;
+    size_t              c, parent;
+
+    if ( cache->heap_count == cache->heap_max )
+	cache->heap = sam_mate_grow(cache->heap, &cache->heap_max,
+				    sizeof(*cache->heap), "heap");
+    heap = cache->heap;
+    item.mate_pos = cache->entries[e].mate_pos;
+    item.entry = e;
+    item.generation = cache->entries[e].generation;
+    for (c = cache->heap_count++; c > 0; c = parent)
+    {
+	parent = (c - 1) / 2;
+	if ( heap[parent].mate_pos <= item.mate_pos )
+	    break;
+	heap[c] = heap[parent];
+    }
+    heap[c] = item;
+}
+
+
+static void sam_mate_heap_pop(bl_sam_mate_t *cache)
+
+{
+    bl_sam_mate_heap_t  item, *heap = cache->heap;
+    size_t              c, child, count = --cache->heap_count;
+
+    item = heap[count];
+    for (c = 0; (child = 2 * c + 1) < count; c = child)
+    {
+	if ( (child + 1 < count) &&
+	     (heap[child + 1].mate_pos < heap[child].mate_pos) )
+	    ++child;
+	if ( item.mate_pos <= heap[child].mate_pos )
+	    break;
+	heap[c] = heap[child];
+    }
+    heap[c] = item;
+}
+
+
+/*
+ *  Entry management
+ */
+
+static void sam_mate_orphan(bl_sam_mate_t *cache, size_t e)
+
+{
+    sam_mate_table_delete(cache, e);
+    cache->entries[e].state = SAM_MATE_ORPHANED;
+    ++cache->entries[e].generation;
+    if ( cache->orphan_count == cache->orphan_max )
+	cache->orphans = sam_mate_grow(cache->orphans, &cache->orphan_max,
+				       sizeof(*cache->orphans), "orphans");
+    cache->orphans[cache->orphan_count++] = e;
+    --cache->pending;
+    ++cache->orphaned;
+}
+
+
+static void sam_mate_release(bl_sam_mate_t *cache, size_t e, bl_sam_t *dest)
+
+{
+    bl_sam_mate_entry_t *entry = &cache->entries[e];
+    char                *qname;
+
+    qname = cache->blocks[entry->block].data + entry->offset;
+    bl_sam_free(dest);
+    bl_sam_deserialize_mem(qname + strlen(qname) + 1, dest);
+    sam_mate_release_block(cache, entry->block);
+    entry->state = SAM_MATE_FREE;
+    ++entry->generation;
+    cache->free_entries[cache->free_entry_count++] = e;
+}
+
+
+static void sam_mate_switch_contig(bl_sam_mate_t *cache, size_t contig)
+
+{
+    size_t  e;
+
+    /*
+     *  Reads still waiting for a mate on the finished contig are orphans.
+     *  Reads waiting for a mate on the new contig, i.e. pairs that span
+     *  contigs, join the eviction heap.
+     */
+    if ( cache->current_contig != SAM_MATE_NO_CONTIG )
+	cache->contig_done[cache->current_contig] = true;
+    cache->heap_count = 0;
+    for (e = 0; e < cache->entry_count; ++e)
+    {
+	if ( cache->entries[e].state != SAM_MATE_WAITING )
+	    continue;
+	if ( cache->entries[e].mate_contig == cache->current_contig )
+	    sam_mate_orphan(cache, e);
+	else if ( cache->entries[e].mate_contig == contig )
+	    sam_mate_heap_push(cache, e);
+    }
+    cache->current_contig = contig;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-mate.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a mate-pair cache for pairing the two reads of each
+ *      fragment in a coordinate-sorted SAM stream.  Alignments are fed
+ *      to bl_sam_mate_push(3), which returns the mate when it completes
+ *      a pair and otherwise holds the alignment until its mate arrives.
+ *      Because the input is sorted, a held read whose mate position
+ *      (PNEXT) has been passed can never be paired.  Such reads are
+ *      evicted immediately and reported by bl_sam_mate_next_orphan(3),
+ *      so memory use is bounded by the number of fragments spanning the
+ *      current position rather than by the size of the input.
+ *
+ *  Arguments:
+ *      cache:  Pointer to the bl_sam_mate_t structure to initialize
+ *
+ *  Examples:
+ *      bl_sam_mate_t   cache;
+ *      bl_sam_t        sam_alignment, mate = BL_SAM_ALIGNMENT_INIT,
+ *                      orphan = BL_SAM_ALIGNMENT_INIT;
+ *
+ *      bl_sam_mate_init(&cache);
+ *      while ( bl_sam_reader_read(&reader, &sam_alignment) == BL_READ_OK )
+ *      {
+ *          if ( bl_sam_mate_push(&cache, &sam_alignment, &mate)
+ *                  == BL_SAM_MATE_PAIRED )
+ *              process_fragment(&mate, &sam_alignment);
+ *          while ( bl_sam_mate_next_orphan(&cache, &orphan) )
+ *              process_orphan(&orphan);
+ *      }
+ *      bl_sam_mate_finish(&cache);
+ *      while ( bl_sam_mate_next_orphan(&cache, &orphan) )
+ *          process_orphan(&orphan);
+ *      bl_sam_mate_free(&cache);
+ *
+ *  See also:
+ *      bl_sam_mate_push(3), bl_sam_mate_next_orphan(3),
+ *      bl_sam_mate_finish(3), bl_sam_mate_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_mate_init(bl_sam_mate_t *cache)
+
+{
+    cache->blocks = NULL;
+    cache->block_count = cache->block_max = 0;
+    cache->current_block = SIZE_MAX;
+    cache->free_blocks = NULL;
+    cache->free_block_count = 0;
+
+    cache->entries = NULL;
+    cache->entry_count = cache->entry_max = 0;
+    cache->free_entries = NULL;
+    cache->free_entry_count = 0;
+
+    cache->table_size = SAM_MATE_TABLE_START_SIZE;
+    if ( (cache->table = xt_malloc(cache->table_size,
+	    sizeof(*cache->table))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_mate_init(): Could not allocate table.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    memset(cache->table, 0, cache->table_size * sizeof(*cache->table));
+
+    cache->heap = NULL;
+    cache->heap_count = cache->heap_max = 0;
+    cache->contigs = NULL;
+    cache->contig_done = NULL;
+    cache->contig_count = cache->contig_max = 0;
+    cache->current_contig = SAM_MATE_NO_CONTIG;
+    cache->orphans = NULL;
+    cache->orphan_count = cache->orphan_max = cache->orphan_next = 0;
+
+    cache->pairs = cache->orphaned = 0;
+    cache->pending = cache->max_pending = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-mate.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Add the next alignment from a coordinate-sorted stream to a
+ *      mate-pair cache.  Mates are matched by QNAME and by each read's
+ *      RNAME/POS agreeing with the other's RNEXT/PNEXT, so that
+ *      secondary placements are not mistaken for mates.  Unpaired,
+ *      secondary, and supplementary alignments are skipped.
+ *
+ *      If the alignment completes a pair, the held mate, which is
+ *      always the one that came first in the stream, is stored in mate
+ *      and the alignment itself is not held.  mate must be initialized
+ *      with BL_SAM_ALIGNMENT_INIT or bl_sam_init(3), and any memory it
+ *      holds is freed first.
+ *
+ *      If the mate could still arrive, the alignment is copied into
+ *      the cache in compact form.  Held reads whose mate position has
+ *      been passed, or whose mate contig has ended, are queued for
+ *      bl_sam_mate_next_orphan(3), which should be called after each
+ *      push to keep memory use low.
+ *
+ *  Arguments:
+ *      cache:          Pointer to an initialized bl_sam_mate_t structure
+ *      sam_alignment:  Pointer to the next alignment in the stream
+ *      mate:           Pointer to a bl_sam_t structure to receive the mate
+ *
+ *  Returns:
+ *      BL_SAM_MATE_PAIRED if the mate was found and stored in mate
+ *      BL_SAM_MATE_PENDING if the alignment is held for its mate
+ *      BL_SAM_MATE_ORPHAN if the mate can no longer arrive
+ *      BL_SAM_MATE_SKIPPED if the alignment is not a primary paired read
+ *
+ *  See also:
+ *      bl_sam_mate_init(3), bl_sam_mate_next_orphan(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_mate_push(bl_sam_mate_t *cache, bl_sam_t *sam_alignment,
+			 bl_sam_t *mate)
+
+{
+    bl_sam_mate_entry_t *entry;
+    bl_sam_mate_heap_t  *top;
+    uint64_t            hash;
+    size_t              contig, mate_contig, mask, slot, e, qname_len, bytes;
+    uint32_t            block;
+    size_t              offset;
+    char                *p;
+
+    if ( ! (BL_SAM_FLAG(sam_alignment) & BAM_FPAIRED) ||
+	 (BL_SAM_FLAG(sam_alignment) & (BAM_FSECONDARY | BAM_FSUPPLEMENTARY)) )
+	return BL_SAM_MATE_SKIPPED;
+
+    if ( (cache->current_contig == SAM_MATE_NO_CONTIG) ||
+	 (strcmp(BL_SAM_RNAME(sam_alignment),
+		 cache->contigs[cache->current_contig]) != 0) )
+	sam_mate_switch_contig(cache,
+			       sam_mate_contig(cache, BL_SAM_RNAME(sam_alignment)));
+    contig = cache->current_contig;
+
+    // Evict reads whose mate position has been passed
+    while ( (cache->heap_count > 0) &&
+	    (cache->heap[0].mate_pos < BL_SAM_POS(sam_alignment)) )
+    {
+	top = &cache->heap[0];
+	e = top->entry;
+	if ( (cache->entries[e].state == SAM_MATE_WAITING) &&
+	     (cache->entries[e].generation == top->generation) )
+	    sam_mate_orphan(cache, e);
+	sam_mate_heap_pop(cache);
+    }
+
+    if ( strcmp(BL_SAM_RNEXT(sam_alignment), "*") == 0 )
+    {
+	++cache->orphaned;
+	return BL_SAM_MATE_ORPHAN;
+    }
+    if ( (strcmp(BL_SAM_RNEXT(sam_alignment), "=") == 0) ||
+	 (strcmp(BL_SAM_RNEXT(sam_alignment), BL_SAM_RNAME(sam_alignment)) == 0) )
+	mate_contig = contig;
+    else
+	mate_contig = sam_mate_contig(cache, BL_SAM_RNEXT(sam_alignment));
+
+    // Look for the mate among held reads
+    hash = sam_mate_hash(BL_SAM_QNAME(sam_alignment));
+    mask = cache->table_size - 1;
+    for (slot = hash & mask; cache->table[slot] != 0; slot = (slot + 1) & mask)
+    {
+	e = cache->table[slot] - 1;
+	entry = &cache->entries[e];
+	if ( (entry->hash == hash) && (entry->mate_contig == contig) &&
+	     (entry->mate_pos == BL_SAM_POS(sam_alignment)) &&
+	     (entry->contig == mate_contig) &&
+	     (entry->pos == BL_SAM_PNEXT(sam_alignment)) &&
+	     (strcmp(cache->blocks[entry->block].data + entry->offset,
+		     BL_SAM_QNAME(sam_alignment)) == 0) )
+	{
+	    sam_mate_table_delete(cache, e);
+	    sam_mate_release(cache, e, mate);
+	    --cache->pending;
+	    ++cache->pairs;
+	    return BL_SAM_MATE_PAIRED;
+	}
+    }
+
+    // Mate already passed or on a finished contig
+    if ( ((mate_contig == contig) &&
+	  (BL_SAM_PNEXT(sam_alignment) < BL_SAM_POS(sam_alignment))) ||
+	 cache->contig_done[mate_contig] )
+    {
+	++cache->orphaned;
+	return BL_SAM_MATE_ORPHAN;
+    }
+
+    // Hold it
+    if ( cache->free_entry_count > 0 )
+	e = cache->free_entries[--cache->free_entry_count];
+    else
+    {
+	if ( cache->entry_count == cache->entry_max )
+	{
+	    cache->entries = sam_mate_grow(cache->entries, &cache->entry_max,
+					   sizeof(*cache->entries), "entries");
+	    if ( (cache->free_entries = xt_realloc(cache->free_entries,
+		    cache->entry_max, sizeof(*cache->free_entries))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_mate_push(): Could not allocate free_entries.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	}
+	e = cache->entry_count++;
+	cache->entries[e].generation = 0;
+    }
+    entry = &cache->entries[e];
+    entry->hash = hash;
+    entry->pos = BL_SAM_POS(sam_alignment);
+    entry->mate_pos = BL_SAM_PNEXT(sam_alignment);
+    entry->contig = contig;
+    entry->mate_contig = mate_contig;
+    entry->state = SAM_MATE_WAITING;
+
+    qname_len = strlen(BL_SAM_QNAME(sam_alignment)) + 1;
+    bytes = qname_len + bl_sam_serialized_size(sam_alignment);
+    p = sam_mate_alloc(cache, bytes, &block, &offset);
+    entry->block = block;
+    entry->offset = offset;
+    memcpy(p, BL_SAM_QNAME(sam_alignment), qname_len);
+    bl_sam_serialize_mem(p + qname_len, sam_alignment);
+
+    if ( 2 * (cache->pending + 1) > cache->table_size )
+	sam_mate_table_resize(cache);
+    sam_mate_table_insert(cache, e);
+    if ( mate_contig == contig )
+	sam_mate_heap_push(cache, e);
+    if ( ++cache->pending > cache->max_pending )
+	cache->max_pending = cache->pending;
+    return BL_SAM_MATE_PENDING;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-mate.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Mark the end of the input stream.  All reads still held are
+ *      queued as orphans for bl_sam_mate_next_orphan(3).
+ *
+ *  Arguments:
+ *      cache:  Pointer to an initialized bl_sam_mate_t structure
+ *
+ *  See also:
+ *      bl_sam_mate_push(3), bl_sam_mate_next_orphan(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_mate_finish(bl_sam_mate_t *cache)
+
+{
+    size_t  e;
+
+    for (e = 0; e < cache->entry_count; ++e)
+	if ( cache->entries[e].state == SAM_MATE_WAITING )
+	    sam_mate_orphan(cache, e);
+    cache->heap_count = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-mate.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Retrieve the next held read whose mate can no longer arrive,
+ *      either because the stream has passed the mate position or
+ *      because bl_sam_mate_finish(3) was called.  The read is removed
+ *      from the cache.  orphan must be initialized with
+ *      BL_SAM_ALIGNMENT_INIT or bl_sam_init(3), and any memory it holds
+ *      is freed first.
+ *
+ *  Arguments:
+ *      cache:  Pointer to an initialized bl_sam_mate_t structure
+ *      orphan: Pointer to a bl_sam_t structure to receive the read
+ *
+ *  Returns:
+ *      true if an orphan was stored in orphan, false if there are none
+ *
+ *  See also:
+ *      bl_sam_mate_push(3), bl_sam_mate_finish(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    bl_sam_mate_next_orphan(bl_sam_mate_t *cache, bl_sam_t *orphan)
+
+{
+    if ( cache->orphan_next == cache->orphan_count )
+    {
+	cache->orphan_next = cache->orphan_count = 0;
+	return false;
+    }
+    sam_mate_release(cache, cache->orphans[cache->orphan_next++], orphan);
+    return true;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-mate.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Free all memory allocated by a mate-pair cache.  Held reads and
+ *      unretrieved orphans are discarded.  Statistics are left intact.
+ *
+ *  Arguments:
+ *      cache:  Pointer to an initialized bl_sam_mate_t structure
+ *
+ *  See also:
+ *      bl_sam_mate_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_mate_free(bl_sam_mate_t *cache)
+
+{
+    size_t  c;
+
+    for (c = 0; c < cache->block_count; ++c)
+	free(cache->blocks[c].data);
+    free(cache->blocks);
+    free(cache->free_blocks);
+    free(cache->entries);
+    free(cache->free_entries);
+    free(cache->table);
+    free(cache->heap);
+    for (c = 0; c < cache->contig_count; ++c)
+	free(cache->contigs[c]);
+    free(cache->contigs);
+    free(cache->contig_done);
+    free(cache->orphans);
+
+    cache->blocks = NULL;
+    cache->free_blocks = NULL;
+    cache->entries = NULL;
+    cache->free_entries = NULL;
+    cache->table = NULL;
+    cache->heap = NULL;
+    cache->contigs = NULL;
+    cache->contig_done = NULL;
+    cache->orphans = NULL;
+    cache->block_count = cache->block_max = cache->free_block_count = 0;
+    cache->entry_count = cache->entry_max = cache->free_entry_count = 0;
+    cache->table_size = cache->heap_count = cache->heap_max = 0;
+    cache->contig_count = cache->contig_max = 0;
+    cache->orphan_count = cache->orphan_max = cache->orphan_next = 0;
+    cache->current_block = SIZE_MAX;
+    cache->current_contig = SAM_MATE_NO_CONTIG;
+}
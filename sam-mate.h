@@ -0,0 +1,107 @@
+#ifndef _sam_mate_h_
+#define _sam_mate_h_
+
+#ifndef _sam_h_
+#include "sam.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+// Return values for bl_sam_mate_push()
+#define BL_SAM_MATE_PAIRED      0   // Mate returned
+#define BL_SAM_MATE_PENDING     1   // Held until the mate arrives
+#define BL_SAM_MATE_ORPHAN      2   // Mate cannot arrive, alignment not held
+#define BL_SAM_MATE_SKIPPED     3   // Unpaired, secondary, or supplementary
+
+#define BL_SAM_MATE_BLOCK_SIZE  (1024 * 1024)
+
+/*
+ *  Pending alignments are stored serialized (bl_sam_serialize_mem())
+ *  in large blocks.  A block is reused once every alignment in it has
+ *  been paired or reported as an orphan.
+ */
+typedef struct
+{
+    char        *data;
+    size_t      size;
+    size_t      used;
+    size_t      live;       // Alignments not yet released
+}   bl_sam_mate_block_t;
+
+typedef struct
+{
+    uint64_t        hash;           // Hash of QNAME
+    uint64_t        pos;
+    uint64_t        mate_pos;       // PNEXT
+    uint32_t        contig;         // Index of RNAME in contigs
+    uint32_t        mate_contig;    // Index of RNEXT in contigs
+    uint32_t        generation;     // Invalidates stale heap items
+    uint32_t        block;
+    size_t          offset;         // QNAME, '\0', serialized alignment
+    unsigned char   state;
+}   bl_sam_mate_entry_t;
+
+typedef struct
+{
+    uint64_t    mate_pos;
+    size_t      entry;
+    uint32_t    generation;
+}   bl_sam_mate_heap_t;
+
+typedef struct
+{
+    bl_sam_mate_block_t *blocks;
+    size_t              block_count;
+    size_t              block_max;
+    size_t              current_block;
+    size_t              *free_blocks;
+    size_t              free_block_count;
+
+    bl_sam_mate_entry_t *entries;
+    size_t              entry_count;
+    size_t              entry_max;
+    size_t              *free_entries;
+    size_t              free_entry_count;
+
+    size_t              *table;     // Entry index + 1, 0 if empty
+    size_t              table_size; // Power of 2
+
+    // Pending reads whose mate is on the current contig, by PNEXT
+    bl_sam_mate_heap_t  *heap;
+    size_t              heap_count;
+    size_t              heap_max;
+
+    char                **contigs;
+    bool                *contig_done;
+    size_t              contig_count;
+    size_t              contig_max;
+    size_t              current_contig;
+
+    size_t              *orphans;   // Entries to report
+    size_t              orphan_count;
+    size_t              orphan_max;
+    size_t              orphan_next;
+
+    uint64_t            pairs,
+			orphaned,
+			pending,
+			max_pending;
+}   bl_sam_mate_t;
+
+/* Not generated by gen-get-set */
+#define BL_SAM_MATE_PAIRS(ptr)          ((ptr)->pairs)
+#define BL_SAM_MATE_ORPHANED(ptr)       ((ptr)->orphaned)
+#define BL_SAM_MATE_PENDING_COUNT(ptr)  ((ptr)->pending)
+#define BL_SAM_MATE_MAX_PENDING(ptr)    ((ptr)->max_pending)
+#define BL_SAM_MATE_BLOCK_COUNT(ptr)    ((ptr)->block_count)
+
+/* sam-mate.c */
+void bl_sam_mate_init(bl_sam_mate_t *cache);
+int bl_sam_mate_push(bl_sam_mate_t *cache, bl_sam_t *sam_alignment, bl_sam_t *mate);
+void bl_sam_mate_finish(bl_sam_mate_t *cache);
+bool bl_sam_mate_next_orphan(bl_sam_mate_t *cache, bl_sam_t *orphan);
+void bl_sam_mate_free(bl_sam_mate_t *cache);
+
+#endif  // _sam_mate_h_
@@ -294,7 +294,7 @@ int     bl_sam_set_rname_cpy(bl_sam_t *bl_sam_ptr, char new_rname[], size_t arra
  *      assignment for scalar or pointer structure members.  If
  *      pos is a pointer, data previously pointed to should
  *      generally be freed before calling this function to avoid memory
- *      leaks.
+ *      leaks.  BL_SAM_REF_END() is updated to match.
  *
  *      Note that there is an equivalent macro (), which performs
  *      this function with no data verification or function call overhead.
@@ -333,6 +333,7 @@ int     bl_sam_set_pos(bl_sam_t *bl_sam_ptr, uint64_t new_pos)
     else
     {
 	bl_sam_ptr->pos = new_pos;
+	bl_sam_update_ref_end(bl_sam_ptr);
 	return BL_DATA_OK;
     }
 }
@@ -403,6 +404,8 @@ int     bl_sam_set_mapq(bl_sam_t *bl_sam_ptr, unsigned char new_mapq)
  *      Mutator for an array element of cigar member in a bl_sam_t
  *      structure. Use this function to set an element of the array
  *      cigar in a bl_sam_t variable from non-member functions.
+ *      Decoded CIGAR operations are discarded, since they no longer
+ *      match, and BL_SAM_REF_END() is recomputed from the string.
  *
  *      Note that there is an equivalent macro BL_SAM_SET_CIGAR_AE(), which performs
  *      this function with no data verification or function call overhead.
@@ -442,6 +445,9 @@ int     bl_sam_set_cigar_ae(bl_sam_t *bl_sam_ptr, size_t c, char new_cigar_eleme
     else
     {
 	bl_sam_ptr->cigar[c] = new_cigar_element;
+	// Decoded ops no longer match, rescan the string for ref_end
+	bl_sam_ptr->cigar_op_count = 0;
+	bl_sam_update_ref_end(bl_sam_ptr);
 	return BL_DATA_OK;
     }
 }
@@ -456,7 +462,8 @@ int     bl_sam_set_cigar_ae(bl_sam_t *bl_sam_ptr, size_t c, char new_cigar_eleme
  *      Mutator for cigar member in a bl_sam_t structure.
  *      Use this function to set cigar in a bl_sam_t variable
  *      from non-member functions.  This function copies the array pointed to
- *      by new_cigar to ->cigar.
+ *      by new_cigar to ->cigar.  Decoded CIGAR operations, if present,
+ *      and BL_SAM_REF_END() are updated to match.
  *
  *      Note that there is an equivalent macro BL_SAM_SET_CIGAR(), which performs
  *      this function with no data verification or function call overhead.
@@ -471,6 +478,7 @@ int     bl_sam_set_cigar_ae(bl_sam_t *bl_sam_ptr, size_t c, char new_cigar_eleme
  *  Returns:
  *      BL_DATA_OK if the new value is acceptable and assigned
  *      BL_DATA_OUT_OF_RANGE otherwise
+ *      BL_DATA_INVALID if operations were decoded and new_cigar is malformed
  *
  *  Examples:
  *      bl_sam_t        bl_sam;
@@ -497,6 +505,10 @@ int     bl_sam_set_cigar_cpy(bl_sam_t *bl_sam_ptr, char new_cigar[], size_t arra
     {
 	// FIXME: Assuming char array is a null-terminated string
 	strlcpy(bl_sam_ptr->cigar, new_cigar, array_size);
+	// Keep decoded ops, if any, and ref_end in sync with the string
+	if ( bl_sam_ptr->cigar_op_count > 0 )
+	    return bl_sam_cigar_parse(bl_sam_ptr);
+	bl_sam_update_ref_end(bl_sam_ptr);
 	return BL_DATA_OK;
     }
 }
@@ -773,6 +785,7 @@ int     bl_sam_set_seq(bl_sam_t *bl_sam_ptr, char * new_seq)
     else
     {
 	bl_sam_ptr->seq = new_seq;
+	bl_sam_ptr->seq_capacity = 0;   // Unknown
 	return BL_DATA_OK;
     }
 }
@@ -937,6 +950,7 @@ int     bl_sam_set_qual(bl_sam_t *bl_sam_ptr, char * new_qual)
     else
     {
 	bl_sam_ptr->qual = new_qual;
+	bl_sam_ptr->qual_capacity = 0;  // Unknown
 	return BL_DATA_OK;
     }
 }
@@ -1062,7 +1076,8 @@ int     bl_sam_set_qual_cpy(bl_sam_t *bl_sam_ptr, char * new_qual, size_t array_
  *      assignment for scalar or pointer structure members.  If
  *      seq_len is a pointer, data previously pointed to should
  *      generally be freed before calling this function to avoid memory
- *      leaks.
+ *      leaks.  BL_SAM_REF_END() is updated to match, since it falls back
+ *      on seq_len when there is no CIGAR.
  *
  *      Note that there is an equivalent macro (), which performs
  *      this function with no data verification or function call overhead.
@@ -1101,6 +1116,7 @@ int     bl_sam_set_seq_len(bl_sam_t *bl_sam_ptr, size_t new_seq_len)
     else
     {
 	bl_sam_ptr->seq_len = new_seq_len;
+	bl_sam_update_ref_end(bl_sam_ptr);    // Falls back on seq_len
 	return BL_DATA_OK;
     }
 }
@@ -0,0 +1,609 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam-sched.h"
+#include "biolibc.h"
+
+/*
+ *  State shared by the workers and the merging thread during one
+ *  bl_sam_sched_run().  Everything below the mutex is protected by it.
+ */
+typedef struct
+{
+    bl_sam_sched_t          *sched;
+    bl_sam_sched_work_t     work;
+    void                    *arg;
+    pthread_mutex_t         mutex;
+    pthread_cond_t          cond;
+    size_t                  next_region;
+    unsigned                active;     // Workers still running
+    bool                    stop;
+    void                    **results;
+    int                     *statuses;
+    bool                    *done;
+}   sam_sched_run_t;
+
+typedef struct
+{
+    sam_sched_run_t *run;
+    unsigned        worker;
+}   sam_sched_worker_t;
+
+static void *sam_sched_grow(void *array, size_t *max, size_t size,
+			    const char *what)
+
+{
+    *max = *max == 0 ? 64 : *max * 2;
+    if ( (array = xt_realloc(array, *max, size)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_sched_add_contig(): Could not allocate %s.\n",
+		what);
+	exit(EX_UNAVAILABLE);
+    }
+    return array;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-sched.h>
+ *      -lbiolibc -lxtend -lpthread
+ *
+ *  Description:
+ *      Initialize a scheduler for processing an indexed, coordinate-
+ *      sorted SAM file in parallel.  Work is partitioned into regions,
+ *      added with bl_sam_sched_add_contig(3) or bl_sam_sched_read_dict(3),
+ *      which bl_sam_sched_run(3) hands out to a pool of worker threads.
+ *      Each worker opens filename with its own bl_sam_reader_t and seeks
+ *      to each region using index, so the bl_sam_buff_t ordering rules
+ *      hold within every region.
+ *
+ *      BL_SAM_FIELD_RNAME, BL_SAM_FIELD_POS, and BL_SAM_FIELD_CIGAR are
+ *      added to field_mask, since the index iterator needs them.  If
+ *      flags includes BL_SAM_SCHED_OWNED, bl_sam_sched_next(3) returns
+ *      only alignments starting in the region, so that each alignment
+ *      is seen exactly once even when contigs are split.  Otherwise it
+ *      returns all alignments overlapping the region, as pileup-style
+ *      work needs.  The MAPQ minimum passed to bl_sam_buff_init(3) is 0
+ *      unless changed with BL_SAM_SCHED_SET_MAPQ_MIN().
+ *
+ *  Arguments:
+ *      sched:      Pointer to the bl_sam_sched_t structure to initialize
+ *      filename:   Uncompressed SAM file indexed by bl_sam_index_build(3)
+ *      index:      Pointer to the index for filename
+ *      field_mask: Fields to read, as for bl_sam_reader_init(3)
+ *      flags:      0 or BL_SAM_SCHED_OWNED
+ *
+ *  See also:
+ *      bl_sam_sched_add_contig(3), bl_sam_sched_read_dict(3),
+ *      bl_sam_sched_run(3), bl_sam_sched_free(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_sched_init(bl_sam_sched_t *sched, const char *filename,
+			  bl_sam_index_t *index, sam_field_mask_t field_mask,
+			  unsigned flags)
+
+{
+    if ( (sched->filename = strdup(filename)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_sched_init(): Could not allocate filename.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    sched->index = index;
+    sched->field_mask = field_mask | BL_SAM_FIELD_RNAME | BL_SAM_FIELD_POS |
+			BL_SAM_FIELD_CIGAR;
+    sched->flags = flags;
+    sched->mapq_min = 0;
+    sched->contigs = NULL;
+    sched->contig_count = sched->contig_max = 0;
+    sched->regions = NULL;
+    sched->region_count = sched->region_max = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-sched.h>
+ *      -lbiolibc -lxtend -lpthread
+ *
+ *  Description:
+ *      Add a contig to the scheduler's work list, as one region if
+ *      region_size is BL_SAM_SCHED_WHOLE_CONTIG, or as consecutive
+ *      regions of region_size bases otherwise.  Results are merged in
+ *      the order regions are added.  Contigs with no alignments cost
+ *      only an index lookup.
+ *
+ *      Splitting contigs balances the load better, e.g. chr1 is about
+ *      8% of GRCh38, limiting a per-contig run to about 12 busy threads.
+ *      Alignments overlapping a boundary are read by both regions, so
+ *      very small regions waste I/O.
+ *
+ *  Arguments:
+ *      sched:          Pointer to an initialized bl_sam_sched_t structure
+ *      rname:          Contig name, as in RNAME
+ *      length:         Contig length
+ *      region_size:    Bases per region, or BL_SAM_SCHED_WHOLE_CONTIG
+ *
+ *  Returns:
+ *      BL_DATA_OK on success, BL_DATA_INVALID if length is 0
+ *
+ *  See also:
+ *      bl_sam_sched_init(3), bl_sam_sched_read_dict(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_sched_add_contig(bl_sam_sched_t *sched, const char *rname,
+				uint64_t length, uint64_t region_size)
+
+{
+    char            *name;
+    uint64_t        beg;
+    bl_sam_region_t *region;
+
+    if ( length == 0 )
+	return BL_DATA_INVALID;
+    if ( region_size == BL_SAM_SCHED_WHOLE_CONTIG )
+	region_size = length;
+
+    if ( sched->contig_count == sched->contig_max )
+	sched->contigs = sam_sched_grow(sched->contigs, &sched->contig_max,
+					sizeof(*sched->contigs), "contigs");
+    if ( (name = strdup(rname)) == NULL )
+    {
+	fprintf(stderr, "bl_sam_sched_add_contig(): Could not allocate rname.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    sched->contigs[sched->contig_count++] = name;
+
+    for (beg = 1; beg <= length; beg += region_size)
+    {
+	if ( sched->region_count == sched->region_max )
+	    sched->regions = sam_sched_grow(sched->regions, &sched->region_max,
+					    sizeof(*sched->regions), "regions");
+	region = &sched->regions[sched->region_count++];
+	region->rname = name;
+	region->beg = beg;
+	region->end = length - beg < region_size ? length : beg + region_size - 1;
+    }
+    return BL_DATA_OK;
+}
+
+
+/*
+ *  Find "\tTAG:" in a header line and return the start of its value.
+ */
+
+static char *sam_sched_header_tag(char *line, const char *tag)
+
+{
+    char    key[5] = { '\t', tag[0], tag[1], ':', '\0' };
+
+    if ( (line = strstr(line, key)) == NULL )
+	return NULL;
+    return line + 4;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-sched.h>
+ *      -lbiolibc -lxtend -lpthread
+ *
+ *  Description:
+ *      Read the SAM header from sam_stream and add every @SQ contig to
+ *      the scheduler with bl_sam_sched_add_contig(3), in header order.
+ *      Reading stops at the first line not beginning with '@', which is
+ *      left unread.  sam_stream would normally be a separate stream on
+ *      the same file given to bl_sam_sched_init(3), positioned at the
+ *      beginning.
+ *
+ *  Arguments:
+ *      sched:          Pointer to an initialized bl_sam_sched_t structure
+ *      sam_stream:     SAM stream positioned at the start of the header
+ *      region_size:    Bases per region, or BL_SAM_SCHED_WHOLE_CONTIG
+ *
+ *  Returns:
+ *      BL_DATA_OK if at least one contig was added
+ *      BL_DATA_NOT_FOUND if the header has no @SQ lines
+ *      BL_DATA_INVALID if an @SQ line lacks a valid SN or LN
+ *
+ *  Examples:
+ *      if ( bl_sam_sched_read_dict(&sched, header_stream, 10000000)
+ *              != BL_DATA_OK )
+ *          ...
+ *
+ *  See also:
+ *      bl_sam_sched_add_contig(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_sched_read_dict(bl_sam_sched_t *sched, FILE *sam_stream,
+			       uint64_t region_size)
+
+{
+    char        *line = NULL, *sn, *ln, *end;
+    size_t      len, max = 0;
+    int         ch, status = BL_DATA_NOT_FOUND;
+    uint64_t    length;
+
+    while ( (ch = getc(sam_stream)) == '@' )
+    {
+	for (len = 0; (ch != '\n') && (ch != EOF); ch = getc(sam_stream))
+	{
+	    if ( len + 1 >= max )
+		line = sam_sched_grow(line, &max, sizeof(*line), "line");
+	    line[len++] = ch;
+	}
+	line[len] = '\0';
+	if ( strncmp(line, "@SQ\t", 4) != 0 )
+	    continue;
+
+	if ( ((sn = sam_sched_header_tag(line, "SN")) == NULL) ||
+	     ((ln = sam_sched_header_tag(line, "LN")) == NULL) )
+	{
+	    status = BL_DATA_INVALID;
+	    break;
+	}
+	length = strtoull(ln, &end, 10);
+	if ( ((*end != '\t') && (*end != '\0')) || (length == 0) )
+	{
+	    status = BL_DATA_INVALID;
+	    break;
+	}
+	sn[strcspn(sn, "\t")] = '\0';
+	bl_sam_sched_add_contig(sched, sn, length, region_size);
+	status = BL_DATA_OK;
+    }
+    if ( ch != EOF )
+	ungetc(ch, sam_stream);
+    free(line);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-sched.h>
+ *      -lbiolibc -lxtend -lpthread
+ *
+ *  Description:
+ *      Read the next alignment for the task's region into
+ *      task->sam_alignment (BL_SAM_SCHED_TASK_ALIGNMENT()).  Call this
+ *      from a work function passed to bl_sam_sched_run(3).  See
+ *      bl_sam_sched_init(3) for which alignments are returned.
+ *
+ *  Arguments:
+ *      task:   Pointer to the task passed to the work function
+ *
+ *  Returns:
+ *      BL_READ_OK if an alignment was read
+ *      BL_READ_EOF at the end of the region
+ *      Other BL_READ_* values on error
+ *
+ *  Examples:
+ *      int     count_reads(bl_sam_sched_task_t *task, void *arg)
+ *
+ *      {
+ *          uint64_t    *count = xt_malloc(1, sizeof(*count));
+ *
+ *          *count = 0;
+ *          while ( bl_sam_sched_next(task) == BL_READ_OK )
+ *              ++*count;
+ *          BL_SAM_SCHED_TASK_SET_RESULT(task, count);
+ *          return BL_DATA_OK;
+ *      }
+ *
+ *  See also:
+ *      bl_sam_sched_run(3), bl_sam_iter_next(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_sched_next(bl_sam_sched_task_t *task)
+
+{
+    int     status;
+
+    while ( (status = bl_sam_iter_next(&task->iter, &task->sam_alignment))
+	    == BL_READ_OK )
+    {
+	if ( ! (task->sched->flags & BL_SAM_SCHED_OWNED) ||
+	     (BL_SAM_POS(&task->sam_alignment) >= task->region->beg) )
+	    return BL_READ_OK;
+    }
+    return status;
+}
+
+
+/*
+ *  Worker thread: claim regions in order until none are left or
+ *  another thread has failed.
+ */
+
+static void *sam_sched_worker(void *data)
+
+{
+    sam_sched_worker_t  *worker = data;
+    sam_sched_run_t     *run = worker->run;
+    bl_sam_sched_t      *sched = run->sched;
+    bl_sam_sched_task_t task;
+    size_t              r;
+    int                 status = BL_DATA_OK;
+    bool                opened;
+
+    task.sched = sched;
+    task.worker = worker->worker;
+    if ( (opened = (bl_sam_reader_open(&task.reader, sched->filename,
+				       sched->field_mask) != NULL)) )
+	bl_sam_init(&task.sam_alignment, BL_SAM_SEQ_MAX_CHARS,
+		    sched->field_mask);
+    else
+    {
+	fprintf(stderr, "bl_sam_sched_run(): Could not open %s: %s\n",
+		sched->filename, strerror(errno));
+	status = BL_DATA_INVALID;
+    }
+
+    pthread_mutex_lock(&run->mutex);
+    while ( ! run->stop && (run->next_region < sched->region_count) )
+    {
+	if ( status != BL_DATA_OK )
+	{
+	    // Could not open: record the failure against the next region
+	    r = run->next_region++;
+	    run->statuses[r] = status;
+	    run->done[r] = true;
+	    run->stop = true;
+	    break;
+	}
+	r = run->next_region++;
+	pthread_mutex_unlock(&run->mutex);
+
+	task.region = &sched->regions[r];
+	task.region_index = r;
+	task.result = NULL;
+	status = bl_sam_iter_init(&task.iter, sched->index, &task.reader,
+				  task.region->rname, task.region->beg,
+				  task.region->end);
+	if ( status == BL_DATA_OK )
+	{
+	    bl_sam_buff_init(&task.sam_buff, sched->mapq_min);
+	    status = run->work(&task, run->arg);
+	    bl_sam_buff_free(&task.sam_buff);
+	}
+	bl_sam_iter_free(&task.iter);
+
+	pthread_mutex_lock(&run->mutex);
+	run->results[r] = task.result;
+	run->statuses[r] = status;
+	run->done[r] = true;
+	if ( status != BL_DATA_OK )
+	    run->stop = true;
+	pthread_cond_signal(&run->cond);
+    }
+    --run->active;
+    pthread_cond_signal(&run->cond);
+    pthread_mutex_unlock(&run->mutex);
+
+    if ( opened )
+    {
+	bl_sam_free(&task.sam_alignment);
+	bl_sam_reader_close(&task.reader);
+    }
+    return NULL;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-sched.h>
+ *      -lbiolibc -lxtend -lpthread
+ *
+ *  Description:
+ *      Process all regions on a pool of worker threads.  Regions are
+ *      claimed in order by idle workers.  For each region, work is called
+ *      with a task holding the worker's reader, an index iterator for
+ *      the region, a fresh bl_sam_buff_t, and a bl_sam_t to read into
+ *      with bl_sam_sched_next(3).  work may store a pointer to its
+ *      per-region result with BL_SAM_SCHED_TASK_SET_RESULT().
+ *
+ *      merge is called from the calling thread with each region's result
+ *      strictly in region order, as soon as all earlier regions have been
+ *      merged, so it can write output or accumulate totals without
+ *      locking.  merge takes ownership of the result.  Results waiting
+ *      behind a slow region are held in memory.
+ *
+ *      work and merge return BL_DATA_OK on success.  Any other value
+ *      stops the run: no new regions are started, regions after the
+ *      failure are not merged, and their results are released with
+ *      free(3), so results should be single malloc()ed blocks or NULL.
+ *
+ *      work runs concurrently in several threads, so it must not modify
+ *      arg or other shared data without its own locking.
+ *
+ *  Arguments:
+ *      sched:      Pointer to a bl_sam_sched_t with regions added
+ *      threads:    Number of worker threads, at least 1
+ *      work:       Function to process one region
+ *      merge:      Function to consume results in order, or NULL
+ *      arg:        Passed to work and merge
+ *
+ *  Returns:
+ *      BL_DATA_OK if all regions were processed and merged
+ *      The first failure status from work or merge otherwise
+ *
+ *  Examples:
+ *      int     add_count(const bl_sam_region_t *region, void *result,
+ *                        void *arg)
+ *
+ *      {
+ *          *(uint64_t *)arg += *(uint64_t *)result;
+ *          free(result);
+ *          return BL_DATA_OK;
+ *      }
+ *
+ *      uint64_t    total = 0;
+ *
+ *      bl_sam_sched_init(&sched, "sorted.sam", &index, BL_SAM_FIELD_ALL,
+ *                        BL_SAM_SCHED_OWNED);
+ *      bl_sam_sched_read_dict(&sched, header_stream, 10000000);
+ *      bl_sam_sched_run(&sched, 16, count_reads, add_count, &total);
+ *      bl_sam_sched_free(&sched);
+ *
+ *  See also:
+ *      bl_sam_sched_init(3), bl_sam_sched_next(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_sched_run(bl_sam_sched_t *sched, unsigned threads,
+			 bl_sam_sched_work_t work, bl_sam_sched_merge_t merge,
+			 void *arg)
+
+{
+    sam_sched_run_t     run;
+    sam_sched_worker_t  *workers;
+    pthread_t           *tids;
+    size_t              merged, r;
+    unsigned            t;
+    int                 status = BL_DATA_OK;
+
+    if ( threads == 0 )
+	threads = 1;
+    if ( threads > sched->region_count )
+	threads = sched->region_count == 0 ? 1 : sched->region_count;
+
+    run.sched = sched;
+    run.work = work;
+    run.arg = arg;
+    run.next_region = 0;
+    run.active = threads;
+    run.stop = false;
+    run.results = xt_malloc(sched->region_count + 1, sizeof(*run.results));
+    run.statuses = xt_malloc(sched->region_count + 1, sizeof(*run.statuses));
+    run.done = xt_malloc(sched->region_count + 1, sizeof(*run.done));
+    workers = xt_malloc(threads, sizeof(*workers));
+    tids = xt_malloc(threads, sizeof(*tids));
+    if ( (run.results == NULL) || (run.statuses == NULL) ||
+	 (run.done == NULL) || (workers == NULL) || (tids == NULL) )
+    {
+	fprintf(stderr, "bl_sam_sched_run(): Could not allocate run state.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    for (r = 0; r < sched->region_count; ++r)
+    {
+	run.results[r] = NULL;
+	run.done[r] = false;
+    }
+    pthread_mutex_init(&run.mutex, NULL);
+    pthread_cond_init(&run.cond, NULL);
+
+    for (t = 0; t < threads; ++t)
+    {
+	workers[t].run = &run;
+	workers[t].worker = t;
+	if ( pthread_create(&tids[t], NULL, sam_sched_worker, &workers[t]) != 0 )
+	{
+	    fprintf(stderr, "bl_sam_sched_run(): Could not create thread.\n");
+	    exit(EX_OSERR);
+	}
+    }
+
+    /*
+     *  Merge in region order.  A region not yet done will be finished
+     *  by its worker unless the run was stopped and all workers exited.
+     */
+    pthread_mutex_lock(&run.mutex);
+    for (merged = 0; merged < sched->region_count; ++merged)
+    {
+	while ( ! run.done[merged] && ! (run.stop && (run.active == 0)) )
+	    pthread_cond_wait(&run.cond, &run.mutex);
+	if ( ! run.done[merged] )
+	    break;
+	if ( (status = run.statuses[merged]) != BL_DATA_OK )
+	    break;
+	pthread_mutex_unlock(&run.mutex);
+	if ( merge != NULL )
+	    status = merge(&sched->regions[merged], run.results[merged], arg);
+	run.results[merged] = NULL;
+	pthread_mutex_lock(&run.mutex);
+	if ( status != BL_DATA_OK )
+	{
+	    run.stop = true;
+	    break;
+	}
+    }
+    pthread_mutex_unlock(&run.mutex);
+
+    for (t = 0; t < threads; ++t)
+	pthread_join(tids[t], NULL);
+
+    // Unmerged results after a failure
+    for (r = 0; r < sched->region_count; ++r)
+	free(run.results[r]);
+
+    pthread_cond_destroy(&run.cond);
+    pthread_mutex_destroy(&run.mutex);
+    free(run.results);
+    free(run.statuses);
+    free(run.done);
+    free(workers);
+    free(tids);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam-sched.h>
+ *      -lbiolibc -lxtend -lpthread
+ *
+ *  Description:
+ *      Free the region list and contig names of a scheduler.  The index
+ *      is not affected.
+ *
+ *  Arguments:
+ *      sched:  Pointer to an initialized bl_sam_sched_t structure
+ *
+ *  See also:
+ *      bl_sam_sched_init(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_sched_free(bl_sam_sched_t *sched)
+
+{
+    size_t  c;
+
+    for (c = 0; c < sched->contig_count; ++c)
+	free(sched->contigs[c]);
+    free(sched->contigs);
+    free(sched->regions);
+    free(sched->filename);
+    sched->contigs = NULL;
+    sched->regions = NULL;
+    sched->filename = NULL;
+    sched->contig_count = sched->contig_max = 0;
+    sched->region_count = sched->region_max = 0;
+}
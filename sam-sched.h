@@ -0,0 +1,93 @@
+#ifndef _sam_sched_h_
+#define _sam_sched_h_
+
+#ifndef _sam_h_
+#include "sam.h"
+#endif
+
+#ifndef _sam_buff_h_
+#include "sam-buff.h"
+#endif
+
+#ifndef _sam_index_h_
+#include "sam-index.h"
+#endif
+
+#ifndef _biolibc_h_
+#include "biolibc.h"
+#endif
+
+// Flags for bl_sam_sched_init()
+#define BL_SAM_SCHED_OWNED  0x1 // Only alignments starting in the region
+
+// region_size for bl_sam_sched_add_contig(): one region per contig
+#define BL_SAM_SCHED_WHOLE_CONTIG   0
+
+// One unit of work: a contig or a fixed-size piece of one
+typedef struct
+{
+    const char  *rname;     // Points into sched->contigs
+    uint64_t    beg;        // 1-based, inclusive
+    uint64_t    end;
+}   bl_sam_region_t;
+
+struct bl_sam_sched;
+
+/*
+ *  Everything a work function needs to process one region.  Each worker
+ *  thread has its own task with its own reader, so nothing here is
+ *  shared.  iter and sam_buff are set up fresh for every region.
+ */
+typedef struct
+{
+    struct bl_sam_sched     *sched;
+    const bl_sam_region_t   *region;
+    size_t                  region_index;
+    unsigned                worker;     // 0 to threads - 1
+    bl_sam_reader_t         reader;
+    bl_sam_iter_t           iter;
+    bl_sam_buff_t           sam_buff;
+    bl_sam_t                sam_alignment;  // Filled by bl_sam_sched_next()
+    void                    *result;        // Set by the work function
+}   bl_sam_sched_task_t;
+
+typedef int (*bl_sam_sched_work_t)(bl_sam_sched_task_t *task, void *arg);
+typedef int (*bl_sam_sched_merge_t)(const bl_sam_region_t *region,
+				    void *result, void *arg);
+
+typedef struct bl_sam_sched
+{
+    char                *filename;
+    bl_sam_index_t      *index;
+    sam_field_mask_t    field_mask;
+    unsigned            flags;
+    unsigned            mapq_min;   // For bl_sam_buff_init()
+
+    char                **contigs;
+    size_t              contig_count;
+    size_t              contig_max;
+    bl_sam_region_t     *regions;   // In contig dictionary order
+    size_t              region_count;
+    size_t              region_max;
+}   bl_sam_sched_t;
+
+/* Not generated by gen-get-set */
+#define BL_SAM_SCHED_REGION_COUNT(ptr)      ((ptr)->region_count)
+#define BL_SAM_SCHED_REGIONS_AE(ptr,c)      ((ptr)->regions[c])
+#define BL_SAM_SCHED_CONTIG_COUNT(ptr)      ((ptr)->contig_count)
+#define BL_SAM_SCHED_MAPQ_MIN(ptr)          ((ptr)->mapq_min)
+#define BL_SAM_SCHED_SET_MAPQ_MIN(ptr,val)  ((ptr)->mapq_min = (val))
+#define BL_SAM_SCHED_TASK_REGION(ptr)       ((ptr)->region)
+#define BL_SAM_SCHED_TASK_SAM_BUFF(ptr)     (&(ptr)->sam_buff)
+#define BL_SAM_SCHED_TASK_ALIGNMENT(ptr)    (&(ptr)->sam_alignment)
+#define BL_SAM_SCHED_TASK_SET_RESULT(ptr,val)   ((ptr)->result = (val))
+
+/* sam-sched.c */
+void bl_sam_sched_init(bl_sam_sched_t *sched, const char *filename, bl_sam_index_t *index, sam_field_mask_t field_mask, unsigned flags);
+int bl_sam_sched_add_contig(bl_sam_sched_t *sched, const char *rname, uint64_t length, uint64_t region_size);
+int bl_sam_sched_read_dict(bl_sam_sched_t *sched, FILE *sam_stream, uint64_t region_size);
+int bl_sam_sched_next(bl_sam_sched_task_t *task);
+int bl_sam_sched_run(bl_sam_sched_t *sched, unsigned threads, bl_sam_sched_work_t work, bl_sam_sched_merge_t merge, void *arg);
+void bl_sam_sched_free(bl_sam_sched_t *sched);
+
+#endif  // _sam_sched_h_
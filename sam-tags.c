@@ -0,0 +1,460 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <xtend.h>
+#include "sam.h"
+#include "biolibc.h"
+
+#define BL_SAM_TAG_INDEX_MIN_SIZE   16
+
+#define SAM_TAG_KEY(k)      (((uint16_t)(unsigned char)(k)[0] << 8) | \
+			     (unsigned char)(k)[1])
+#define SAM_TAG_HASH(key,size)  (((key) * 40503u >> 8) & ((size) - 1))
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Build a hash index of the optional fields (tags) retained by
+ *      bl_sam_read(3) with BL_SAM_FIELD_TAGS.  The index maps each
+ *      two-character key to the type and location of its value, so
+ *      that lookups take constant time regardless of the number of
+ *      tags.  The index array is reused across records.
+ *
+ *      This function is called automatically by bl_sam_tag_find(3) and
+ *      the bl_sam_get_tag_*() functions the first time a record's tags
+ *      are examined, so there is normally no need to call it directly.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_INVALID if a tag is malformed.  Tags preceding the
+ *      malformed one are still indexed.
+ *
+ *  See also:
+ *      bl_sam_tag_find(3), bl_sam_get_tag_int(3), bl_sam_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_tag_index(bl_sam_t *sam_alignment)
+
+{
+    char        *tags = sam_alignment->tags, *p, *end;
+    unsigned    fields, size, slot;
+    uint16_t    key;
+    int         status = BL_DATA_OK;
+
+    sam_alignment->tag_count = 0;
+    sam_alignment->tags_indexed = true;
+    if ( sam_alignment->tags_len == 0 )
+	return BL_DATA_OK;
+
+    // Keep the table at most half full for short probe sequences
+    for (fields = 1, p = tags; *p != '\0'; ++p)
+	if ( *p == '\t' )
+	    ++fields;
+    for (size = BL_SAM_TAG_INDEX_MIN_SIZE; size < fields * 2; size *= 2)
+	;
+    if ( size > sam_alignment->tag_index_size )
+    {
+	sam_alignment->tag_index = xt_realloc(sam_alignment->tag_index,
+				    size, sizeof(*sam_alignment->tag_index));
+	if ( sam_alignment->tag_index == NULL )
+	{
+	    fprintf(stderr, "bl_sam_tag_index(): Could not allocate tag_index.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	sam_alignment->tag_index_size = size;
+    }
+    else
+	size = sam_alignment->tag_index_size;
+    for (slot = 0; slot < size; ++slot)
+	sam_alignment->tag_index[slot].key = 0;
+
+    for (p = tags; *p != '\0'; p = end + (*end == '\t'))
+    {
+	if ( (end = strchr(p, '\t')) == NULL )
+	    end = p + strlen(p);
+	// TG:T:value
+	if ( (end - p < 5) || (p[2] != ':') || (p[4] != ':') )
+	{
+	    status = BL_DATA_INVALID;
+	    break;
+	}
+	key = SAM_TAG_KEY(p);
+	for (slot = SAM_TAG_HASH(key, size);
+	     (sam_alignment->tag_index[slot].key != 0) &&
+	     (sam_alignment->tag_index[slot].key != key);
+	     slot = (slot + 1) & (size - 1))
+	    ;
+	// Keep the first occurrence of a duplicate key
+	if ( sam_alignment->tag_index[slot].key == 0 )
+	{
+	    sam_alignment->tag_index[slot].key = key;
+	    sam_alignment->tag_index[slot].type = p[3];
+	    sam_alignment->tag_index[slot].offset = p + 5 - tags;
+	    sam_alignment->tag_index[slot].len = end - p - 5;
+	    ++sam_alignment->tag_count;
+	}
+    }
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Look up an optional field (tag) by its two-character key,
+ *      building the tag index first if necessary.  The value is
+ *      found at BL_SAM_TAGS(sam_alignment) + tag->offset and is
+ *      tag->len characters long.  It is not null-terminated.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      key:            Two-character tag, e.g. "NM"
+ *      tag:            Address of a pointer to receive the index entry
+ *
+ *  Returns:
+ *      BL_DATA_OK if the tag is present
+ *      BL_DATA_NOT_FOUND otherwise
+ *
+ *  See also:
+ *      bl_sam_tag_index(3), bl_sam_get_tag_int(3),
+ *      bl_sam_get_tag_string(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_tag_find(bl_sam_t *sam_alignment, const char *key,
+			bl_sam_tag_t **tag)
+
+{
+    unsigned    slot, size;
+    uint16_t    k = SAM_TAG_KEY(key);
+
+    if ( ! sam_alignment->tags_indexed )
+	bl_sam_tag_index(sam_alignment);
+    if ( sam_alignment->tag_count == 0 )
+	return BL_DATA_NOT_FOUND;
+
+    size = sam_alignment->tag_index_size;
+    for (slot = SAM_TAG_HASH(k, size);
+	 sam_alignment->tag_index[slot].key != 0;
+	 slot = (slot + 1) & (size - 1))
+    {
+	if ( sam_alignment->tag_index[slot].key == k )
+	{
+	    *tag = &sam_alignment->tag_index[slot];
+	    return BL_DATA_OK;
+	}
+    }
+    return BL_DATA_NOT_FOUND;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Get the value of an integer (type i) optional field, such as NM
+ *      or AS.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      key:            Two-character tag
+ *      value:          Address of variable to receive the value
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_NOT_FOUND if the tag is not present
+ *      BL_DATA_INVALID if the tag is not an integer
+ *
+ *  Examples:
+ *      bl_sam_t    sam_alignment = BL_SAM_ALIGNMENT_INIT;
+ *      int64_t     edit_distance;
+ *
+ *      bl_sam_read(stdin, &sam_alignment,
+ *                  BL_SAM_FIELD_ALL | BL_SAM_FIELD_TAGS);
+ *      if ( bl_sam_get_tag_int(&sam_alignment, "NM", &edit_distance)
+ *              == BL_DATA_OK )
+ *
+ *  See also:
+ *      bl_sam_get_tag_float(3), bl_sam_get_tag_string(3),
+ *      bl_sam_get_tag_array_int(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_get_tag_int(bl_sam_t *sam_alignment, const char *key,
+			   int64_t *value)
+
+{
+    bl_sam_tag_t    *tag;
+    char            *end;
+    int             status;
+
+    if ( (status = bl_sam_tag_find(sam_alignment, key, &tag)) != BL_DATA_OK )
+	return status;
+    if ( tag->type != 'i' )
+	return BL_DATA_INVALID;
+    *value = strtoll(sam_alignment->tags + tag->offset, &end, 10);
+    if ( end != sam_alignment->tags + tag->offset + tag->len )
+	return BL_DATA_INVALID;
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Get the value of a numeric optional field as a double.  Both
+ *      float (type f) and integer (type i) fields are accepted.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      key:            Two-character tag
+ *      value:          Address of variable to receive the value
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_NOT_FOUND if the tag is not present
+ *      BL_DATA_INVALID if the tag is not numeric
+ *
+ *  See also:
+ *      bl_sam_get_tag_int(3), bl_sam_get_tag_array_float(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_get_tag_float(bl_sam_t *sam_alignment, const char *key,
+			     double *value)
+
+{
+    bl_sam_tag_t    *tag;
+    char            *end;
+    int             status;
+
+    if ( (status = bl_sam_tag_find(sam_alignment, key, &tag)) != BL_DATA_OK )
+	return status;
+    if ( (tag->type != 'f') && (tag->type != 'i') )
+	return BL_DATA_INVALID;
+    *value = strtod(sam_alignment->tags + tag->offset, &end);
+    if ( end != sam_alignment->tags + tag->offset + tag->len )
+	return BL_DATA_INVALID;
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Get the value of a string (type Z), hex (type H), or character
+ *      (type A) optional field, such as RG or MD.  No copy is made:
+ *      value points into the tags buffer and is not null-terminated,
+ *      so use len to delimit it.  It remains valid until the next
+ *      read into sam_alignment.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      key:            Two-character tag
+ *      value:          Address of pointer to receive the start of the value
+ *      len:            Address of variable to receive the length
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_NOT_FOUND if the tag is not present
+ *      BL_DATA_INVALID if the tag is not a string
+ *
+ *  Examples:
+ *      const char  *rg;
+ *      size_t      rg_len;
+ *
+ *      if ( bl_sam_get_tag_string(&sam_alignment, "RG", &rg, &rg_len)
+ *              == BL_DATA_OK )
+ *          printf("%.*s\n", (int)rg_len, rg);
+ *
+ *  See also:
+ *      bl_sam_get_tag_int(3), bl_sam_tag_find(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_get_tag_string(bl_sam_t *sam_alignment, const char *key,
+			      const char **value, size_t *len)
+
+{
+    bl_sam_tag_t    *tag;
+    int             status;
+
+    if ( (status = bl_sam_tag_find(sam_alignment, key, &tag)) != BL_DATA_OK )
+	return status;
+    if ( (tag->type != 'Z') && (tag->type != 'H') && (tag->type != 'A') )
+	return BL_DATA_INVALID;
+    *value = sam_alignment->tags + tag->offset;
+    *len = tag->len;
+    return BL_DATA_OK;
+}
+
+
+/*
+ *  Check that tag is a B array and return a pointer to the comma
+ *  preceding the first element.
+ */
+
+static int  sam_tag_array(bl_sam_t *sam_alignment, const char *key,
+			  char *subtype, char **p)
+
+{
+    bl_sam_tag_t    *tag;
+    int             status;
+
+    if ( (status = bl_sam_tag_find(sam_alignment, key, &tag)) != BL_DATA_OK )
+	return status;
+    if ( (tag->type != 'B') || (tag->len < 1) )
+	return BL_DATA_INVALID;
+    *subtype = sam_alignment->tags[tag->offset];
+    *p = sam_alignment->tags + tag->offset + 1;
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Get the elements of an integer array (type B with subtype c, C,
+ *      s, S, i, or I) optional field.  Up to max_count elements are
+ *      stored in values.  The total number of elements is returned in
+ *      count, so a second call with a larger array can be made if
+ *      count > max_count.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      key:            Two-character tag
+ *      values:         Array to receive the elements
+ *      max_count:      Number of elements values can hold
+ *      count:          Address of variable to receive the number of elements
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_NOT_FOUND if the tag is not present
+ *      BL_DATA_INVALID if the tag is not an integer array
+ *
+ *  See also:
+ *      bl_sam_get_tag_array_float(3), bl_sam_get_tag_int(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_get_tag_array_int(bl_sam_t *sam_alignment, const char *key,
+				 int64_t values[], size_t max_count,
+				 size_t *count)
+
+{
+    char    subtype, *p, *end;
+    int64_t value;
+    int     status;
+
+    if ( (status = sam_tag_array(sam_alignment, key, &subtype, &p))
+	    != BL_DATA_OK )
+	return status;
+    if ( strchr("cCsSiI", subtype) == NULL )
+	return BL_DATA_INVALID;
+    for (*count = 0; *p == ','; p = end, ++*count)
+    {
+	value = strtoll(p + 1, &end, 10);
+	if ( end == p + 1 )
+	    return BL_DATA_INVALID;
+	if ( *count < max_count )
+	    values[*count] = value;
+    }
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Get the elements of a numeric array (type B) optional field as
+ *      doubles.  Float (subtype f) and integer subtypes are accepted.
+ *      Up to max_count elements are stored in values.  The total
+ *      number of elements is returned in count.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      key:            Two-character tag
+ *      values:         Array to receive the elements
+ *      max_count:      Number of elements values can hold
+ *      count:          Address of variable to receive the number of elements
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_NOT_FOUND if the tag is not present
+ *      BL_DATA_INVALID if the tag is not a numeric array
+ *
+ *  See also:
+ *      bl_sam_get_tag_array_int(3), bl_sam_get_tag_float(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_get_tag_array_float(bl_sam_t *sam_alignment, const char *key,
+				   double values[], size_t max_count,
+				   size_t *count)
+
+{
+    char    subtype, *p, *end;
+    double  value;
+    int     status;
+
+    if ( (status = sam_tag_array(sam_alignment, key, &subtype, &p))
+	    != BL_DATA_OK )
+	return status;
+    if ( strchr("cCsSiIf", subtype) == NULL )
+	return BL_DATA_INVALID;
+    for (*count = 0; *p == ','; p = end, ++*count)
+    {
+	value = strtod(p + 1, &end);
+	if ( end == p + 1 )
+	    return BL_DATA_INVALID;
+	if ( *count < max_count )
+	    values[*count] = value;
+    }
+    return BL_DATA_OK;
+}
@@ -2,104 +2,196 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sysexits.h>
+#include <unistd.h>     // write()
+#include <errno.h>
+#include <sys/param.h>  // MIN(), MAX()
 #include <xtend.h>      // strlcpy() on Linux
 #include "sam.h"
+#include "sam-filter.h"
 #include "biolibc.h"
+#include "biostring.h"
 
-/***************************************************************************
- *  Library:
- *      #include <biolibc/sam.h>
- *      -lbiolibc -lxtend
- *
- *  Description:
- *      Read next alignment (line) from a SAM stream.
- *
- *      If field_mask is not BL_SAM_FIELD_ALL, fields not indicated by a 1
- *      in the bit mask are discarded rather than stored in sam_alignment.
- *      That field in the structure is then populated with an appropriate
- *      marker, such as '.'.  Possible mask values are:
- *
- *      BL_SAM_FIELD_ALL
- *      BL_SAM_FIELD_QNAME
- *      BL_SAM_FIELD_FLAG
- *      BL_SAM_FIELD_RNAME
- *      BL_SAM_FIELD_POS
- *      BL_SAM_FIELD_MAPQ
- *      BL_SAM_FIELD_CIGAR
- *      BL_SAM_FIELD_RNEXT
- *      BL_SAM_FIELD_PNEXT
- *      BL_SAM_FIELD_TLEN
- *      BL_SAM_FIELD_SEQ
- *      BL_SAM_FIELD_QUAL
- *
- *  Arguments:
- *      sam_stream:     A FILE stream from which to read the line
- *      sam_alignment:  Pointer to a bl_sam_t structure
- *      field_mask:     Bit mask indicating which fields to store in sam_alignment
- *
- *  Returns:
- *      BL_READ_OK on successful read
- *      BL_READ_EOF if EOF is encountered after a complete feature
- *      BL_READ_TRUNCATED if EOF or bad data is encountered elsewhere
- *
- *  Examples:
- *      bl_sam_read(stdin, &sam_alignment, BL_SAM_FIELD_ALL);
- *      bl_sam_read(sam_stream, &sam_alignment,
- *                         BL_SAM_FIELD_QNAME|BL_SAM_FIELD_POS|BL_SAM_FIELD_TLEN);
- *
- *  See also:
- *      bl_sam_write(3)
- *
- *  History: 
- *  Date        Name        Modification
- *  2019-12-09  Jason Bacon Begin
- ***************************************************************************/
+#define BL_SAM_TAGS_START_SIZE  256
+#define BL_SAM_SEQ_START_SIZE   256
 
-int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
-			   sam_field_mask_t field_mask)
+/*
+ *  Size of a packed sequence.  NT4 exceptions start on a 4-byte boundary
+ *  following the packed bases.
+ */
+#define SAM_NT4_EXCEPTIONS_OFFSET(len)  ((BL_SEQ_NT4_BYTES(len) + 3) & ~(size_t)3)
+#define SAM_NT4_EXCEPTIONS(a) \
+	((uint32_t *)((a)->packed_seq + SAM_NT4_EXCEPTIONS_OFFSET((a)->seq_len)))
+
+/*
+ *  Fixed-size part of an alignment written by bl_sam_serialize().  Strings
+ *  and arrays follow, without null terminators.
+ */
+typedef struct
+{
+    uint64_t    pos;
+    uint64_t    pnext;
+    int64_t     tlen;
+    uint64_t    seq_len;
+    uint64_t    qual_len;
+    uint64_t    tags_len;
+    uint64_t    ref_end;
+    uint32_t    flag;
+    uint32_t    cigar_op_count;
+    uint32_t    seq_exception_count;
+    uint16_t    qname_len;
+    uint16_t    rname_len;
+    uint16_t    cigar_len;
+    uint16_t    rnext_len;
+    uint8_t     mapq;
+    uint8_t     seq_encoding;
+}   sam_serial_t;
+
+static size_t   sam_packed_seq_bytes(bl_sam_t *sam_alignment)
+
+{
+    if ( sam_alignment->seq_encoding == BL_SEQ_NT16 )
+	return BL_SEQ_NT16_BYTES(sam_alignment->seq_len);
+    else
+	return SAM_NT4_EXCEPTIONS_OFFSET(sam_alignment->seq_len) +
+	       sam_alignment->seq_exception_count * sizeof(uint32_t);
+}
+
+/*
+ *  Copy the optional fields, up to but not including the newline, into
+ *  the tags buffer, which is reused and extended across calls.
+ */
+
+static void sam_read_tags(FILE *sam_stream, bl_sam_t *sam_alignment)
+
+{
+    int     ch;
+    size_t  len = 0;
+    
+    while ( ((ch = getc(sam_stream)) != '\n') && (ch != EOF) )
+    {
+	if ( len + 1 >= sam_alignment->tags_max )
+	{
+	    sam_alignment->tags_max = sam_alignment->tags_max == 0 ?
+		BL_SAM_TAGS_START_SIZE : sam_alignment->tags_max * 2;
+	    if ( (sam_alignment->tags = xt_realloc(sam_alignment->tags,
+		    sam_alignment->tags_max, sizeof(*sam_alignment->tags))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_read(): Could not allocate tags.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	}
+	sam_alignment->tags[len++] = ch;
+    }
+    if ( sam_alignment->tags != NULL )
+	sam_alignment->tags[len] = '\0';
+    sam_alignment->tags_len = len;
+}
+
+
+/*
+ *  Read SEQ or QUAL straight into the alignment, growing the buffer as
+ *  needed.  Returns the delimiter, as tsv_read_field() does.
+ */
+
+static int  sam_read_var_field(FILE *sam_stream, char **buff,
+			       size_t *capacity, size_t *len)
+
+{
+    int     ch;
+    size_t  c = 0;
+    
+    if ( *capacity == 0 )
+    {
+	*capacity = BL_SAM_SEQ_START_SIZE;
+	if ( (*buff = xt_realloc(*buff, *capacity, sizeof(**buff))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_read(): Could not allocate seq or qual.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    while ( ((ch = getc(sam_stream)) != '\t') && (ch != '\n') && (ch != EOF) )
+    {
+	if ( c + 1 == *capacity )
+	{
+	    *capacity *= 2;
+	    if ( (*buff = xt_realloc(*buff, *capacity, sizeof(**buff))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_read(): Could not allocate seq or qual.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	}
+	(*buff)[c++] = ch;
+    }
+    (*buff)[c] = '\0';
+    *len = c;
+    return ch;
+}
+
+
+/*
+ *  Identify the record being read in an error message.  Only a reader
+ *  context knows the position of the previous alignment.
+ */
+
+static void sam_read_error_context(bl_sam_reader_t *reader,
+				   bl_sam_t *sam_alignment)
+
+{
+    fprintf(stderr, "qname = %s rname = %s\n",
+	    sam_alignment->qname, sam_alignment->rname);
+    if ( reader->alignments_read > 0 )
+	fprintf(stderr, "previous_pos = %" PRIu64 "\n", reader->previous_pos);
+}
+
+
+// sam_read_record() status for a record rejected by reader->filter
+#define SAM_READ_FILTERED   1
+
+/*
+ *  Shared by bl_sam_read() and bl_sam_reader_read().  All state lives in
+ *  reader, so this is safe to use on different streams in parallel.
+ */
+
+static int  sam_read_record(bl_sam_reader_t *reader, bl_sam_t *sam_alignment)
 
 {
     char    mapq_str[BL_SAM_MAPQ_MAX_CHARS + 1],
-	    temp_seq_or_qual[BL_SAM_SEQ_MAX_CHARS + 1],
 	    pos_str[BL_POSITION_MAX_DIGITS + 1],
 	    flag_str[BL_SAM_FLAG_MAX_DIGITS + 1],
 	    *end;
     size_t  len;
-    static size_t   previous_pos = 0;
     int     delim;
     
-    if ( field_mask & BL_SAM_FIELD_QNAME )
-	delim = tsv_read_field(sam_stream, sam_alignment->qname,
+    if ( reader->field_mask & BL_SAM_FIELD_QNAME )
+	delim = tsv_read_field(reader->stream, sam_alignment->qname,
 			BL_SAM_QNAME_MAX_CHARS, &len);
     else
     {
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
 	*sam_alignment->qname = '\0';
     }
     if ( delim == EOF )
 	return BL_READ_EOF;
 
     // 2 Flag
-    if ( field_mask & BL_SAM_FIELD_FLAG )
-	delim = tsv_read_field(sam_stream, flag_str, BL_SAM_FLAG_MAX_DIGITS, &len);
+    if ( reader->field_mask & BL_SAM_FIELD_FLAG )
+	delim = tsv_read_field(reader->stream, flag_str, BL_SAM_FLAG_MAX_DIGITS, &len);
     else
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
     if ( delim == EOF )
     {
 	fprintf(stderr, "bl_sam_read(): Got EOF reading flag: %s.\n",
 		flag_str);
 	return BL_READ_TRUNCATED;
     }
-    if ( field_mask & BL_SAM_FIELD_FLAG )
+    if ( reader->field_mask & BL_SAM_FIELD_FLAG )
     {
 	sam_alignment->flag = strtoul(flag_str, &end, 10);
 	if ( *end != '\0' )
 	{
 	    fprintf(stderr, "bl_sam_read(): Invalid position: %s\n",
 		    flag_str);
-	    fprintf(stderr, "qname = %s rname = %s\n",
-		    sam_alignment->qname, sam_alignment->rname);
-	    fprintf(stderr, "previous_pos = %zu\n", previous_pos);
+	    sam_read_error_context(reader, sam_alignment);
 	    exit(EX_DATAERR);
 	}
     }
@@ -107,12 +199,12 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
 	sam_alignment->flag = 0;    // FIXME: Is there a better choice?
     
     // 3 RNAME
-    if ( field_mask & BL_SAM_FIELD_RNAME )
-	delim = tsv_read_field(sam_stream, sam_alignment->rname,
+    if ( reader->field_mask & BL_SAM_FIELD_RNAME )
+	delim = tsv_read_field(reader->stream, sam_alignment->rname,
 			       BL_SAM_RNAME_MAX_CHARS, &len);
     else
     {
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
 	*sam_alignment->rname = '\0';
     }
     if ( delim == EOF )
@@ -123,40 +215,37 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
     }
     
     // 4 POS
-    if ( field_mask & BL_SAM_FIELD_POS )
-	delim = tsv_read_field(sam_stream, pos_str, BL_POSITION_MAX_DIGITS,
+    if ( reader->field_mask & BL_SAM_FIELD_POS )
+	delim = tsv_read_field(reader->stream, pos_str, BL_POSITION_MAX_DIGITS,
 			       &len);
     else
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
     if ( delim == EOF )
     {
 	fprintf(stderr, "bl_sam_read(): Got EOF reading pos: %s.\n",
 		pos_str);
 	return BL_READ_TRUNCATED;
     }
-    if ( field_mask & BL_SAM_FIELD_POS )
+    if ( reader->field_mask & BL_SAM_FIELD_POS )
     {
 	sam_alignment->pos = strtoul(pos_str, &end, 10);
 	if ( *end != '\0' )
 	{
 	    fprintf(stderr, "bl_sam_read(): Invalid position: %s\n",
 		    pos_str);
-	    fprintf(stderr, "qname = %s rname = %s\n",
-		    sam_alignment->qname, sam_alignment->rname);
-	    fprintf(stderr, "previous_pos = %zu\n", previous_pos);
+	    sam_read_error_context(reader, sam_alignment);
 	    exit(EX_DATAERR);
 	}
-	previous_pos = sam_alignment->pos;
     }
     else
 	sam_alignment->pos = 0;
     
     // 5 MAPQ
-    if ( field_mask & BL_SAM_FIELD_MAPQ )
-	delim = tsv_read_field(sam_stream, mapq_str, BL_SAM_MAPQ_MAX_CHARS,
+    if ( reader->field_mask & BL_SAM_FIELD_MAPQ )
+	delim = tsv_read_field(reader->stream, mapq_str, BL_SAM_MAPQ_MAX_CHARS,
 			       &len);
     else
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
     if ( delim == EOF )
     {
 	fprintf(stderr, "bl_sam_read(): Got EOF reading mapq: %s.\n",
@@ -164,16 +253,14 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
 	return BL_READ_TRUNCATED;
     }
 
-    if ( field_mask & BL_SAM_FIELD_MAPQ )
+    if ( reader->field_mask & BL_SAM_FIELD_MAPQ )
     {
 	sam_alignment->mapq = strtoul(mapq_str, &end, 10);
 	if ( *end != '\0' )
 	{
 	    fprintf(stderr, "bl_sam_read(): Invalid mapq: %s\n",
 		    mapq_str);
-	    fprintf(stderr, "qname = %s rname = %s\n",
-		    sam_alignment->qname, sam_alignment->rname);
-	    fprintf(stderr, "previous_pos = %zu\n", previous_pos);
+	    sam_read_error_context(reader, sam_alignment);
 	    exit(EX_DATAERR);
 	}
     }
@@ -181,12 +268,12 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
 	sam_alignment->mapq = 0;
     
     // 6 CIGAR
-    if ( field_mask & BL_SAM_FIELD_CIGAR )
-	delim = tsv_read_field(sam_stream, sam_alignment->cigar,
+    if ( reader->field_mask & (BL_SAM_FIELD_CIGAR | BL_SAM_FIELD_CIGAR_OPS) )
+	delim = tsv_read_field(reader->stream, sam_alignment->cigar,
 			       BL_SAM_CIGAR_MAX_CHARS, &len);
     else
     {
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
 	*sam_alignment->cigar = '\0';
     }
     if ( delim == EOF )
@@ -197,12 +284,12 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
     }
     
     // 7 RNEXT
-    if ( field_mask & BL_SAM_FIELD_RNEXT )
-	delim = tsv_read_field(sam_stream, sam_alignment->rnext,
+    if ( reader->field_mask & BL_SAM_FIELD_RNEXT )
+	delim = tsv_read_field(reader->stream, sam_alignment->rnext,
 			       BL_SAM_RNAME_MAX_CHARS, &len);
     else
     {
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
 	*sam_alignment->rnext = '\0';
     }
     if ( delim == EOF )
@@ -213,27 +300,25 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
     }
     
     // 8 PNEXT
-    if ( field_mask & BL_SAM_FIELD_PNEXT )
-	delim = tsv_read_field(sam_stream, pos_str, BL_POSITION_MAX_DIGITS,
+    if ( reader->field_mask & BL_SAM_FIELD_PNEXT )
+	delim = tsv_read_field(reader->stream, pos_str, BL_POSITION_MAX_DIGITS,
 			       &len);
     else
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
     if ( delim == EOF )
     {
 	fprintf(stderr, "bl_sam_read(): Got EOF reading pnext: %s.\n",
 		pos_str);
 	return BL_READ_TRUNCATED;
     }
-    if ( field_mask & BL_SAM_FIELD_PNEXT )
+    if ( reader->field_mask & BL_SAM_FIELD_PNEXT )
     {
 	sam_alignment->pnext = strtoul(pos_str, &end, 10);
 	if ( *end != '\0' )
 	{
 	    fprintf(stderr, "bl_sam_read(): Invalid pnext: %s\n",
 		    pos_str);
-	    fprintf(stderr, "qname = %s rname = %s\n",
-		    sam_alignment->qname, sam_alignment->rname);
-	    fprintf(stderr, "previous_pos = %zu\n", previous_pos);
+	    sam_read_error_context(reader, sam_alignment);
 	    exit(EX_DATAERR);
 	}
     }
@@ -241,95 +326,83 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
 	sam_alignment->pnext = 0;
     
     // 9 TLEN
-    if ( field_mask & BL_SAM_FIELD_TLEN )
-	delim = tsv_read_field(sam_stream, pos_str, BL_POSITION_MAX_DIGITS,
+    if ( reader->field_mask & BL_SAM_FIELD_TLEN )
+	delim = tsv_read_field(reader->stream, pos_str, BL_POSITION_MAX_DIGITS,
 			       &len);
     else
-	delim = tsv_skip_field(sam_stream);
+	delim = tsv_skip_field(reader->stream);
     if ( delim == EOF )
     {
 	fprintf(stderr, "bl_sam_read(): Got EOF reading tlen: %s.\n",
 		pos_str);
 	return BL_READ_TRUNCATED;
     }
-    if ( field_mask & BL_SAM_FIELD_TLEN )
+    if ( reader->field_mask & BL_SAM_FIELD_TLEN )
     {
 	sam_alignment->tlen = strtoul(pos_str, &end, 10);
 	if ( *end != '\0' )
 	{
 	    fprintf(stderr, "bl_sam_read(): Invalid tlen: %s\n",
 		    pos_str);
-	    fprintf(stderr, "qname = %s rname = %s\n",
-		    sam_alignment->qname, sam_alignment->rname);
-	    fprintf(stderr, "previous_pos = %zu\n", previous_pos);
+	    sam_read_error_context(reader, sam_alignment);
 	    exit(EX_DATAERR);
 	}
     }
     else
 	sam_alignment->tlen = 0;
     
-    // 10 SEQ
-    if ( field_mask & BL_SAM_FIELD_SEQ )
-	delim = tsv_read_field(sam_stream, temp_seq_or_qual, BL_SAM_SEQ_MAX_CHARS,
-			       &sam_alignment->seq_len);
-    else
+    /*
+     *  All fixed-width fields are in.  Check the filter before copying
+     *  SEQ, QUAL, and tags, which are most of the bytes in a record.
+     */
+    if ( (reader->filter != NULL) &&
+	 ! bl_sam_filter_eval(reader->filter, sam_alignment) )
     {
-	delim = tsv_skip_field(sam_stream);
-	// sam_alignment->seq = NULL;   Mem leak if allocated elsewhere
+	while ( ((delim = getc(reader->stream)) != '\n') && (delim != EOF) )
+	    ;
+	return SAM_READ_FILTERED;
     }
-    if ( delim == EOF )
+
+    /*
+     *  10 SEQ.  seq may have been allocated by bl_sam_init(), bl_sam_copy(),
+     *  or a previous read, and is grown to fit.  If the previous record
+     *  was packed, discard the packed bases so they cannot be mistaken
+     *  for this record's.
+     */
+    if ( sam_alignment->seq_encoding != BL_SEQ_ASCII )
     {
-	fprintf(stderr, "bl_sam_read(): Got EOF reading seq: %s.\n",
-		temp_seq_or_qual);
-	return BL_READ_TRUNCATED;
+	free(sam_alignment->packed_seq);
+	sam_alignment->packed_seq = NULL;
+	sam_alignment->seq_exception_count = 0;
+	sam_alignment->seq_encoding = BL_SEQ_ASCII;
     }
-
-    if ( field_mask & BL_SAM_FIELD_SEQ )
+    if ( reader->field_mask & BL_SAM_FIELD_SEQ )
+	delim = sam_read_var_field(reader->stream, &sam_alignment->seq,
+				   &sam_alignment->seq_capacity,
+				   &sam_alignment->seq_len);
+    else
+	delim = tsv_skip_field(reader->stream);
+    if ( delim == EOF )
     {
-	// May be allocated by bl_sam_init() or bl_sam_copy()
-	if ( sam_alignment->seq == NULL )
-	{
-	    if ( (sam_alignment->seq = xt_malloc(sam_alignment->seq_len + 1,
-		    sizeof(*sam_alignment->seq))) == NULL )
-	    {
-		fprintf(stderr, "bl_sam_read(): Could not allocate seq.\n");
-		exit(EX_UNAVAILABLE);
-	    }
-	}
-	memcpy(sam_alignment->seq, temp_seq_or_qual, sam_alignment->seq_len + 1);
+	fprintf(stderr, "bl_sam_read(): Got EOF reading seq.\n");
+	return BL_READ_TRUNCATED;
     }
     
     // 11 QUAL, should be last field
-    if ( field_mask & BL_SAM_FIELD_QUAL )
-	delim = tsv_read_field(sam_stream, temp_seq_or_qual, BL_SAM_SEQ_MAX_CHARS,
-			       &sam_alignment->qual_len);
+    if ( reader->field_mask & BL_SAM_FIELD_QUAL )
+	delim = sam_read_var_field(reader->stream, &sam_alignment->qual,
+				   &sam_alignment->qual_capacity,
+				   &sam_alignment->qual_len);
     else
-    {
-	delim = tsv_skip_field(sam_stream);
-	// sam_alignment->qual = NULL; Mem leak if allocated elsewhere
-    }
+	delim = tsv_skip_field(reader->stream);
     if ( delim == EOF )
     {
-	fprintf(stderr, "bl_sam_read(): Got EOF reading qual: %s.\n",
-		temp_seq_or_qual);
+	fprintf(stderr, "bl_sam_read(): Got EOF reading qual.\n");
 	return BL_READ_TRUNCATED;
     }
 
-    if ( field_mask & BL_SAM_FIELD_QUAL )
+    if ( reader->field_mask & BL_SAM_FIELD_QUAL )
     {
-	// May be allocated by bl_sam_init() or bl_sam_copy()
-	if ( sam_alignment->qual == NULL )
-	{
-	    if ( (sam_alignment->qual = xt_malloc(sam_alignment->qual_len + 1,
-		    sizeof(*sam_alignment->qual))) == NULL )
-	    {
-		fprintf(stderr, "bl_sam_read(): Could not allocate qual.\n");
-		exit(EX_UNAVAILABLE);
-	    }
-	}
-	memcpy(sam_alignment->qual, temp_seq_or_qual,
-	       sam_alignment->qual_len + 1);
-    
 	if ( (sam_alignment->qual_len != 1) &&
 	     (sam_alignment->seq_len != sam_alignment->qual_len) )
 	    fprintf(stderr, "bl_sam_read(): Warning: qual_len != seq_len for %s,%zu\n",
@@ -337,11 +410,39 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
     }
     
     // Some SRA CRAMs have 11 fields, most have 12
-    // Discard everything after the 11th
+    // Keep or discard everything after the 11th
+    sam_alignment->tags_len = 0;
+    sam_alignment->tags_indexed = false;
+    if ( sam_alignment->tags != NULL )
+	*sam_alignment->tags = '\0';
     if ( delim == '\t' )
-	while ( getc(sam_stream) != '\n' )
-	    ;
+    {
+	if ( reader->field_mask & BL_SAM_FIELD_TAGS )
+	    sam_read_tags(reader->stream, sam_alignment);
+	else
+	    while ( ((delim = getc(reader->stream)) != '\n') && (delim != EOF) )
+		;
+    }
+
+    // Decode CIGAR last, so the reference span can fall back on seq_len
+    if ( reader->field_mask & BL_SAM_FIELD_CIGAR_OPS )
+    {
+	if ( bl_sam_cigar_parse(sam_alignment) != BL_DATA_OK )
+	{
+	    fprintf(stderr, "bl_sam_read(): Invalid CIGAR: %s\n",
+		    sam_alignment->cigar);
+	    sam_read_error_context(reader, sam_alignment);
+	    exit(EX_DATAERR);
+	}
+    }
+    else
+    {
+	sam_alignment->cigar_op_count = 0;
+	bl_sam_update_ref_end(sam_alignment);
+    }
 
+    ++reader->alignments_read;
+    reader->previous_pos = sam_alignment->pos;
     /*fprintf(stderr,"bl_sam_read(): %s,%zu,%zu\n",
 	    BL_SAM_RNAME(sam_alignment), BL_SAM_POS(sam_alignment),
 	    BL_SAM_SEQ_LEN(sam_alignment));*/
@@ -350,62 +451,105 @@ int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
 }
 
 
+static int  sam_read(bl_sam_reader_t *reader, bl_sam_t *sam_alignment)
+
+{
+    int     status;
+
+    while ( (status = sam_read_record(reader, sam_alignment))
+	    == SAM_READ_FILTERED )
+	++reader->alignments_filtered;
+    return status;
+}
+
+
 /***************************************************************************
  *  Library:
  *      #include <biolibc/sam.h>
  *      -lbiolibc -lxtend
  *
  *  Description:
- *      Copy a SAM alignment as efficiently as possible, allocating memory
- *      as needed.
+ *      Read next alignment (line) from a SAM stream.
+ *
+ *      If field_mask is not BL_SAM_FIELD_ALL, fields not indicated by a 1
+ *      in the bit mask are discarded rather than stored in sam_alignment.
+ *      That field in the structure is then populated with an appropriate
+ *      marker, such as '.'.  Possible mask values are:
+ *
+ *      BL_SAM_FIELD_ALL
+ *      BL_SAM_FIELD_QNAME
+ *      BL_SAM_FIELD_FLAG
+ *      BL_SAM_FIELD_RNAME
+ *      BL_SAM_FIELD_POS
+ *      BL_SAM_FIELD_MAPQ
+ *      BL_SAM_FIELD_CIGAR
+ *      BL_SAM_FIELD_RNEXT
+ *      BL_SAM_FIELD_PNEXT
+ *      BL_SAM_FIELD_TLEN
+ *      BL_SAM_FIELD_SEQ
+ *      BL_SAM_FIELD_QUAL
+ *      BL_SAM_FIELD_CIGAR_OPS
+ *      BL_SAM_FIELD_TAGS
+ *
+ *      BL_SAM_FIELD_TAGS keeps the optional fields following QUAL as
+ *      raw text, accessible via BL_SAM_TAGS() and the bl_sam_get_tag_*()
+ *      functions.  It is not included in BL_SAM_FIELD_ALL, so that
+ *      programs not using tags do not pay for copying them.
+ *
+ *      BL_SAM_FIELD_CIGAR_OPS causes the CIGAR string to be decoded
+ *      into BAM-style packed operations by bl_sam_cigar_parse(3).  It
+ *      is not included in BL_SAM_FIELD_ALL, so that programs not using
+ *      the decoded operations do not pay for them, and an invalid CIGAR
+ *      is passed through as before.
+ *      The reference end position, BL_SAM_REF_END(), is computed from
+ *      the CIGAR whenever the CIGAR is read.
+ *
+ *      SEQ and QUAL are read directly into sam_alignment, growing its
+ *      buffers as needed, so one bl_sam_t may be reused for records of
+ *      any length.  If sam_alignment was packed by bl_sam_pack_seq(3),
+ *      the packed bases are discarded and SEQ is read as ASCII.
+ *
+ *      bl_sam_read() keeps no state between calls.  Programs reading
+ *      many alignments, or reading in threads, should use a reader
+ *      context instead.  See bl_sam_reader_read(3).
  *
  *  Arguments:
- *      dest:   Pointer to bl_sam_t structure to receive copy
- *      src:    Pointer to bl_sam_t structure to be copied
+ *      sam_stream:     A FILE stream from which to read the line
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      field_mask:     Bit mask indicating which fields to store in sam_alignment
+ *
+ *  Returns:
+ *      BL_READ_OK on successful read
+ *      BL_READ_EOF if EOF is encountered after a complete feature
+ *      BL_READ_TRUNCATED if EOF or bad data is encountered elsewhere
+ *
+ *  Examples:
+ *      bl_sam_read(stdin, &sam_alignment, BL_SAM_FIELD_ALL);
+ *      bl_sam_read(sam_stream, &sam_alignment,
+ *                         BL_SAM_FIELD_QNAME|BL_SAM_FIELD_POS|BL_SAM_FIELD_TLEN);
  *
  *  See also:
- *      bl_sam_read(3), bl_sam_init(3), bl_sam_free(3)
+ *      bl_sam_write(3), bl_sam_cigar_parse(3), bl_sam_reader_read(3)
  *
  *  History: 
  *  Date        Name        Modification
- *  2020-05-27  Jason Bacon Begin
+ *  2019-12-09  Jason Bacon Begin
  ***************************************************************************/
 
-void    bl_sam_copy(bl_sam_t *dest, bl_sam_t *src)
+int     bl_sam_read(FILE *sam_stream, bl_sam_t *sam_alignment,
+			   sam_field_mask_t field_mask)
 
 {
-    strlcpy(dest->qname, src->qname, BL_SAM_QNAME_MAX_CHARS + 1);
-    dest->flag = src->flag;
-    strlcpy(dest->rname, src->rname, BL_SAM_RNAME_MAX_CHARS + 1);
-    dest->pos = src->pos;
-    dest->mapq = src->mapq;
-    // FIXME: Add cigar and RNEXT
-    strlcpy(dest->cigar, src->cigar, BL_SAM_CIGAR_MAX_CHARS + 1);
-    strlcpy(dest->rnext, src->rnext, BL_SAM_RNAME_MAX_CHARS + 1);
-    dest->pnext = src->pnext;
-    dest->tlen = src->tlen;
-    
-    if ( (dest->seq = xt_malloc(src->seq_len + 1,
-	    sizeof(*dest->seq))) == NULL )
-    {
-	fprintf(stderr, "bl_sam_copy(): Could not allocate seq.\n");
-	exit(EX_UNAVAILABLE);
-    }
-    memcpy(dest->seq, src->seq, src->seq_len + 1);
-    
-    if ( (dest->qual = xt_malloc(src->seq_len + 1,
-	    sizeof(*dest->qual))) == NULL )
-    {
-	fprintf(stderr, "bl_sam_copy(): Could not allocate qual.\n");
-	exit(EX_UNAVAILABLE);
-    }
-    
-    /* qual is an optional field */
-    if ( src->qual_len > 0 )
-	memcpy(dest->qual, src->qual, src->qual_len + 1);
+    bl_sam_reader_t reader;
     
-    dest->seq_len = src->seq_len;
-    dest->qual_len = src->qual_len;
+    reader.stream = sam_stream;
+    reader.owns_stream = false;
+    reader.field_mask = field_mask;
+    reader.previous_pos = 0;
+    reader.alignments_read = 0;
+    reader.filter = NULL;
+    reader.alignments_filtered = 0;
+    return sam_read(&reader, sam_alignment);
 }
 
 
@@ -415,28 +559,42 @@ void    bl_sam_copy(bl_sam_t *dest, bl_sam_t *src)
  *      -lbiolibc -lxtend
  *
  *  Description:
- *      Free memory allocated by bl_sam_read() or
- *      bl_sam_init().
+ *      Initialize a SAM reader context for an open stream, such as
+ *      stdin or a pipe.  The reader holds all state used while parsing,
+ *      so separate readers may be used in parallel threads.  The stream
+ *      is not closed by bl_sam_reader_close(3).
+ *
+ *      See bl_sam_read(3) for field_mask values.
  *
  *  Arguments:
- *      sam_alignment:  Pointer to bl_sam_t structure to be freed.
+ *      reader:         Pointer to the bl_sam_reader_t structure to initialize
+ *      sam_stream:     Open FILE stream positioned at the first alignment
+ *      field_mask:     Bit mask indicating which fields to store
+ *
+ *  Examples:
+ *      bl_sam_reader_t reader;
+ *
+ *      bl_sam_reader_init(&reader, stdin, BL_SAM_FIELD_ALL);
  *
  *  See also:
- *      bl_sam_read(3), bl_sam_init(3), bl_sam_copy(3)
+ *      bl_sam_reader_open(3), bl_sam_reader_read(3), bl_sam_reader_close(3)
  *
  *  History: 
  *  Date        Name        Modification
- *  2020-05-29  Jason Bacon Begin
+ *  2026-10-18  Jason Bacon Begin
  ***************************************************************************/
 
-void    bl_sam_free(bl_sam_t *sam_alignment)
+void    bl_sam_reader_init(bl_sam_reader_t *reader, FILE *sam_stream,
+			   sam_field_mask_t field_mask)
 
 {
-    if ( sam_alignment->seq != NULL )
-	free(sam_alignment->seq);
-    if ( sam_alignment->qual != NULL )
-	free(sam_alignment->qual);
-    // FIXME: Cigar and rnext?
+    reader->stream = sam_stream;
+    reader->owns_stream = false;
+    reader->field_mask = field_mask;
+    reader->previous_pos = 0;
+    reader->alignments_read = 0;
+    reader->filter = NULL;
+    reader->alignments_filtered = 0;
 }
 
 
@@ -446,66 +604,306 @@ void    bl_sam_free(bl_sam_t *sam_alignment)
  *      -lbiolibc -lxtend
  *
  *  Description:
- *      Initialize a bl_sam_t structure, allocating memory for
- *      sequence and quality strings according to seq_len.  Passing a
- *      seq_len of 0 prevents memory allocation from occurring.
- *
- *      Only BL_SAM_FIELD_SEQ and BL_SAM_FIELD_QUAL are meaningful bits in
- *      field_mask, as they determine whether memory is allocated.  All
- *      other fields are unconditionally initialized to 0, NULL, or blank.
+ *      Open a SAM file and initialize a reader context for it.  The
+ *      file is opened with xt_fopen(3), so compressed files are
+ *      supported, and is closed by bl_sam_reader_close(3).
  *
  *  Arguments:
- *      sam_alignment:  Pointer to bl_sam_t structure to initialize
- *      seq_len:        Length of sequence and quality strings
- *      field_mask:     Bit mask indicating which fields will be used
+ *      reader:         Pointer to the bl_sam_reader_t structure to initialize
+ *      filename:       Name of the SAM file
+ *      field_mask:     Bit mask indicating which fields to store
+ *
+ *  Returns:
+ *      The open FILE stream, or NULL if the file could not be opened
+ *
+ *  Examples:
+ *      bl_sam_reader_t reader;
+ *
+ *      if ( bl_sam_reader_open(&reader, argv[1], BL_SAM_FIELD_ALL) == NULL )
+ *      {
+ *          fprintf(stderr, "Cannot open %s.\n", argv[1]);
+ *          exit(EX_NOINPUT);
+ *      }
  *
  *  See also:
- *      bl_sam_read(3), bl_sam_free(3), bl_sam_copy(3)
+ *      bl_sam_reader_init(3), bl_sam_reader_read(3), bl_sam_reader_close(3)
  *
  *  History: 
  *  Date        Name        Modification
- *  2020-05-29  Jason Bacon Begin
+ *  2026-10-18  Jason Bacon Begin
  ***************************************************************************/
 
-void    bl_sam_init(bl_sam_t *sam_alignment, size_t seq_len,
-			   sam_field_mask_t field_mask)
+FILE    *bl_sam_reader_open(bl_sam_reader_t *reader, const char *filename,
+			    sam_field_mask_t field_mask)
 
 {
-    *sam_alignment->qname = '\0';
-    sam_alignment->flag = 0;
-    *sam_alignment->rname = '\0';
-    sam_alignment->pos = 0;
-    sam_alignment->mapq = 0;
-    *sam_alignment->cigar = '\0';
-    *sam_alignment->rnext = '\0';
-    sam_alignment->pnext = 0;
-    sam_alignment->tlen = 0;
-    if ( seq_len == 0 )
+    FILE    *sam_stream;
+    
+    if ( (sam_stream = xt_fopen(filename, "r")) == NULL )
+	return NULL;
+    bl_sam_reader_init(reader, sam_stream, field_mask);
+    reader->owns_stream = true;
+    return sam_stream;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Read the next alignment from a SAM reader context.  Behaves
+ *      exactly like bl_sam_read(3), but keeps its state in reader
+ *      rather than on the stack or in static variables, so it is safe
+ *      to read different streams in parallel threads.  The reader also
+ *      remembers the position of the previous alignment, which is
+ *      reported with parse errors.
+ *
+ *      If a filter has been attached with bl_sam_reader_set_filter(3),
+ *      records it rejects are skipped and the next accepted record is
+ *      returned.
+ *
+ *  Arguments:
+ *      reader:         Pointer to an initialized bl_sam_reader_t structure
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      BL_READ_OK on successful read
+ *      BL_READ_EOF if EOF is encountered after a complete feature
+ *      BL_READ_TRUNCATED if EOF or bad data is encountered elsewhere
+ *
+ *  Examples:
+ *      bl_sam_reader_t reader;
+ *      bl_sam_t        sam_alignment = BL_SAM_ALIGNMENT_INIT;
+ *
+ *      bl_sam_init(&sam_alignment, BL_SAM_SEQ_MAX_CHARS, BL_SAM_FIELD_ALL);
+ *      bl_sam_reader_init(&reader, stdin, BL_SAM_FIELD_ALL);
+ *      while ( bl_sam_reader_read(&reader, &sam_alignment) == BL_READ_OK )
+ *      {
+ *      }
+ *      bl_sam_reader_close(&reader);
+ *
+ *  See also:
+ *      bl_sam_read(3), bl_sam_reader_init(3), bl_sam_reader_close(3),
+ *      bl_sam_reader_set_filter(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_reader_read(bl_sam_reader_t *reader, bl_sam_t *sam_alignment)
+
+{
+    return sam_read(reader, sam_alignment);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Close the stream of a SAM reader context if it was opened by
+ *      bl_sam_reader_open(3).
+ *
+ *  Arguments:
+ *      reader:     Pointer to a bl_sam_reader_t structure
+ *
+ *  See also:
+ *      bl_sam_reader_init(3), bl_sam_reader_open(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_reader_close(bl_sam_reader_t *reader)
+
+{
+    if ( reader->owns_stream )
+	xt_fclose(reader->stream);
+    reader->stream = NULL;
+    reader->owns_stream = false;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      #include <biolibc/sam-filter.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Attach a compiled filter expression to a SAM reader context.
+ *      bl_sam_reader_read(3) evaluates the filter as soon as the fixed
+ *      fields QNAME through TLEN have been parsed, and skips the rest
+ *      of any record it rejects, so rejected records cost no SEQ, QUAL,
+ *      or tag copying.  Rejected records are counted in
+ *      BL_SAM_READER_ALIGNMENTS_FILTERED() and not returned.
+ *
+ *      Fields used by the expression are added to the reader's field
+ *      mask.  The filter is not copied and must remain valid while the
+ *      reader is in use.  Pass NULL to remove a filter.
+ *
+ *  Arguments:
+ *      reader:     Pointer to an initialized bl_sam_reader_t structure
+ *      filter:     Pointer to a filter from bl_sam_filter_compile(3),
+ *                  or NULL
+ *
+ *  Examples:
+ *      bl_sam_filter_t filter;
+ *
+ *      if ( bl_sam_filter_compile(&filter,
+ *              "!(flag & 0x904) && mapq >= 20 && rname in {chr1, chr2}")
+ *              != BL_DATA_OK )
+ *          exit(EX_USAGE);
+ *      bl_sam_reader_init(&reader, stdin, BL_SAM_FIELD_ALL);
+ *      bl_sam_reader_set_filter(&reader, &filter);
+ *
+ *  See also:
+ *      bl_sam_filter_compile(3), bl_sam_reader_read(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_reader_set_filter(bl_sam_reader_t *reader,
+				 struct bl_sam_filter *filter)
+
+{
+    reader->filter = filter;
+    if ( filter != NULL )
+	reader->field_mask |= filter->field_mask;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Copy a SAM alignment as efficiently as possible, allocating memory
+ *      as needed.
+ *
+ *  Arguments:
+ *      dest:   Pointer to bl_sam_t structure to receive copy
+ *      src:    Pointer to bl_sam_t structure to be copied
+ *
+ *  See also:
+ *      bl_sam_read(3), bl_sam_init(3), bl_sam_free(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2020-05-27  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_copy(bl_sam_t *dest, bl_sam_t *src)
+
+{
+    size_t  bytes;
+    
+    strlcpy(dest->qname, src->qname, BL_SAM_QNAME_MAX_CHARS + 1);
+    dest->flag = src->flag;
+    strlcpy(dest->rname, src->rname, BL_SAM_RNAME_MAX_CHARS + 1);
+    dest->pos = src->pos;
+    dest->mapq = src->mapq;
+    // FIXME: Add cigar and RNEXT
+    strlcpy(dest->cigar, src->cigar, BL_SAM_CIGAR_MAX_CHARS + 1);
+    strlcpy(dest->rnext, src->rnext, BL_SAM_RNAME_MAX_CHARS + 1);
+    dest->pnext = src->pnext;
+    dest->tlen = src->tlen;
+    
+    dest->seq_encoding = src->seq_encoding;
+    dest->seq_exception_count = src->seq_exception_count;
+    if ( src->seq_encoding == BL_SEQ_ASCII )
     {
-	sam_alignment->seq = NULL;
-	sam_alignment->qual = NULL;
+	if ( (dest->seq = xt_malloc(src->seq_len + 1,
+		sizeof(*dest->seq))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_copy(): Could not allocate seq.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	memcpy(dest->seq, src->seq, src->seq_len + 1);
+	dest->seq_capacity = src->seq_len + 1;
+	dest->packed_seq = NULL;
     }
     else
     {
-	if ( seq_len != 0 )
+	// No packed data for SEQ "*"
+	dest->packed_seq = NULL;
+	if ( (bytes = sam_packed_seq_bytes(src)) > 0 )
 	{
-	    if ( (field_mask & BL_SAM_FIELD_SEQ) && 
-		 ((sam_alignment->seq = xt_malloc(seq_len + 1,
-			sizeof(*sam_alignment->seq))) == NULL) )
-	    {
-		fprintf(stderr, "bl_sam_init(): Could not allocate seq.\n");
-		exit(EX_UNAVAILABLE);
-	    }
-	    if ( (field_mask & BL_SAM_FIELD_QUAL) &&
-		 ((sam_alignment->qual = xt_malloc(seq_len + 1,
-			sizeof(*sam_alignment->qual))) == NULL) )
+	    if ( (dest->packed_seq = xt_malloc(bytes,
+		    sizeof(*dest->packed_seq))) == NULL )
 	    {
-		fprintf(stderr, "bl_sam_init(): Could not allocate qual.\n");
+		fprintf(stderr, "bl_sam_copy(): Could not allocate packed_seq.\n");
 		exit(EX_UNAVAILABLE);
 	    }
+	    memcpy(dest->packed_seq, src->packed_seq, bytes);
 	}
+	dest->seq = NULL;
+	dest->seq_capacity = 0;
+    }
+    
+    // qual may be "*" when seq is "*" or absent
+    if ( (dest->qual = xt_malloc(MAX(src->seq_len, src->qual_len) + 1,
+	    sizeof(*dest->qual))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_copy(): Could not allocate qual.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    dest->qual_capacity = MAX(src->seq_len, src->qual_len) + 1;
+    
+    /* qual is an optional field */
+    if ( src->qual_len > 0 )
+	memcpy(dest->qual, src->qual, src->qual_len + 1);
+    
+    dest->seq_len = src->seq_len;
+    dest->qual_len = src->qual_len;
+    
+    // Allocate only what's used, since copies are often buffered
+    dest->cigar_op_count = dest->cigar_op_max = src->cigar_op_count;
+    if ( src->cigar_op_count == 0 )
+	dest->cigar_ops = NULL;
+    else
+    {
+	if ( (dest->cigar_ops = xt_malloc(src->cigar_op_count,
+		sizeof(*dest->cigar_ops))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_copy(): Could not allocate cigar_ops.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	memcpy(dest->cigar_ops, src->cigar_ops,
+	       src->cigar_op_count * sizeof(*dest->cigar_ops));
+    }
+    dest->ref_end = src->ref_end;
+    
+    // Index is rebuilt on demand
+    dest->tag_index = NULL;
+    dest->tag_index_size = dest->tag_count = 0;
+    dest->tags_indexed = false;
+    dest->tags_len = src->tags_len;
+    if ( src->tags_len == 0 )
+    {
+	dest->tags = NULL;
+	dest->tags_max = 0;
+    }
+    else
+    {
+	dest->tags_max = src->tags_len + 1;
+	if ( (dest->tags = xt_malloc(dest->tags_max,
+		sizeof(*dest->tags))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_copy(): Could not allocate tags.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	memcpy(dest->tags, src->tags, dest->tags_max);
     }
-    sam_alignment->seq_len = seq_len;
 }
 
 
@@ -515,60 +913,1389 @@ void    bl_sam_init(bl_sam_t *sam_alignment, size_t seq_len,
  *      -lbiolibc -lxtend
  *
  *  Description:
- *      Write an alignment (line) to a SAM stream.
+ *      Free memory allocated by bl_sam_read() or
+ *      bl_sam_init().
  *
- *      If field_mask is not BL_SAM_FIELD_ALL, fields not indicated by a 1
- *      in the bit mask are written as an appropriate placeholder such as '.'
- *      rather than stored in sam_alignment.  Possible mask values are:
+ *  Arguments:
+ *      sam_alignment:  Pointer to bl_sam_t structure to be freed.
  *
- *      BL_SAM_FIELD_ALL
- *      BL_SAM_FIELD_QNAME
- *      BL_SAM_FIELD_FLAG
- *      BL_SAM_FIELD_RNAME
- *      BL_SAM_FIELD_POS
- *      BL_SAM_FIELD_MAPQ
- *      BL_SAM_FIELD_CIGAR
- *      BL_SAM_FIELD_RNEXT
- *      BL_SAM_FIELD_PNEXT
- *      BL_SAM_FIELD_TLEN
- *      BL_SAM_FIELD_SEQ
- *      BL_SAM_FIELD_QUAL
+ *  See also:
+ *      bl_sam_read(3), bl_sam_init(3), bl_sam_copy(3)
  *
- *  Arguments:
- *      sam_stream:     A FILE stream to which to write the line
- *      sam_alignment:  Pointer to a bl_sam_t structure
- *      field_mask:     Bit mask indicating which fields to store in sam_alignment
+ *  History: 
+ *  Date        Name        Modification
+ *  2020-05-29  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_free(bl_sam_t *sam_alignment)
+
+{
+    if ( sam_alignment->seq != NULL )
+    {
+	free(sam_alignment->seq);
+	sam_alignment->seq = NULL;
+    }
+    if ( sam_alignment->qual != NULL )
+    {
+	free(sam_alignment->qual);
+	sam_alignment->qual = NULL;
+    }
+    sam_alignment->seq_capacity = sam_alignment->qual_capacity = 0;
+    if ( sam_alignment->cigar_ops != NULL )
+    {
+	free(sam_alignment->cigar_ops);
+	sam_alignment->cigar_ops = NULL;
+    }
+    sam_alignment->cigar_op_count = sam_alignment->cigar_op_max = 0;
+    if ( sam_alignment->packed_seq != NULL )
+    {
+	free(sam_alignment->packed_seq);
+	sam_alignment->packed_seq = NULL;
+    }
+    sam_alignment->seq_encoding = BL_SEQ_ASCII;
+    sam_alignment->seq_exception_count = 0;
+    if ( sam_alignment->tags != NULL )
+    {
+	free(sam_alignment->tags);
+	sam_alignment->tags = NULL;
+    }
+    if ( sam_alignment->tag_index != NULL )
+    {
+	free(sam_alignment->tag_index);
+	sam_alignment->tag_index = NULL;
+    }
+    sam_alignment->tags_len = sam_alignment->tags_max = 0;
+    sam_alignment->tag_index_size = sam_alignment->tag_count = 0;
+    sam_alignment->tags_indexed = false;
+    // FIXME: Cigar and rnext?
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
  *
- *  Returns:
- *      Number of items written (per fprintf() output)
+ *  Description:
+ *      Initialize a bl_sam_t structure, allocating memory for
+ *      sequence and quality strings according to seq_len.  Passing a
+ *      seq_len of 0 prevents memory allocation from occurring.
+ *
+ *      Only BL_SAM_FIELD_SEQ and BL_SAM_FIELD_QUAL are meaningful bits in
+ *      field_mask, as they determine whether memory is allocated.  All
+ *      other fields are unconditionally initialized to 0, NULL, or blank.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to bl_sam_t structure to initialize
+ *      seq_len:        Length of sequence and quality strings
+ *      field_mask:     Bit mask indicating which fields will be used
  *
  *  See also:
- *      bl_sam_read(3)
+ *      bl_sam_read(3), bl_sam_free(3), bl_sam_copy(3)
  *
  *  History: 
  *  Date        Name        Modification
- *  2019-12-09  Jason Bacon Begin
+ *  2020-05-29  Jason Bacon Begin
  ***************************************************************************/
 
-int     bl_sam_write(FILE *sam_stream, bl_sam_t *sam_alignment,
+void    bl_sam_init(bl_sam_t *sam_alignment, size_t seq_len,
 			   sam_field_mask_t field_mask)
 
 {
-    int     count;
-    
-    count = fprintf(sam_stream, "%s\t%u\t%s\t%zu\t%u\t%s\t%s\t%zu\t%zu\t%s\t%s\t%zu\t%zu\n",
-		    sam_alignment->qname,
-		    sam_alignment->flag,
-		    sam_alignment->rname,
-		    sam_alignment->pos,
-		    sam_alignment->mapq,
-		    sam_alignment->cigar,
-		    sam_alignment->rnext,
-		    sam_alignment->pnext,
-		    sam_alignment->tlen,
-		    sam_alignment->seq,
-		    sam_alignment->qual,
-		    sam_alignment->seq_len,
-		    sam_alignment->qual_len);
-    return count;
+    *sam_alignment->qname = '\0';
+    sam_alignment->flag = 0;
+    *sam_alignment->rname = '\0';
+    sam_alignment->pos = 0;
+    sam_alignment->mapq = 0;
+    *sam_alignment->cigar = '\0';
+    *sam_alignment->rnext = '\0';
+    sam_alignment->pnext = 0;
+    sam_alignment->tlen = 0;
+    sam_alignment->cigar_ops = NULL;
+    sam_alignment->cigar_op_count = 0;
+    sam_alignment->cigar_op_max = 0;
+    sam_alignment->ref_end = 0;
+    sam_alignment->packed_seq = NULL;
+    sam_alignment->seq_exception_count = 0;
+    sam_alignment->seq_encoding = BL_SEQ_ASCII;
+    sam_alignment->tags = NULL;
+    sam_alignment->tags_len = 0;
+    sam_alignment->tags_max = 0;
+    sam_alignment->tag_index = NULL;
+    sam_alignment->tag_index_size = 0;
+    sam_alignment->tag_count = 0;
+    sam_alignment->tags_indexed = false;
+    sam_alignment->seq = NULL;
+    sam_alignment->qual = NULL;
+    sam_alignment->seq_capacity = sam_alignment->qual_capacity = 0;
+    if ( seq_len != 0 )
+    {
+	if ( field_mask & BL_SAM_FIELD_SEQ )
+	{
+	    if ( (sam_alignment->seq = xt_malloc(seq_len + 1,
+		    sizeof(*sam_alignment->seq))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_init(): Could not allocate seq.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	    sam_alignment->seq_capacity = seq_len + 1;
+	}
+	if ( field_mask & BL_SAM_FIELD_QUAL )
+	{
+	    if ( (sam_alignment->qual = xt_malloc(seq_len + 1,
+		    sizeof(*sam_alignment->qual))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_init(): Could not allocate qual.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	    sam_alignment->qual_capacity = seq_len + 1;
+	}
+    }
+    sam_alignment->seq_len = seq_len;
+}
+
+
+/*
+ *  Upper bounds on the length of QNAME through TLEN, and of a formatted
+ *  alignment, including the newline and the null byte stored by the
+ *  sequence unpackers
+ */
+#define SAM_FIXED_MAX \
+	(BL_SAM_QNAME_MAX_CHARS + 2 * BL_SAM_RNAME_MAX_CHARS + \
+	 BL_SAM_CIGAR_MAX_CHARS + 9 * (BL_U64_MAX_DIGITS + 2))
+#define SAM_LINE_MAX(a) \
+	(SAM_FIXED_MAX + (a)->seq_len + (a)->qual_len + (a)->tags_len + 8)
+
+// Bases unpacked at a time by bl_sam_write()
+#define SAM_SEQ_CHUNK   4096
+
+static char *sam_put_str(char *p, const char *str)
+
+{
+    size_t  len = strlen(str);
+    
+    memcpy(p, str, len);
+    return p + len;
+}
+
+
+/*
+ *  Format QNAME through TLEN, followed by a tab.  Fields not in
+ *  field_mask, and empty strings, are written as the SAM placeholders
+ *  for unavailable data.
+ */
+
+static char *sam_format_fixed(char *p, bl_sam_t *sam_alignment,
+			      sam_field_mask_t field_mask)
+
+{
+    if ( (field_mask & BL_SAM_FIELD_QNAME) && (*sam_alignment->qname != '\0') )
+	p = sam_put_str(p, sam_alignment->qname);
+    else
+	*p++ = '*';
+    *p++ = '\t';
+    if ( field_mask & BL_SAM_FIELD_FLAG )
+	p += bl_u64_to_str(p, sam_alignment->flag);
+    else
+	*p++ = '0';
+    *p++ = '\t';
+    if ( (field_mask & BL_SAM_FIELD_RNAME) && (*sam_alignment->rname != '\0') )
+	p = sam_put_str(p, sam_alignment->rname);
+    else
+	*p++ = '*';
+    *p++ = '\t';
+    if ( field_mask & BL_SAM_FIELD_POS )
+	p += bl_u64_to_str(p, sam_alignment->pos);
+    else
+	*p++ = '0';
+    *p++ = '\t';
+    if ( field_mask & BL_SAM_FIELD_MAPQ )
+	p += bl_u64_to_str(p, sam_alignment->mapq);
+    else
+    {
+	// 255 means MAPQ is unavailable
+	memcpy(p, "255", 3);
+	p += 3;
+    }
+    *p++ = '\t';
+    if ( (field_mask & BL_SAM_FIELD_CIGAR) && (*sam_alignment->cigar != '\0') )
+	p = sam_put_str(p, sam_alignment->cigar);
+    else
+	*p++ = '*';
+    *p++ = '\t';
+    if ( (field_mask & BL_SAM_FIELD_RNEXT) && (*sam_alignment->rnext != '\0') )
+	p = sam_put_str(p, sam_alignment->rnext);
+    else
+	*p++ = '*';
+    *p++ = '\t';
+    if ( field_mask & BL_SAM_FIELD_PNEXT )
+	p += bl_u64_to_str(p, sam_alignment->pnext);
+    else
+	*p++ = '0';
+    *p++ = '\t';
+    if ( field_mask & BL_SAM_FIELD_TLEN )
+	p += bl_i64_to_str(p, sam_alignment->tlen);
+    else
+	*p++ = '0';
+    *p++ = '\t';
+    return p;
+}
+
+
+/*
+ *  Format SEQ, QUAL, optional fields, and the newline.  Packed
+ *  sequences are unpacked directly into the output.
+ */
+
+static char *sam_format_var(char *p, bl_sam_t *sam_alignment,
+			    sam_field_mask_t field_mask)
+
+{
+    if ( (field_mask & BL_SAM_FIELD_SEQ) && (sam_alignment->seq_len > 0) )
+    {
+	switch(sam_alignment->seq_encoding)
+	{
+	    case    BL_SEQ_NT16:
+		bl_seq_unpack_nt16(p, sam_alignment->packed_seq,
+				   sam_alignment->seq_len);
+		break;
+	    case    BL_SEQ_NT4:
+		bl_seq_unpack_nt4(p, sam_alignment->packed_seq,
+				  sam_alignment->seq_len,
+				  SAM_NT4_EXCEPTIONS(sam_alignment),
+				  sam_alignment->seq_exception_count);
+		break;
+	    default:
+		memcpy(p, sam_alignment->seq, sam_alignment->seq_len);
+	}
+	p += sam_alignment->seq_len;
+    }
+    else
+	*p++ = '*';
+    *p++ = '\t';
+    if ( (field_mask & BL_SAM_FIELD_QUAL) && (sam_alignment->qual_len > 0) )
+    {
+	memcpy(p, sam_alignment->qual, sam_alignment->qual_len);
+	p += sam_alignment->qual_len;
+    }
+    else
+	*p++ = '*';
+    if ( (field_mask & BL_SAM_FIELD_TAGS) && (sam_alignment->tags_len > 0) )
+    {
+	*p++ = '\t';
+	memcpy(p, sam_alignment->tags, sam_alignment->tags_len);
+	p += sam_alignment->tags_len;
+    }
+    *p++ = '\n';
+    return p;
+}
+
+
+/*
+ *  Write a packed SEQ to a stream, unpacking SAM_SEQ_CHUNK bases at a
+ *  time so no buffer proportional to the read length is needed.  Chunks
+ *  start on a byte boundary for both encodings, and NT4 exceptions are
+ *  in ascending order, so they are restored one chunk at a time.
+ */
+
+static int  sam_write_packed_seq(FILE *sam_stream, bl_sam_t *sam_alignment)
+
+{
+    char            buff[SAM_SEQ_CHUNK + 1];
+    const uint32_t  *exceptions;
+    size_t          c, e = 0, len;
+    
+    for (c = 0; c < sam_alignment->seq_len; c += len)
+    {
+	len = MIN(SAM_SEQ_CHUNK, sam_alignment->seq_len - c);
+	if ( sam_alignment->seq_encoding == BL_SEQ_NT16 )
+	    bl_seq_unpack_nt16(buff, sam_alignment->packed_seq + c / 2, len);
+	else
+	{
+	    bl_seq_unpack_nt4(buff, sam_alignment->packed_seq + c / 4, len,
+			      NULL, 0);
+	    exceptions = SAM_NT4_EXCEPTIONS(sam_alignment);
+	    for (; (e < sam_alignment->seq_exception_count) &&
+		   (exceptions[e] < c + len); ++e)
+		buff[exceptions[e] - c] = 'N';
+	}
+	if ( fwrite(buff, len, 1, sam_stream) != 1 )
+	    return BL_WRITE_FAILURE;
+    }
+    return BL_WRITE_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Write an alignment (line) to a SAM stream.
+ *
+ *      If field_mask is not BL_SAM_FIELD_ALL, fields not indicated by a 1
+ *      in the bit mask are written as the SAM placeholder for unavailable
+ *      data ('*' for strings, 0 for numbers, 255 for MAPQ) rather than
+ *      taken from sam_alignment.  Empty strings are also written as '*'.
+ *      Optional fields are written only if BL_SAM_FIELD_TAGS is set.
+ *      Possible mask values are:
+ *
+ *      BL_SAM_FIELD_ALL
+ *      BL_SAM_FIELD_QNAME
+ *      BL_SAM_FIELD_FLAG
+ *      BL_SAM_FIELD_RNAME
+ *      BL_SAM_FIELD_POS
+ *      BL_SAM_FIELD_MAPQ
+ *      BL_SAM_FIELD_CIGAR
+ *      BL_SAM_FIELD_RNEXT
+ *      BL_SAM_FIELD_PNEXT
+ *      BL_SAM_FIELD_TLEN
+ *      BL_SAM_FIELD_SEQ
+ *      BL_SAM_FIELD_QUAL
+ *      BL_SAM_FIELD_TAGS
+ *
+ *      Packed sequences are written as ASCII.  For writing many
+ *      alignments, bl_sam_writer_write(3) is much faster.
+ *
+ *  Arguments:
+ *      sam_stream:     A FILE stream to which to write the line
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      field_mask:     Bit mask indicating which fields to write
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE otherwise
+ *
+ *  See also:
+ *      bl_sam_read(3), bl_sam_writer_write(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2019-12-09  Jason Bacon Begin
+ *  2026-10-18  Jason Bacon Write valid SAM and respect field_mask
+ ***************************************************************************/
+
+int     bl_sam_write(FILE *sam_stream, bl_sam_t *sam_alignment,
+			   sam_field_mask_t field_mask)
+
+{
+    char    fixed[SAM_FIXED_MAX], *end;
+    int     status = BL_WRITE_OK;
+    
+    /*
+     *  Format the bounded columns on the stack and send the rest straight
+     *  from sam_alignment, so nothing is allocated per call.
+     */
+    end = sam_format_fixed(fixed, sam_alignment, field_mask);
+    if ( fwrite(fixed, end - fixed, 1, sam_stream) != 1 )
+	status = BL_WRITE_FAILURE;
+    
+    if ( (field_mask & BL_SAM_FIELD_SEQ) && (sam_alignment->seq_len > 0) )
+    {
+	if ( sam_alignment->seq_encoding == BL_SEQ_ASCII )
+	{
+	    if ( fwrite(sam_alignment->seq, sam_alignment->seq_len, 1,
+			sam_stream) != 1 )
+		status = BL_WRITE_FAILURE;
+	}
+	else if ( sam_write_packed_seq(sam_stream, sam_alignment)
+		  != BL_WRITE_OK )
+	    status = BL_WRITE_FAILURE;
+    }
+    else
+	putc('*', sam_stream);
+    putc('\t', sam_stream);
+    
+    if ( (field_mask & BL_SAM_FIELD_QUAL) && (sam_alignment->qual_len > 0) )
+    {
+	if ( fwrite(sam_alignment->qual, sam_alignment->qual_len, 1,
+		    sam_stream) != 1 )
+	    status = BL_WRITE_FAILURE;
+    }
+    else
+	putc('*', sam_stream);
+    
+    if ( (field_mask & BL_SAM_FIELD_TAGS) && (sam_alignment->tags_len > 0) )
+    {
+	putc('\t', sam_stream);
+	if ( fwrite(sam_alignment->tags, sam_alignment->tags_len, 1,
+		    sam_stream) != 1 )
+	    status = BL_WRITE_FAILURE;
+    }
+    if ( putc('\n', sam_stream) == EOF )
+	status = BL_WRITE_FAILURE;
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Initialize a SAM writer context for an open stream, such as
+ *      stdout.  Alignments are formatted with memcpy() and
+ *      bl_u64_to_str(3) into a large buffer, which is passed to write(2)
+ *      on the underlying file descriptor when full, avoiding printf()
+ *      and stdio overhead.  Any data already written to sam_stream with
+ *      stdio, such as header lines, are flushed first.  Do not write to
+ *      sam_stream with stdio again until bl_sam_writer_flush(3) or
+ *      bl_sam_writer_close(3) is called.  The stream is not closed by
+ *      bl_sam_writer_close(3).
+ *
+ *      See bl_sam_write(3) for field_mask values.
+ *
+ *  Arguments:
+ *      writer:         Pointer to the bl_sam_writer_t structure to initialize
+ *      sam_stream:     Open FILE stream
+ *      field_mask:     Bit mask indicating which fields to write
+ *
+ *  Examples:
+ *      bl_sam_writer_t writer;
+ *
+ *      bl_sam_writer_init(&writer, stdout, BL_SAM_FIELD_ALL | BL_SAM_FIELD_TAGS);
+ *      while ( bl_sam_reader_read(&reader, &sam_alignment) == BL_READ_OK )
+ *          if ( BL_SAM_MAPQ(&sam_alignment) >= 20 )
+ *              bl_sam_writer_write(&writer, &sam_alignment);
+ *      bl_sam_writer_close(&writer);
+ *
+ *  See also:
+ *      bl_sam_writer_open(3), bl_sam_writer_write(3),
+ *      bl_sam_writer_flush(3), bl_sam_writer_close(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_sam_writer_init(bl_sam_writer_t *writer, FILE *sam_stream,
+			   sam_field_mask_t field_mask)
+
+{
+    fflush(sam_stream);
+    writer->stream = sam_stream;
+    writer->fd = fileno(sam_stream);
+    writer->owns_stream = false;
+    writer->field_mask = field_mask;
+    writer->buff_size = BL_SAM_WRITER_BUFF_SIZE;
+    writer->buff_len = 0;
+    if ( (writer->buff = xt_malloc(writer->buff_size,
+	    sizeof(*writer->buff))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_writer_init(): Could not allocate buff.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    writer->alignments_written = 0;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Open a file for writing and initialize a SAM writer context for
+ *      it.  The file is closed by bl_sam_writer_close(3).
+ *
+ *  Arguments:
+ *      writer:         Pointer to the bl_sam_writer_t structure to initialize
+ *      filename:       Name of the file to create
+ *      field_mask:     Bit mask indicating which fields to write
+ *
+ *  Returns:
+ *      The open FILE stream, or NULL if the file could not be opened
+ *
+ *  See also:
+ *      bl_sam_writer_init(3), bl_sam_writer_close(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+FILE    *bl_sam_writer_open(bl_sam_writer_t *writer, const char *filename,
+			    sam_field_mask_t field_mask)
+
+{
+    FILE    *sam_stream;
+    
+    if ( (sam_stream = xt_fopen(filename, "w")) == NULL )
+	return NULL;
+    bl_sam_writer_init(writer, sam_stream, field_mask);
+    writer->owns_stream = true;
+    return sam_stream;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Append an alignment to the writer's buffer, flushing it first
+ *      if the alignment might not fit.  The buffer is enlarged for
+ *      alignments longer than BL_SAM_WRITER_BUFF_SIZE.
+ *
+ *  Arguments:
+ *      writer:         Pointer to an initialized bl_sam_writer_t structure
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE if a flush failed
+ *
+ *  See also:
+ *      bl_sam_writer_init(3), bl_sam_write(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_writer_write(bl_sam_writer_t *writer, bl_sam_t *sam_alignment)
+
+{
+    size_t  max = SAM_LINE_MAX(sam_alignment);
+    char    *end;
+    
+    if ( writer->buff_len + max > writer->buff_size )
+    {
+	if ( bl_sam_writer_flush(writer) != BL_WRITE_OK )
+	    return BL_WRITE_FAILURE;
+	if ( max > writer->buff_size )
+	{
+	    writer->buff_size = max;
+	    if ( (writer->buff = xt_realloc(writer->buff, writer->buff_size,
+		    sizeof(*writer->buff))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_writer_write(): Could not allocate buff.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	}
+    }
+    end = sam_format_fixed(writer->buff + writer->buff_len, sam_alignment,
+			   writer->field_mask);
+    end = sam_format_var(end, sam_alignment, writer->field_mask);
+    writer->buff_len = end - writer->buff;
+    ++writer->alignments_written;
+    return BL_WRITE_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Check whether an alignment is certain to fit in the writer's
+ *      buffer, i.e. whether bl_sam_writer_write(3) can add it without
+ *      flushing.  This allows a caller that manages the file descriptor
+ *      itself, such as bl_sam_demux_write(3), to open it only when a
+ *      flush is actually needed.
+ *
+ *  Arguments:
+ *      writer:         Pointer to an initialized bl_sam_writer_t structure
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      true if the alignment fits without a flush, false otherwise
+ *
+ *  See also:
+ *      bl_sam_writer_write(3), bl_sam_writer_flush(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    bl_sam_writer_fits(bl_sam_writer_t *writer, bl_sam_t *sam_alignment)
+
+{
+    return writer->buff_len + SAM_LINE_MAX(sam_alignment) <= writer->buff_size;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Write all buffered alignments to the underlying file descriptor.
+ *      After this, the stream may be written with stdio again, e.g. to
+ *      interleave other output.
+ *
+ *  Arguments:
+ *      writer:         Pointer to an initialized bl_sam_writer_t structure
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE otherwise
+ *
+ *  See also:
+ *      bl_sam_writer_write(3), bl_sam_writer_close(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_writer_flush(bl_sam_writer_t *writer)
+
+{
+    size_t  done = 0;
+    ssize_t bytes;
+    
+    while ( done < writer->buff_len )
+    {
+	bytes = write(writer->fd, writer->buff + done,
+		      writer->buff_len - done);
+	if ( bytes < 0 )
+	{
+	    if ( errno == EINTR )
+		continue;
+	    return BL_WRITE_FAILURE;
+	}
+	done += bytes;
+    }
+    writer->buff_len = 0;
+    return BL_WRITE_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Flush and free a SAM writer context, closing the stream if it
+ *      was opened by bl_sam_writer_open(3).
+ *
+ *  Arguments:
+ *      writer:         Pointer to an initialized bl_sam_writer_t structure
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE if the final flush failed
+ *
+ *  See also:
+ *      bl_sam_writer_init(3), bl_sam_writer_open(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_writer_close(bl_sam_writer_t *writer)
+
+{
+    int     status;
+    
+    status = bl_sam_writer_flush(writer);
+    if ( writer->owns_stream )
+	xt_fclose(writer->stream);
+    writer->stream = NULL;
+    writer->fd = -1;
+    writer->owns_stream = false;
+    free(writer->buff);
+    writer->buff = NULL;
+    writer->buff_size = 0;
+    return status;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Pack the sequence of an alignment to reduce memory use, e.g.
+ *      for alignments held in a bl_sam_buff_t buffer.  The ASCII seq
+ *      buffer is freed and BL_SAM_SEQ() becomes NULL.  Use
+ *      bl_sam_seq_base(3) to access individual bases, or
+ *      bl_sam_unpack_seq(3) to restore the ASCII sequence.
+ *
+ *      BL_SEQ_NT16 packs two bases per byte and preserves all IUPAC
+ *      codes.  BL_SEQ_NT4 packs four bases per byte and restores any
+ *      base other than ACGT as N.  Lower case bases are restored as
+ *      upper case in either encoding.  BL_SEQ_ASCII unpacks a
+ *      previously packed sequence.  A missing SEQ ("*") is packed with
+ *      BL_SAM_SEQ_LEN() 0 and restored as "*".
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      encoding:       BL_SEQ_NT16, BL_SEQ_NT4, or BL_SEQ_ASCII
+ *
+ *  Returns:
+ *      BL_DATA_OK on success
+ *      BL_DATA_INVALID if encoding is not recognized
+ *
+ *  Examples:
+ *      bl_sam_read(stdin, &sam_alignment, BL_SAM_FIELD_ALL);
+ *      bl_sam_pack_seq(&sam_alignment, BL_SEQ_NT4);
+ *
+ *  See also:
+ *      bl_sam_unpack_seq(3), bl_sam_seq_base(3), bl_seq_pack_nt16(3),
+ *      bl_seq_pack_nt4(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_pack_seq(bl_sam_t *sam_alignment, int encoding)
+
+{
+    size_t  len = sam_alignment->seq_len, bytes, exception_count;
+    
+    if ( encoding == sam_alignment->seq_encoding )
+	return BL_DATA_OK;
+    
+    if ( sam_alignment->seq_encoding != BL_SEQ_ASCII )
+	bl_sam_unpack_seq(sam_alignment);
+    
+    // Nothing to pack if SEQ was not read
+    if ( sam_alignment->seq == NULL )
+	return BL_DATA_OK;
+    
+    /*
+     *  SEQ "*" has no bases, so it is packed as length 0 with no packed
+     *  data, and restored as "*" by bl_sam_unpack_seq().
+     */
+    if ( (len == 1) && (*sam_alignment->seq == '*') &&
+	 ((encoding == BL_SEQ_NT16) || (encoding == BL_SEQ_NT4)) )
+    {
+	sam_alignment->seq_len = 0;
+	sam_alignment->seq_exception_count = 0;
+    }
+    else switch(encoding)
+    {
+	case    BL_SEQ_ASCII:
+	    return BL_DATA_OK;
+	
+	case    BL_SEQ_NT16:
+	    bytes = BL_SEQ_NT16_BYTES(len);
+	    if ( (sam_alignment->packed_seq = xt_malloc(bytes,
+		    sizeof(*sam_alignment->packed_seq))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_pack_seq(): Could not allocate packed_seq.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	    bl_seq_pack_nt16(sam_alignment->packed_seq, sam_alignment->seq, len);
+	    sam_alignment->seq_exception_count = 0;
+	    break;
+	
+	case    BL_SEQ_NT4:
+	    /*
+	     *  Pack once to count exceptions, which are rare in most data,
+	     *  and again to store them only if there are any.
+	     */
+	    bytes = SAM_NT4_EXCEPTIONS_OFFSET(len);
+	    if ( (sam_alignment->packed_seq = xt_malloc(bytes,
+		    sizeof(*sam_alignment->packed_seq))) == NULL )
+	    {
+		fprintf(stderr, "bl_sam_pack_seq(): Could not allocate packed_seq.\n");
+		exit(EX_UNAVAILABLE);
+	    }
+	    exception_count = bl_seq_pack_nt4(sam_alignment->packed_seq,
+					      sam_alignment->seq, len, NULL);
+	    sam_alignment->seq_exception_count = exception_count;
+	    if ( exception_count > 0 )
+	    {
+		bytes += exception_count * sizeof(uint32_t);
+		if ( (sam_alignment->packed_seq =
+			xt_realloc(sam_alignment->packed_seq, bytes,
+			sizeof(*sam_alignment->packed_seq))) == NULL )
+		{
+		    fprintf(stderr, "bl_sam_pack_seq(): Could not allocate packed_seq.\n");
+		    exit(EX_UNAVAILABLE);
+		}
+		bl_seq_pack_nt4(sam_alignment->packed_seq, sam_alignment->seq,
+				len, SAM_NT4_EXCEPTIONS(sam_alignment));
+	    }
+	    break;
+	
+	default:
+	    return BL_DATA_INVALID;
+    }
+    
+    sam_alignment->seq_encoding = encoding;
+    free(sam_alignment->seq);
+    sam_alignment->seq = NULL;
+    sam_alignment->seq_capacity = 0;
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Restore the ASCII sequence of an alignment packed by
+ *      bl_sam_pack_seq(3) and free the packed sequence.  Does nothing
+ *      if the sequence is not packed.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      BL_DATA_OK
+ *
+ *  See also:
+ *      bl_sam_pack_seq(3), bl_sam_seq_base(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_unpack_seq(bl_sam_t *sam_alignment)
+
+{
+    size_t  len = sam_alignment->seq_len;
+    
+    if ( sam_alignment->seq_encoding == BL_SEQ_ASCII )
+	return BL_DATA_OK;
+    
+    // Length 0 is SEQ "*", see bl_sam_pack_seq()
+    if ( (sam_alignment->seq = xt_malloc(MAX(len, 1) + 1,
+	    sizeof(*sam_alignment->seq))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_unpack_seq(): Could not allocate seq.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    sam_alignment->seq_capacity = MAX(len, 1) + 1;
+    if ( len == 0 )
+    {
+	strlcpy(sam_alignment->seq, "*", 2);
+	sam_alignment->seq_len = 1;
+    }
+    else if ( sam_alignment->seq_encoding == BL_SEQ_NT16 )
+	bl_seq_unpack_nt16(sam_alignment->seq, sam_alignment->packed_seq, len);
+    else
+	bl_seq_unpack_nt4(sam_alignment->seq, sam_alignment->packed_seq, len,
+			  SAM_NT4_EXCEPTIONS(sam_alignment),
+			  sam_alignment->seq_exception_count);
+    
+    free(sam_alignment->packed_seq);
+    sam_alignment->packed_seq = NULL;
+    sam_alignment->seq_exception_count = 0;
+    sam_alignment->seq_encoding = BL_SEQ_ASCII;
+    return BL_DATA_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Return the base at a 0-based position in the sequence of an
+ *      alignment, whether or not the sequence is packed.  Bases in a
+ *      packed sequence are returned as upper case.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *      c:              0-based position in SEQ, less than BL_SAM_SEQ_LEN()
+ *
+ *  Returns:
+ *      The ASCII base at position c
+ *
+ *  Examples:
+ *      for (c = 0; c < BL_SAM_SEQ_LEN(&sam_alignment); ++c)
+ *          putchar(bl_sam_seq_base(&sam_alignment, c));
+ *
+ *  See also:
+ *      bl_sam_pack_seq(3), bl_sam_unpack_seq(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+char    bl_sam_seq_base(bl_sam_t *sam_alignment, size_t c)
+
+{
+    switch(sam_alignment->seq_encoding)
+    {
+	case    BL_SEQ_NT16:
+	    return BL_SEQ_NT16_BASE(sam_alignment->packed_seq, c);
+	case    BL_SEQ_NT4:
+	    return bl_seq_nt4_base(sam_alignment->packed_seq, c,
+				   SAM_NT4_EXCEPTIONS(sam_alignment),
+				   sam_alignment->seq_exception_count);
+	default:
+	    return sam_alignment->seq[c];
+    }
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Return the number of bytes of memory used by a bl_sam_t
+ *      structure as allocated by bl_sam_copy(3), including the structure
+ *      itself.  Note that the fixed-size QNAME, RNAME, CIGAR, and RNEXT
+ *      arrays make sizeof(bl_sam_t) over 16 KiB, which dominates for
+ *      short reads.  See bl_sam_serialized_size(3) for the packed size.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      Bytes used by sam_alignment
+ *
+ *  See also:
+ *      bl_sam_copy(3), bl_sam_serialized_size(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  bl_sam_footprint(bl_sam_t *sam_alignment)
+
+{
+    size_t  bytes = sizeof(*sam_alignment);
+    
+    if ( sam_alignment->seq_encoding == BL_SEQ_ASCII )
+	bytes += sam_alignment->seq_len + 1;
+    else
+	bytes += sam_packed_seq_bytes(sam_alignment);
+    bytes += MAX(sam_alignment->seq_len, sam_alignment->qual_len) + 1;
+    bytes += sam_alignment->cigar_op_count * sizeof(*sam_alignment->cigar_ops);
+    if ( sam_alignment->tags_len > 0 )
+	bytes += sam_alignment->tags_len + 1;
+    return bytes;
+}
+
+
+/*
+ *  Fill in the fixed-size part of a serialized alignment
+ */
+
+static void sam_serial_head(sam_serial_t *head, bl_sam_t *sam_alignment)
+
+{
+    memset(head, 0, sizeof(*head));     // No uninitialized padding
+    head->qname_len = strlen(sam_alignment->qname);
+    head->rname_len = strlen(sam_alignment->rname);
+    head->cigar_len = strlen(sam_alignment->cigar);
+    head->rnext_len = strlen(sam_alignment->rnext);
+    head->flag = sam_alignment->flag;
+    head->pos = sam_alignment->pos;
+    head->pnext = sam_alignment->pnext;
+    head->tlen = sam_alignment->tlen;
+    head->seq_len = sam_alignment->seq_len;
+    head->qual_len = sam_alignment->qual_len;
+    head->tags_len = sam_alignment->tags_len;
+    head->ref_end = sam_alignment->ref_end;
+    head->cigar_op_count = sam_alignment->cigar_op_count;
+    head->seq_exception_count = sam_alignment->seq_exception_count;
+    head->mapq = sam_alignment->mapq;
+    head->seq_encoding = sam_alignment->seq_encoding;
+}
+
+
+static size_t   sam_serial_seq_bytes(bl_sam_t *sam_alignment)
+
+{
+    if ( sam_alignment->seq_encoding == BL_SEQ_ASCII )
+	return sam_alignment->seq_len;
+    else
+	return sam_packed_seq_bytes(sam_alignment);
+}
+
+
+/*
+ *  Set the scalar fields of an alignment from a serialized header and
+ *  allocate its arrays, ready to be filled in from the serialized data.
+ */
+
+static int  sam_serial_apply(bl_sam_t *sam_alignment, sam_serial_t *head)
+
+{
+    bl_sam_init(sam_alignment, 0, BL_SAM_FIELD_ALL);
+    if ( (head->qname_len > BL_SAM_QNAME_MAX_CHARS) ||
+	 (head->rname_len > BL_SAM_RNAME_MAX_CHARS) ||
+	 (head->cigar_len > BL_SAM_CIGAR_MAX_CHARS) ||
+	 (head->rnext_len > BL_SAM_RNAME_MAX_CHARS) )
+	return BL_READ_TRUNCATED;
+    sam_alignment->qname[head->qname_len] = '\0';
+    sam_alignment->rname[head->rname_len] = '\0';
+    sam_alignment->cigar[head->cigar_len] = '\0';
+    sam_alignment->rnext[head->rnext_len] = '\0';
+    sam_alignment->flag = head->flag;
+    sam_alignment->pos = head->pos;
+    sam_alignment->mapq = head->mapq;
+    sam_alignment->pnext = head->pnext;
+    sam_alignment->tlen = head->tlen;
+    sam_alignment->seq_len = head->seq_len;
+    sam_alignment->qual_len = head->qual_len;
+    sam_alignment->ref_end = head->ref_end;
+    sam_alignment->seq_encoding = head->seq_encoding;
+    sam_alignment->seq_exception_count = head->seq_exception_count;
+    
+    if ( head->seq_encoding == BL_SEQ_ASCII )
+    {
+	if ( (sam_alignment->seq = xt_malloc(head->seq_len + 1,
+		sizeof(*sam_alignment->seq))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_deserialize(): Could not allocate seq.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	sam_alignment->seq_capacity = head->seq_len + 1;
+	sam_alignment->seq[head->seq_len] = '\0';
+    }
+    else if ( (sam_packed_seq_bytes(sam_alignment) > 0) &&
+	      ((sam_alignment->packed_seq =
+		xt_malloc(sam_packed_seq_bytes(sam_alignment),
+			  sizeof(*sam_alignment->packed_seq))) == NULL) )
+    {
+	fprintf(stderr, "bl_sam_deserialize(): Could not allocate packed_seq.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    
+    if ( (sam_alignment->qual = xt_malloc(MAX(head->seq_len, head->qual_len) + 1,
+	    sizeof(*sam_alignment->qual))) == NULL )
+    {
+	fprintf(stderr, "bl_sam_deserialize(): Could not allocate qual.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    sam_alignment->qual_capacity = MAX(head->seq_len, head->qual_len) + 1;
+    sam_alignment->qual[head->qual_len] = '\0';
+    
+    if ( head->tags_len > 0 )
+    {
+	sam_alignment->tags_len = head->tags_len;
+	sam_alignment->tags_max = head->tags_len + 1;
+	if ( (sam_alignment->tags = xt_malloc(sam_alignment->tags_max,
+		sizeof(*sam_alignment->tags))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_deserialize(): Could not allocate tags.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+	sam_alignment->tags[head->tags_len] = '\0';
+    }
+    
+    if ( head->cigar_op_count > 0 )
+    {
+	sam_alignment->cigar_op_count = sam_alignment->cigar_op_max =
+	    head->cigar_op_count;
+	if ( (sam_alignment->cigar_ops = xt_malloc(head->cigar_op_count,
+		sizeof(*sam_alignment->cigar_ops))) == NULL )
+	{
+	    fprintf(stderr, "bl_sam_deserialize(): Could not allocate cigar_ops.\n");
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    return BL_READ_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Write an alignment to a binary stream in a compact form that
+ *      omits the unused portions of fixed-size fields.  A packed sequence
+ *      is written packed, and decoded CIGAR operations and optional
+ *      fields are included, so bl_sam_deserialize(3) restores an exact
+ *      copy without reparsing.  The format is native byte order and is
+ *      meant for temporary files, not interchange.
+ *
+ *  Arguments:
+ *      stream:         FILE stream open for writing
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      BL_WRITE_OK on success, BL_WRITE_FAILURE otherwise
+ *
+ *  See also:
+ *      bl_sam_deserialize(3), bl_sam_serialize_mem(3),
+ *      bl_sam_buff_add_alignment(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_serialize(FILE *stream, bl_sam_t *sam_alignment)
+
+{
+    sam_serial_t    head;
+    size_t          seq_bytes;
+    
+    sam_serial_head(&head, sam_alignment);
+    seq_bytes = sam_serial_seq_bytes(sam_alignment);
+    
+    if ( (fwrite(&head, sizeof(head), 1, stream) != 1) ||
+	 (fwrite(sam_alignment->qname, 1, head.qname_len, stream) != head.qname_len) ||
+	 (fwrite(sam_alignment->rname, 1, head.rname_len, stream) != head.rname_len) ||
+	 (fwrite(sam_alignment->cigar, 1, head.cigar_len, stream) != head.cigar_len) ||
+	 (fwrite(sam_alignment->rnext, 1, head.rnext_len, stream) != head.rnext_len) )
+	return BL_WRITE_FAILURE;
+    if ( (seq_bytes > 0) &&
+	 (fwrite(sam_alignment->seq_encoding == BL_SEQ_ASCII ?
+		 (void *)sam_alignment->seq : (void *)sam_alignment->packed_seq,
+		 1, seq_bytes, stream) != seq_bytes) )
+	return BL_WRITE_FAILURE;
+    if ( (head.qual_len > 0) &&
+	 (fwrite(sam_alignment->qual, 1, head.qual_len, stream) != head.qual_len) )
+	return BL_WRITE_FAILURE;
+    if ( (head.tags_len > 0) &&
+	 (fwrite(sam_alignment->tags, 1, head.tags_len, stream) != head.tags_len) )
+	return BL_WRITE_FAILURE;
+    if ( (head.cigar_op_count > 0) &&
+	 (fwrite(sam_alignment->cigar_ops, sizeof(*sam_alignment->cigar_ops),
+		 head.cigar_op_count, stream) != head.cigar_op_count) )
+	return BL_WRITE_FAILURE;
+    return BL_WRITE_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Read an alignment written by bl_sam_serialize(3).  Memory is
+ *      allocated as by bl_sam_copy(3), so sam_alignment should not hold
+ *      allocated memory when this is called.  Free it with bl_sam_free(3).
+ *
+ *  Arguments:
+ *      stream:         FILE stream open for reading
+ *      sam_alignment:  Pointer to a bl_sam_t structure to receive the alignment
+ *
+ *  Returns:
+ *      BL_READ_OK on success
+ *      BL_READ_EOF if there are no more alignments in stream
+ *      BL_READ_TRUNCATED if an alignment is incomplete
+ *
+ *  See also:
+ *      bl_sam_serialize(3), bl_sam_free(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+int     bl_sam_deserialize(FILE *stream, bl_sam_t *sam_alignment)
+
+{
+    sam_serial_t    head;
+    size_t          seq_bytes;
+    
+    if ( fread(&head, sizeof(head), 1, stream) != 1 )
+    {
+	bl_sam_init(sam_alignment, 0, BL_SAM_FIELD_ALL);
+	return feof(stream) ? BL_READ_EOF : BL_READ_TRUNCATED;
+    }
+    if ( sam_serial_apply(sam_alignment, &head) != BL_READ_OK )
+	return BL_READ_TRUNCATED;
+    seq_bytes = sam_serial_seq_bytes(sam_alignment);
+    if ( (fread(sam_alignment->qname, 1, head.qname_len, stream) != head.qname_len) ||
+	 (fread(sam_alignment->rname, 1, head.rname_len, stream) != head.rname_len) ||
+	 (fread(sam_alignment->cigar, 1, head.cigar_len, stream) != head.cigar_len) ||
+	 (fread(sam_alignment->rnext, 1, head.rnext_len, stream) != head.rnext_len) ||
+	 ((seq_bytes > 0) &&
+	  (fread(head.seq_encoding == BL_SEQ_ASCII ?
+		 (void *)sam_alignment->seq : (void *)sam_alignment->packed_seq,
+		 1, seq_bytes, stream) != seq_bytes)) ||
+	 (fread(sam_alignment->qual, 1, head.qual_len, stream) != head.qual_len) ||
+	 ((head.tags_len > 0) &&
+	  (fread(sam_alignment->tags, 1, head.tags_len, stream) != head.tags_len)) ||
+	 ((head.cigar_op_count > 0) &&
+	  (fread(sam_alignment->cigar_ops, sizeof(*sam_alignment->cigar_ops),
+		 head.cigar_op_count, stream) != head.cigar_op_count)) )
+	return BL_READ_TRUNCATED;
+    return BL_READ_OK;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Return the number of bytes bl_sam_serialize_mem(3) will store for
+ *      an alignment.
+ *
+ *  Arguments:
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      Size of the serialized alignment in bytes
+ *
+ *  See also:
+ *      bl_sam_serialize_mem(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  bl_sam_serialized_size(bl_sam_t *sam_alignment)
+
+{
+    return sizeof(sam_serial_t) + strlen(sam_alignment->qname) +
+	   strlen(sam_alignment->rname) + strlen(sam_alignment->cigar) +
+	   strlen(sam_alignment->rnext) + sam_serial_seq_bytes(sam_alignment) +
+	   sam_alignment->qual_len + sam_alignment->tags_len +
+	   sam_alignment->cigar_op_count * sizeof(*sam_alignment->cigar_ops);
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Store an alignment in memory in the compact form written by
+ *      bl_sam_serialize(3).  This is typically a few hundred bytes for
+ *      a short read, versus over 16 KiB for a bl_sam_t copy, and is
+ *      meant for holding large numbers of alignments, as in
+ *      bl_sam_mate_push(3).  The serialized data have no alignment
+ *      requirements.
+ *
+ *  Arguments:
+ *      dest:           Buffer of at least bl_sam_serialized_size() bytes
+ *      sam_alignment:  Pointer to a bl_sam_t structure
+ *
+ *  Returns:
+ *      The number of bytes stored in dest
+ *
+ *  See also:
+ *      bl_sam_deserialize_mem(3), bl_sam_serialized_size(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  bl_sam_serialize_mem(char *dest, bl_sam_t *sam_alignment)
+
+{
+    sam_serial_t    head;
+    char            *p = dest;
+    size_t          seq_bytes;
+    
+    sam_serial_head(&head, sam_alignment);
+    seq_bytes = sam_serial_seq_bytes(sam_alignment);
+    memcpy(p, &head, sizeof(head));
+    p += sizeof(head);
+    memcpy(p, sam_alignment->qname, head.qname_len);
+    p += head.qname_len;
+    memcpy(p, sam_alignment->rname, head.rname_len);
+    p += head.rname_len;
+    memcpy(p, sam_alignment->cigar, head.cigar_len);
+    p += head.cigar_len;
+    memcpy(p, sam_alignment->rnext, head.rnext_len);
+    p += head.rnext_len;
+    if ( seq_bytes > 0 )
+    {
+	memcpy(p, sam_alignment->seq_encoding == BL_SEQ_ASCII ?
+		  (void *)sam_alignment->seq : (void *)sam_alignment->packed_seq,
+	       seq_bytes);
+	p += seq_bytes;
+    }
+    if ( head.qual_len > 0 )
+    {
+	memcpy(p, sam_alignment->qual, head.qual_len);
+	p += head.qual_len;
+    }
+    if ( head.tags_len > 0 )
+    {
+	memcpy(p, sam_alignment->tags, head.tags_len);
+	p += head.tags_len;
+    }
+    if ( head.cigar_op_count > 0 )
+    {
+	memcpy(p, sam_alignment->cigar_ops,
+	       head.cigar_op_count * sizeof(*sam_alignment->cigar_ops));
+	p += head.cigar_op_count * sizeof(*sam_alignment->cigar_ops);
+    }
+    return p - dest;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/sam.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Restore an alignment stored by bl_sam_serialize_mem(3).  Memory is
+ *      allocated as by bl_sam_copy(3), so sam_alignment should not hold
+ *      allocated memory when this is called.  Free it with bl_sam_free(3).
+ *
+ *  Arguments:
+ *      src:            Serialized alignment
+ *      sam_alignment:  Pointer to a bl_sam_t structure to receive the alignment
+ *
+ *  Returns:
+ *      The number of bytes consumed from src
+ *
+ *  See also:
+ *      bl_sam_serialize_mem(3), bl_sam_free(3)
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  bl_sam_deserialize_mem(const char *src, bl_sam_t *sam_alignment)
+
+{
+    sam_serial_t    head;
+    const char      *p = src;
+    size_t          bytes;
+    
+    memcpy(&head, p, sizeof(head));
+    p += sizeof(head);
+    sam_serial_apply(sam_alignment, &head);
+    memcpy(sam_alignment->qname, p, head.qname_len);
+    p += head.qname_len;
+    memcpy(sam_alignment->rname, p, head.rname_len);
+    p += head.rname_len;
+    memcpy(sam_alignment->cigar, p, head.cigar_len);
+    p += head.cigar_len;
+    memcpy(sam_alignment->rnext, p, head.rnext_len);
+    p += head.rnext_len;
+    bytes = sam_serial_seq_bytes(sam_alignment);
+    if ( bytes > 0 )
+    {
+	memcpy(head.seq_encoding == BL_SEQ_ASCII ?
+		(void *)sam_alignment->seq : (void *)sam_alignment->packed_seq,
+	       p, bytes);
+	p += bytes;
+    }
+    memcpy(sam_alignment->qual, p, head.qual_len);
+    p += head.qual_len;
+    if ( head.tags_len > 0 )
+    {
+	memcpy(sam_alignment->tags, p, head.tags_len);
+	p += head.tags_len;
+    }
+    if ( head.cigar_op_count > 0 )
+    {
+	bytes = head.cigar_op_count * sizeof(*sam_alignment->cigar_ops);
+	memcpy(sam_alignment->cigar_ops, p, bytes);
+	p += bytes;
+    }
+    return p - src;
 }
@@ -5,6 +5,10 @@
 #include <inttypes.h>
 #endif
 
+#ifndef _STDBOOL_H_
+#include <stdbool.h>
+#endif
+
 #ifndef __xtend_h__
 #include <xtend.h>
 #endif
@@ -13,6 +17,10 @@
 #include "biolibc.h"
 #endif
 
+#ifndef _seq_pack_h_
+#include "seq-pack.h"
+#endif
+
 #define BL_SAM_MAPQ_MAX_CHARS  3
 #define BL_SAM_QNAME_MAX_CHARS 4096
 #define BL_SAM_RNAME_MAX_CHARS 4096
@@ -22,7 +30,47 @@
 #define BL_SAM_SEQ_MAX_CHARS   1024*1024
 
 // Use this or the function for every new object
-#define BL_SAM_ALIGNMENT_INIT  { "", 0, "", 0, 0, "", "", 0, 0, NULL, NULL, 0, 0 }
+#define BL_SAM_ALIGNMENT_INIT  \
+	{ "", 0, "", 0, 0, "", "", 0, 0, NULL, NULL, 0, 0, 0, 0, NULL, 0, 0, 0, \
+	  NULL, 0, BL_SEQ_ASCII, NULL, 0, 0, NULL, 0, 0, false }
+
+/*
+ *  CIGAR operations are stored BAM-style, one uint32_t per operation,
+ *  with the length in the upper 28 bits and the operation code in the
+ *  lower 4.  Codes are the same as BAM/htslib so that packed CIGARs can
+ *  be exchanged without translation.
+ */
+#define BL_SAM_CIGAR_M          0   // Alignment match (match or mismatch)
+#define BL_SAM_CIGAR_I          1   // Insertion to the reference
+#define BL_SAM_CIGAR_D          2   // Deletion from the reference
+#define BL_SAM_CIGAR_N          3   // Skipped region (intron)
+#define BL_SAM_CIGAR_S          4   // Soft clip
+#define BL_SAM_CIGAR_H          5   // Hard clip
+#define BL_SAM_CIGAR_P          6   // Padding
+#define BL_SAM_CIGAR_EQ         7   // Sequence match
+#define BL_SAM_CIGAR_X          8   // Sequence mismatch
+#define BL_SAM_CIGAR_OP_CHARS   "MIDNSHP=X"
+
+#define BL_SAM_CIGAR_OP(op)             ((op) & 0xf)
+#define BL_SAM_CIGAR_OP_LEN(op)         ((op) >> 4)
+#define BL_SAM_CIGAR_PACK(len,code)     (((uint32_t)(len) << 4) | (code))
+#define BL_SAM_CIGAR_OP_LEN_MAX         ((1u << 28) - 1)
+// Bit vectors indexed by op code: M D N = X and M I S = X respectively
+#define BL_SAM_CIGAR_CONSUMES_REF(code)     ((0x18d >> (code)) & 1)
+#define BL_SAM_CIGAR_CONSUMES_QUERY(code)   ((0x193 >> (code)) & 1)
+
+/*
+ *  Optional field (tag) index entry.  Built by bl_sam_tag_index() on
+ *  the first tag lookup, so records whose tags are never examined
+ *  cost only the copy of the raw text.
+ */
+typedef struct
+{
+    uint16_t        key;        // (tag[0] << 8) | tag[1], 0 if slot empty
+    char            type;       // SAM type: A, i, f, Z, H, or B
+    uint32_t        offset;     // Offset of value within tags
+    uint32_t        len;        // Length of value
+}   bl_sam_tag_t;
 
 typedef struct
 {
@@ -42,11 +90,70 @@ typedef struct
     /* Additional data */
     size_t          seq_len;
     size_t          qual_len;
+    
+    /*
+     *  Bytes allocated for seq and qual, grown by bl_sam_read() as
+     *  needed, so one bl_sam_t can be reused for records of any length.
+     *  0 if unknown, e.g. set by bl_sam_set_seq(), which forces a
+     *  realloc() on the next read.
+     */
+    size_t          seq_capacity;
+    size_t          qual_capacity;
+    
+    /*
+     *  CIGAR decoded by bl_sam_cigar_parse(), and the last reference
+     *  position covered by the alignment (1-based, inclusive), which
+     *  accounts for deletions, insertions, skips, and clipping.
+     */
+    uint32_t        *cigar_ops;
+    unsigned        cigar_op_count;
+    unsigned        cigar_op_max;
+    uint64_t        ref_end;
+    
+    /*
+     *  Sequence packed by bl_sam_pack_seq().  When seq_encoding is not
+     *  BL_SEQ_ASCII, seq is NULL and bases are in packed_seq.  BL_SEQ_NT4
+     *  exceptions follow the packed bases, starting on a 4-byte boundary.
+     *  SEQ "*" is packed as seq_len 0 with packed_seq NULL.
+     */
+    uint8_t         *packed_seq;
+    uint32_t        seq_exception_count;
+    unsigned char   seq_encoding;
+    
+    /*
+     *  Optional fields after QUAL, kept only with BL_SAM_FIELD_TAGS.
+     *  Tab-separated and null-terminated, exactly as in the input.
+     */
+    char            *tags;
+    size_t          tags_len;
+    size_t          tags_max;
+    bl_sam_tag_t    *tag_index;     // Open-addressed, power of 2 slots
+    unsigned        tag_index_size;
+    unsigned        tag_count;
+    bool            tags_indexed;
 }   bl_sam_t;
 
+/*
+ *  FLAG bits, copied from htslib/sam.h to avoid an htslib dependency.
+ *  It should be safe to assume these will never change, since changing
+ *  them would break all existing SAM/BAM/CRAM files.
+ */
+#define     BAM_FPAIRED         1
+#define     BAM_FPROPER_PAIR    2
+#define     BAM_FUNMAP          4
+#define     BAM_FMUNMAP         8
+#define     BAM_FREVERSE        16
+#define     BAM_FMREVERSE       32
+#define     BAM_FREAD1          64
+#define     BAM_FREAD2          128
+#define     BAM_FSECONDARY      256
+#define     BAM_FQCFAIL         512
+#define     BAM_FDUP            1024
+#define     BAM_FSUPPLEMENTARY  2048
+
 typedef unsigned int        sam_field_mask_t;
 
-#define BL_SAM_FIELD_ALL    0xfff
+#define BL_SAM_FIELD_ALL    0x7ff
 #define BL_SAM_FIELD_QNAME  0x001
 #define BL_SAM_FIELD_FLAG   0x002
 #define BL_SAM_FIELD_RNAME  0x004
@@ -58,6 +165,50 @@ typedef unsigned int        sam_field_mask_t;
 #define BL_SAM_FIELD_TLEN   0x100
 #define BL_SAM_FIELD_SEQ    0x200
 #define BL_SAM_FIELD_QUAL   0x400
+#define BL_SAM_FIELD_CIGAR_OPS  0x800   // Decode CIGAR, not included in ALL
+#define BL_SAM_FIELD_TAGS   0x1000      // Not included in ALL
+
+struct bl_sam_filter;   // sam-filter.h
+
+/*
+ *  SAM stream reader context.  All state needed to parse a SAM stream,
+ *  so that separate streams can be read in parallel threads.
+ */
+typedef struct
+{
+    FILE            *stream;
+    bool            owns_stream;    // Opened by bl_sam_reader_open()
+    sam_field_mask_t    field_mask;
+    uint64_t        previous_pos;   // Of last alignment read
+    uint64_t        alignments_read;
+    struct bl_sam_filter    *filter;    // Applied after the TLEN field
+    uint64_t        alignments_filtered;
+}   bl_sam_reader_t;
+
+#define BL_SAM_WRITER_BUFF_SIZE (256 * 1024)
+
+typedef struct
+{
+    FILE            *stream;
+    int             fd;             // fileno(stream), written with write()
+    bool            owns_stream;    // Opened by bl_sam_writer_open()
+    sam_field_mask_t    field_mask;
+    char            *buff;          // Formatted alignments not yet written
+    size_t          buff_len;
+    size_t          buff_size;
+    uint64_t        alignments_written;
+}   bl_sam_writer_t;
+
+/* Not generated by gen-get-set */
+#define BL_SAM_READER_STREAM(ptr)           ((ptr)->stream)
+#define BL_SAM_READER_FIELD_MASK(ptr)       ((ptr)->field_mask)
+#define BL_SAM_READER_PREVIOUS_POS(ptr)     ((ptr)->previous_pos)
+#define BL_SAM_READER_ALIGNMENTS_READ(ptr)  ((ptr)->alignments_read)
+#define BL_SAM_READER_FILTER(ptr)           ((ptr)->filter)
+#define BL_SAM_READER_ALIGNMENTS_FILTERED(ptr)  ((ptr)->alignments_filtered)
+#define BL_SAM_WRITER_STREAM(ptr)           ((ptr)->stream)
+#define BL_SAM_WRITER_FIELD_MASK(ptr)       ((ptr)->field_mask)
+#define BL_SAM_WRITER_ALIGNMENTS_WRITTEN(ptr)   ((ptr)->alignments_written)
 
 /*
  *  Generated by /home/bacon/scripts/gen-get-set
@@ -89,6 +240,21 @@ typedef unsigned int        sam_field_mask_t;
 #define BL_SAM_SEQ_LEN(ptr)             ((ptr)->seq_len)
 #define BL_SAM_QUAL_LEN(ptr)            ((ptr)->qual_len)
 
+/* Not generated by gen-get-set.  Set only by bl_sam_cigar_parse(). */
+#define BL_SAM_CIGAR_OPS(ptr)           ((ptr)->cigar_ops)
+#define BL_SAM_CIGAR_OPS_AE(ptr,c)      ((ptr)->cigar_ops[c])
+#define BL_SAM_CIGAR_OP_COUNT(ptr)      ((ptr)->cigar_op_count)
+#define BL_SAM_REF_END(ptr)             ((ptr)->ref_end)
+
+/* Not generated by gen-get-set.  Set only by bl_sam_pack_seq(). */
+#define BL_SAM_PACKED_SEQ(ptr)          ((ptr)->packed_seq)
+#define BL_SAM_SEQ_EXCEPTION_COUNT(ptr) ((ptr)->seq_exception_count)
+#define BL_SAM_SEQ_ENCODING(ptr)        ((ptr)->seq_encoding)
+
+/* Not generated by gen-get-set.  Set only by bl_sam_read(). */
+#define BL_SAM_TAGS(ptr)                ((ptr)->tags)
+#define BL_SAM_TAGS_LEN(ptr)            ((ptr)->tags_len)
+
 /*
  *  Generated by /home/bacon/scripts/gen-get-set
  *
@@ -116,10 +282,10 @@ typedef unsigned int        sam_field_mask_t;
 #define BL_SAM_SET_RNEXT_AE(ptr,c,val)          ((ptr)->rnext[c] = (val))
 #define BL_SAM_SET_PNEXT(ptr,val)               ((ptr)->pnext = (val))
 #define BL_SAM_SET_TLEN(ptr,val)                ((ptr)->tlen = (val))
-#define BL_SAM_SET_SEQ(ptr,val)                 ((ptr)->seq = (val))
+#define BL_SAM_SET_SEQ(ptr,val)                 ((ptr)->seq = (val), (ptr)->seq_capacity = 0)
 #define BL_SAM_SET_SEQ_CPY(ptr,val,array_size)  strlcpy((ptr)->seq,val,array_size)
 #define BL_SAM_SET_SEQ_AE(ptr,c,val)            ((ptr)->seq[c] = (val))
-#define BL_SAM_SET_QUAL(ptr,val)                ((ptr)->qual = (val))
+#define BL_SAM_SET_QUAL(ptr,val)                ((ptr)->qual = (val), (ptr)->qual_capacity = 0)
 #define BL_SAM_SET_QUAL_CPY(ptr,val,array_size) strlcpy((ptr)->qual,val,array_size)
 #define BL_SAM_SET_QUAL_AE(ptr,c,val)           ((ptr)->qual[c] = (val))
 #define BL_SAM_SET_SEQ_LEN(ptr,val)             ((ptr)->seq_len = (val))
@@ -131,6 +297,42 @@ void bl_sam_copy(bl_sam_t *dest, bl_sam_t *src);
 void bl_sam_free(bl_sam_t *sam_alignment);
 void bl_sam_init(bl_sam_t *sam_alignment, size_t seq_len, sam_field_mask_t field_mask);
 int bl_sam_write(FILE *sam_stream, bl_sam_t *sam_alignment, sam_field_mask_t field_mask);
+int bl_sam_pack_seq(bl_sam_t *sam_alignment, int encoding);
+int bl_sam_unpack_seq(bl_sam_t *sam_alignment);
+char bl_sam_seq_base(bl_sam_t *sam_alignment, size_t c);
+size_t bl_sam_footprint(bl_sam_t *sam_alignment);
+int bl_sam_serialize(FILE *stream, bl_sam_t *sam_alignment);
+int bl_sam_deserialize(FILE *stream, bl_sam_t *sam_alignment);
+size_t bl_sam_serialized_size(bl_sam_t *sam_alignment);
+size_t bl_sam_serialize_mem(char *dest, bl_sam_t *sam_alignment);
+size_t bl_sam_deserialize_mem(const char *src, bl_sam_t *sam_alignment);
+void bl_sam_reader_init(bl_sam_reader_t *reader, FILE *sam_stream, sam_field_mask_t field_mask);
+FILE *bl_sam_reader_open(bl_sam_reader_t *reader, const char *filename, sam_field_mask_t field_mask);
+int bl_sam_reader_read(bl_sam_reader_t *reader, bl_sam_t *sam_alignment);
+void bl_sam_reader_close(bl_sam_reader_t *reader);
+void bl_sam_reader_set_filter(bl_sam_reader_t *reader, struct bl_sam_filter *filter);
+void bl_sam_writer_init(bl_sam_writer_t *writer, FILE *sam_stream, sam_field_mask_t field_mask);
+FILE *bl_sam_writer_open(bl_sam_writer_t *writer, const char *filename, sam_field_mask_t field_mask);
+int bl_sam_writer_write(bl_sam_writer_t *writer, bl_sam_t *sam_alignment);
+bool bl_sam_writer_fits(bl_sam_writer_t *writer, bl_sam_t *sam_alignment);
+int bl_sam_writer_flush(bl_sam_writer_t *writer);
+int bl_sam_writer_close(bl_sam_writer_t *writer);
+
+/* sam-cigar.c */
+int bl_sam_cigar_parse(bl_sam_t *sam_alignment);
+uint64_t bl_sam_cigar_ref_len(const char *cigar);
+void bl_sam_update_ref_end(bl_sam_t *sam_alignment);
+uint64_t bl_sam_query_to_ref(bl_sam_t *sam_alignment, size_t query_pos);
+int bl_sam_ref_to_query(bl_sam_t *sam_alignment, uint64_t ref_pos, size_t *query_pos);
+
+/* sam-tags.c */
+int bl_sam_tag_index(bl_sam_t *sam_alignment);
+int bl_sam_tag_find(bl_sam_t *sam_alignment, const char *key, bl_sam_tag_t **tag);
+int bl_sam_get_tag_int(bl_sam_t *sam_alignment, const char *key, int64_t *value);
+int bl_sam_get_tag_float(bl_sam_t *sam_alignment, const char *key, double *value);
+int bl_sam_get_tag_string(bl_sam_t *sam_alignment, const char *key, const char **value, size_t *len);
+int bl_sam_get_tag_array_int(bl_sam_t *sam_alignment, const char *key, int64_t values[], size_t max_count, size_t *count);
+int bl_sam_get_tag_array_float(bl_sam_t *sam_alignment, const char *key, double values[], size_t max_count, size_t *count);
 
 /* sam-mutators.c */
 int bl_sam_set_qname_ae(bl_sam_t *bl_sam_ptr, size_t c, char new_qname_element);
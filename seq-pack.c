@@ -0,0 +1,563 @@
+#include <stdio.h>
+#include <string.h>
+#include "seq-pack.h"
+
+/*
+ *  Neither AVX2 nor SSSE3 is part of the x86_64 baseline, so the SIMD
+ *  kernels are compiled with function target attributes and chosen at
+ *  run time with __builtin_cpu_supports().  A default build thus uses
+ *  them on CPUs that have them, without -mavx2 or -march=native.  The
+ *  scalar code is used on all other CPUs.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SEQ_PACK_X86
+#include <immintrin.h>
+#endif
+
+/*
+ *  ASCII to BAM 4-bit code.  Unknown characters map to 15 (N) like
+ *  htslib's seq_nt16_table.
+ */
+static const uint8_t    Nt16_codes[256] =
+{
+    ['='] = 0,
+    ['A'] = 1, ['C'] = 2, ['M'] = 3, ['G'] = 4, ['R'] = 5, ['S'] = 6,
+    ['V'] = 7, ['T'] = 8, ['W'] = 9, ['Y'] = 10, ['H'] = 11, ['K'] = 12,
+    ['D'] = 13, ['B'] = 14, ['N'] = 15,
+    ['a'] = 1, ['c'] = 2, ['m'] = 3, ['g'] = 4, ['r'] = 5, ['s'] = 6,
+    ['v'] = 7, ['t'] = 8, ['w'] = 9, ['y'] = 10, ['h'] = 11, ['k'] = 12,
+    ['d'] = 13, ['b'] = 14, ['n'] = 15,
+    // Everything else is N, filled in by nt16_code()
+};
+
+/*
+ *  ASCII to 2-bit code + 1, so 0 marks an exception
+ */
+static const uint8_t    Nt4_codes[256] =
+{
+    ['A'] = 1, ['C'] = 2, ['G'] = 3, ['T'] = 4,
+    ['a'] = 1, ['c'] = 2, ['g'] = 3, ['t'] = 4
+};
+
+static inline uint8_t   nt16_code(unsigned char base)
+
+{
+    uint8_t code = Nt16_codes[base];
+
+    // '=' is the only valid base with code 0
+    return (code == 0) && (base != '=') ? 15 : code;
+}
+
+
+#if defined(SEQ_PACK_X86)
+/*
+ *  Pack runs of ACGTN 32 or 16 bases at a time for bl_seq_pack_nt16(),
+ *  stopping at the first block with another base.  Return the number
+ *  of bases packed so the caller can finish with scalar code.
+ */
+
+__attribute__((target("avx2")))
+static size_t   seq_pack_nt16_avx2(uint8_t *dest, const char *src,
+			size_t len)
+
+{
+    const __m256i   case_mask = _mm256_set1_epi8((char)0xdf),
+		    a = _mm256_set1_epi8('A'), cc = _mm256_set1_epi8('C'),
+		    g = _mm256_set1_epi8('G'), t = _mm256_set1_epi8('T'),
+		    n = _mm256_set1_epi8('N'),
+		    one = _mm256_set1_epi8(1), two = _mm256_set1_epi8(2),
+		    four = _mm256_set1_epi8(4), eight = _mm256_set1_epi8(8),
+		    fifteen = _mm256_set1_epi8(15),
+		    hi_lo = _mm256_set1_epi16(0x0110);
+    __m256i         bases, ea, ec, eg, et, en, codes, pairs;
+    size_t          c;
+
+    for (c = 0; c + 32 <= len; c += 32)
+    {
+	bases = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(src + c)),
+				 case_mask);
+	ea = _mm256_cmpeq_epi8(bases, a);
+	ec = _mm256_cmpeq_epi8(bases, cc);
+	eg = _mm256_cmpeq_epi8(bases, g);
+	et = _mm256_cmpeq_epi8(bases, t);
+	en = _mm256_cmpeq_epi8(bases, n);
+	if ( (unsigned)_mm256_movemask_epi8(_mm256_or_si256(
+		_mm256_or_si256(_mm256_or_si256(ea, ec), _mm256_or_si256(eg, et)),
+		en)) != 0xffffffffu )
+	    break;  // IUPAC or '=', finish with scalar code
+	codes = _mm256_or_si256(
+		    _mm256_or_si256(_mm256_and_si256(ea, one),
+				    _mm256_and_si256(ec, two)),
+		    _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(eg, four),
+						    _mm256_and_si256(et, eight)),
+				    _mm256_and_si256(en, fifteen)));
+	// first * 16 + second for each pair of bases
+	pairs = _mm256_maddubs_epi16(codes, hi_lo);
+	pairs = _mm256_packus_epi16(pairs, pairs);
+	pairs = _mm256_permute4x64_epi64(pairs, 0x08);
+	_mm_storeu_si128((__m128i *)(dest + c / 2),
+			 _mm256_castsi256_si128(pairs));
+    }
+    return c;
+}
+
+
+__attribute__((target("ssse3")))
+static size_t   seq_pack_nt16_ssse3(uint8_t *dest, const char *src,
+			size_t len)
+
+{
+    const __m128i   case_mask = _mm_set1_epi8((char)0xdf),
+		    a = _mm_set1_epi8('A'), cc = _mm_set1_epi8('C'),
+		    g = _mm_set1_epi8('G'), t = _mm_set1_epi8('T'),
+		    n = _mm_set1_epi8('N'),
+		    one = _mm_set1_epi8(1), two = _mm_set1_epi8(2),
+		    four = _mm_set1_epi8(4), eight = _mm_set1_epi8(8),
+		    fifteen = _mm_set1_epi8(15),
+		    hi_lo = _mm_set1_epi16(0x0110);
+    __m128i         bases, ea, ec, eg, et, en, codes, pairs;
+    size_t          c;
+
+    for (c = 0; c + 16 <= len; c += 16)
+    {
+	bases = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + c)),
+			      case_mask);
+	ea = _mm_cmpeq_epi8(bases, a);
+	ec = _mm_cmpeq_epi8(bases, cc);
+	eg = _mm_cmpeq_epi8(bases, g);
+	et = _mm_cmpeq_epi8(bases, t);
+	en = _mm_cmpeq_epi8(bases, n);
+	if ( _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(ea, ec),
+			_mm_or_si128(eg, et)), en)) != 0xffff )
+	    break;  // IUPAC or '=', finish with scalar code
+	codes = _mm_or_si128(
+		    _mm_or_si128(_mm_and_si128(ea, one), _mm_and_si128(ec, two)),
+		    _mm_or_si128(_mm_or_si128(_mm_and_si128(eg, four),
+					      _mm_and_si128(et, eight)),
+				 _mm_and_si128(en, fifteen)));
+	// first * 16 + second for each pair of bases
+	pairs = _mm_maddubs_epi16(codes, hi_lo);
+	_mm_storel_epi64((__m128i *)(dest + c / 2),
+			 _mm_packus_epi16(pairs, pairs));
+    }
+    return c;
+}
+
+
+/*
+ *  Unpack 32 or 16 bases at a time for bl_seq_unpack_nt16(), using a
+ *  byte shuffle as a 16-entry lookup table.  Return the number of
+ *  bases unpacked.
+ */
+
+__attribute__((target("avx2")))
+static size_t   seq_unpack_nt16_avx2(char *dest, const uint8_t *src,
+			size_t len)
+
+{
+    const __m256i   table = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i *)BL_SEQ_NT16_CHARS));
+    const __m128i   nibble = _mm_set1_epi8(0x0f);
+    __m128i         packed, hi, lo;
+    __m256i         codes;
+    size_t          c;
+
+    for (c = 0; c + 32 <= len; c += 32)
+    {
+	packed = _mm_loadu_si128((const __m128i *)(src + c / 2));
+	hi = _mm_and_si128(_mm_srli_epi16(packed, 4), nibble);
+	lo = _mm_and_si128(packed, nibble);
+	codes = _mm256_set_m128i(_mm_unpackhi_epi8(hi, lo),
+				 _mm_unpacklo_epi8(hi, lo));
+	_mm256_storeu_si256((__m256i *)(dest + c),
+			    _mm256_shuffle_epi8(table, codes));
+    }
+    return c;
+}
+
+
+__attribute__((target("ssse3")))
+static size_t   seq_unpack_nt16_ssse3(char *dest, const uint8_t *src,
+			size_t len)
+
+{
+    const __m128i   table = _mm_loadu_si128((const __m128i *)BL_SEQ_NT16_CHARS),
+		    nibble = _mm_set1_epi8(0x0f);
+    __m128i         packed, hi, lo;
+    size_t          c;
+
+    for (c = 0; c + 16 <= len; c += 16)
+    {
+	packed = _mm_loadl_epi64((const __m128i *)(src + c / 2));
+	hi = _mm_and_si128(_mm_srli_epi16(packed, 4), nibble);
+	lo = _mm_and_si128(packed, nibble);
+	_mm_storeu_si128((__m128i *)(dest + c),
+			 _mm_shuffle_epi8(table, _mm_unpacklo_epi8(hi, lo)));
+    }
+    return c;
+}
+
+
+/*
+ *  Pack 16 bases at a time for bl_seq_pack_nt4(), recording exceptions
+ *  as it does.  This is used with AVX2 as well, since the 32-bit lane
+ *  packing gains nothing from 256-bit registers.  Return the number of
+ *  bases packed.
+ */
+
+__attribute__((target("ssse3")))
+static size_t   seq_pack_nt4_ssse3(uint8_t *dest, const char *src, size_t len,
+			uint32_t *exceptions, size_t *exception_count)
+
+{
+    const __m128i   case_mask = _mm_set1_epi8((char)0xdf),
+		    a = _mm_set1_epi8('A'), cc = _mm_set1_epi8('C'),
+		    g = _mm_set1_epi8('G'), t = _mm_set1_epi8('T'),
+		    one = _mm_set1_epi8(1), two = _mm_set1_epi8(2),
+		    three = _mm_set1_epi8(3),
+		    pair_weights = _mm_set1_epi16(0x0104),
+		    quad_weights = _mm_set1_epi32(0x00010010);
+    __m128i         bases, ea, ec, eg, et, codes, pairs, quads;
+    unsigned        invalid;
+    uint32_t        packed;
+    size_t          c;
+
+    for (c = 0; c + 16 <= len; c += 16)
+    {
+	bases = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + c)),
+			      case_mask);
+	ea = _mm_cmpeq_epi8(bases, a);
+	ec = _mm_cmpeq_epi8(bases, cc);
+	eg = _mm_cmpeq_epi8(bases, g);
+	et = _mm_cmpeq_epi8(bases, t);
+	codes = _mm_or_si128(_mm_and_si128(ec, one),
+			     _mm_or_si128(_mm_and_si128(eg, two),
+					  _mm_and_si128(et, three)));
+	// c0 * 4 + c1, then (c0 * 4 + c1) * 16 + c2 * 4 + c3
+	pairs = _mm_maddubs_epi16(codes, pair_weights);
+	quads = _mm_madd_epi16(pairs, quad_weights);
+	quads = _mm_packs_epi32(quads, quads);
+	quads = _mm_packus_epi16(quads, quads);
+	// dest has no alignment guarantee
+	packed = (uint32_t)_mm_cvtsi128_si32(quads);
+	memcpy(dest + c / 4, &packed, sizeof(packed));
+
+	invalid = ~_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(ea, ec),
+					_mm_or_si128(eg, et))) & 0xffff;
+	while ( invalid != 0 )
+	{
+	    if ( exceptions != NULL )
+		exceptions[*exception_count] = c + __builtin_ctz(invalid);
+	    ++*exception_count;
+	    invalid &= invalid - 1;
+	}
+    }
+    return c;
+}
+
+
+/*
+ *  Unpack 16 bases at a time for bl_seq_unpack_nt4().  Broadcast each
+ *  packed byte to 4 lanes and mask out one base per lane.  The isolated
+ *  2 bits land either in the low nibble or the high nibble, as code or
+ *  code << 2.  OR-ing the two nibbles gives an index that is unique for
+ *  each base, so one byte shuffle does the table lookup.  Return the
+ *  number of bases unpacked.
+ */
+
+__attribute__((target("ssse3")))
+static size_t   seq_unpack_nt4_ssse3(char *dest, const uint8_t *src,
+			size_t len)
+
+{
+    const __m128i   spread = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1,
+					   2, 2, 2, 2, 3, 3, 3, 3),
+		    select = _mm_setr_epi8((char)0xc0, 0x30, 0x0c, 0x03,
+					   (char)0xc0, 0x30, 0x0c, 0x03,
+					   (char)0xc0, 0x30, 0x0c, 0x03,
+					   (char)0xc0, 0x30, 0x0c, 0x03),
+		    table = _mm_setr_epi8('A', 'C', 'G', 'T', 'C', 0, 0, 0,
+					  'G', 0, 0, 0, 'T', 0, 0, 0),
+		    nibble = _mm_set1_epi8(0x0f);
+    __m128i         bits;
+    uint32_t        packed;
+    size_t          c;
+
+    for (c = 0; c + 16 <= len; c += 16)
+    {
+	memcpy(&packed, src + c / 4, sizeof(packed));
+	bits = _mm_and_si128(_mm_shuffle_epi8(_mm_cvtsi32_si128(packed),
+					      spread), select);
+	bits = _mm_or_si128(_mm_and_si128(bits, nibble),
+			    _mm_and_si128(_mm_srli_epi16(bits, 4), nibble));
+	_mm_storeu_si128((__m128i *)(dest + c), _mm_shuffle_epi8(table, bits));
+    }
+    return c;
+}
+#endif
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/seq-pack.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Pack an ASCII nucleotide sequence into the 4-bit BAM encoding,
+ *      two bases per byte with the first base in the high nibble.
+ *      All IUPAC codes and '=' are preserved.  Lower case bases are
+ *      packed as upper case and any other character is packed as N.
+ *
+ *      dest must have room for BL_SEQ_NT16_BYTES(len) bytes.  On CPUs
+ *      with SSSE3 or AVX2, which are detected at run time, runs of
+ *      ACGTN are packed 16 or 32 bases at a time.
+ *
+ *  Arguments:
+ *      dest:   Buffer to receive packed sequence
+ *      src:    ASCII sequence
+ *      len:    Number of bases in src
+ *
+ *  Examples:
+ *      uint8_t *packed = xt_malloc(BL_SEQ_NT16_BYTES(len), 1);
+ *
+ *      bl_seq_pack_nt16(packed, BL_SAM_SEQ(&sam_alignment), len);
+ *
+ *  See also:
+ *      bl_seq_unpack_nt16(3), bl_seq_pack_nt4(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_seq_pack_nt16(uint8_t *dest, const char *src, size_t len)
+
+{
+    size_t  c = 0;
+
+#if defined(SEQ_PACK_X86)
+    if ( __builtin_cpu_supports("avx2") )
+	c = seq_pack_nt16_avx2(dest, src, len);
+    else if ( __builtin_cpu_supports("ssse3") )
+	c = seq_pack_nt16_ssse3(dest, src, len);
+#endif
+
+    for (; c + 2 <= len; c += 2)
+	dest[c / 2] = (nt16_code(src[c]) << 4) | nt16_code(src[c + 1]);
+    if ( c < len )
+	dest[c / 2] = nt16_code(src[c]) << 4;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/seq-pack.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Unpack a 4-bit BAM encoded sequence to null-terminated ASCII.
+ *      dest must have room for len + 1 characters.  On CPUs with SSSE3
+ *      or AVX2, which are detected at run time, 16 or 32 bases are
+ *      unpacked at a time using a byte shuffle as a 16-entry lookup
+ *      table.
+ *
+ *  Arguments:
+ *      dest:   Buffer to receive ASCII sequence
+ *      src:    Packed sequence
+ *      len:    Number of bases in src
+ *
+ *  See also:
+ *      bl_seq_pack_nt16(3), BL_SEQ_NT16_BASE(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_seq_unpack_nt16(char *dest, const uint8_t *src, size_t len)
+
+{
+    size_t  c = 0;
+
+#if defined(SEQ_PACK_X86)
+    if ( __builtin_cpu_supports("avx2") )
+	c = seq_unpack_nt16_avx2(dest, src, len);
+    else if ( __builtin_cpu_supports("ssse3") )
+	c = seq_unpack_nt16_ssse3(dest, src, len);
+#endif
+
+    for (; c < len; ++c)
+	dest[c] = BL_SEQ_NT16_BASE(src, c);
+    dest[len] = '\0';
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/seq-pack.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Pack an ASCII nucleotide sequence into a 2-bit encoding, four
+ *      bases per byte with the first base in the high bits, A=0, C=1,
+ *      G=2, T=3.  Upper and lower case are equivalent.  Any other
+ *      character is packed as A and its 0-based position is appended
+ *      to the exceptions array, so it can be restored as N when
+ *      unpacked.
+ *
+ *      dest must have room for BL_SEQ_NT4_BYTES(len) bytes.  exceptions
+ *      must have room for every non-ACGT base in src, or be NULL to
+ *      count exceptions without storing them.  Exceptions are rare in
+ *      most data, so a common approach is to pack once with NULL,
+ *      allocate the exact number needed if non-zero, and pack again.
+ *
+ *      On CPUs with SSSE3, which is detected at run time, 16 bases are
+ *      packed at a time.
+ *
+ *  Arguments:
+ *      dest:       Buffer to receive packed sequence
+ *      src:        ASCII sequence
+ *      len:        Number of bases in src
+ *      exceptions: Array to receive positions of non-ACGT bases, or NULL
+ *
+ *  Returns:
+ *      The number of non-ACGT bases in src
+ *
+ *  See also:
+ *      bl_seq_unpack_nt4(3), bl_seq_nt4_base(3), bl_seq_pack_nt16(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  bl_seq_pack_nt4(uint8_t *dest, const char *src, size_t len,
+			uint32_t *exceptions)
+
+{
+    size_t      c = 0, exception_count = 0;
+    unsigned    k, code;
+    uint8_t     byte;
+
+#if defined(SEQ_PACK_X86)
+    if ( __builtin_cpu_supports("ssse3") )
+	c = seq_pack_nt4_ssse3(dest, src, len, exceptions, &exception_count);
+#endif
+
+    for (; c < len; c += 4)
+    {
+	byte = 0;
+	for (k = 0; k < 4; ++k)
+	{
+	    byte <<= 2;
+	    if ( c + k < len )
+	    {
+		if ( (code = Nt4_codes[(unsigned char)src[c + k]]) == 0 )
+		{
+		    if ( exceptions != NULL )
+			exceptions[exception_count] = c + k;
+		    ++exception_count;
+		}
+		else
+		    byte |= code - 1;
+	    }
+	}
+	dest[c / 4] = byte;
+    }
+    return exception_count;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/seq-pack.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Unpack a 2-bit encoded sequence to null-terminated ASCII,
+ *      restoring bases listed in exceptions as 'N'.  dest must have room
+ *      for len + 1 characters.  On CPUs with SSSE3, which is detected
+ *      at run time, 16 bases are unpacked at a time.
+ *
+ *  Arguments:
+ *      dest:               Buffer to receive ASCII sequence
+ *      src:                Packed sequence
+ *      len:                Number of bases in src
+ *      exceptions:         Positions of non-ACGT bases from bl_seq_pack_nt4()
+ *      exception_count:    Number of positions in exceptions
+ *
+ *  See also:
+ *      bl_seq_pack_nt4(3), bl_seq_nt4_base(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+void    bl_seq_unpack_nt4(char *dest, const uint8_t *src, size_t len,
+			  const uint32_t *exceptions, size_t exception_count)
+
+{
+    size_t  c = 0;
+
+#if defined(SEQ_PACK_X86)
+    if ( __builtin_cpu_supports("ssse3") )
+	c = seq_unpack_nt4_ssse3(dest, src, len);
+#endif
+
+    for (; c < len; ++c)
+	dest[c] = BL_SEQ_NT4_CHARS[BL_SEQ_NT4_CODE(src, c)];
+    dest[len] = '\0';
+
+    for (c = 0; c < exception_count; ++c)
+	dest[exceptions[c]] = 'N';
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <biolibc/seq-pack.h>
+ *      -lbiolibc -lxtend
+ *
+ *  Description:
+ *      Return the base at a given position of a 2-bit encoded sequence,
+ *      checking the exception list so that non-ACGT bases are reported
+ *      as 'N'.  The exception list is sorted, as produced by
+ *      bl_seq_pack_nt4(3), so lookup is a binary search.  If it is
+ *      known that there are no exceptions, BL_SEQ_NT4_CODE() is faster.
+ *
+ *  Arguments:
+ *      packed:             Packed sequence
+ *      c:                  0-based position of the base
+ *      exceptions:         Positions of non-ACGT bases from bl_seq_pack_nt4()
+ *      exception_count:    Number of positions in exceptions
+ *
+ *  Returns:
+ *      The ASCII base at position c
+ *
+ *  See also:
+ *      bl_seq_pack_nt4(3), bl_seq_unpack_nt4(3)
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-18  Jason Bacon Begin
+ ***************************************************************************/
+
+char    bl_seq_nt4_base(const uint8_t *packed, size_t c,
+			const uint32_t *exceptions, size_t exception_count)
+
+{
+    size_t  low = 0, high = exception_count, mid;
+
+    while ( low < high )
+    {
+	mid = (low + high) / 2;
+	if ( exceptions[mid] < c )
+	    low = mid + 1;
+	else
+	    high = mid;
+    }
+    if ( (low < exception_count) && (exceptions[low] == c) )
+	return 'N';
+    return BL_SEQ_NT4_CHARS[BL_SEQ_NT4_CODE(packed, c)];
+}
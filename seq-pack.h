@@ -0,0 +1,47 @@
+#ifndef _seq_pack_h_
+#define _seq_pack_h_
+
+#ifndef _STDINT_H_
+#include <stdint.h>
+#endif
+
+#ifndef _STDDEF_H_
+#include <stddef.h>
+#endif
+
+/*
+ *  Nucleotide sequence encodings.
+ *
+ *  BL_SEQ_NT16 is the 4-bit BAM encoding, two bases per byte with the
+ *  first base in the high nibble.  It preserves N and all IUPAC codes.
+ *
+ *  BL_SEQ_NT4 is a 2-bit encoding, four bases per byte with the first
+ *  base in the high bits, A=0, C=1, G=2, T=3.  Anything other than
+ *  ACGT is stored as an exception (a 0-based position) and unpacked as
+ *  'N'.  Lower case is unpacked as upper case.
+ */
+#define BL_SEQ_ASCII            0
+#define BL_SEQ_NT16             1
+#define BL_SEQ_NT4              2
+
+#define BL_SEQ_NT16_CHARS       "=ACMGRSVTWYHKDBN"
+#define BL_SEQ_NT4_CHARS        "ACGT"
+
+// Bytes needed to pack len bases
+#define BL_SEQ_NT16_BYTES(len)  (((len) + 1) / 2)
+#define BL_SEQ_NT4_BYTES(len)   (((len) + 3) / 4)
+
+// Base at 0-based position c of a packed sequence.  NT4 ignores exceptions.
+#define BL_SEQ_NT16_BASE(packed,c) \
+	(BL_SEQ_NT16_CHARS[((packed)[(c) >> 1] >> ((~(c) & 1) << 2)) & 0xf])
+#define BL_SEQ_NT4_CODE(packed,c) \
+	(((packed)[(c) >> 2] >> ((3 - ((c) & 3)) << 1)) & 3)
+
+/* seq-pack.c */
+void bl_seq_pack_nt16(uint8_t *dest, const char *src, size_t len);
+void bl_seq_unpack_nt16(char *dest, const uint8_t *src, size_t len);
+size_t bl_seq_pack_nt4(uint8_t *dest, const char *src, size_t len, uint32_t *exceptions);
+void bl_seq_unpack_nt4(char *dest, const uint8_t *src, size_t len, const uint32_t *exceptions, size_t exception_count);
+char bl_seq_nt4_base(const uint8_t *packed, size_t c, const uint32_t *exceptions, size_t exception_count);
+
+#endif  // _seq_pack_h_
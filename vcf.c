@@ -777,7 +777,9 @@ vcf_field_mask_t    bl_vcf_parse_field_spec(char *spec)
  *  Description:
  *      Determine if a VCF call is within a SAM alignment, i.e. on the
  *      same chrom and between the start and end positions of the
- *      alignment.
+ *      alignment.  The end position is BL_SAM_REF_END(), which accounts
+ *      for deletions, insertions, and clipping in the CIGAR.  If it has
+ *      not been computed (0), it is set with bl_sam_update_ref_end(3).
  *
  *  Arguments:
  *      vcf_call:   Pointer to bl_vcf_t structure containing VCF call
@@ -799,10 +801,12 @@ vcf_field_mask_t    bl_vcf_parse_field_spec(char *spec)
 bool    bl_vcf_call_in_alignment(bl_vcf_t *vcf_call, bl_sam_t *sam_alignment)
 
 {
+    // Not yet computed, e.g. built with bl_sam_init() and macros
+    if ( BL_SAM_REF_END(sam_alignment) == 0 )
+	bl_sam_update_ref_end(sam_alignment);
     if ( (strcmp(BL_VCF_CHROM(vcf_call), BL_SAM_RNAME(sam_alignment)) == 0) &&
 	 (BL_VCF_POS(vcf_call) >= BL_SAM_POS(sam_alignment)) &&
-	 (BL_VCF_POS(vcf_call) <
-	    BL_SAM_POS(sam_alignment) + BL_SAM_SEQ_LEN(sam_alignment)) )
+	 (BL_VCF_POS(vcf_call) <= BL_SAM_REF_END(sam_alignment)) )
 	return true;
     else
 	return false;
@@ -817,7 +821,9 @@ bool    bl_vcf_call_in_alignment(bl_vcf_t *vcf_call, bl_sam_t *sam_alignment)
  *  Description:
  *      Determine if a VCF call is downstream of a SAM alignment.
  *      For the purpose of this function, this could mean on the same
- *      chrom and higher position, or on a later chrom.
+ *      chrom and higher position than BL_SAM_REF_END(), or on a later
+ *      chrom.  If BL_SAM_REF_END() has not been computed (0), it is set
+ *      with bl_sam_update_ref_end(3).
  *
  *  Arguments:
  *      vcf_call:   Pointer to bl_vcf_t structure containing VCF call
@@ -843,7 +849,9 @@ bool    bl_vcf_call_downstream_of_alignment(bl_vcf_t *vcf_call,
 	    BL_SAM_RNAME(sam_alignment),BL_SAM_POS(sam_alignment),
 	    BL_SAM_SEQ_LEN(sam_alignment),
 	    BL_VCF_CHROM(vcf_call),BL_VCF_POS(vcf_call));*/
-    if ( (BL_SAM_POS(alignment) + BL_SAM_SEQ_LEN(alignment) <= BL_VCF_POS(vcf_call)) &&
+    if ( BL_SAM_REF_END(alignment) == 0 )
+	bl_sam_update_ref_end(alignment);
+    if ( (BL_SAM_REF_END(alignment) < BL_VCF_POS(vcf_call)) &&
 	  (strcmp(BL_SAM_RNAME(alignment), BL_VCF_CHROM(vcf_call)) == 0) )
 	return true;
     else if ( bl_chrom_name_cmp(BL_SAM_RNAME(alignment), BL_VCF_CHROM(vcf_call)) < 0 )